@@ -1,32 +1,96 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
 #include <obsidian/asset_converter/asset_converter.hpp>
 #include <obsidian/core/logging.hpp>
 #include <obsidian/task/task_executor.hpp>
 #include <obsidian/task/task_type.hpp>
 
+#include <charconv>
 #include <cstring>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace fs = std::filesystem;
 
+using CompressionSettings =
+    obsidian::asset_converter::AssetConverter::CompressionSettings;
+
 void reportInvalidArguments() {
   OBS_LOG_ERR("Invalid command line arguments. The required command line "
               "arguments are:\n"
               "-s <source-dir-path>\n"
-              "-d <destination-dir-path>\n");
+              "-d <destination-dir-path>\n"
+              "Optionally, the compression of an asset type can be set with\n"
+              "-c <texture|mesh|shader|material>="
+              "<none|lz4|lz4chunked|lz4hc|zstd>[:<level>]\n");
+}
+
+// Parses <asset-type>=<mode>[:<level>].
+std::optional<std::pair<obsidian::asset::AssetType, CompressionSettings>>
+parseCompressionArgument(std::string_view arg) {
+  using obsidian::asset::AssetType;
+  using obsidian::asset::CompressionMode;
+
+  static std::unordered_map<std::string_view, AssetType> const assetTypes = {
+      {"texture", AssetType::texture},
+      {"mesh", AssetType::mesh},
+      {"shader", AssetType::shader},
+      {"material", AssetType::material}};
+
+  static std::unordered_map<std::string_view, CompressionMode> const modes = {
+      {"none", CompressionMode::none},
+      {"lz4", CompressionMode::LZ4},
+      {"lz4chunked", CompressionMode::LZ4Chunked},
+      {"lz4hc", CompressionMode::LZ4HC},
+      {"zstd", CompressionMode::zstd}};
+
+  std::size_t const equalsPos = arg.find('=');
+
+  if (equalsPos == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  auto const assetType = assetTypes.find(arg.substr(0, equalsPos));
+  std::string_view const setting = arg.substr(equalsPos + 1);
+  std::size_t const colonPos = setting.find(':');
+  auto const mode = modes.find(setting.substr(0, colonPos));
+
+  if (assetType == assetTypes.cend() || mode == modes.cend()) {
+    return std::nullopt;
+  }
+
+  CompressionSettings compressionSettings{mode->second};
+
+  if (colonPos != std::string_view::npos) {
+    std::string_view const level = setting.substr(colonPos + 1);
+    auto const result = std::from_chars(level.data(),
+                                        level.data() + level.size(),
+                                        compressionSettings.level);
+
+    if (result.ec != std::errc{} || result.ptr != level.data() + level.size()) {
+      return std::nullopt;
+    }
+  }
+
+  return std::pair{assetType->second, compressionSettings};
 }
 
 int main(int argc, char const** argv) {
-  if (argc != 5) {
+  if (argc < 5) {
     reportInvalidArguments();
     return -1;
   }
 
   std::optional<fs::path> srcPath;
   std::optional<fs::path> dstPath;
+  std::vector<std::pair<obsidian::asset::AssetType, CompressionSettings>>
+      compressionSettings;
 
   for (std::size_t i = 1; i < argc - 1; ++i) {
     if (std::strcmp(argv[i], "-s") == 0) {
@@ -35,6 +99,16 @@ int main(int argc, char const** argv) {
     } else if (std::strcmp(argv[i], "-d") == 0) {
       dstPath = argv[i + 1];
       ++i;
+    } else if (std::strcmp(argv[i], "-c") == 0) {
+      auto const setting = parseCompressionArgument(argv[i + 1]);
+
+      if (!setting) {
+        reportInvalidArguments();
+        return -1;
+      }
+
+      compressionSettings.push_back(*setting);
+      ++i;
     }
   }
 
@@ -68,6 +142,10 @@ int main(int argc, char const** argv) {
   taskExecutor.initAndRun({{obsidian::task::TaskType::general, nCores}});
   obsidian::asset_converter::AssetConverter converter{taskExecutor};
 
+  for (auto const& [assetType, settings] : compressionSettings) {
+    converter.setCompression(assetType, settings);
+  }
+
   for (auto const& entry : dirIter) {
     if (!std::filesystem::is_regular_file(entry)) {
       continue;
@@ -0,0 +1,90 @@
+#include <obsidian/asset/asset_pack.hpp>
+#include <obsidian/core/logging.hpp>
+#include <obsidian/globals/file_extensions.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+void reportInvalidArguments() {
+  OBS_LOG_ERR("Invalid command line arguments. The required command line "
+              "arguments are:\n"
+              "-p <project-dir-path>\n"
+              "Optionally, the pack is written to\n"
+              "-o <pack-file-path>\n"
+              "instead of the project root.\n");
+}
+
+bool isPackedAsset(fs::path const& path) {
+  namespace globals = obsidian::globals;
+
+  static std::array<char const*, 5> const extensions = {
+      globals::textureAssetExt, globals::meshAssetExt, globals::shaderAssetExt,
+      globals::materialAssetExt, globals::prefabAssetExt};
+
+  return std::find(extensions.cbegin(), extensions.cend(),
+                   path.extension()) != extensions.cend() ||
+         path.filename().string().ends_with(globals::sceneAssetExt);
+}
+
+int main(int argc, char const** argv) {
+  if (argc < 3) {
+    reportInvalidArguments();
+    return -1;
+  }
+
+  std::optional<fs::path> projectPath;
+  std::optional<fs::path> packPath;
+
+  for (std::size_t i = 1; i < argc - 1; ++i) {
+    if (std::strcmp(argv[i], "-p") == 0) {
+      projectPath = argv[i + 1];
+      ++i;
+    } else if (std::strcmp(argv[i], "-o") == 0) {
+      packPath = argv[i + 1];
+      ++i;
+    }
+  }
+
+  if (!projectPath) {
+    reportInvalidArguments();
+    return -1;
+  }
+
+  if (!fs::is_directory(*projectPath)) {
+    OBS_LOG_ERR("The project path " + projectPath->string() +
+                " is not a directory.");
+    return -1;
+  }
+
+  if (!packPath) {
+    packPath = *projectPath / obsidian::asset::projectAssetPackName;
+  }
+
+  std::vector<fs::path> relativePaths;
+
+  for (auto const& entry : fs::recursive_directory_iterator(*projectPath)) {
+    if (entry.is_regular_file() && isPackedAsset(entry.path())) {
+      relativePaths.push_back(entry.path().lexically_relative(*projectPath));
+    }
+  }
+
+  // Keeps packs of the same project identical.
+  std::sort(relativePaths.begin(), relativePaths.end());
+
+  if (!obsidian::asset::buildAssetPack(*projectPath, relativePaths,
+                                       *packPath)) {
+    return -1;
+  }
+
+  OBS_LOG_MSG("Packed " + std::to_string(relativePaths.size()) +
+              " assets into " + packPath->string());
+
+  return 0;
+}
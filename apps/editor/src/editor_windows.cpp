@@ -84,8 +84,14 @@ scene::GameObject* pendingObjDelete = nullptr;
 std::vector<fs::path> _pendingDraggedFiles;
 
 void refreshAssetLists() {
+  obsidian::project::AssetIndex& assetIndex = project.getAssetIndex();
+
+  if (!assetIndex.isWatching()) {
+    assetIndex.rescan();
+  }
+
   texturesInProj.setValues(
-      project.getAllFilesWithExtension(globals::textureAssetExt));
+      assetIndex.getAssetPaths(obsidian::project::AssetFileType::texture));
 
   auto transformToStr = [](auto& dst, auto& src) {
     std::transform(src.cbegin(), src.cend(), std::back_inserter(dst),
@@ -93,13 +99,13 @@ void refreshAssetLists() {
   };
 
   shadersInProj.setValues(
-      project.getAllFilesWithExtension(globals::shaderAssetExt));
+      assetIndex.getAssetPaths(obsidian::project::AssetFileType::shader));
 
   materialsInProj.setValues(
-      project.getAllFilesWithExtension(globals::materialAssetExt));
+      assetIndex.getAssetPaths(obsidian::project::AssetFileType::material));
 
   meshesInProj.setValues(
-      project.getAllFilesWithExtension(globals::meshAssetExt));
+      assetIndex.getAssetPaths(obsidian::project::AssetFileType::mesh));
 }
 
 template <typename TCollection, typename TValue>
@@ -133,8 +139,7 @@ void loadScene(char const scenePath[], scene::Scene& scene,
   std::string sceneJsonStr;
   sceneJsonStr.resize(sceneAssetInfo.unpackedSize);
 
-  if (!asset::unpackAsset(sceneAssetInfo, sceneAsset.binaryBlob.data(),
-                          sceneAsset.binaryBlob.size(), sceneJsonStr.data())) {
+  if (!asset::unpackAsset(sceneAssetInfo, sceneAsset, sceneJsonStr.data())) {
     OBS_LOG_ERR("Failed to unpack scene asset.");
     return;
   }
@@ -1116,6 +1121,11 @@ void projectTab(ObsidianEngine& engine) {
 void begnEditorFrame(ImGuiIO& imguiIO) {
   ZoneScoped;
 
+  // Picks up the asset files changed in and outside of the editor.
+  if (project.getAssetIndex().update()) {
+    assetListDirty = true;
+  }
+
   if (assetListDirty) {
     refreshAssetLists();
     assetListDirty = false;
@@ -1197,8 +1207,7 @@ void instantiatePrefab(fs::path const& prefabPath, ObsidianEngine& engine) {
   std::string prefabJsonStr;
   prefabJsonStr.resize(prefabAssetInfo.unpackedSize);
 
-  if (!asset::unpackAsset(prefabAssetInfo, prefabAsset.binaryBlob.data(),
-                          prefabAsset.binaryBlob.size(),
+  if (!asset::unpackAsset(prefabAssetInfo, prefabAsset,
                           prefabJsonStr.data())) {
     OBS_LOG_ERR("Failed to unpack asset.");
     return;
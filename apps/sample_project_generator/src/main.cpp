@@ -90,8 +90,7 @@ int main(int argc, char const** argv) {
 
   std::string gameObjectDataString;
   gameObjectDataString.resize(prefabAssetInfo.unpackedSize);
-  asset::unpackAsset(prefabAssetInfo, prefabAsset.binaryBlob.data(),
-                     prefabAsset.binaryBlob.size(),
+  asset::unpackAsset(prefabAssetInfo, prefabAsset,
                      gameObjectDataString.data());
 
   nlohmann::json prefabJson;
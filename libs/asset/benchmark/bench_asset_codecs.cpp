@@ -0,0 +1,248 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
+#include <obsidian/globals/file_extensions.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Points to a directory with converted textures and meshes, for example a
+// project made by ObsidianSampleProjectGenerator. Synthetic data is used if
+// it isn't set.
+constexpr char const* assetDirEnvVar = "OBSIDIAN_BENCH_ASSET_DIR";
+
+bool readUnpackedBlob(fs::path const& path, std::vector<char>& outBlob) {
+  Asset asset;
+
+  if (!loadAssetFromFile(path, asset)) {
+    return false;
+  }
+
+  AssetInfo info;
+
+  if (path.extension() == globals::textureAssetExt) {
+    TextureAssetInfo textureInfo;
+
+    if (!readTextureAssetInfo(*asset.metadata, textureInfo)) {
+      return false;
+    }
+
+    info = textureInfo;
+  } else {
+    MeshAssetInfo meshInfo;
+
+    if (!readMeshAssetInfo(*asset.metadata, meshInfo)) {
+      return false;
+    }
+
+    info = meshInfo;
+  }
+
+  outBlob.resize(info.unpackedSize);
+  return unpackAsset(info, asset, outBlob.data());
+}
+
+std::vector<std::vector<char>> loadSampleBlobs(fs::path const& dir) {
+  std::vector<std::vector<char>> blobs;
+
+  for (auto const& entry : fs::recursive_directory_iterator(dir)) {
+    fs::path const& path = entry.path();
+
+    if (!entry.is_regular_file() ||
+        (path.extension() != globals::textureAssetExt &&
+         path.extension() != globals::meshAssetExt)) {
+      continue;
+    }
+
+    if (!readUnpackedBlob(path, blobs.emplace_back())) {
+      blobs.pop_back();
+    }
+  }
+
+  return blobs;
+}
+
+// A 1024x1024 RGBA texture with smooth gradients and some noise, and a grid
+// mesh with positions, normals and uvs followed by its indices.
+std::vector<std::vector<char>> createSyntheticBlobs() {
+  constexpr std::size_t textureSize = 1024;
+  constexpr std::uint32_t gridSize = 256;
+
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<int> noise{-4, 4};
+
+  std::vector<char> texture(textureSize * textureSize * 4);
+
+  for (std::size_t y = 0; y < textureSize; ++y) {
+    for (std::size_t x = 0; x < textureSize; ++x) {
+      char* const pixel = texture.data() + (y * textureSize + x) * 4;
+      pixel[0] = static_cast<char>(std::clamp<int>(x / 4 + noise(rng), 0, 255));
+      pixel[1] = static_cast<char>(std::clamp<int>(y / 4 + noise(rng), 0, 255));
+      pixel[2] = static_cast<char>(((x / 64) ^ (y / 64)) & 1 ? 200 : 40);
+      pixel[3] = static_cast<char>(255);
+    }
+  }
+
+  std::vector<float> vertices;
+  vertices.reserve(gridSize * gridSize * 8);
+
+  for (std::size_t z = 0; z < gridSize; ++z) {
+    for (std::size_t x = 0; x < gridSize; ++x) {
+      float const u = static_cast<float>(x) / (gridSize - 1);
+      float const v = static_cast<float>(z) / (gridSize - 1);
+      float const height = 0.1f * std::sin(u * 20.0f) * std::cos(v * 20.0f);
+      vertices.insert(vertices.end(),
+                      {u, height, v, 0.0f, 1.0f, 0.0f, u, v});
+    }
+  }
+
+  std::vector<std::uint32_t> indices;
+  indices.reserve((gridSize - 1) * (gridSize - 1) * 6);
+
+  for (std::uint32_t z = 0; z + 1 < gridSize; ++z) {
+    for (std::uint32_t x = 0; x + 1 < gridSize; ++x) {
+      std::uint32_t const i = z * gridSize + x;
+      indices.insert(indices.end(), {i, i + gridSize, i + 1, i + 1,
+                                     i + gridSize, i + gridSize + 1});
+    }
+  }
+
+  std::vector<char> mesh(vertices.size() * sizeof(float) +
+                         indices.size() * sizeof(std::uint32_t));
+  std::memcpy(mesh.data(), vertices.data(), vertices.size() * sizeof(float));
+  std::memcpy(mesh.data() + vertices.size() * sizeof(float), indices.data(),
+              indices.size() * sizeof(std::uint32_t));
+
+  return {std::move(texture), std::move(mesh)};
+}
+
+std::vector<std::vector<char>> const& getSampleBlobs() {
+  static std::vector<std::vector<char>> const blobs = []() {
+    char const* const dir = std::getenv(assetDirEnvVar);
+    return dir ? loadSampleBlobs(dir) : createSyntheticBlobs();
+  }();
+
+  return blobs;
+}
+
+} /*namespace*/
+
+// Packs the sample blobs with the mode and level of range(0) and range(1) and
+// measures unpacking them, so bytes_per_second is the decode speed in terms
+// of unpacked bytes. With range(2) set, chunked blobs are unpacked by all
+// cores. The ratio and the single pass compression speed are counters.
+static void BM_asset_codec_decode(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+
+  CompressionMode const mode = static_cast<CompressionMode>(state.range(0));
+  bool const parallel = state.range(2);
+
+  PackOptions options;
+  options.compressionLevel = static_cast<int>(state.range(1));
+
+  std::vector<std::vector<char>> const& blobs = getSampleBlobs();
+
+  if (blobs.empty()) {
+    state.SkipWithError("No sample assets found.");
+    return;
+  }
+
+  std::vector<Asset> packedAssets(blobs.size());
+  std::vector<AssetInfo> infos(blobs.size());
+  std::size_t unpackedSize = 0;
+  std::size_t packedSize = 0;
+
+  Clock::time_point const compressStart = Clock::now();
+
+  for (std::size_t i = 0; i < blobs.size(); ++i) {
+    if (!compress(mode, blobs[i], packedAssets[i].binaryBlob, options)) {
+      state.SkipWithError("Compression failed.");
+      return;
+    }
+
+    infos[i] = {blobs[i].size(), mode};
+    unpackedSize += blobs[i].size();
+    packedSize += packedAssets[i].binaryBlob.size();
+  }
+
+  double const compressSeconds =
+      std::chrono::duration<double>(Clock::now() - compressStart).count();
+
+  task::TaskExecutor executor;
+
+  if (parallel) {
+    executor.initAndRun(
+        {{task::TaskType::general,
+          std::max(std::thread::hardware_concurrency(), 2u) - 1}});
+  }
+
+  std::vector<char> dst(
+      std::max_element(blobs.cbegin(), blobs.cend(),
+                       [](auto const& a, auto const& b) {
+                         return a.size() < b.size();
+                       })
+          ->size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < packedAssets.size(); ++i) {
+      bool const success =
+          parallel ? unpackAsset(infos[i], packedAssets[i], dst.data(),
+                                 executor, task::TaskType::general)
+                   : unpackAsset(infos[i], packedAssets[i], dst.data());
+
+      if (!success) {
+        state.SkipWithError("Decompression failed.");
+        break;
+      }
+
+      benchmark::ClobberMemory();
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * unpackedSize);
+  state.counters["ratio"] = static_cast<double>(unpackedSize) / packedSize;
+  state.counters["compressMBps"] =
+      static_cast<double>(unpackedSize) / compressSeconds / 1e6;
+
+  if (parallel) {
+    executor.shutdown();
+  }
+}
+
+BENCHMARK(BM_asset_codec_decode)
+    ->ArgNames({"mode", "level", "parallel"})
+    ->Args({static_cast<std::int64_t>(CompressionMode::none), 0, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4), 0, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4Chunked), 0, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4Chunked), 0, 1})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4HC), 9, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4HC), 12, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::LZ4HC), 12, 1})
+    ->Args({static_cast<std::int64_t>(CompressionMode::zstd), 3, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::zstd), 19, 0})
+    ->Args({static_cast<std::int64_t>(CompressionMode::zstd), 19, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,576 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/core/texture_format.hpp>
+#include <obsidian/globals/file_extensions.hpp>
+
+#include <benchmark/benchmark.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// range(0) of the benchmarks below. Sample assets are read from the directory
+// in OBSIDIAN_BENCH_ASSET_DIR and keep the compression they were converted
+// with.
+enum BenchAssetType { textureAsset = 0, meshAsset = 1, sampleAsset = 2 };
+
+constexpr char const* assetDirEnvVar = "OBSIDIAN_BENCH_ASSET_DIR";
+
+// Every benchmark run works on this many assets of the same kind, so that the
+// per-asset latency is an average.
+constexpr std::size_t assetsPerSet = 4;
+
+struct AssetSet {
+  std::vector<fs::path> paths;
+  std::size_t fileBytes = 0;
+  std::size_t metadataBytes = 0;
+  std::size_t unpackedBytes = 0;
+};
+
+fs::path getBenchDir() {
+  return fs::temp_directory_path() / "obsidian_bench_asset_io";
+}
+
+// Writes the dirty pages of the file back and drops it from the page cache,
+// so that the next read comes from the disk. Pages of live mappings of the
+// file stay cached. Returns false where the cache can't be dropped.
+bool dropFileCache(fs::path const& path) {
+#ifdef __linux__
+  int const fd = open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  bool const dropped =
+      !fdatasync(fd) && !posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+
+  return dropped;
+#else
+  (void)path;
+  return false;
+#endif
+}
+
+bool dropFileCaches(AssetSet const& assetSet) {
+  bool dropped = true;
+
+  for (fs::path const& path : assetSet.paths) {
+    dropped &= dropFileCache(path);
+  }
+
+  return dropped;
+}
+
+bool readBlobInfo(AssetMetadata const& metadata, AssetInfo& outInfo) {
+  switch (getAssetType(metadata.type)) {
+  case AssetType::texture: {
+    TextureAssetInfo textureInfo;
+
+    if (!readTextureAssetInfo(metadata, textureInfo)) {
+      return false;
+    }
+
+    outInfo = textureInfo;
+    return true;
+  }
+  case AssetType::mesh: {
+    MeshAssetInfo meshInfo;
+
+    if (!readMeshAssetInfo(metadata, meshInfo)) {
+      return false;
+    }
+
+    outInfo = meshInfo;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+// A cooked RGBA texture with a full mip chain of gradients, a checker pattern
+// and some noise, which compresses about as well as photos do.
+bool createTexture(std::size_t size, CompressionMode mode, std::mt19937& rng,
+                   Asset& outAsset) {
+  std::uniform_int_distribution<int> noise{-4, 4};
+
+  TextureAssetInfo info;
+  info.compressionMode = mode;
+  info.format = core::TextureFormat::R8G8B8A8_SRGB;
+  info.width = static_cast<std::uint32_t>(size);
+  info.height = static_cast<std::uint32_t>(size);
+  info.mipLevels = static_cast<std::uint32_t>(std::bit_width(size));
+  info.unpackedSize = size * size * 4 * 2;
+  info.transparent = false;
+
+  std::vector<char> pixels(info.unpackedSize);
+  char* pixel = pixels.data();
+
+  for (std::uint32_t mip = 0; mip < info.mipLevels; ++mip) {
+    std::size_t const levelSize = size >> mip;
+
+    for (std::size_t y = 0; y < levelSize; ++y) {
+      for (std::size_t x = 0; x < levelSize; ++x) {
+        int const u = static_cast<int>((x << mip) * 256 / size);
+        int const v = static_cast<int>((y << mip) * 256 / size);
+
+        pixel[0] = static_cast<char>(std::clamp<int>(u + noise(rng), 0, 255));
+        pixel[1] = static_cast<char>(std::clamp<int>(v + noise(rng), 0, 255));
+        pixel[2] = static_cast<char>(((u / 16) ^ (v / 16)) & 1 ? 200 : 40);
+        pixel[3] = static_cast<char>(255);
+        pixel += 4;
+      }
+    }
+  }
+
+  std::vector<char> cookedPixels;
+  cookTexture(info, pixels.data(), cookedPixels);
+
+  return packTexture(info, cookedPixels.data(), outAsset);
+}
+
+// A cooked grid mesh of size x size vertices with positions, normals and uvs,
+// split into four surfaces.
+bool createMesh(std::size_t size, CompressionMode mode, Asset& outAsset) {
+  constexpr std::size_t surfaceCount = 4;
+
+  std::vector<float> vertices;
+  vertices.reserve(size * size * 8);
+
+  for (std::size_t z = 0; z < size; ++z) {
+    for (std::size_t x = 0; x < size; ++x) {
+      float const u = static_cast<float>(x) / (size - 1);
+      float const v = static_cast<float>(z) / (size - 1);
+      float const height = 0.1f * std::sin(u * 20.0f) * std::cos(v * 20.0f);
+      vertices.insert(vertices.end(), {u, height, v, 0.0f, 1.0f, 0.0f, u, v});
+    }
+  }
+
+  std::vector<std::vector<std::uint32_t>> surfaces(surfaceCount);
+
+  for (std::uint32_t z = 0; z + 1 < size; ++z) {
+    std::vector<std::uint32_t>& indices =
+        surfaces[z * surfaceCount / (size - 1)];
+
+    for (std::uint32_t x = 0; x + 1 < size; ++x) {
+      std::uint32_t const i = z * size + x;
+      std::uint32_t const below = i + static_cast<std::uint32_t>(size);
+      indices.insert(indices.end(), {i, below, i + 1, i + 1, below, below + 1});
+    }
+  }
+
+  MeshAssetInfo info;
+  info.compressionMode = mode;
+  info.vertexCount = size * size;
+  info.vertexBufferSize = vertices.size() * sizeof(float);
+  info.indexCount = 0;
+  info.aabb.topCorner = {1.0f, 0.1f, 1.0f};
+  info.aabb.bottomCorner = {0.0f, -0.1f, 0.0f};
+  info.hasNormals = true;
+  info.hasColors = false;
+  info.hasUV = true;
+  info.hasTangents = false;
+
+  for (std::vector<std::uint32_t> const& indices : surfaces) {
+    info.indexBufferSizes.push_back(indices.size() * sizeof(std::uint32_t));
+    info.indexCount += indices.size();
+  }
+
+  cookMeshLayout(info);
+
+  std::vector<char> meshData(info.unpackedSize);
+  std::memcpy(meshData.data(), vertices.data(), info.vertexBufferSize);
+
+  for (std::size_t i = 0; i < surfaceCount; ++i) {
+    std::memcpy(meshData.data() + info.indexBufferOffsets[i],
+                surfaces[i].data(), info.indexBufferSizes[i]);
+  }
+
+  return packMeshAsset(info, std::move(meshData), outAsset);
+}
+
+// The assets the benchmark asks for, packed in memory.
+bool createAssets(benchmark::State const& state,
+                  std::vector<Asset>& outAssets) {
+  BenchAssetType const type = static_cast<BenchAssetType>(state.range(0));
+  std::size_t const size = static_cast<std::size_t>(state.range(1));
+  CompressionMode const mode = static_cast<CompressionMode>(state.range(2));
+
+  if (type == sampleAsset) {
+    char const* const dir = std::getenv(assetDirEnvVar);
+
+    if (!dir) {
+      return false;
+    }
+
+    for (auto const& entry : fs::recursive_directory_iterator(dir)) {
+      fs::path const& path = entry.path();
+
+      if (!entry.is_regular_file() ||
+          (path.extension() != globals::textureAssetExt &&
+           path.extension() != globals::meshAssetExt)) {
+        continue;
+      }
+
+      if (!loadAssetFromFile(path, outAssets.emplace_back())) {
+        outAssets.pop_back();
+      }
+    }
+
+    return !outAssets.empty();
+  }
+
+  std::mt19937 rng{42};
+
+  for (std::size_t i = 0; i < assetsPerSet; ++i) {
+    Asset& asset = outAssets.emplace_back();
+
+    bool const created = type == textureAsset
+                             ? createTexture(size, mode, rng, asset)
+                             : createMesh(size, mode, asset);
+
+    if (!created) {
+      return false;
+    }
+
+    asset.metadata->binaryBlobSize = getBinaryBlob(asset).size();
+  }
+
+  return true;
+}
+
+bool saveAssets(std::span<Asset const> assets, fs::path const& dir,
+                AssetSet& outAssetSet) {
+  fs::create_directories(dir);
+
+  for (std::size_t i = 0; i < assets.size(); ++i) {
+    char const* const extension =
+        getAssetType(assets[i].metadata->type) == AssetType::texture
+            ? globals::textureAssetExt
+            : globals::meshAssetExt;
+    fs::path const path = dir / ("asset" + std::to_string(i) + extension);
+
+    if (!saveToFile(path, assets[i])) {
+      return false;
+    }
+
+    AssetInfo info;
+
+    if (!readBlobInfo(*assets[i].metadata, info)) {
+      return false;
+    }
+
+    std::size_t const fileSize = fs::file_size(path);
+
+    outAssetSet.paths.push_back(path);
+    outAssetSet.fileBytes += fileSize;
+    outAssetSet.metadataBytes +=
+        fileSize - assets[i].metadata->binaryBlobSize;
+    outAssetSet.unpackedBytes += info.unpackedSize;
+  }
+
+  return true;
+}
+
+// The asset files the benchmark reads, written once per process and shared
+// by all benchmarks with the same type, size and compression mode.
+AssetSet const* getAssetSet(benchmark::State const& state) {
+  using Key = std::tuple<std::int64_t, std::int64_t, std::int64_t>;
+
+  static std::map<Key, AssetSet> assetSets;
+
+  Key const key{state.range(0), state.range(1), state.range(2)};
+  auto const it = assetSets.find(key);
+
+  if (it != assetSets.cend()) {
+    return &it->second;
+  }
+
+  std::vector<Asset> assets;
+  AssetSet assetSet;
+
+  fs::path const dir =
+      getBenchDir() / (std::to_string(state.range(0)) + "_" +
+                       std::to_string(state.range(1)) + "_" +
+                       std::to_string(state.range(2)));
+
+  if (!createAssets(state, assets) || !saveAssets(assets, dir, assetSet)) {
+    return nullptr;
+  }
+
+  return &assetSets.emplace(key, std::move(assetSet)).first->second;
+}
+
+// bytes_per_second and items_per_second are there for compare.py, MBps and
+// usPerAsset are the same numbers in units that are easier to read.
+void setCounters(benchmark::State& state, std::size_t assetCount,
+                 std::size_t bytes, bool coldCache) {
+  double const iterations = static_cast<double>(state.iterations());
+
+  state.SetItemsProcessed(state.iterations() * assetCount);
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.counters["MBps"] =
+      benchmark::Counter(iterations * bytes / 1e6, benchmark::Counter::kIsRate);
+  state.counters["usPerAsset"] = benchmark::Counter(
+      iterations * assetCount / 1e6,
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  state.counters["coldCache"] = coldCache;
+}
+
+// Drops the asset files from the page cache before every iteration if
+// range(3) asks for a cold cache. Returns whether the cache was cold.
+bool prepareIteration(benchmark::State& state, AssetSet const& assetSet) {
+  if (!state.range(3)) {
+    return false;
+  }
+
+  state.PauseTiming();
+  bool const dropped = dropFileCaches(assetSet);
+  state.ResumeTiming();
+
+  return dropped;
+}
+
+void applyIOArgs(benchmark::internal::Benchmark* benchmark,
+                 bool coldCacheArgs) {
+  benchmark->ArgNames({"type", "size", "mode", "cold"});
+
+  std::vector<std::int64_t> const coldCacheValues =
+      coldCacheArgs ? std::vector<std::int64_t>{0, 1}
+                    : std::vector<std::int64_t>{0};
+
+  std::pair<BenchAssetType, std::vector<std::int64_t>> const sizes[] = {
+      {textureAsset, {256, 2048}}, {meshAsset, {64, 512}}};
+
+  for (auto const& [type, typeSizes] : sizes) {
+    for (std::int64_t const size : typeSizes) {
+      for (CompressionMode const mode :
+           {CompressionMode::none, CompressionMode::LZ4,
+            CompressionMode::LZ4Chunked, CompressionMode::LZ4HC,
+            CompressionMode::zstd}) {
+        for (std::int64_t const cold : coldCacheValues) {
+          benchmark->Args(
+              {type, size, static_cast<std::int64_t>(mode), cold});
+        }
+      }
+    }
+  }
+
+  for (std::int64_t const cold : coldCacheValues) {
+    benchmark->Args({sampleAsset, 0, -1, cold});
+  }
+
+  benchmark->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+void applyColdCacheArgs(benchmark::internal::Benchmark* benchmark) {
+  applyIOArgs(benchmark, true);
+}
+
+void applyWarmCacheArgs(benchmark::internal::Benchmark* benchmark) {
+  applyIOArgs(benchmark, false);
+}
+
+void skipWithoutAssets(benchmark::State& state) {
+  state.SkipWithError(state.range(0) == sampleAsset
+                          ? "No sample assets found."
+                          : "Failed to create the assets.");
+}
+
+} /*namespace*/
+
+// Saves the assets packed in memory. The files stay in the page cache, so
+// this measures serializing the asset and the write syscalls.
+static void BM_asset_io_save(benchmark::State& state) {
+  std::vector<Asset> assets;
+
+  if (!createAssets(state, assets)) {
+    skipWithoutAssets(state);
+    return;
+  }
+
+  fs::path const dir = getBenchDir() / "save";
+  fs::create_directories(dir);
+
+  std::vector<fs::path> paths;
+  std::size_t fileBytes = 0;
+
+  for (std::size_t i = 0; i < assets.size(); ++i) {
+    paths.push_back(dir / ("asset" + std::to_string(i)));
+  }
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+      if (!saveToFile(paths[i], assets[i])) {
+        state.SkipWithError("Saving failed.");
+        return;
+      }
+    }
+  }
+
+  for (fs::path const& path : paths) {
+    fileBytes += fs::file_size(path);
+  }
+
+  setCounters(state, assets.size(), fileBytes, false);
+}
+
+BENCHMARK(BM_asset_io_save)->Apply(applyWarmCacheArgs);
+
+// Reads the metadata of every asset file. bytes_per_second counts the
+// metadata, which is all that is read of the file.
+static void BM_asset_io_load_metadata(benchmark::State& state) {
+  AssetSet const* const assetSet = getAssetSet(state);
+
+  if (!assetSet) {
+    skipWithoutAssets(state);
+    return;
+  }
+
+  bool coldCache = true;
+
+  for (auto _ : state) {
+    coldCache &= prepareIteration(state, *assetSet);
+
+    for (fs::path const& path : assetSet->paths) {
+      AssetMetadata metadata;
+
+      if (!loadAssetMetadataFromFile(path, metadata)) {
+        state.SkipWithError("Loading the metadata failed.");
+        return;
+      }
+
+      benchmark::DoNotOptimize(metadata);
+    }
+  }
+
+  setCounters(state, assetSet->paths.size(), assetSet->metadataBytes,
+              coldCache);
+}
+
+BENCHMARK(BM_asset_io_load_metadata)->Apply(applyColdCacheArgs);
+
+// Loads every asset file. The blob is only mapped by loading it, so one byte
+// of every page is read to pull the whole file in.
+static void BM_asset_io_load(benchmark::State& state) {
+  AssetSet const* const assetSet = getAssetSet(state);
+
+  if (!assetSet) {
+    skipWithoutAssets(state);
+    return;
+  }
+
+  bool coldCache = true;
+
+  for (auto _ : state) {
+    coldCache &= prepareIteration(state, *assetSet);
+
+    for (fs::path const& path : assetSet->paths) {
+      Asset asset;
+
+      if (!loadAssetFromFile(path, asset)) {
+        state.SkipWithError("Loading the asset failed.");
+        return;
+      }
+
+      std::span<char const> const blob = getBinaryBlob(asset);
+      char sum = 0;
+
+      for (std::size_t i = 0; i < blob.size(); i += 4096) {
+        sum += blob[i];
+      }
+
+      benchmark::DoNotOptimize(sum);
+    }
+  }
+
+  setCounters(state, assetSet->paths.size(), assetSet->fileBytes, coldCache);
+}
+
+BENCHMARK(BM_asset_io_load)->Apply(applyColdCacheArgs);
+
+// Unpacks every loaded asset, bytes_per_second counts the unpacked bytes. The
+// assets are loaded while the timer is paused, but with a cold cache their
+// pages are read from the disk while they are unpacked, like they would be at
+// runtime.
+static void BM_asset_io_unpack(benchmark::State& state) {
+  AssetSet const* const assetSet = getAssetSet(state);
+
+  if (!assetSet) {
+    skipWithoutAssets(state);
+    return;
+  }
+
+  std::vector<Asset> assets(assetSet->paths.size());
+  std::vector<AssetInfo> infos(assetSet->paths.size());
+  std::vector<char> dst;
+  bool coldCache = true;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+
+    // The mappings have to be gone for the cache to be dropped.
+    assets.assign(assetSet->paths.size(), Asset{});
+
+    if (state.range(3)) {
+      coldCache &= dropFileCaches(*assetSet);
+    } else {
+      coldCache = false;
+    }
+
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+      if (!loadAssetFromFile(assetSet->paths[i], assets[i]) ||
+          !readBlobInfo(*assets[i].metadata, infos[i])) {
+        state.SkipWithError("Loading the asset failed.");
+        return;
+      }
+
+      dst.resize(std::max(dst.size(), infos[i].unpackedSize));
+    }
+
+    state.ResumeTiming();
+
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+      if (!unpackAsset(infos[i], assets[i], dst.data())) {
+        state.SkipWithError("Unpacking failed.");
+        return;
+      }
+
+      benchmark::ClobberMemory();
+    }
+  }
+
+  setCounters(state, assetSet->paths.size(), assetSet->unpackedBytes,
+              coldCache);
+}
+
+BENCHMARK(BM_asset_io_unpack)->Apply(applyColdCacheArgs);
@@ -0,0 +1,304 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/material_asset_info.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/core/material.hpp>
+#include <obsidian/core/texture_format.hpp>
+
+#include <benchmark/benchmark.h>
+#include <glm/vec4.hpp>
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+
+namespace {
+
+// range(1) of the benchmarks below, the format the infos are stored in.
+enum InfoFormat { binaryInfo = 0, jsonInfo = 1 };
+
+std::string getPath(std::size_t i, char const* extension) {
+  return "assets/folder" + std::to_string(i % 16) + "/asset" +
+         std::to_string(i) + extension;
+}
+
+TextureAssetInfo createTextureAssetInfo(std::size_t i) {
+  // small enough for packing the pixels to stay cheap, the mip levels have to
+  // fit into the unpacked size
+  TextureAssetInfo info;
+  info.compressionMode = CompressionMode::LZ4;
+  info.format = core::TextureFormat::R8G8B8A8_SRGB;
+  info.width = 32 << (i % 2);
+  info.height = 32;
+  info.mipLevels = 6;
+  info.unpackedSize = info.width * info.height * 4 * 2;
+  info.transparent = i % 2;
+
+  return info;
+}
+
+MeshAssetInfo createMeshAssetInfo(std::size_t i) {
+  MeshAssetInfo info;
+  info.compressionMode = CompressionMode::LZ4;
+  info.vertexCount = 1000 + i;
+  info.vertexBufferSize = info.vertexCount * 48;
+  info.indexCount = 3000;
+  info.indexBufferSizes = {1000, 1000, 1000};
+  info.unpackedSize = info.vertexBufferSize + 3000;
+  info.hasNormals = true;
+  info.hasColors = false;
+  info.hasUV = true;
+  info.hasTangents = true;
+  info.defaultMatRelativePaths = {getPath(i, ".obsmat"),
+                                  getPath(i + 1, ".obsmat"),
+                                  getPath(i + 2, ".obsmat")};
+  info.aabb.topCorner = {1.0f, 2.0f, 3.0f};
+  info.aabb.bottomCorner = {-1.0f, -2.0f, -3.0f};
+
+  return info;
+}
+
+MaterialAssetInfo createMaterialAssetInfo(std::size_t i) {
+  MaterialAssetInfo info;
+  info.unpackedSize = 0;
+  info.compressionMode = CompressionMode::none;
+  info.materialType = core::MaterialType::lit;
+  info.vertexShaderPath = "shaders/lit.obsshad";
+  info.fragmentShaderPath = "shaders/lit-frag.obsshad";
+  info.transparent = false;
+  info.hasTimer = false;
+
+  LitMaterialAssetData& litData =
+      info.materialSubtypeData.emplace<LitMaterialAssetData>();
+  litData.diffuseTexturePath = getPath(i, ".obstex");
+  litData.normalMapTexturePath = getPath(i + 1, ".obstex");
+  litData.shininess = 32.0f;
+  litData.reflection = false;
+
+  return info;
+}
+
+nlohmann::json vec4ToJson(glm::vec4 const& v) {
+  return nlohmann::json::array({v.x, v.y, v.z, v.w});
+}
+
+// The infos as version 0 wrote them, for comparing with the JSON parse cost.
+std::string createTextureInfoJson(TextureAssetInfo const& info) {
+  nlohmann::json json;
+  json["unpackedSize"] = info.unpackedSize;
+  json["compressionMode"] = info.compressionMode;
+  json["format"] = info.format;
+  json["width"] = info.width;
+  json["height"] = info.height;
+  json["mipLevels"] = info.mipLevels;
+  json["transparent"] = info.transparent;
+
+  return json.dump();
+}
+
+std::string createMeshInfoJson(MeshAssetInfo const& info) {
+  nlohmann::json json;
+  json["unpackedSize"] = info.unpackedSize;
+  json["compressionMode"] = info.compressionMode;
+  json["vertexCount"] = info.vertexCount;
+  json["vertexBufferSize"] = info.vertexBufferSize;
+  json["indexCount"] = info.indexCount;
+  json["indexBufferSizes"] = info.indexBufferSizes;
+  json["hasNormals"] = info.hasNormals;
+  json["hasColors"] = info.hasColors;
+  json["hasUV"] = info.hasUV;
+  json["hasTangents"] = info.hasTangents;
+  json["defaultMatPaths"] = info.defaultMatRelativePaths;
+
+  nlohmann::json& aabbJson = json["aabb"];
+  aabbJson["topRight"]["x"] = info.aabb.topCorner.x;
+  aabbJson["topRight"]["y"] = info.aabb.topCorner.y;
+  aabbJson["topRight"]["z"] = info.aabb.topCorner.z;
+  aabbJson["bottomLeft"]["x"] = info.aabb.bottomCorner.x;
+  aabbJson["bottomLeft"]["y"] = info.aabb.bottomCorner.y;
+  aabbJson["bottomLeft"]["z"] = info.aabb.bottomCorner.z;
+
+  return json.dump();
+}
+
+std::string createMaterialInfoJson(MaterialAssetInfo const& info) {
+  LitMaterialAssetData const& litData =
+      std::get<LitMaterialAssetData>(info.materialSubtypeData);
+
+  nlohmann::json json;
+  json["unpackedSize"] = info.unpackedSize;
+  json["compressionMode"] = info.compressionMode;
+  json["materialType"] = info.materialType;
+  json["vertexShader"] = info.vertexShaderPath;
+  json["fragmentShader"] = info.fragmentShaderPath;
+  json["transparent"] = info.transparent;
+  json["hasTimer"] = info.hasTimer;
+
+  nlohmann::json& litJson = json["litData"];
+  litJson["diffuseTex"] = litData.diffuseTexturePath;
+  litJson["normalMapTex"] = litData.normalMapTexturePath;
+  litJson["shininess"] = litData.shininess;
+  litJson["ambientColor"] = vec4ToJson(litData.ambientColor);
+  litJson["diffuseColor"] = vec4ToJson(litData.diffuseColor);
+  litJson["specularColor"] = vec4ToJson(litData.specularColor);
+  litJson["reflection"] = litData.reflection;
+
+  return json.dump();
+}
+
+// Packs count assets with pack and replaces their info with the version 0
+// JSON if the benchmark asks for it.
+template <typename CreateInfo, typename Pack, typename CreateJson>
+std::vector<AssetMetadata> createMetadata(benchmark::State const& state,
+                                          CreateInfo createInfo, Pack pack,
+                                          CreateJson createJson) {
+  std::size_t const count = static_cast<std::size_t>(state.range(0));
+  std::vector<AssetMetadata> result;
+  result.reserve(count);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    auto const info = createInfo(i);
+    Asset asset;
+    pack(info, asset);
+
+    if (state.range(1) == jsonInfo) {
+      asset.metadata->version = lastJsonAssetVersion;
+      asset.metadata->info = createJson(info);
+    }
+
+    result.push_back(std::move(*asset.metadata));
+  }
+
+  return result;
+}
+
+template <typename Info, typename Read>
+void runReadInfos(benchmark::State& state,
+                  std::vector<AssetMetadata> const& metadata, Read read) {
+  std::size_t infoBytes = 0;
+
+  for (AssetMetadata const& m : metadata) {
+    infoBytes += m.info.size();
+  }
+
+  for (auto _ : state) {
+    for (AssetMetadata const& m : metadata) {
+      Info info;
+      bool const success = read(m, info);
+      benchmark::DoNotOptimize(success);
+      benchmark::DoNotOptimize(info);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * metadata.size());
+  state.SetBytesProcessed(state.iterations() * infoBytes);
+}
+
+void applyMetadataArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"assets", "json"});
+
+  for (std::int64_t const count : {1024, 8192}) {
+    benchmark->Args({count, binaryInfo});
+    benchmark->Args({count, jsonInfo});
+  }
+}
+
+} /*namespace*/
+
+static void BM_asset_read_texture_infos(benchmark::State& state) {
+  std::vector<AssetMetadata> const metadata = createMetadata(
+      state, &createTextureAssetInfo,
+      [](TextureAssetInfo const& info, Asset& outAsset) {
+        std::vector<char> const pixels(info.unpackedSize);
+        packTexture(info, pixels.data(), outAsset);
+      },
+      &createTextureInfoJson);
+
+  runReadInfos<TextureAssetInfo>(state, metadata, &readTextureAssetInfo);
+}
+
+BENCHMARK(BM_asset_read_texture_infos)->Apply(applyMetadataArgs);
+
+static void BM_asset_read_mesh_infos(benchmark::State& state) {
+  std::vector<AssetMetadata> const metadata = createMetadata(
+      state, &createMeshAssetInfo,
+      [](MeshAssetInfo const& info, Asset& outAsset) {
+        packMeshAsset(info, std::vector<char>(info.unpackedSize), outAsset);
+      },
+      &createMeshInfoJson);
+
+  runReadInfos<MeshAssetInfo>(state, metadata, &readMeshAssetInfo);
+}
+
+BENCHMARK(BM_asset_read_mesh_infos)->Apply(applyMetadataArgs);
+
+static void BM_asset_read_material_infos(benchmark::State& state) {
+  std::vector<AssetMetadata> const metadata = createMetadata(
+      state, &createMaterialAssetInfo,
+      [](MaterialAssetInfo const& info, Asset& outAsset) {
+        packMaterial(info, {}, outAsset);
+      },
+      &createMaterialInfoJson);
+
+  runReadInfos<MaterialAssetInfo>(state, metadata, &readMaterialAssetInfo);
+}
+
+BENCHMARK(BM_asset_read_material_infos)->Apply(applyMetadataArgs);
+
+// Loads the metadata of texture files and reads their info, the way a scan of
+// a project does. The files stay in the page cache, so this is the parse cost
+// plus the system calls rather than the cost of the disk.
+static void BM_asset_load_texture_metadata_files(benchmark::State& state) {
+  std::filesystem::path const dir =
+      std::filesystem::temp_directory_path() / "obsidian_bench_asset_metadata";
+  std::filesystem::create_directories(dir);
+
+  std::vector<AssetMetadata> const metadata = createMetadata(
+      state, &createTextureAssetInfo,
+      [](TextureAssetInfo info, Asset& outAsset) {
+        // only the metadata is read, keep the files small
+        info.compressionMode = CompressionMode::none;
+        info.unpackedSize = 16;
+        std::vector<char> const pixels(info.unpackedSize);
+        packTexture(info, pixels.data(), outAsset);
+      },
+      &createTextureInfoJson);
+
+  std::vector<std::filesystem::path> paths;
+  paths.reserve(metadata.size());
+
+  for (std::size_t i = 0; i < metadata.size(); ++i) {
+    Asset asset;
+    asset.metadata = metadata[i];
+    asset.binaryBlob.resize(16);
+
+    paths.push_back(dir / ("texture" + std::to_string(i) + ".obstex"));
+    saveToFile(paths.back(), asset);
+  }
+
+  for (auto _ : state) {
+    for (std::filesystem::path const& path : paths) {
+      AssetMetadata loadedMetadata;
+      TextureAssetInfo info;
+      bool const success = loadAssetMetadataFromFile(path, loadedMetadata) &&
+                           readTextureAssetInfo(loadedMetadata, info);
+      benchmark::DoNotOptimize(success);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * paths.size());
+
+  std::filesystem::remove_all(dir);
+}
+
+BENCHMARK(BM_asset_load_texture_metadata_files)->Apply(applyMetadataArgs);
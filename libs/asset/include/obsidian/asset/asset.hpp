@@ -1,14 +1,25 @@
 #pragma once
 
+#include <obsidian/platform/mapped_file.hpp>
+
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 namespace obsidian::asset {
 
-static constexpr std::size_t currentAssetVersion = 0;
+// Version 0 stores the asset info as JSON, later versions as a fixed layout
+// binary header per asset type. From version 2 on, the info is preceded by the
+// table of the asset's dependencies. From version 3 on, texture and mesh infos
+// store where every mip level and index buffer starts in the unpacked blob.
+static constexpr std::size_t currentAssetVersion = 3;
+static constexpr std::size_t lastJsonAssetVersion = 0;
+static constexpr std::size_t firstDependencyTableAssetVersion = 2;
+static constexpr std::size_t firstSectionOffsetsAssetVersion = 3;
 
 enum class AssetType { unknown, mesh, texture, shader, material };
 
@@ -18,15 +29,31 @@ struct AssetMetadata {
   char type[4];
   SizeType binaryBlobSize;
   std::uint32_t version;
-  std::string json;
+  // The asset info of the type, JSON text up to lastJsonAssetVersion.
+  std::string info;
+  // Paths relative to the project root of the assets that have to be
+  // uploaded before this one. Stored from firstDependencyTableAssetVersion.
+  std::vector<std::string> dependencies;
 };
 
+bool isJsonAssetInfo(AssetMetadata const& assetMetadata);
+bool hasDependencyTable(AssetMetadata const& assetMetadata);
+bool hasSectionOffsets(AssetMetadata const& assetMetadata);
+
 struct Asset {
   std::optional<AssetMetadata> metadata;
+  // Filled when saving and by loads that couldn't map the file.
   std::vector<char> binaryBlob;
+  // Loaded assets usually point into the mapped file instead of copying the
+  // blob. The mapping lives as long as any copy of the asset.
+  std::shared_ptr<platform::MappedFile const> mappedFile;
+  std::span<char const> mappedBlob;
   bool isLoaded = false;
 };
 
 AssetType getAssetType(char const typeStr[4]);
 
+// The blob of a loaded or saved asset, wherever it is stored.
+std::span<char const> getBinaryBlob(Asset const& asset);
+
 } /*namespace obsidian::asset*/
@@ -1,14 +1,48 @@
 #pragma once
 
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/task/task_type.hpp>
+
 #include <cstddef>
 #include <cstdint>
+#include <span>
+
+namespace obsidian::task {
+
+class TaskExecutor;
+
+} /*namespace obsidian::task*/
 
 namespace obsidian::asset {
 
 constexpr char const* unpackedSizeJsonName = "unpackedSize";
 constexpr char const* compressionModeJsonName = "compressionMode";
 
-enum class CompressionMode : std::uint32_t { none = 0, LZ4 = 1 };
+// The chunked modes compress blocks of compressionChunkSize bytes on their own,
+// which lets large blobs be packed and unpacked by several threads. LZ4HC
+// decompresses as fast as LZ4 but compresses better and a lot slower. zstd
+// compresses best and decompresses slowest, it is meant for data that is
+// rarely loaded.
+enum class CompressionMode : std::uint32_t {
+  none = 0,
+  LZ4 = 1,
+  LZ4Chunked = 2,
+  LZ4HC = 3,
+  zstd = 4
+};
+
+// Mip levels and index buffers of cooked assets start at multiples of it in
+// the unpacked blob, so that the RHI copies them to the GPU straight from the
+// staging buffer. It is a multiple of the optimalBufferCopyOffsetAlignment of
+// the GPUs we run on, which the converter can't query.
+constexpr std::size_t cookedSectionAlignment = 256;
+
+struct PackOptions {
+  // Used by LZ4HC and zstd, 0 selects the codec's default level.
+  int compressionLevel = 0;
+  // With an executor, chunked blobs are compressed in parallel.
+  task::TaskExecutor* taskExecutor = nullptr;
+};
 
 struct AssetInfo {
   std::size_t unpackedSize;
@@ -18,4 +52,20 @@ struct AssetInfo {
 bool unpackAsset(AssetInfo const& assetInfo, char const* src,
                  std::size_t srcSize, char* dst);
 
+// Unpacks the blob of a loaded asset straight from where it is stored, which
+// is usually the mapped file.
+bool unpackAsset(AssetInfo const& assetInfo, Asset const& asset, char* dst);
+
+// Like the above, but the chunks of a chunked blob are unpacked by the
+// workers of the task type together with the calling thread.
+bool unpackAsset(AssetInfo const& assetInfo, Asset const& asset, char* dst,
+                 task::TaskExecutor& taskExecutor, task::TaskType taskType);
+
+// Unpacks dst.size() bytes starting at offset of the unpacked blob into dst.
+// Chunked blobs only decompress the chunks overlapping the range, so with a
+// mapped asset only the pages of those chunks are read. An LZ4 blob is
+// decompressed up to the end of the range.
+bool unpackAssetRange(AssetInfo const& assetInfo, Asset const& asset,
+                      std::size_t offset, std::span<char> dst);
+
 } /*namespace obsidian::asset*/
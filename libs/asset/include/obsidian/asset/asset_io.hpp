@@ -1,15 +1,77 @@
 #pragma once
 
 #include <obsidian/asset/asset.hpp>
+#include <obsidian/platform/async_file_reader.hpp>
+#include <obsidian/platform/mapped_file.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace obsidian::asset {
 
 bool loadAssetMetadataFromFile(std::filesystem::path const& path,
                                asset::AssetMetadata& outAssetMetadata);
 
-bool loadAssetFromFile(std::filesystem::path const& path, Asset& outAsset);
+// Reads only the dependency table of the asset file, which is a lot cheaper
+// than loading the metadata. The dependencies of assets saved before the
+// table was stored are found in their info instead.
+bool loadAssetDependenciesFromFile(std::filesystem::path const& path,
+                                   std::vector<std::string>& outDependencies);
+
+// Without readAhead a mapped blob isn't read ahead, so that unpacking a range
+// of it with unpackAssetRange only reads the pages of that range.
+bool loadAssetFromFile(std::filesystem::path const& path, Asset& outAsset,
+                       bool readAhead = true);
+
+// Awaitable version of loadAssetFromFile. The calling thread only queues the
+// read, which runs on a worker of the given target. outAsset has to stay alive
+// until the returned handle completes. If the token is cancelled by the time
+// a worker picks up the read, the file isn't read and the result is false.
+task::TaskHandle<bool>
+loadAssetFromFileAsync(task::TaskExecutor& executor, task::TaskTarget target,
+                       std::filesystem::path path, Asset& outAsset,
+                       task::CancellationToken token = {});
+
+// Reads the asset file of size bytes stored at offset in the file at path with
+// the reader, so no worker blocks on the disk meanwhile. Assets whose header
+// is invalid or whose sizes don't fit in size bytes fail without reading
+// further. Only the blob is read if the
+// asset's metadata is loaded already. The blob is read into binaryBlob
+// instead of being mapped. Once the reads completed the coroutine continues
+// on a worker of the given target, where the asset can be unpacked right
+// away. outAsset has to stay alive until the returned handle completes. If
+// the token is cancelled before the read started, the result is false.
+task::TaskHandle<bool>
+readAssetAsync(task::TaskExecutor& executor, task::TaskTarget target,
+               platform::AsyncFileReader& reader, std::filesystem::path path,
+               std::uint64_t offset, std::uint64_t size, Asset& outAsset,
+               task::CancellationToken token = {});
+
+// Reads the metadata from the start of data, which holds an asset file as it
+// is stored on disk. Returns false if the data is too short to hold it.
+bool readAssetMetadata(std::span<char const> data,
+                       AssetMetadata& outAssetMetadata);
+
+// Same as loadAssetDependenciesFromFile for the asset file at the start of
+// data.
+bool readAssetDependencies(std::span<char const> data,
+                           std::vector<std::string>& outDependencies);
+
+// Loads the asset file stored in data, a range of mappedFile. The blob isn't
+// copied, the asset keeps the mapping alive instead. The path is only used
+// in error messages. See loadAssetFromFile for readAhead.
+bool loadMappedAsset(std::filesystem::path const& path,
+                     std::shared_ptr<platform::MappedFile const> mappedFile,
+                     std::span<char const> data, Asset& outAsset,
+                     bool readAhead = true);
 
 bool saveToFile(std::filesystem::path const& path, Asset const& asset);
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/platform/mapped_file.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace obsidian::asset {
+
+// The pack a project's assets are read from, if it exists in the project
+// root.
+constexpr char const* projectAssetPackName = "assets.obspack";
+
+static constexpr std::uint32_t currentAssetPackVersion = 0;
+// The table of contents and every asset in a pack start at a multiple of it.
+static constexpr std::size_t assetPackAlignment = 64;
+
+struct AssetPackHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t assetCount;
+  std::uint64_t tocOffset;
+  // offset of the path strings of all assets
+  std::uint64_t pathsOffset;
+};
+
+struct AssetPackTocEntry {
+  std::uint64_t pathHash;
+  // offset and size of the asset file stored in the pack
+  std::uint64_t offset;
+  std::uint64_t size;
+  // relative to AssetPackHeader::pathsOffset
+  std::uint32_t pathOffset;
+  std::uint32_t pathSize;
+};
+
+// Where an asset file is stored in a pack.
+struct AssetPackRange {
+  std::uint64_t offset;
+  std::uint64_t size;
+};
+
+// 64-bit FNV-1a hash of the generic form of a path relative to the project
+// root, the key of the asset in a pack.
+std::uint64_t getAssetPathHash(std::filesystem::path const& relativePath);
+
+// Read-only view of a mapped pack file. A pack starts with a header and a
+// table of contents sorted by path hash, followed by the asset paths and the
+// assets. Every asset is stored the same way as its loose file, and the
+// dependencies of an asset come before it, so loading them together reads
+// the pack front to back. Reading from an open pack is thread-safe.
+class AssetPack {
+public:
+  // Closes the previously opened pack, if any.
+  bool open(std::filesystem::path const& path);
+  void close();
+
+  bool isOpen() const;
+  std::filesystem::path const& getPath() const;
+  std::size_t getAssetCount() const;
+  bool contains(std::filesystem::path const& relativePath) const;
+
+  // Where the asset file is stored in the pack, for reading it without the
+  // mapping.
+  std::optional<AssetPackRange>
+  findAssetRange(std::filesystem::path const& relativePath) const;
+
+  // Same as loadAssetMetadataFromFile, loadAssetDependenciesFromFile and
+  // loadAssetFromFile for the asset at the path relative to the project root.
+  // Return false if the pack doesn't contain the asset. Loaded blobs point
+  // into the pack mapping, which stays alive as long as any asset loaded from
+  // it. See loadAssetFromFile for readAhead.
+  bool loadAssetMetadata(std::filesystem::path const& relativePath,
+                         AssetMetadata& outAssetMetadata) const;
+  bool loadAssetDependencies(std::filesystem::path const& relativePath,
+                             std::vector<std::string>& outDependencies) const;
+  bool loadAsset(std::filesystem::path const& relativePath, Asset& outAsset,
+                 bool readAhead = true) const;
+
+private:
+  // The asset file stored for the path, empty if there is none.
+  std::span<char const>
+  findAsset(std::filesystem::path const& relativePath) const;
+
+  std::filesystem::path _path;
+  std::shared_ptr<platform::MappedFile> _mappedFile;
+  std::span<AssetPackTocEntry const> _toc;
+  std::span<char const> _paths;
+};
+
+// Packs the assets at the paths relative to projectRootPath into a new pack
+// at outPackPath, replacing the file there if it exists.
+bool buildAssetPack(std::filesystem::path const& projectRootPath,
+                    std::span<std::filesystem::path const> relativePaths,
+                    std::filesystem::path const& outPackPath);
+
+} /*namespace obsidian::asset*/
@@ -54,7 +54,13 @@ struct MaterialAssetInfo : public AssetInfo {
 bool readMaterialAssetInfo(AssetMetadata const& assetMetadata,
                            MaterialAssetInfo& outMaterialAssetInfo);
 
+// The textures and shaders the material uses, in the order they're stored in
+// the asset's dependency table.
+std::vector<std::string>
+getMaterialDependencies(MaterialAssetInfo const& materialAssetInfo);
+
 bool packMaterial(MaterialAssetInfo const& materialAssetInfo,
-                  std::vector<char> materialData, Asset& outAsset);
+                  std::vector<char> materialData, Asset& outAsset,
+                  PackOptions const& options = {});
 
 } /*namespace obsidian::asset*/
@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 
 #include <cstddef>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,10 @@ struct MeshAssetInfo : public AssetInfo {
   std::size_t vertexBufferSize;
   std::size_t indexCount;
   std::vector<std::size_t> indexBufferSizes;
+  // Where every index buffer starts in the unpacked blob, which starts with
+  // the vertex buffer. If empty, the index buffers follow the vertex buffer
+  // one after the other.
+  std::vector<std::size_t> indexBufferOffsets;
   std::vector<std::string> defaultMatRelativePaths;
   core::Box3D aabb;
   bool hasNormals;
@@ -30,7 +35,23 @@ struct MeshAssetInfo : public AssetInfo {
 bool readMeshAssetInfo(AssetMetadata const& assetMetadata,
                        MeshAssetInfo& outMeshAssetInfo);
 
+// meshData has to be laid out as described by the indexBufferOffsets of the
+// info.
 bool packMeshAsset(MeshAssetInfo const& meshAssetInfo,
-                   std::vector<char> meshData, Asset& outAsset);
+                   std::vector<char> meshData, Asset& outAsset,
+                   PackOptions const& options = {});
+
+// Sets the indexBufferOffsets and unpackedSize of the info to the cooked
+// layout, in which every index buffer starts at a multiple of
+// cookedSectionAlignment after the vertex buffer.
+void cookMeshLayout(MeshAssetInfo& meshAssetInfo);
+
+// Unpack only the vertex buffer or a single index buffer into dst, which has
+// to have the size of the buffer. See unpackAssetRange.
+bool unpackMeshVertexBuffer(MeshAssetInfo const& meshAssetInfo,
+                            Asset const& asset, std::span<char> dst);
+bool unpackMeshIndexBuffer(MeshAssetInfo const& meshAssetInfo,
+                           Asset const& asset, std::size_t indexBufferIndex,
+                           std::span<char> dst);
 
 } // namespace obsidian::asset
@@ -18,6 +18,7 @@ bool readShaderAssetInfo(AssetMetadata const& assetMetadata,
                          ShaderAssetInfo& outShaderAssetInfo);
 
 bool packShader(ShaderAssetInfo const& shaderAssetInfo,
-                std::vector<char> shaderData, Asset& outAsset);
+                std::vector<char> shaderData, Asset& outAsset,
+                PackOptions const& options = {});
 
 } /*namespace obsidian::asset*/
@@ -5,6 +5,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 namespace obsidian::asset {
 
@@ -17,15 +19,43 @@ struct TextureAssetInfo : public AssetInfo {
   std::uint32_t height;
   std::uint32_t mipLevels;
   bool transparent;
+  // Where every mip level starts in the unpacked blob. If empty, the levels
+  // are stored one after the other.
+  std::vector<std::size_t> mipOffsets;
 };
 
 bool readTextureAssetInfo(AssetMetadata const& assetMetadata,
                           TextureAssetInfo& outTextureAssetInfo);
 
+// pixelData has to be laid out as described by the mipOffsets of the info.
 bool packTexture(TextureAssetInfo const& textureAssetInfo,
-                 void const* pixelData, Asset& outAsset);
+                 void const* pixelData, Asset& outAsset,
+                 PackOptions const& options = {});
 
 bool updateTextureAssetInfo(TextureAssetInfo const& textureAssetInfo,
                             Asset& outAsset);
 
+// Moves the mip levels stored one after the other in pixelData to the cooked
+// layout in outPixelData, every level starting at a multiple of
+// cookedSectionAlignment. Sets the mipOffsets and unpackedSize of the info.
+void cookTexture(TextureAssetInfo& textureAssetInfo, void const* pixelData,
+                 std::vector<char>& outPixelData);
+
+// Size of the pixels of the mip level.
+std::size_t getTextureMipSize(TextureAssetInfo const& textureAssetInfo,
+                              std::uint32_t mip);
+
+// Offset and size in the unpacked blob of mipCount levels starting at
+// firstMip.
+std::size_t getTextureMipsOffset(TextureAssetInfo const& textureAssetInfo,
+                                 std::uint32_t firstMip);
+std::size_t getTextureMipsSize(TextureAssetInfo const& textureAssetInfo,
+                               std::uint32_t firstMip, std::uint32_t mipCount);
+
+// Unpacks only mipCount levels starting at firstMip into dst, which has to be
+// getTextureMipsSize bytes. See unpackAssetRange.
+bool unpackTextureMips(TextureAssetInfo const& textureAssetInfo,
+                       Asset const& asset, std::uint32_t firstMip,
+                       std::uint32_t mipCount, std::span<char> dst);
+
 } /*namespace obsidian::asset*/
@@ -1,10 +1,118 @@
 #pragma once
 
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
 #include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace obsidian::asset {
 
 bool compress(std::span<const char> src, std::vector<char>& outDst);
 
+// Compresses src with the given mode, copying it for CompressionMode::none.
+// See compressChunked for the section offsets.
+bool compress(CompressionMode mode, std::span<char const> src,
+              std::vector<char>& outDst, PackOptions const& options = {},
+              std::span<std::size_t const> sectionOffsets = {});
+
+// Uncompressed size of the independently compressed blocks of the chunked
+// compression modes.
+constexpr std::size_t compressionChunkSize = 256 * 1024;
+
+bool isChunkedCompressionMode(CompressionMode mode);
+
+// Splits src into chunks of compressionChunkSize bytes and compresses each on
+// its own with a chunked mode, so that the chunks can be decompressed in
+// parallel. The result starts with a table of the chunk ends. Chunks that
+// don't get smaller are stored uncompressed. With an executor in the options,
+// the workers of the task type and the calling thread compress the chunks
+// together. A new chunk starts at every offset in sectionOffsets, which have
+// to be sorted, so that a section can be decompressed without the chunks of
+// its neighbours.
+bool compressChunked(CompressionMode mode, std::span<char const> src,
+                     std::vector<char>& outDst,
+                     PackOptions const& options = {},
+                     task::TaskType taskType = task::TaskType::general,
+                     std::span<std::size_t const> sectionOffsets = {});
+
+// Decompresses what compressChunked produced with the same mode straight into
+// dst, which has to have the size of the uncompressed data. Fails if src is
+// malformed.
+bool decompressChunked(CompressionMode mode, std::span<char const> src,
+                       std::span<char> dst,
+                       task::TaskExecutor* taskExecutor = nullptr,
+                       task::TaskType taskType = task::TaskType::general);
+
+// Decompresses dst.size() bytes starting at offset of the uncompressed data
+// into dst, decompressing only the chunks that overlap the range.
+bool decompressChunkedRange(CompressionMode mode, std::span<char const> src,
+                            std::size_t unpackedSize, std::size_t offset,
+                            std::span<char> dst,
+                            task::TaskExecutor* taskExecutor = nullptr,
+                            task::TaskType taskType = task::TaskType::general);
+
+// Moves the file at tempPath over the one at path, removing it if that fails.
+// Mappings of the replaced file stay valid on Linux. Windows refuses to
+// replace a file while it is mapped, for example by an asset loaded from it
+// or an open pack, so saving over such a file fails there until they are
+// released.
+bool replaceFile(std::filesystem::path const& tempPath,
+                 std::filesystem::path const& path);
+
+// Appends to the binary info of an asset. Values are stored with their
+// in-memory layout, so header structs shouldn't have padding.
+class BinaryInfoWriter {
+public:
+  explicit BinaryInfoWriter(std::string& outInfo) : _info{outInfo} {}
+
+  template <typename T> void write(T const& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    _info.append(reinterpret_cast<char const*>(&value), sizeof(value));
+  }
+
+  // Length prefixed, without a terminator.
+  void writeString(std::string_view str);
+
+private:
+  std::string& _info;
+};
+
+// Reads what BinaryInfoWriter wrote. Every read is bounds-checked and fails
+// without changing the output if the info is too short.
+class BinaryInfoReader {
+public:
+  explicit BinaryInfoReader(std::string_view info) : _info{info} {}
+
+  template <typename T> bool read(T& outValue) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if (sizeof(T) > _info.size() - _offset) {
+      return false;
+    }
+
+    std::memcpy(&outValue, _info.data() + _offset, sizeof(T));
+    _offset += sizeof(T);
+
+    return true;
+  }
+
+  bool readString(std::string& outStr);
+
+  // Lets readers reject element counts that can't fit into the rest of the
+  // info before allocating for them.
+  std::size_t getRemainingSize() const { return _info.size() - _offset; }
+
+private:
+  std::string_view _info;
+  std::size_t _offset = 0;
+};
+
 } // namespace obsidian::asset
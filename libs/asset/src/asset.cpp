@@ -1,6 +1,7 @@
 #include <obsidian/asset/asset.hpp>
 
 #include <cstring>
+#include <span>
 
 namespace obsidian::asset {
 
@@ -18,4 +19,24 @@ AssetType getAssetType(char const typeStr[4]) {
   return AssetType::unknown;
 }
 
+bool isJsonAssetInfo(AssetMetadata const& assetMetadata) {
+  return assetMetadata.version <= lastJsonAssetVersion;
+}
+
+bool hasDependencyTable(AssetMetadata const& assetMetadata) {
+  return assetMetadata.version >= firstDependencyTableAssetVersion;
+}
+
+bool hasSectionOffsets(AssetMetadata const& assetMetadata) {
+  return assetMetadata.version >= firstSectionOffsetsAssetVersion;
+}
+
+std::span<char const> getBinaryBlob(Asset const& asset) {
+  if (asset.mappedFile) {
+    return asset.mappedBlob;
+  }
+
+  return asset.binaryBlob;
+}
+
 } /*namespace obsidian::asset*/
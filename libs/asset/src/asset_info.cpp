@@ -1,21 +1,34 @@
+#include <obsidian/asset/asset.hpp>
 #include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
 #include <obsidian/core/logging.hpp>
 
 #include <lz4.h>
 #include <tracy/Tracy.hpp>
 
-#include <cassert>
 #include <cstring>
+#include <span>
+#include <vector>
 
 namespace obsidian::asset {
 
-bool unpackAsset(AssetInfo const& assetInfo, char const* src,
-                 std::size_t srcSize, char* dst) {
+namespace {
+
+bool unpackBlob(AssetInfo const& assetInfo, char const* src,
+                std::size_t srcSize, char* dst,
+                task::TaskExecutor* taskExecutor, task::TaskType taskType) {
   ZoneScoped;
 
   switch (assetInfo.compressionMode) {
   case CompressionMode::none: {
     ZoneScopedN("unpackAsset - uncompressed");
+
+    // dst is sized for the unpacked size, often exactly.
+    if (srcSize != assetInfo.unpackedSize) {
+      OBS_LOG_ERR("Uncompressed blob size doesn't match the asset info.");
+      return false;
+    }
+
     std::memcpy(dst, src, srcSize);
     return true;
   }
@@ -24,15 +37,95 @@ bool unpackAsset(AssetInfo const& assetInfo, char const* src,
     int const decompressedSize =
         LZ4_decompress_safe(src, dst, srcSize, assetInfo.unpackedSize);
 
-    assert(decompressedSize == assetInfo.unpackedSize);
-
-    bool const unpackingSuceeded = decompressedSize >= 0;
+    bool const unpackingSuceeded =
+        decompressedSize >= 0 &&
+        static_cast<std::size_t>(decompressedSize) == assetInfo.unpackedSize;
     if (!unpackingSuceeded) {
-      OBS_LOG_ERR("LZ4 decompression failed with code ");
+      OBS_LOG_ERR("LZ4 decompression failed.");
     }
     return unpackingSuceeded;
   }
+  case CompressionMode::LZ4Chunked:
+  case CompressionMode::LZ4HC:
+  case CompressionMode::zstd: {
+    ZoneScopedN("unpackAsset - chunked compression");
+    return decompressChunked(assetInfo.compressionMode,
+                             std::span(src, srcSize),
+                             std::span(dst, assetInfo.unpackedSize),
+                             taskExecutor, taskType);
+  }
+  default:
+    return false;
+  }
+}
+
+} /*namespace*/
+
+bool unpackAsset(AssetInfo const& assetInfo, char const* src,
+                 std::size_t srcSize, char* dst) {
+  return unpackBlob(assetInfo, src, srcSize, dst, nullptr,
+                    task::TaskType::general);
+}
+
+bool unpackAsset(AssetInfo const& assetInfo, Asset const& asset, char* dst) {
+  std::span<char const> const blob = getBinaryBlob(asset);
+
+  return unpackAsset(assetInfo, blob.data(), blob.size(), dst);
+}
+
+bool unpackAsset(AssetInfo const& assetInfo, Asset const& asset, char* dst,
+                 task::TaskExecutor& taskExecutor, task::TaskType taskType) {
+  std::span<char const> const blob = getBinaryBlob(asset);
+
+  return unpackBlob(assetInfo, blob.data(), blob.size(), dst, &taskExecutor,
+                    taskType);
+}
+
+bool unpackAssetRange(AssetInfo const& assetInfo, Asset const& asset,
+                      std::size_t offset, std::span<char> dst) {
+  ZoneScoped;
+
+  if (offset > assetInfo.unpackedSize ||
+      dst.size() > assetInfo.unpackedSize - offset) {
+    OBS_LOG_ERR("Requested range is out of the bounds of the asset.");
+    return false;
+  }
+
+  std::span<char const> const blob = getBinaryBlob(asset);
+
+  switch (assetInfo.compressionMode) {
+  case CompressionMode::none: {
+    if (blob.size() != assetInfo.unpackedSize) {
+      OBS_LOG_ERR("Uncompressed blob size doesn't match the asset info.");
+      return false;
+    }
+
+    std::memcpy(dst.data(), blob.data() + offset, dst.size());
+    return true;
+  }
+  case CompressionMode::LZ4: {
+    // A single LZ4 block can't be entered in the middle.
+    std::vector<char> unpacked(offset + dst.size());
+    int const decompressedSize =
+        LZ4_decompress_safe_partial(blob.data(), unpacked.data(), blob.size(),
+                                    unpacked.size(), unpacked.size());
+
+    if (decompressedSize < 0 ||
+        static_cast<std::size_t>(decompressedSize) != unpacked.size()) {
+      OBS_LOG_ERR("LZ4 decompression failed.");
+      return false;
+    }
+
+    std::memcpy(dst.data(), unpacked.data() + offset, dst.size());
+    return true;
+  }
+  case CompressionMode::LZ4Chunked:
+  case CompressionMode::LZ4HC:
+  case CompressionMode::zstd:
+    return decompressChunkedRange(assetInfo.compressionMode, blob,
+                                  assetInfo.unpackedSize, offset, dst);
   default:
+    OBS_LOG_ERR("Unknown compression mode.");
     return false;
   }
 }
@@ -1,36 +1,287 @@
 #include <obsidian/asset/asset.hpp>
 #include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/material_asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
 #include <obsidian/core/logging.hpp>
+#include <obsidian/platform/async_file_reader.hpp>
+#include <obsidian/platform/mapped_file.hpp>
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 
 #include <tracy/Tracy.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <ios>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
 
 namespace fs = std::filesystem;
 
 namespace obsidian::asset {
 
-void readAssetMetadata(std::ifstream& inputFileStream,
+// The metadata fields in front of the info.
+constexpr std::size_t fixedAssetMetadataSize =
+    sizeof(AssetMetadata::type) + sizeof(AssetMetadata::version) +
+    /*info size:*/ sizeof(AssetMetadata::SizeType) +
+    sizeof(AssetMetadata::binaryBlobSize);
+
+// Starts the info of assets that have a dependency table. Each path is
+// stored as its size followed by its characters.
+struct DependencyTableHeader {
+  std::uint32_t dependencyCount;
+  // size of the stored paths following the header
+  std::uint32_t pathsSize;
+};
+
+std::size_t getDependencyTableSize(AssetMetadata const& assetMetadata) {
+  if (!hasDependencyTable(assetMetadata)) {
+    return 0;
+  }
+
+  std::size_t size = sizeof(DependencyTableHeader);
+
+  for (std::string const& dependency : assetMetadata.dependencies) {
+    size += sizeof(std::uint32_t) + dependency.size();
+  }
+
+  return size;
+}
+
+std::size_t getAssetMetadataSize(AssetMetadata const& assetMetadata) {
+  return fixedAssetMetadataSize + getDependencyTableSize(assetMetadata) +
+         assetMetadata.info.size();
+}
+
+bool readFixedAssetMetadata(std::span<char const> data,
+                            asset::AssetMetadata& outAssetMetadata,
+                            AssetMetadata::SizeType& outInfoSize) {
+  if (data.size() < fixedAssetMetadataSize) {
+    return false;
+  }
+
+  char const* src = data.data();
+
+  auto const read = [&src](void* dst, std::size_t size) {
+    std::memcpy(dst, src, size);
+    src += size;
+  };
+
+  read(outAssetMetadata.type, std::size(outAssetMetadata.type));
+  read(&outAssetMetadata.version, sizeof(outAssetMetadata.version));
+  read(&outInfoSize, sizeof(outInfoSize));
+  read(&outAssetMetadata.binaryBlobSize,
+       sizeof(outAssetMetadata.binaryBlobSize));
+
+  return true;
+}
+
+// Reads the table from the start of data. Returns the size of the table, or
+// nothing if it's truncated.
+std::optional<std::size_t>
+readDependencyTable(std::span<char const> data,
+                    std::vector<std::string>& outDependencies) {
+  DependencyTableHeader header;
+
+  if (data.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  // Every path stores at least its size, a larger count can't be read from
+  // the paths and mustn't be reserved for.
+  if (header.pathsSize > data.size() - sizeof(header) ||
+      header.dependencyCount > header.pathsSize / sizeof(std::uint32_t)) {
+    return std::nullopt;
+  }
+
+  std::span<char const> paths = data.subspan(sizeof(header), header.pathsSize);
+
+  outDependencies.clear();
+  outDependencies.reserve(header.dependencyCount);
+
+  for (std::uint32_t i = 0; i < header.dependencyCount; ++i) {
+    std::uint32_t pathSize;
+
+    if (paths.size() < sizeof(pathSize)) {
+      return std::nullopt;
+    }
+
+    std::memcpy(&pathSize, paths.data(), sizeof(pathSize));
+    paths = paths.subspan(sizeof(pathSize));
+
+    if (paths.size() < pathSize) {
+      return std::nullopt;
+    }
+
+    outDependencies.emplace_back(paths.data(), pathSize);
+    paths = paths.subspan(pathSize);
+  }
+
+  return sizeof(header) + header.pathsSize;
+}
+
+// Splits the stored info into the dependency table, if the asset version has
+// one, and the info of the asset type.
+bool readAssetInfo(std::span<char const> data,
+                   AssetMetadata& outAssetMetadata) {
+  outAssetMetadata.dependencies.clear();
+
+  if (hasDependencyTable(outAssetMetadata)) {
+    std::optional<std::size_t> const tableSize =
+        readDependencyTable(data, outAssetMetadata.dependencies);
+
+    if (!tableSize) {
+      return false;
+    }
+
+    data = data.subspan(*tableSize);
+  }
+
+  outAssetMetadata.info.assign(data.data(), data.size());
+
+  return true;
+}
+
+// The info is allocated before it's read, so its size is checked against the
+// size of the file first.
+bool readAssetMetadata(std::ifstream& inputFileStream, std::uintmax_t fileSize,
                        asset::AssetMetadata& outAssetMetadata) {
   ZoneScoped;
 
-  inputFileStream.read(outAssetMetadata.type, std::size(outAssetMetadata.type));
-  inputFileStream.read(reinterpret_cast<char*>(&outAssetMetadata.version),
-                       sizeof(outAssetMetadata.version));
+  std::array<char, fixedAssetMetadataSize> fixedMetadata;
+  inputFileStream.read(fixedMetadata.data(), fixedMetadata.size());
+
+  AssetMetadata::SizeType infoSize;
+  readFixedAssetMetadata(fixedMetadata, outAssetMetadata, infoSize);
 
-  AssetMetadata::SizeType jsonSize;
-  inputFileStream.read(reinterpret_cast<char*>(&jsonSize),
-                       sizeof(AssetMetadata::SizeType));
+  if (fileSize < fixedAssetMetadataSize ||
+      infoSize > fileSize - fixedAssetMetadataSize) {
+    return false;
+  }
 
-  inputFileStream.read(
-      reinterpret_cast<char*>(&outAssetMetadata.binaryBlobSize),
-      sizeof(AssetMetadata::SizeType));
+  std::vector<char> info(infoSize);
+  inputFileStream.read(info.data(), info.size());
 
-  outAssetMetadata.json.resize(jsonSize);
-  inputFileStream.read(outAssetMetadata.json.data(),
-                       outAssetMetadata.json.length());
+  return readAssetInfo(info, outAssetMetadata);
+}
+
+bool readAssetMetadata(std::span<char const> data,
+                       asset::AssetMetadata& outAssetMetadata) {
+  ZoneScoped;
+
+  AssetMetadata::SizeType infoSize;
+
+  if (!readFixedAssetMetadata(data, outAssetMetadata, infoSize) ||
+      infoSize > data.size() - fixedAssetMetadataSize) {
+    return false;
+  }
+
+  return readAssetInfo(data.subspan(fixedAssetMetadataSize, infoSize),
+                       outAssetMetadata);
+}
+
+// Assets saved before the dependency table was stored only name their
+// dependencies in the info.
+bool readDependenciesFromInfo(AssetMetadata const& assetMetadata,
+                              std::vector<std::string>& outDependencies) {
+  outDependencies.clear();
+
+  if (getAssetType(assetMetadata.type) != AssetType::material) {
+    return true;
+  }
+
+  MaterialAssetInfo materialAssetInfo;
+
+  if (!readMaterialAssetInfo(assetMetadata, materialAssetInfo)) {
+    return false;
+  }
+
+  outDependencies = getMaterialDependencies(materialAssetInfo);
+
+  return true;
+}
+
+bool readAssetDependencies(std::span<char const> data,
+                           std::vector<std::string>& outDependencies) {
+  ZoneScoped;
+
+  AssetMetadata assetMetadata;
+  AssetMetadata::SizeType infoSize;
+
+  if (!readFixedAssetMetadata(data, assetMetadata, infoSize) ||
+      infoSize > data.size() - fixedAssetMetadataSize) {
+    return false;
+  }
+
+  std::span<char const> const info =
+      data.subspan(fixedAssetMetadataSize, infoSize);
+
+  if (hasDependencyTable(assetMetadata)) {
+    return readDependencyTable(info, outDependencies).has_value();
+  }
+
+  return readAssetInfo(info, assetMetadata) &&
+         readDependenciesFromInfo(assetMetadata, outDependencies);
+}
+
+// The blob stays in the mapping, the hints make the kernel read it ahead so
+// that unpacking it later doesn't stall on page faults. Ranged loads only
+// fault in the pages they touch instead.
+bool loadMappedAsset(fs::path const& path,
+                     std::shared_ptr<platform::MappedFile const> mappedFile,
+                     std::span<char const> data, Asset& outAsset,
+                     bool readAhead) {
+  if (!outAsset.metadata) {
+    outAsset.metadata.emplace();
+
+    if (!readAssetMetadata(data, *outAsset.metadata)) {
+      OBS_LOG_ERR("Failed to read asset metadata: " + path.string());
+      outAsset.metadata.reset();
+      return false;
+    }
+  }
+
+  std::size_t const blobOffset = getAssetMetadataSize(*outAsset.metadata);
+  std::size_t const blobSize = outAsset.metadata->binaryBlobSize;
+
+  if (blobOffset > data.size() || blobSize > data.size() - blobOffset) {
+    OBS_LOG_ERR("Asset file is truncated: " + path.string());
+    return false;
+  }
+
+  // the hints take offsets into the whole mapping
+  std::size_t const mappedBlobOffset =
+      data.data() - mappedFile->getData().data() + blobOffset;
+
+  using AccessHint = platform::MappedFile::AccessHint;
+
+  if (readAhead) {
+    mappedFile->advise(AccessHint::sequential, mappedBlobOffset, blobSize);
+    mappedFile->advise(AccessHint::willNeed, mappedBlobOffset, blobSize);
+  } else {
+    mappedFile->advise(AccessHint::random, mappedBlobOffset, blobSize);
+  }
+
+  outAsset.binaryBlob = {};
+  outAsset.mappedBlob = data.subspan(blobOffset, blobSize);
+  outAsset.mappedFile = std::move(mappedFile);
+  outAsset.isLoaded = true;
+
+  return true;
 }
 
 bool loadAssetMetadataFromFile(std::filesystem::path const& path,
@@ -51,17 +302,109 @@ bool loadAssetMetadataFromFile(std::filesystem::path const& path,
     return false;
   }
 
-  readAssetMetadata(inputFileStream, outAssetMetadata);
+  std::error_code ec;
+  std::uintmax_t const fileSize = fs::file_size(path, ec);
+
+  if (ec) {
+    OBS_LOG_ERR("Failed to get the size of " + path.string() + ": " +
+                ec.message());
+    return false;
+  }
+
+  try {
+    if (!readAssetMetadata(inputFileStream, fileSize, outAssetMetadata)) {
+      OBS_LOG_ERR("Failed to read asset metadata: " + path.string());
+      return false;
+    }
+  } catch (std::ios_base::failure const&) {
+    OBS_LOG_ERR("Asset file is truncated: " + path.string());
+    return false;
+  }
 
   return true;
 }
 
-bool loadAssetFromFile(fs::path const& path, Asset& outAsset) {
+bool loadAssetDependenciesFromFile(fs::path const& path,
+                                   std::vector<std::string>& outDependencies) {
   ZoneScoped;
 
   std::ifstream inputFileStream;
   inputFileStream.exceptions(std::ios::failbit);
 
+  try {
+    inputFileStream.open(path, std::ios_base::in | std::ios_base::binary);
+
+    std::array<char, fixedAssetMetadataSize> fixedMetadata;
+    inputFileStream.read(fixedMetadata.data(), fixedMetadata.size());
+
+    AssetMetadata assetMetadata;
+    AssetMetadata::SizeType infoSize;
+    readFixedAssetMetadata(fixedMetadata, assetMetadata, infoSize);
+
+    std::error_code ec;
+    std::uintmax_t const fileSize = fs::file_size(path, ec);
+
+    if (ec || infoSize > fileSize - fixedAssetMetadataSize) {
+      OBS_LOG_ERR("Asset info is truncated: " + path.string());
+      return false;
+    }
+
+    if (!hasDependencyTable(assetMetadata)) {
+      std::vector<char> info(infoSize);
+      inputFileStream.read(info.data(), info.size());
+
+      return readAssetInfo(info, assetMetadata) &&
+             readDependenciesFromInfo(assetMetadata, outDependencies);
+    }
+
+    // Only the table is read, not the rest of the info.
+    DependencyTableHeader header;
+
+    if (infoSize < sizeof(header)) {
+      OBS_LOG_ERR("Asset dependency table is truncated: " + path.string());
+      return false;
+    }
+
+    inputFileStream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (header.pathsSize > infoSize - sizeof(header)) {
+      OBS_LOG_ERR("Asset dependency table is truncated: " + path.string());
+      return false;
+    }
+
+    std::vector<char> table(sizeof(header) + header.pathsSize);
+    std::memcpy(table.data(), &header, sizeof(header));
+    inputFileStream.read(table.data() + sizeof(header), header.pathsSize);
+
+    if (!readDependencyTable(table, outDependencies)) {
+      OBS_LOG_ERR("Asset dependency table is truncated: " + path.string());
+      return false;
+    }
+  } catch (std::ios_base::failure const& e) {
+    OBS_LOG_ERR("Failed to read asset dependencies from " + path.string() +
+                ": " + e.what());
+    return false;
+  }
+
+  return true;
+}
+
+bool loadAssetFromFile(fs::path const& path, Asset& outAsset,
+                       bool readAhead) {
+  ZoneScoped;
+
+  auto mappedFile = std::make_shared<platform::MappedFile>();
+
+  if (mappedFile->map(path)) {
+    std::span<char const> const data = mappedFile->getData();
+    return loadMappedAsset(path, std::move(mappedFile), data, outAsset,
+                           readAhead);
+  }
+
+  // Reading the file into the blob works wherever mapping it doesn't.
+  std::ifstream inputFileStream;
+  inputFileStream.exceptions(std::ios::failbit);
+
   try {
     inputFileStream.open(path, std::ios_base::in | std::ios_base::binary);
   } catch (std::ios_base::failure const& e) {
@@ -74,63 +417,249 @@ bool loadAssetFromFile(fs::path const& path, Asset& outAsset) {
     return false;
   }
 
+  std::error_code ec;
+  std::uintmax_t const fileSize = fs::file_size(path, ec);
+
+  if (ec) {
+    OBS_LOG_ERR("Failed to get the size of " + path.string() + ": " +
+                ec.message());
+    return false;
+  }
+
   bool const metadataLoaded = outAsset.metadata.has_value();
 
-  if (!metadataLoaded) {
-    outAsset.metadata.emplace();
-    readAssetMetadata(inputFileStream, *outAsset.metadata);
-  } else {
-    std::size_t metadataSize = sizeof(AssetMetadata::type) +
-                               /*json size:*/ sizeof(AssetMetadata::SizeType) +
-                               sizeof(AssetMetadata::binaryBlobSize) +
-                               sizeof(AssetMetadata::version) +
-                               outAsset.metadata->json.size();
-    inputFileStream.seekg(metadataSize);
+  // The stream throws on reads past the end of a truncated file.
+  try {
+    if (!metadataLoaded) {
+      outAsset.metadata.emplace();
+
+      if (!readAssetMetadata(inputFileStream, fileSize, *outAsset.metadata)) {
+        OBS_LOG_ERR("Failed to read asset metadata: " + path.string());
+        outAsset.metadata.reset();
+        return false;
+      }
+    }
+
+    std::size_t const blobOffset = getAssetMetadataSize(*outAsset.metadata);
+    std::size_t const blobSize = outAsset.metadata->binaryBlobSize;
+
+    if (blobOffset > fileSize || blobSize > fileSize - blobOffset) {
+      OBS_LOG_ERR("Asset file is truncated: " + path.string());
+      return false;
+    }
+
+    if (metadataLoaded) {
+      inputFileStream.seekg(blobOffset);
+    }
+
+    outAsset.binaryBlob.resize(blobSize);
+    inputFileStream.read(outAsset.binaryBlob.data(),
+                         outAsset.binaryBlob.size());
+  } catch (std::ios_base::failure const& e) {
+    OBS_LOG_ERR(e.what());
+
+    if (!metadataLoaded) {
+      outAsset.metadata.reset();
+    }
+
+    outAsset.binaryBlob = {};
+    return false;
   }
 
-  outAsset.binaryBlob.resize(outAsset.metadata->binaryBlobSize);
-  inputFileStream.read(outAsset.binaryBlob.data(), outAsset.binaryBlob.size());
+  outAsset.mappedFile.reset();
+  outAsset.mappedBlob = {};
 
   outAsset.isLoaded = true;
 
   return true;
 }
 
+task::TaskHandle<bool>
+loadAssetFromFileAsync(task::TaskExecutor& executor, task::TaskTarget target,
+                       fs::path path, Asset& outAsset,
+                       task::CancellationToken token) {
+  co_await executor.schedule(target);
+
+  if (token.isCancelled()) {
+    co_return false;
+  }
+
+  co_return loadAssetFromFile(path, outAsset);
+}
+
+// Completes once the reader is done, with no data if the read failed.
+task::TaskHandle<std::optional<std::vector<char>>>
+readRangeAsync(platform::AsyncFileReader& reader, fs::path path,
+               std::uint64_t offset, std::size_t size) {
+  using ReadResult = std::optional<std::vector<char>>;
+
+  auto const state = std::make_shared<task::TaskHandleState<ReadResult>>();
+  task::TaskHandle<ReadResult> handle = state->getHandle();
+
+  reader.read(std::move(path), offset, size,
+              [state](bool success, std::vector<char> data) {
+                state->promise.set_value(
+                    success ? ReadResult{std::move(data)} : std::nullopt);
+                state->completion->complete();
+              });
+
+  return handle;
+}
+
+task::TaskHandle<bool>
+readAssetAsync(task::TaskExecutor& executor, task::TaskTarget target,
+               platform::AsyncFileReader& reader, fs::path path,
+               std::uint64_t offset, std::uint64_t size, Asset& outAsset,
+               task::CancellationToken token) {
+  if (token.isCancelled()) {
+    co_return false;
+  }
+
+  std::optional<AssetMetadata> metadata = outAsset.metadata;
+  std::optional<std::vector<char>> blob;
+
+  if (metadata) {
+    std::size_t const blobOffset = getAssetMetadataSize(*metadata);
+
+    if (blobOffset > size || metadata->binaryBlobSize > size - blobOffset) {
+      OBS_LOG_ERR("Asset file is truncated: " + path.string());
+    } else {
+      blob = co_await readRangeAsync(reader, path, offset + blobOffset,
+                                     metadata->binaryBlobSize);
+    }
+  } else if (fixedAssetMetadataSize > size) {
+    OBS_LOG_ERR("Asset file is truncated: " + path.string());
+  } else if (std::optional<std::vector<char>> const fixedMetadata =
+                 co_await readRangeAsync(reader, path, offset,
+                                         fixedAssetMetadataSize)) {
+    metadata.emplace();
+    AssetMetadata::SizeType infoSize;
+
+    // The sizes are allocated by the reader, a corrupt header mustn't make it
+    // allocate more than the file holds.
+    std::uint64_t const sizeLeft = size - fixedAssetMetadataSize;
+
+    if (!readFixedAssetMetadata(*fixedMetadata, *metadata, infoSize) ||
+        getAssetType(metadata->type) == AssetType::unknown ||
+        metadata->version > currentAssetVersion || infoSize > sizeLeft ||
+        metadata->binaryBlobSize > sizeLeft - infoSize) {
+      OBS_LOG_ERR("Invalid asset header: " + path.string());
+    } else {
+      // Both reads are submitted together.
+      std::uint64_t const infoOffset = offset + fixedAssetMetadataSize;
+      task::TaskHandle<std::optional<std::vector<char>>> const infoRead =
+          readRangeAsync(reader, path, infoOffset, infoSize);
+      task::TaskHandle<std::optional<std::vector<char>>> const blobRead =
+          readRangeAsync(reader, path, infoOffset + infoSize,
+                         metadata->binaryBlobSize);
+
+      std::optional<std::vector<char>> const info = co_await infoRead;
+      blob = co_await blobRead;
+
+      if (!info || !readAssetInfo(*info, *metadata)) {
+        blob.reset();
+      }
+    }
+  }
+
+  // The reader's thread only hands the data over.
+  co_await executor.schedule(target);
+
+  if (!blob) {
+    OBS_LOG_ERR("Failed to read asset from " + path.string());
+    co_return false;
+  }
+
+  outAsset.metadata = std::move(metadata);
+  outAsset.binaryBlob = std::move(*blob);
+  outAsset.mappedFile.reset();
+  outAsset.mappedBlob = {};
+  outAsset.isLoaded = true;
+
+  co_return true;
+}
+
 bool saveToFile(fs::path const& path, Asset const& asset) {
   ZoneScoped;
 
-  std::ofstream outputFileStream;
-  outputFileStream.exceptions(std::ios_base::failbit);
+  // Loaded assets may still map the file at path. Writing a new file and
+  // replacing the old one leaves those mappings intact on Linux, truncating
+  // the file in place would make reading them fault. See replaceFile for
+  // Windows.
+  fs::path tempPath = path;
+  tempPath += ".tmp";
+
+  bool tempFileCreated = false;
 
   try {
     fs::path const directoryPath = path.parent_path();
     if (!fs::exists(directoryPath)) {
       fs::create_directories(directoryPath);
     }
-    outputFileStream.open(path, std::ios_base::out | std::ios_base::binary);
-  } catch (std::ios_base::failure const& e) {
-    OBS_LOG_ERR(e.what());
-    return false;
-  }
 
-  outputFileStream.write(asset.metadata->type, std::size(asset.metadata->type));
-  outputFileStream.write(
-      reinterpret_cast<char const*>(&asset.metadata->version),
-      sizeof(asset.metadata->version));
+    // Destroyed before the handler runs, so the file is closed by the time
+    // it's removed.
+    std::ofstream outputFileStream;
+    outputFileStream.exceptions(std::ios_base::failbit);
+    outputFileStream.open(tempPath,
+                          std::ios_base::out | std::ios_base::binary);
+    tempFileCreated = true;
+
+    outputFileStream.write(asset.metadata->type,
+                           std::size(asset.metadata->type));
+    outputFileStream.write(
+        reinterpret_cast<char const*>(&asset.metadata->version),
+        sizeof(asset.metadata->version));
+
+    // The stored info starts with the dependency table.
+    std::size_t const dependencyTableSize =
+        getDependencyTableSize(*asset.metadata);
+    AssetMetadata::SizeType const infoSize{dependencyTableSize +
+                                           asset.metadata->info.size()};
+    outputFileStream.write(reinterpret_cast<char const*>(&infoSize),
+                           sizeof(infoSize));
+
+    std::span<char const> const binaryBlob = getBinaryBlob(asset);
+
+    AssetMetadata::SizeType const binaryBlobSize{binaryBlob.size()};
+    outputFileStream.write(reinterpret_cast<char const*>(&binaryBlobSize),
+                           sizeof(binaryBlobSize));
+
+    if (dependencyTableSize) {
+      DependencyTableHeader const header = {
+          static_cast<std::uint32_t>(asset.metadata->dependencies.size()),
+          static_cast<std::uint32_t>(dependencyTableSize -
+                                     sizeof(DependencyTableHeader))};
+      outputFileStream.write(reinterpret_cast<char const*>(&header),
+                             sizeof(header));
+
+      for (std::string const& dependency : asset.metadata->dependencies) {
+        std::uint32_t const pathSize =
+            static_cast<std::uint32_t>(dependency.size());
+        outputFileStream.write(reinterpret_cast<char const*>(&pathSize),
+                               sizeof(pathSize));
+        outputFileStream.write(dependency.data(), dependency.size());
+      }
+    }
 
-  AssetMetadata::SizeType const jsonSize{asset.metadata->json.size()};
-  outputFileStream.write(reinterpret_cast<char const*>(&jsonSize),
-                         sizeof(jsonSize));
+    outputFileStream.write(asset.metadata->info.data(),
+                           asset.metadata->info.size());
+    outputFileStream.write(binaryBlob.data(), binaryBlob.size());
+    outputFileStream.close();
+  } catch (std::ios_base::failure const& e) {
+    OBS_LOG_ERR("Failed to write asset " + tempPath.string() + ": " +
+                e.what());
 
-  AssetMetadata::SizeType const binaryBlobSize{asset.binaryBlob.size()};
-  outputFileStream.write(reinterpret_cast<char const*>(&binaryBlobSize),
-                         sizeof(binaryBlobSize));
+    // A partly written file mustn't be left next to the asset.
+    if (tempFileCreated) {
+      std::error_code ec;
+      fs::remove(tempPath, ec);
+    }
 
-  outputFileStream.write(asset.metadata->json.data(),
-                         asset.metadata->json.size());
-  outputFileStream.write(asset.binaryBlob.data(), asset.binaryBlob.size());
+    return false;
+  }
 
-  return true;
+  return replaceFile(tempPath, path);
 }
 
 } /*namespace obsidian::asset*/
@@ -0,0 +1,426 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/asset_pack.hpp>
+#include <obsidian/asset/material_asset_info.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
+#include <obsidian/core/logging.hpp>
+#include <obsidian/platform/mapped_file.hpp>
+
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::asset {
+
+namespace {
+
+constexpr char assetPackMagic[4] = {'o', 'b', 'p', 'k'};
+
+std::size_t alignToPack(std::size_t value) {
+  return (value + assetPackAlignment - 1) & ~(assetPackAlignment - 1);
+}
+
+std::string getPackPathString(fs::path const& relativePath) {
+  return relativePath.lexically_normal().generic_string();
+}
+
+std::uint64_t hashPathString(std::string_view pathString) {
+  std::uint64_t hash = 14695981039346656037ull;
+
+  for (char const c : pathString) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+// The assets that are loaded together with the asset: the ones it has to be
+// uploaded after and the default materials of a mesh.
+std::vector<std::string> getDependencyPaths(AssetMetadata const& metadata) {
+  std::vector<std::string> dependencies = metadata.dependencies;
+
+  switch (getAssetType(metadata.type)) {
+  case AssetType::mesh: {
+    MeshAssetInfo meshInfo;
+
+    if (readMeshAssetInfo(metadata, meshInfo)) {
+      dependencies.insert(dependencies.end(),
+                          meshInfo.defaultMatRelativePaths.cbegin(),
+                          meshInfo.defaultMatRelativePaths.cend());
+    }
+    break;
+  }
+  case AssetType::material: {
+    MaterialAssetInfo materialInfo;
+
+    if (!hasDependencyTable(metadata) &&
+        readMaterialAssetInfo(metadata, materialInfo)) {
+      dependencies = getMaterialDependencies(materialInfo);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+
+  std::erase_if(dependencies, [](std::string const& d) { return d.empty(); });
+
+  return dependencies;
+}
+
+struct PackInput {
+  std::string path;
+  platform::MappedFile file;
+  std::vector<std::string> dependencies;
+};
+
+// Appends the index of the input after the indices of its dependencies that
+// weren't added yet. Dependencies outside the pack are ignored.
+void addInDependencyOrder(
+    std::size_t index, std::vector<PackInput> const& inputs,
+    std::unordered_map<std::string, std::size_t> const& inputIndices,
+    std::vector<bool>& added, std::vector<std::size_t>& outOrder) {
+  if (added[index]) {
+    return;
+  }
+
+  added[index] = true;
+
+  for (std::string const& dependency : inputs[index].dependencies) {
+    auto const dependencyIndex =
+        inputIndices.find(getPackPathString(dependency));
+
+    if (dependencyIndex != inputIndices.cend()) {
+      addInDependencyOrder(dependencyIndex->second, inputs, inputIndices,
+                           added, outOrder);
+    }
+  }
+
+  outOrder.push_back(index);
+}
+
+} /*namespace*/
+
+std::uint64_t getAssetPathHash(fs::path const& relativePath) {
+  return hashPathString(getPackPathString(relativePath));
+}
+
+bool AssetPack::open(fs::path const& path) {
+  ZoneScoped;
+
+  close();
+
+  auto mappedFile = std::make_shared<platform::MappedFile>();
+
+  if (!mappedFile->map(path)) {
+    OBS_LOG_ERR("Failed to open asset pack: " + path.string());
+    return false;
+  }
+
+  std::span<char const> const data = mappedFile->getData();
+  AssetPackHeader header;
+
+  if (data.size() < sizeof(header)) {
+    OBS_LOG_ERR("Asset pack is truncated: " + path.string());
+    return false;
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, assetPackMagic, sizeof(assetPackMagic)) ||
+      header.version != currentAssetPackVersion) {
+    OBS_LOG_ERR("Not an asset pack of a supported version: " + path.string());
+    return false;
+  }
+
+  if (header.tocOffset % alignof(AssetPackTocEntry) ||
+      header.tocOffset > data.size() ||
+      header.assetCount >
+          (data.size() - header.tocOffset) / sizeof(AssetPackTocEntry) ||
+      header.pathsOffset > data.size()) {
+    OBS_LOG_ERR("Asset pack is truncated: " + path.string());
+    return false;
+  }
+
+  // The mapping is page aligned, so the table can be used in place.
+  std::span<AssetPackTocEntry const> const toc{
+      reinterpret_cast<AssetPackTocEntry const*>(data.data() +
+                                                 header.tocOffset),
+      header.assetCount};
+  std::span<char const> const paths = data.subspan(header.pathsOffset);
+
+  for (AssetPackTocEntry const& entry : toc) {
+    if (entry.offset > data.size() ||
+        entry.size > data.size() - entry.offset ||
+        entry.pathOffset > paths.size() ||
+        entry.pathSize > paths.size() - entry.pathOffset) {
+      OBS_LOG_ERR("Asset pack has entries outside of the file: " +
+                  path.string());
+      return false;
+    }
+  }
+
+  _path = path;
+  _mappedFile = std::move(mappedFile);
+  _toc = toc;
+  _paths = paths;
+
+  return true;
+}
+
+void AssetPack::close() {
+  _toc = {};
+  _paths = {};
+  _mappedFile.reset();
+  _path.clear();
+}
+
+bool AssetPack::isOpen() const { return _mappedFile != nullptr; }
+
+fs::path const& AssetPack::getPath() const { return _path; }
+
+std::size_t AssetPack::getAssetCount() const { return _toc.size(); }
+
+bool AssetPack::contains(fs::path const& relativePath) const {
+  return !findAsset(relativePath).empty();
+}
+
+std::optional<AssetPackRange>
+AssetPack::findAssetRange(fs::path const& relativePath) const {
+  std::span<char const> const data = findAsset(relativePath);
+
+  if (data.empty()) {
+    return std::nullopt;
+  }
+
+  return AssetPackRange{
+      static_cast<std::uint64_t>(data.data() - _mappedFile->getData().data()),
+      data.size()};
+}
+
+bool AssetPack::loadAssetMetadata(fs::path const& relativePath,
+                                  AssetMetadata& outAssetMetadata) const {
+  ZoneScoped;
+
+  std::span<char const> const data = findAsset(relativePath);
+
+  if (data.empty()) {
+    return false;
+  }
+
+  if (!readAssetMetadata(data, outAssetMetadata)) {
+    OBS_LOG_ERR("Failed to read asset metadata of " + relativePath.string() +
+                " from asset pack " + _path.string());
+    return false;
+  }
+
+  return true;
+}
+
+bool AssetPack::loadAssetDependencies(
+    fs::path const& relativePath,
+    std::vector<std::string>& outDependencies) const {
+  ZoneScoped;
+
+  std::span<char const> const data = findAsset(relativePath);
+
+  if (data.empty()) {
+    return false;
+  }
+
+  if (!readAssetDependencies(data, outDependencies)) {
+    OBS_LOG_ERR("Failed to read asset dependencies of " +
+                relativePath.string() + " from asset pack " + _path.string());
+    return false;
+  }
+
+  return true;
+}
+
+bool AssetPack::loadAsset(fs::path const& relativePath, Asset& outAsset,
+                          bool readAhead) const {
+  ZoneScoped;
+
+  std::span<char const> const data = findAsset(relativePath);
+
+  if (data.empty()) {
+    return false;
+  }
+
+  return loadMappedAsset(_path / relativePath, _mappedFile, data, outAsset,
+                         readAhead);
+}
+
+std::span<char const> AssetPack::findAsset(fs::path const& relativePath) const {
+  if (!_mappedFile) {
+    return {};
+  }
+
+  std::string const pathString = getPackPathString(relativePath);
+  std::uint64_t const pathHash = hashPathString(pathString);
+
+  auto entry = std::lower_bound(
+      _toc.begin(), _toc.end(), pathHash,
+      [](AssetPackTocEntry const& e, std::uint64_t h) {
+        return e.pathHash < h;
+      });
+
+  for (; entry != _toc.end() && entry->pathHash == pathHash; ++entry) {
+    if (std::string_view{_paths.data() + entry->pathOffset,
+                         entry->pathSize} == pathString) {
+      return _mappedFile->getData().subspan(entry->offset, entry->size);
+    }
+  }
+
+  return {};
+}
+
+bool buildAssetPack(fs::path const& projectRootPath,
+                    std::span<fs::path const> relativePaths,
+                    fs::path const& outPackPath) {
+  ZoneScoped;
+
+  std::vector<PackInput> inputs;
+  std::unordered_map<std::string, std::size_t> inputIndices;
+  inputs.reserve(relativePaths.size());
+
+  for (fs::path const& relativePath : relativePaths) {
+    std::string pathString = getPackPathString(relativePath);
+
+    if (!inputIndices.emplace(pathString, inputs.size()).second) {
+      OBS_LOG_WARN("Asset " + pathString + " is packed only once.");
+      continue;
+    }
+
+    PackInput& input = inputs.emplace_back();
+    input.path = std::move(pathString);
+
+    fs::path const absolutePath = projectRootPath / relativePath;
+    AssetMetadata metadata;
+
+    if (!input.file.map(absolutePath) ||
+        !readAssetMetadata(input.file.getData(), metadata)) {
+      OBS_LOG_ERR("Failed to read asset " + absolutePath.string());
+      return false;
+    }
+
+    input.dependencies = getDependencyPaths(metadata);
+  }
+
+  std::vector<std::size_t> order;
+  std::vector<bool> added(inputs.size());
+  order.reserve(inputs.size());
+
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    addInDependencyOrder(i, inputs, inputIndices, added, order);
+  }
+
+  AssetPackHeader header;
+  std::memcpy(header.magic, assetPackMagic, sizeof(assetPackMagic));
+  header.version = currentAssetPackVersion;
+  header.assetCount = inputs.size();
+  header.tocOffset = alignToPack(sizeof(header));
+  header.pathsOffset =
+      header.tocOffset + inputs.size() * sizeof(AssetPackTocEntry);
+
+  std::vector<AssetPackTocEntry> toc(inputs.size());
+  std::string paths;
+
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    toc[i].pathHash = hashPathString(inputs[i].path);
+    toc[i].pathOffset = static_cast<std::uint32_t>(paths.size());
+    toc[i].pathSize = static_cast<std::uint32_t>(inputs[i].path.size());
+    paths += inputs[i].path;
+  }
+
+  std::size_t offset = alignToPack(header.pathsOffset + paths.size());
+
+  for (std::size_t const i : order) {
+    toc[i].offset = offset;
+    toc[i].size = inputs[i].file.getData().size();
+    offset = alignToPack(offset + toc[i].size);
+  }
+
+  std::sort(toc.begin(), toc.end(),
+            [](AssetPackTocEntry const& a, AssetPackTocEntry const& b) {
+              return a.pathHash < b.pathHash;
+            });
+
+  // Written next to the pack and moved over it, like saveToFile does, so
+  // that readers mapping the old pack aren't affected. See replaceFile for
+  // Windows.
+  fs::path tempPath = outPackPath;
+  tempPath += ".tmp";
+
+  bool tempFileCreated = false;
+
+  try {
+    // Destroyed before the handler runs, so the file is closed by the time
+    // it's removed.
+    std::ofstream outputFileStream;
+    outputFileStream.exceptions(std::ios_base::failbit);
+    outputFileStream.open(tempPath,
+                          std::ios_base::out | std::ios_base::binary);
+    tempFileCreated = true;
+
+    std::size_t position = 0;
+
+    auto const write = [&outputFileStream, &position](void const* data,
+                                                      std::size_t size) {
+      outputFileStream.write(static_cast<char const*>(data), size);
+      position += size;
+    };
+
+    auto const writePadding = [&write, &position]() {
+      constexpr char zeros[assetPackAlignment] = {};
+      write(zeros, alignToPack(position) - position);
+    };
+
+    write(&header, sizeof(header));
+    writePadding();
+    write(toc.data(), toc.size() * sizeof(AssetPackTocEntry));
+    write(paths.data(), paths.size());
+
+    for (std::size_t const i : order) {
+      writePadding();
+
+      std::span<char const> const data = inputs[i].file.getData();
+      write(data.data(), data.size());
+    }
+
+    outputFileStream.close();
+  } catch (std::ios_base::failure const& e) {
+    OBS_LOG_ERR("Failed to write asset pack " + tempPath.string() + ": " +
+                e.what());
+
+    if (tempFileCreated) {
+      std::error_code ec;
+      fs::remove(tempPath, ec);
+    }
+
+    return false;
+  }
+
+  return replaceFile(tempPath, outPackPath);
+}
+
+} /*namespace obsidian::asset*/
@@ -3,12 +3,16 @@
 #include <obsidian/asset/utility.hpp>
 #include <obsidian/core/logging.hpp>
 #include <obsidian/core/material.hpp>
+#include <obsidian/core/utils/visitor.hpp>
 #include <obsidian/serialization/serialization.hpp>
 
 #include <nlohmann/json.hpp>
 #include <tracy/Tracy.hpp>
 
 #include <cassert>
+#include <cstdint>
+#include <exception>
+#include <string>
 #include <variant>
 
 namespace obsidian::asset {
@@ -34,19 +38,77 @@ constexpr char const* transparentJsonName = "transparent";
 constexpr char const* reflectionJsonName = "reflection";
 constexpr char const* hasTimerJsonName = "hasTimer";
 
-bool writeUnlitMaterialAssetData(UnlitMaterialAssetData const& litData,
-                                 nlohmann::json& outJson) {
-  try {
-    outJson[colorJsonName] = serialization::vecToArray(litData.color);
-    outJson[colorTextureJsonName] = litData.colorTexturePath;
-  } catch (std::exception const& e) {
-    OBS_LOG_ERR(e.what());
+namespace {
+
+struct MaterialInfoHeader {
+  std::uint64_t unpackedSize;
+  CompressionMode compressionMode;
+  core::MaterialType materialType;
+  std::uint32_t transparent;
+  std::uint32_t hasTimer;
+  // followed by the shader paths and the subtype data
+};
+
+static_assert(sizeof(MaterialInfoHeader) == 24);
+
+void writeUnlitMaterialAssetData(UnlitMaterialAssetData const& unlitData,
+                                 BinaryInfoWriter& writer) {
+  writer.write(unlitData.color);
+  writer.writeString(unlitData.colorTexturePath);
+}
+
+bool readUnlitMaterialAssetData(BinaryInfoReader& reader,
+                                UnlitMaterialAssetData& outMaterialAssetData) {
+  return reader.read(outMaterialAssetData.color) &&
+         reader.readString(outMaterialAssetData.colorTexturePath);
+}
+
+void writeLitMaterialAssetData(LitMaterialAssetData const& litData,
+                               BinaryInfoWriter& writer) {
+  writer.writeString(litData.diffuseTexturePath);
+  writer.writeString(litData.normalMapTexturePath);
+  writer.write(litData.ambientColor);
+  writer.write(litData.diffuseColor);
+  writer.write(litData.specularColor);
+  writer.write(litData.shininess);
+  writer.write(static_cast<std::uint32_t>(litData.reflection));
+}
+
+bool readLitMaterialAssetData(BinaryInfoReader& reader,
+                              LitMaterialAssetData& outMaterialAssetData) {
+  std::uint32_t reflection;
+
+  if (!reader.readString(outMaterialAssetData.diffuseTexturePath) ||
+      !reader.readString(outMaterialAssetData.normalMapTexturePath) ||
+      !reader.read(outMaterialAssetData.ambientColor) ||
+      !reader.read(outMaterialAssetData.diffuseColor) ||
+      !reader.read(outMaterialAssetData.specularColor) ||
+      !reader.read(outMaterialAssetData.shininess) ||
+      !reader.read(reflection)) {
     return false;
   }
 
+  outMaterialAssetData.reflection = reflection;
+
   return true;
 }
 
+void writePbrMaterialAssetData(PBRMaterialAssetData const& pbrData,
+                               BinaryInfoWriter& writer) {
+  writer.writeString(pbrData.albedoTexturePath);
+  writer.writeString(pbrData.normalMapTexturePath);
+  writer.writeString(pbrData.metalnessTexturePath);
+  writer.writeString(pbrData.roughnessTexturePath);
+}
+
+bool readPbrMaterialAssetData(BinaryInfoReader& reader,
+                              PBRMaterialAssetData& outMaterialAssetData) {
+  return reader.readString(outMaterialAssetData.albedoTexturePath) &&
+         reader.readString(outMaterialAssetData.normalMapTexturePath) &&
+         reader.readString(outMaterialAssetData.metalnessTexturePath) &&
+         reader.readString(outMaterialAssetData.roughnessTexturePath);
+}
+
 bool readUnlitMaterialAssetData(nlohmann::json const& json,
                                 UnlitMaterialAssetData& outMaterialAssetData) {
   try {
@@ -61,27 +123,6 @@ bool readUnlitMaterialAssetData(nlohmann::json const& json,
   return true;
 }
 
-bool writeLitMaterialAssetData(LitMaterialAssetData const& litData,
-                               nlohmann::json& outJson) {
-  try {
-    outJson[diffuseTextureJsonName] = litData.diffuseTexturePath;
-    outJson[normalMapTextureJsonName] = litData.normalMapTexturePath;
-    outJson[shininessJsonName] = litData.shininess;
-    outJson[ambientColorJsonName] =
-        serialization::vecToArray(litData.ambientColor);
-    outJson[diffuseColorJsonName] =
-        serialization::vecToArray(litData.diffuseColor);
-    outJson[specularColorJsonName] =
-        serialization::vecToArray(litData.specularColor);
-    outJson[reflectionJsonName] = litData.reflection;
-  } catch (std::exception const& e) {
-    OBS_LOG_ERR(e.what());
-    return false;
-  }
-
-  return true;
-}
-
 bool readLitMaterialAssetData(nlohmann::json const& json,
                               LitMaterialAssetData& outMaterialAssetData) {
   try {
@@ -103,21 +144,6 @@ bool readLitMaterialAssetData(nlohmann::json const& json,
   return true;
 }
 
-bool writePbrMaterialAssetData(PBRMaterialAssetData const& pbrData,
-                               nlohmann::json& outJson) {
-  try {
-    outJson[albedoTextureJsonName] = pbrData.albedoTexturePath;
-    outJson[normalMapTextureJsonName] = pbrData.normalMapTexturePath;
-    outJson[metalnessTextureJsonName] = pbrData.metalnessTexturePath;
-    outJson[roughnessTextureJsonName] = pbrData.roughnessTexturePath;
-  } catch (std::exception const& e) {
-    OBS_LOG_ERR(e.what());
-    return false;
-  }
-
-  return true;
-}
-
 bool readPbrMaterialAssetData(nlohmann::json const& json,
                               PBRMaterialAssetData& outMaterialAssetData) {
   try {
@@ -133,27 +159,10 @@ bool readPbrMaterialAssetData(nlohmann::json const& json,
   return true;
 }
 
-MaterialSubtypeData createSubtypeData(core::MaterialType matType) {
-  switch (matType) {
-  case core::MaterialType::unlit:
-    return UnlitMaterialAssetData{};
-  case core::MaterialType::lit:
-    return LitMaterialAssetData{};
-  case core::MaterialType::pbr:
-    return PBRMaterialAssetData{};
-  default:
-    OBS_LOG_ERR("Invalid material type with value " +
-                std::to_string((int)matType));
-    return {};
-  }
-}
-
-bool readMaterialAssetInfo(AssetMetadata const& assetmetadata,
-                           MaterialAssetInfo& outMaterialAssetInfo) {
-  ZoneScoped;
-
+bool readMaterialAssetInfoJson(AssetMetadata const& assetMetadata,
+                               MaterialAssetInfo& outMaterialAssetInfo) {
   try {
-    nlohmann::json json = nlohmann::json::parse(assetmetadata.json);
+    nlohmann::json json = nlohmann::json::parse(assetMetadata.info);
     outMaterialAssetInfo.unpackedSize = json[unpackedSizeJsonName];
     outMaterialAssetInfo.compressionMode = json[compressionModeJsonName];
     outMaterialAssetInfo.materialType = json[materialTypeJsonName];
@@ -200,8 +209,113 @@ bool readMaterialAssetInfo(AssetMetadata const& assetmetadata,
   return true;
 }
 
+} /*namespace*/
+
+MaterialSubtypeData createSubtypeData(core::MaterialType matType) {
+  switch (matType) {
+  case core::MaterialType::unlit:
+    return UnlitMaterialAssetData{};
+  case core::MaterialType::lit:
+    return LitMaterialAssetData{};
+  case core::MaterialType::pbr:
+    return PBRMaterialAssetData{};
+  default:
+    OBS_LOG_ERR("Invalid material type with value " +
+                std::to_string((int)matType));
+    return {};
+  }
+}
+
+bool readMaterialAssetInfo(AssetMetadata const& assetMetadata,
+                           MaterialAssetInfo& outMaterialAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readMaterialAssetInfoJson(assetMetadata, outMaterialAssetInfo);
+  }
+
+  BinaryInfoReader reader{assetMetadata.info};
+  MaterialInfoHeader header;
+
+  if (!reader.read(header) ||
+      !reader.readString(outMaterialAssetInfo.vertexShaderPath) ||
+      !reader.readString(outMaterialAssetInfo.fragmentShaderPath)) {
+    OBS_LOG_ERR("Material asset info is truncated.");
+    return false;
+  }
+
+  outMaterialAssetInfo.unpackedSize = header.unpackedSize;
+  outMaterialAssetInfo.compressionMode = header.compressionMode;
+  outMaterialAssetInfo.materialType = header.materialType;
+  outMaterialAssetInfo.transparent = header.transparent;
+  outMaterialAssetInfo.hasTimer = header.hasTimer;
+
+  bool subtypeDataReadSuccess;
+
+  switch (header.materialType) {
+  case core::MaterialType::unlit:
+    subtypeDataReadSuccess = readUnlitMaterialAssetData(
+        reader, outMaterialAssetInfo.materialSubtypeData
+                    .emplace<UnlitMaterialAssetData>());
+    break;
+  case core::MaterialType::lit:
+    subtypeDataReadSuccess = readLitMaterialAssetData(
+        reader, outMaterialAssetInfo.materialSubtypeData
+                    .emplace<LitMaterialAssetData>());
+    break;
+  case core::MaterialType::pbr:
+    subtypeDataReadSuccess = readPbrMaterialAssetData(
+        reader, outMaterialAssetInfo.materialSubtypeData
+                    .emplace<PBRMaterialAssetData>());
+    break;
+  default:
+    OBS_LOG_ERR("Invalid material type with value " +
+                std::to_string(static_cast<int>(header.materialType)));
+    return false;
+  }
+
+  if (!subtypeDataReadSuccess) {
+    OBS_LOG_ERR("Material asset info is truncated.");
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<std::string>
+getMaterialDependencies(MaterialAssetInfo const& materialAssetInfo) {
+  std::vector<std::string> dependencies;
+
+  auto const addDependency = [&dependencies](std::string const& path) {
+    if (!path.empty()) {
+      dependencies.push_back(path);
+    }
+  };
+
+  std::visit(core::visitor{[&](UnlitMaterialAssetData const& unlitData) {
+                             addDependency(unlitData.colorTexturePath);
+                           },
+                           [&](LitMaterialAssetData const& litData) {
+                             addDependency(litData.diffuseTexturePath);
+                             addDependency(litData.normalMapTexturePath);
+                           },
+                           [&](PBRMaterialAssetData const& pbrData) {
+                             addDependency(pbrData.albedoTexturePath);
+                             addDependency(pbrData.normalMapTexturePath);
+                             addDependency(pbrData.metalnessTexturePath);
+                             addDependency(pbrData.roughnessTexturePath);
+                           }},
+             materialAssetInfo.materialSubtypeData);
+
+  addDependency(materialAssetInfo.vertexShaderPath);
+  addDependency(materialAssetInfo.fragmentShaderPath);
+
+  return dependencies;
+}
+
 bool packMaterial(MaterialAssetInfo const& materialAssetInfo,
-                  std::vector<char> materialData, Asset& outAsset) {
+                  std::vector<char> materialData, Asset& outAsset,
+                  PackOptions const& options) {
   ZoneScoped;
 
   if (!outAsset.metadata) {
@@ -214,56 +328,47 @@ bool packMaterial(MaterialAssetInfo const& materialAssetInfo,
   outAsset.metadata->type[3] = 'l';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies = getMaterialDependencies(materialAssetInfo);
 
-  try {
-    nlohmann::json json;
-    json[unpackedSizeJsonName] = materialAssetInfo.unpackedSize;
-    json[compressionModeJsonName] = materialAssetInfo.compressionMode;
-    json[materialTypeJsonName] = materialAssetInfo.materialType;
-    json[vertexShaderJsonName] = materialAssetInfo.vertexShaderPath;
-    json[fragmentShaderJsonName] = materialAssetInfo.fragmentShaderPath;
+  MaterialInfoHeader header;
+  header.unpackedSize = materialAssetInfo.unpackedSize;
+  header.compressionMode = materialAssetInfo.compressionMode;
+  header.materialType = materialAssetInfo.materialType;
+  header.transparent = materialAssetInfo.transparent;
+  header.hasTimer = materialAssetInfo.hasTimer;
 
-    bool subtypeDataWriteSuccess;
+  outAsset.metadata->info.clear();
+
+  try {
+    BinaryInfoWriter writer{outAsset.metadata->info};
+    writer.write(header);
+    writer.writeString(materialAssetInfo.vertexShaderPath);
+    writer.writeString(materialAssetInfo.fragmentShaderPath);
 
     switch (materialAssetInfo.materialType) {
-    case obsidian::core::MaterialType::unlit: {
-      subtypeDataWriteSuccess = writeUnlitMaterialAssetData(
-          std::get<UnlitMaterialAssetData>(
-              materialAssetInfo.materialSubtypeData),
-          json[unlitMaterialSubtypeDataJsonName]);
+    case core::MaterialType::unlit:
+      writeUnlitMaterialAssetData(std::get<UnlitMaterialAssetData>(
+                                      materialAssetInfo.materialSubtypeData),
+                                  writer);
       break;
-    }
-    case obsidian::core::MaterialType::lit: {
-      subtypeDataWriteSuccess = writeLitMaterialAssetData(
+    case core::MaterialType::lit:
+      writeLitMaterialAssetData(
           std::get<LitMaterialAssetData>(materialAssetInfo.materialSubtypeData),
-          json[litMaterialSubtypeDataJsonName]);
+          writer);
       break;
-    }
-    case obsidian::core::MaterialType::pbr: {
-      subtypeDataWriteSuccess = writePbrMaterialAssetData(
+    case core::MaterialType::pbr:
+      writePbrMaterialAssetData(
           std::get<PBRMaterialAssetData>(materialAssetInfo.materialSubtypeData),
-          json[pbrMaterialSubtypeDataJsonName]);
+          writer);
       break;
     }
-    }
-
-    if (!subtypeDataWriteSuccess) {
-      return false;
-    }
-
-    json[transparentJsonName] = materialAssetInfo.transparent;
-    json[hasTimerJsonName] = materialAssetInfo.hasTimer;
-
-    outAsset.metadata->json = json.dump();
 
     if (materialAssetInfo.compressionMode == CompressionMode::none) {
       outAsset.binaryBlob = std::move(materialData);
-    } else if (materialAssetInfo.compressionMode == CompressionMode::LZ4) {
-      assert(materialAssetInfo.unpackedSize == materialData.size());
-      return compress(materialData, outAsset.binaryBlob);
     } else {
-      OBS_LOG_ERR("Unknown compression mode.");
-      return false;
+      assert(materialAssetInfo.unpackedSize == materialData.size());
+      return compress(materialAssetInfo.compressionMode, materialData,
+                      outAsset.binaryBlob, options);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
@@ -1,18 +1,21 @@
-#include <algorithm>
 #include <obsidian/asset/asset.hpp>
 #include <obsidian/asset/asset_info.hpp>
 #include <obsidian/asset/mesh_asset_info.hpp>
 #include <obsidian/asset/utility.hpp>
 #include <obsidian/core/logging.hpp>
 
+#include <glm/vec3.hpp>
 #include <nlohmann/json.hpp>
 #include <tracy/Tracy.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <exception>
-#include <iterator>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace obsidian::asset {
 
@@ -29,12 +32,82 @@ constexpr char const* aabbJsonName = "aabb";
 constexpr char const* aabbTopRightJsonName = "topRight";
 constexpr char const* aabbBottomLeftJsonName = "bottomLeft";
 
-bool readMeshAssetInfo(AssetMetadata const& assetMetadata,
-                       MeshAssetInfo& outMeshAssetInfo) {
-  ZoneScoped;
+namespace {
+
+struct MeshInfoHeader {
+  std::uint64_t unpackedSize;
+  std::uint64_t vertexCount;
+  std::uint64_t vertexBufferSize;
+  std::uint64_t indexCount;
+  glm::vec3 aabbTopCorner;
+  glm::vec3 aabbBottomCorner;
+  CompressionMode compressionMode;
+  std::uint32_t vertexAttributes;
+  // followed by as many index buffer sizes and default material paths
+  std::uint32_t indexBufferCount;
+  std::uint32_t defaultMatPathCount;
+};
+
+static_assert(sizeof(MeshInfoHeader) == 72);
+
+std::vector<std::size_t>
+getPackedIndexBufferOffsets(MeshAssetInfo const& meshAssetInfo) {
+  std::vector<std::size_t> indexBufferOffsets;
+  std::size_t offset = meshAssetInfo.vertexBufferSize;
+
+  for (std::size_t const indexBufferSize : meshAssetInfo.indexBufferSizes) {
+    indexBufferOffsets.push_back(offset);
+    offset += indexBufferSize;
+  }
+
+  return indexBufferOffsets;
+}
+
+std::vector<std::size_t>
+getIndexBufferOffsets(MeshAssetInfo const& meshAssetInfo) {
+  if (meshAssetInfo.indexBufferOffsets.empty()) {
+    return getPackedIndexBufferOffsets(meshAssetInfo);
+  }
+
+  return meshAssetInfo.indexBufferOffsets;
+}
 
+bool validateIndexBufferOffsets(MeshAssetInfo const& meshAssetInfo,
+                                std::span<std::size_t const> offsets) {
+  if (meshAssetInfo.vertexBufferSize > meshAssetInfo.unpackedSize ||
+      offsets.size() != meshAssetInfo.indexBufferSizes.size()) {
+    return false;
+  }
+
+  // The index buffers have to follow the vertex buffer in order and without
+  // overlapping, since the RHI copies them as one section starting at the
+  // first offset.
+  std::size_t minOffset = meshAssetInfo.vertexBufferSize;
+
+  for (std::size_t i = 0; i < offsets.size(); ++i) {
+    if (offsets[i] < minOffset || offsets[i] > meshAssetInfo.unpackedSize ||
+        meshAssetInfo.indexBufferSizes[i] >
+            meshAssetInfo.unpackedSize - offsets[i]) {
+      return false;
+    }
+
+    minOffset = offsets[i] + meshAssetInfo.indexBufferSizes[i];
+  }
+
+  return true;
+}
+
+enum MeshVertexAttributeBits : std::uint32_t {
+  normalsBit = 1 << 0,
+  colorsBit = 1 << 1,
+  uvBit = 1 << 2,
+  tangentsBit = 1 << 3
+};
+
+bool readMeshAssetInfoJson(AssetMetadata const& assetMetadata,
+                           MeshAssetInfo& outMeshAssetInfo) {
   try {
-    nlohmann::json json = nlohmann::json::parse(assetMetadata.json);
+    nlohmann::json json = nlohmann::json::parse(assetMetadata.info);
     outMeshAssetInfo.unpackedSize = json[unpackedSizeJsonName];
     outMeshAssetInfo.compressionMode = json[compressionModeJsonName];
     outMeshAssetInfo.vertexCount = json[vertexCountJsonName];
@@ -74,11 +147,113 @@ bool readMeshAssetInfo(AssetMetadata const& assetMetadata,
     return false;
   }
 
+  outMeshAssetInfo.indexBufferOffsets =
+      getPackedIndexBufferOffsets(outMeshAssetInfo);
+
+  return true;
+}
+
+} /*namespace*/
+
+bool readMeshAssetInfo(AssetMetadata const& assetMetadata,
+                       MeshAssetInfo& outMeshAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readMeshAssetInfoJson(assetMetadata, outMeshAssetInfo);
+  }
+
+  BinaryInfoReader reader{assetMetadata.info};
+  MeshInfoHeader header;
+
+  if (!reader.read(header)) {
+    OBS_LOG_ERR("Mesh asset info is truncated.");
+    return false;
+  }
+
+  outMeshAssetInfo.unpackedSize = header.unpackedSize;
+  outMeshAssetInfo.compressionMode = header.compressionMode;
+  outMeshAssetInfo.vertexCount = header.vertexCount;
+  outMeshAssetInfo.vertexBufferSize = header.vertexBufferSize;
+  outMeshAssetInfo.indexCount = header.indexCount;
+  outMeshAssetInfo.aabb.topCorner = header.aabbTopCorner;
+  outMeshAssetInfo.aabb.bottomCorner = header.aabbBottomCorner;
+  outMeshAssetInfo.hasNormals = header.vertexAttributes & normalsBit;
+  outMeshAssetInfo.hasColors = header.vertexAttributes & colorsBit;
+  outMeshAssetInfo.hasUV = header.vertexAttributes & uvBit;
+  outMeshAssetInfo.hasTangents = header.vertexAttributes & tangentsBit;
+
+  if (header.indexBufferCount >
+      reader.getRemainingSize() / sizeof(std::uint64_t)) {
+    OBS_LOG_ERR("Mesh asset info is truncated.");
+    return false;
+  }
+
+  outMeshAssetInfo.indexBufferSizes.resize(header.indexBufferCount);
+
+  for (std::size_t& indexBufferSize : outMeshAssetInfo.indexBufferSizes) {
+    std::uint64_t size;
+
+    if (!reader.read(size)) {
+      OBS_LOG_ERR("Mesh asset info is truncated.");
+      return false;
+    }
+
+    indexBufferSize = size;
+  }
+
+  if (hasSectionOffsets(assetMetadata)) {
+    if (header.indexBufferCount >
+        reader.getRemainingSize() / sizeof(std::uint64_t)) {
+      OBS_LOG_ERR("Mesh asset info is truncated.");
+      return false;
+    }
+
+    outMeshAssetInfo.indexBufferOffsets.resize(header.indexBufferCount);
+
+    for (std::size_t& indexBufferOffset : outMeshAssetInfo.indexBufferOffsets) {
+      std::uint64_t offset;
+
+      if (!reader.read(offset)) {
+        OBS_LOG_ERR("Mesh asset info is truncated.");
+        return false;
+      }
+
+      indexBufferOffset = offset;
+    }
+
+    if (!validateIndexBufferOffsets(outMeshAssetInfo,
+                                    outMeshAssetInfo.indexBufferOffsets)) {
+      OBS_LOG_ERR("Mesh asset info has an invalid index buffer offset.");
+      return false;
+    }
+  } else {
+    outMeshAssetInfo.indexBufferOffsets =
+        getPackedIndexBufferOffsets(outMeshAssetInfo);
+  }
+
+  // Every path has at least its length prefix.
+  if (header.defaultMatPathCount >
+      reader.getRemainingSize() / sizeof(std::uint32_t)) {
+    OBS_LOG_ERR("Mesh asset info is truncated.");
+    return false;
+  }
+
+  outMeshAssetInfo.defaultMatRelativePaths.resize(header.defaultMatPathCount);
+
+  for (std::string& path : outMeshAssetInfo.defaultMatRelativePaths) {
+    if (!reader.readString(path)) {
+      OBS_LOG_ERR("Mesh asset info is truncated.");
+      return false;
+    }
+  }
+
   return true;
 }
 
 bool packMeshAsset(MeshAssetInfo const& meshAssetInfo,
-                   std::vector<char> meshData, Asset& outAsset) {
+                   std::vector<char> meshData, Asset& outAsset,
+                   PackOptions const& options) {
   ZoneScoped;
 
   if (!outAsset.metadata) {
@@ -91,56 +266,59 @@ bool packMeshAsset(MeshAssetInfo const& meshAssetInfo,
   outAsset.metadata->type[3] = 'h';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies.clear();
 
-  try {
-    nlohmann::json json;
-    json[unpackedSizeJsonName] = meshAssetInfo.unpackedSize;
-    json[compressionModeJsonName] = meshAssetInfo.compressionMode;
-    json[vertexCountJsonName] = meshAssetInfo.vertexCount;
-    json[vertexBufferSizeJsonName] = meshAssetInfo.vertexBufferSize;
-
-    json[aabbJsonName][aabbTopRightJsonName]["x"] =
-        meshAssetInfo.aabb.topCorner.x;
-    json[aabbJsonName][aabbTopRightJsonName]["y"] =
-        meshAssetInfo.aabb.topCorner.y;
-    json[aabbJsonName][aabbTopRightJsonName]["z"] =
-        meshAssetInfo.aabb.topCorner.z;
-
-    json[aabbJsonName][aabbBottomLeftJsonName]["x"] =
-        meshAssetInfo.aabb.bottomCorner.x;
-    json[aabbJsonName][aabbBottomLeftJsonName]["y"] =
-        meshAssetInfo.aabb.bottomCorner.y;
-    json[aabbJsonName][aabbBottomLeftJsonName]["z"] =
-        meshAssetInfo.aabb.bottomCorner.z;
-
-    json[hasNormalsJsonName] = meshAssetInfo.hasNormals;
-    json[hasColorsJsonName] = meshAssetInfo.hasColors;
-    json[hasUVJsonName] = meshAssetInfo.hasUV;
-    json[hasTangentsJsonName] = meshAssetInfo.hasTangents;
-    json[indexCountJsonName] = meshAssetInfo.indexCount;
-
-    nlohmann::json& indexBufferSizesJson = json[indexBufferSizesJsonName];
-
-    std::copy(meshAssetInfo.indexBufferSizes.cbegin(),
-              meshAssetInfo.indexBufferSizes.cend(),
-              std::back_inserter(indexBufferSizesJson));
-
-    nlohmann::json& defaultMatPathsJson = json[defaultMatPathsJsonName];
-
-    std::copy(meshAssetInfo.defaultMatRelativePaths.cbegin(),
-              meshAssetInfo.defaultMatRelativePaths.cend(),
-              std::back_inserter(defaultMatPathsJson));
-
-    outAsset.metadata->json = json.dump();
+  std::vector<std::size_t> const indexBufferOffsets =
+      getIndexBufferOffsets(meshAssetInfo);
+
+  if (!validateIndexBufferOffsets(meshAssetInfo, indexBufferOffsets)) {
+    OBS_LOG_ERR("Mesh buffers don't fit into the unpacked size.");
+    return false;
+  }
+
+  MeshInfoHeader header;
+  header.unpackedSize = meshAssetInfo.unpackedSize;
+  header.vertexCount = meshAssetInfo.vertexCount;
+  header.vertexBufferSize = meshAssetInfo.vertexBufferSize;
+  header.indexCount = meshAssetInfo.indexCount;
+  header.aabbTopCorner = meshAssetInfo.aabb.topCorner;
+  header.aabbBottomCorner = meshAssetInfo.aabb.bottomCorner;
+  header.compressionMode = meshAssetInfo.compressionMode;
+  header.vertexAttributes = (meshAssetInfo.hasNormals ? normalsBit : 0) |
+                            (meshAssetInfo.hasColors ? colorsBit : 0) |
+                            (meshAssetInfo.hasUV ? uvBit : 0) |
+                            (meshAssetInfo.hasTangents ? tangentsBit : 0);
+  header.indexBufferCount =
+      static_cast<std::uint32_t>(meshAssetInfo.indexBufferSizes.size());
+  header.defaultMatPathCount =
+      static_cast<std::uint32_t>(meshAssetInfo.defaultMatRelativePaths.size());
 
+  outAsset.metadata->info.clear();
+
+  BinaryInfoWriter writer{outAsset.metadata->info};
+  writer.write(header);
+
+  for (std::size_t const indexBufferSize : meshAssetInfo.indexBufferSizes) {
+    writer.write(static_cast<std::uint64_t>(indexBufferSize));
+  }
+
+  for (std::size_t const indexBufferOffset : indexBufferOffsets) {
+    writer.write(static_cast<std::uint64_t>(indexBufferOffset));
+  }
+
+  for (std::string const& path : meshAssetInfo.defaultMatRelativePaths) {
+    writer.writeString(path);
+  }
+
+  try {
     if (meshAssetInfo.compressionMode == CompressionMode::none) {
       outAsset.binaryBlob = std::move(meshData);
-    } else if (meshAssetInfo.compressionMode == CompressionMode::LZ4) {
-      assert(meshAssetInfo.unpackedSize == meshData.size());
-      return compress(meshData, outAsset.binaryBlob);
     } else {
-      OBS_LOG_ERR("Unknown compression mode.");
-      return false;
+      assert(meshAssetInfo.unpackedSize == meshData.size());
+      // The vertex buffer and every index buffer start a new chunk, so that
+      // they can be unpacked on their own.
+      return compress(meshAssetInfo.compressionMode, meshData,
+                      outAsset.binaryBlob, options, indexBufferOffsets);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
@@ -149,4 +327,53 @@ bool packMeshAsset(MeshAssetInfo const& meshAssetInfo,
   return true;
 }
 
+void cookMeshLayout(MeshAssetInfo& meshAssetInfo) {
+  meshAssetInfo.indexBufferOffsets.clear();
+
+  std::size_t offset = meshAssetInfo.vertexBufferSize;
+
+  for (std::size_t const indexBufferSize : meshAssetInfo.indexBufferSizes) {
+    offset = (offset + cookedSectionAlignment - 1) &
+             ~(cookedSectionAlignment - 1);
+    meshAssetInfo.indexBufferOffsets.push_back(offset);
+    offset += indexBufferSize;
+  }
+
+  meshAssetInfo.unpackedSize = offset;
+}
+
+bool unpackMeshVertexBuffer(MeshAssetInfo const& meshAssetInfo,
+                            Asset const& asset, std::span<char> dst) {
+  ZoneScoped;
+
+  if (dst.size() != meshAssetInfo.vertexBufferSize) {
+    OBS_LOG_ERR("Destination size doesn't match the vertex buffer size.");
+    return false;
+  }
+
+  return unpackAssetRange(meshAssetInfo, asset, 0, dst);
+}
+
+bool unpackMeshIndexBuffer(MeshAssetInfo const& meshAssetInfo,
+                           Asset const& asset, std::size_t indexBufferIndex,
+                           std::span<char> dst) {
+  ZoneScoped;
+
+  if (indexBufferIndex >= meshAssetInfo.indexBufferSizes.size() ||
+      indexBufferIndex >= meshAssetInfo.indexBufferOffsets.size()) {
+    OBS_LOG_ERR("Index buffer " + std::to_string(indexBufferIndex) +
+                " doesn't exist.");
+    return false;
+  }
+
+  if (dst.size() != meshAssetInfo.indexBufferSizes[indexBufferIndex]) {
+    OBS_LOG_ERR("Destination size doesn't match the index buffer size.");
+    return false;
+  }
+
+  return unpackAssetRange(meshAssetInfo, asset,
+                          meshAssetInfo.indexBufferOffsets[indexBufferIndex],
+                          dst);
+}
+
 } /*namespace obsidian::asset*/
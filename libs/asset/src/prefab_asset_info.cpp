@@ -6,14 +6,24 @@
 #include <nlohmann/json.hpp>
 #include <tracy/Tracy.hpp>
 
+#include <cstdint>
+
 namespace obsidian::asset {
 
-bool readPrefabAssetInfo(AssetMetadata const& assetMetadata,
-                         PrefabAssetInfo& outPrefabAssetInfo) {
-  ZoneScoped;
+namespace {
+
+struct PrefabInfoHeader {
+  std::uint64_t unpackedSize;
+  CompressionMode compressionMode;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(PrefabInfoHeader) == 16);
 
+bool readPrefabAssetInfoJson(AssetMetadata const& assetMetadata,
+                             PrefabAssetInfo& outPrefabAssetInfo) {
   try {
-    nlohmann::json json = nlohmann::json::parse(assetMetadata.json);
+    nlohmann::json json = nlohmann::json::parse(assetMetadata.info);
     outPrefabAssetInfo.unpackedSize = json[unpackedSizeJsonName];
     outPrefabAssetInfo.compressionMode = json[compressionModeJsonName];
   } catch (std::exception const& e) {
@@ -24,6 +34,29 @@ bool readPrefabAssetInfo(AssetMetadata const& assetMetadata,
   return true;
 }
 
+} /*namespace*/
+
+bool readPrefabAssetInfo(AssetMetadata const& assetMetadata,
+                         PrefabAssetInfo& outPrefabAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readPrefabAssetInfoJson(assetMetadata, outPrefabAssetInfo);
+  }
+
+  PrefabInfoHeader header;
+
+  if (!BinaryInfoReader{assetMetadata.info}.read(header)) {
+    OBS_LOG_ERR("Prefab asset info is truncated.");
+    return false;
+  }
+
+  outPrefabAssetInfo.unpackedSize = header.unpackedSize;
+  outPrefabAssetInfo.compressionMode = header.compressionMode;
+
+  return true;
+}
+
 bool packPrefab(PrefabAssetInfo const& prefabAssetInfo,
                 std::vector<char> prefabData, Asset& outAsset) {
   ZoneScoped;
@@ -38,20 +71,23 @@ bool packPrefab(PrefabAssetInfo const& prefabAssetInfo,
   outAsset.metadata->type[3] = 'f';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies.clear();
 
-  try {
-    nlohmann::json json;
-
-    json[unpackedSizeJsonName] = prefabAssetInfo.unpackedSize;
-    json[compressionModeJsonName] = prefabAssetInfo.compressionMode;
+  PrefabInfoHeader header;
+  header.unpackedSize = prefabAssetInfo.unpackedSize;
+  header.compressionMode = prefabAssetInfo.compressionMode;
+  header.reserved = 0;
 
-    outAsset.metadata->json = json.dump();
+  outAsset.metadata->info.clear();
+  BinaryInfoWriter{outAsset.metadata->info}.write(header);
 
+  try {
     if (prefabAssetInfo.compressionMode == CompressionMode::none) {
       outAsset.binaryBlob = std::move(prefabData);
     } else {
       assert(prefabAssetInfo.unpackedSize == prefabData.size());
-      return compress(prefabData, outAsset.binaryBlob);
+      return compress(prefabAssetInfo.compressionMode, prefabData,
+                      outAsset.binaryBlob);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
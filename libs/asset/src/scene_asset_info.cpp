@@ -9,17 +9,26 @@
 #include <tracy/Tracy.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <exception>
 #include <utility>
 
 namespace obsidian::asset {
 
-bool readSceneAssetInfo(AssetMetadata const& assetMetadata,
-                        SceneAssetInfo& outSceneAssetInfo) {
-  ZoneScoped;
+namespace {
 
+struct SceneInfoHeader {
+  std::uint64_t unpackedSize;
+  CompressionMode compressionMode;
+  std::uint32_t reserved;
+};
+
+static_assert(sizeof(SceneInfoHeader) == 16);
+
+bool readSceneAssetInfoJson(AssetMetadata const& assetMetadata,
+                            SceneAssetInfo& outSceneAssetInfo) {
   try {
-    nlohmann::json json = nlohmann::json::parse(assetMetadata.json);
+    nlohmann::json json = nlohmann::json::parse(assetMetadata.info);
     outSceneAssetInfo.unpackedSize = json[unpackedSizeJsonName];
     outSceneAssetInfo.compressionMode = json[compressionModeJsonName];
   } catch (std::exception const& e) {
@@ -30,6 +39,29 @@ bool readSceneAssetInfo(AssetMetadata const& assetMetadata,
   return true;
 }
 
+} /*namespace*/
+
+bool readSceneAssetInfo(AssetMetadata const& assetMetadata,
+                        SceneAssetInfo& outSceneAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readSceneAssetInfoJson(assetMetadata, outSceneAssetInfo);
+  }
+
+  SceneInfoHeader header;
+
+  if (!BinaryInfoReader{assetMetadata.info}.read(header)) {
+    OBS_LOG_ERR("Scene asset info is truncated.");
+    return false;
+  }
+
+  outSceneAssetInfo.unpackedSize = header.unpackedSize;
+  outSceneAssetInfo.compressionMode = header.compressionMode;
+
+  return true;
+}
+
 bool packSceneAsset(SceneAssetInfo const& sceneAssetInfo,
                     std::vector<char> sceneData, Asset& outAsset) {
   ZoneScoped;
@@ -44,20 +76,23 @@ bool packSceneAsset(SceneAssetInfo const& sceneAssetInfo,
   outAsset.metadata->type[3] = 'n';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies.clear();
 
-  try {
-    nlohmann::json json;
+  SceneInfoHeader header;
+  header.unpackedSize = sceneAssetInfo.unpackedSize;
+  header.compressionMode = sceneAssetInfo.compressionMode;
+  header.reserved = 0;
 
-    json[unpackedSizeJsonName] = sceneAssetInfo.unpackedSize;
-    json[compressionModeJsonName] = sceneAssetInfo.compressionMode;
-
-    outAsset.metadata->json = json.dump();
+  outAsset.metadata->info.clear();
+  BinaryInfoWriter{outAsset.metadata->info}.write(header);
 
+  try {
     if (sceneAssetInfo.compressionMode == CompressionMode::none) {
       outAsset.binaryBlob = std::move(sceneData);
     } else {
       assert(sceneAssetInfo.unpackedSize == sceneData.size());
-      return compress(sceneData, outAsset.binaryBlob);
+      return compress(sceneAssetInfo.compressionMode, sceneData,
+                      outAsset.binaryBlob);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
@@ -8,17 +8,26 @@
 #include <tracy/Tracy.hpp>
 
 #include <cassert>
+#include <cstdint>
 
 namespace obsidian::asset {
 
 constexpr char const* shaderTypeJsonName = "shaderType";
 
-bool readShaderAssetInfo(AssetMetadata const& assetMetadata,
-                         ShaderAssetInfo& outShaderAssetInfo) {
-  ZoneScoped;
+namespace {
 
+struct ShaderInfoHeader {
+  std::uint64_t unpackedSize;
+  CompressionMode compressionMode;
+  std::uint32_t shaderType;
+};
+
+static_assert(sizeof(ShaderInfoHeader) == 16);
+
+bool readShaderAssetInfoJson(AssetMetadata const& assetMetadata,
+                             ShaderAssetInfo& outShaderAssetInfo) {
   try {
-    nlohmann::json json = nlohmann::json::parse(assetMetadata.json);
+    nlohmann::json json = nlohmann::json::parse(assetMetadata.info);
     outShaderAssetInfo.unpackedSize = json[unpackedSizeJsonName];
     outShaderAssetInfo.compressionMode = json[compressionModeJsonName];
     outShaderAssetInfo.shaderType = json[shaderTypeJsonName];
@@ -30,8 +39,34 @@ bool readShaderAssetInfo(AssetMetadata const& assetMetadata,
   return true;
 }
 
+} /*namespace*/
+
+bool readShaderAssetInfo(AssetMetadata const& assetMetadata,
+                         ShaderAssetInfo& outShaderAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readShaderAssetInfoJson(assetMetadata, outShaderAssetInfo);
+  }
+
+  ShaderInfoHeader header;
+
+  if (!BinaryInfoReader{assetMetadata.info}.read(header)) {
+    OBS_LOG_ERR("Shader asset info is truncated.");
+    return false;
+  }
+
+  outShaderAssetInfo.unpackedSize = header.unpackedSize;
+  outShaderAssetInfo.compressionMode = header.compressionMode;
+  outShaderAssetInfo.shaderType =
+      static_cast<core::ShaderType>(header.shaderType);
+
+  return true;
+}
+
 bool packShader(ShaderAssetInfo const& shaderAssetInfo,
-                std::vector<char> shaderData, Asset& outAsset) {
+                std::vector<char> shaderData, Asset& outAsset,
+                PackOptions const& options) {
   ZoneScoped;
 
   if (!outAsset.metadata) {
@@ -44,23 +79,23 @@ bool packShader(ShaderAssetInfo const& shaderAssetInfo,
   outAsset.metadata->type[3] = 'd';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies.clear();
 
-  try {
-    nlohmann::json json;
-    json[unpackedSizeJsonName] = shaderAssetInfo.unpackedSize;
-    json[compressionModeJsonName] = shaderAssetInfo.compressionMode;
-    json[shaderTypeJsonName] = shaderAssetInfo.shaderType;
+  ShaderInfoHeader header;
+  header.unpackedSize = shaderAssetInfo.unpackedSize;
+  header.compressionMode = shaderAssetInfo.compressionMode;
+  header.shaderType = static_cast<std::uint32_t>(shaderAssetInfo.shaderType);
 
-    outAsset.metadata->json = json.dump();
+  outAsset.metadata->info.clear();
+  BinaryInfoWriter{outAsset.metadata->info}.write(header);
 
+  try {
     if (shaderAssetInfo.compressionMode == CompressionMode::none) {
       outAsset.binaryBlob = std::move(shaderData);
-    } else if (shaderAssetInfo.compressionMode == CompressionMode::LZ4) {
-      assert(shaderAssetInfo.unpackedSize == shaderData.size());
-      return compress(shaderData, outAsset.binaryBlob);
     } else {
-      OBS_LOG_ERR("Unknown compression mode.");
-      return false;
+      assert(shaderAssetInfo.unpackedSize == shaderData.size());
+      return compress(shaderAssetInfo.compressionMode, shaderData,
+                      outAsset.binaryBlob, options);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
@@ -8,7 +8,14 @@
 #include <nlohmann/json.hpp>
 #include <tracy/Tracy.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <exception>
+#include <span>
+#include <vector>
 
 namespace obsidian::asset {
 
@@ -18,12 +25,83 @@ constexpr char const* textureHeightJsonName = "height";
 constexpr char const* mipLevelsJsonName = "mipLevels";
 constexpr char const* transparentJsonName = "transparent";
 
-bool readTextureAssetInfo(AssetMetadata const& assetMetadata,
-                          TextureAssetInfo& outTextureAssetInfo) {
-  ZoneScoped;
+namespace {
+
+struct TextureInfoHeader {
+  std::uint64_t unpackedSize;
+  CompressionMode compressionMode;
+  core::TextureFormat format;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t mipLevels;
+  std::uint32_t transparent;
+};
+
+static_assert(sizeof(TextureInfoHeader) == 32);
+
+// Packed textures store their mip levels one after the other, starting with
+// the largest.
+std::vector<std::size_t>
+getPackedMipOffsets(TextureAssetInfo const& textureAssetInfo) {
+  std::vector<std::size_t> mipOffsets(textureAssetInfo.mipLevels);
+  std::size_t offset = 0;
+
+  for (std::uint32_t i = 0; i < textureAssetInfo.mipLevels; ++i) {
+    mipOffsets[i] = offset;
+    offset += getTextureMipSize(textureAssetInfo, i);
+  }
+
+  return mipOffsets;
+}
+
+std::vector<std::size_t>
+getMipOffsets(TextureAssetInfo const& textureAssetInfo) {
+  if (textureAssetInfo.mipOffsets.empty()) {
+    return getPackedMipOffsets(textureAssetInfo);
+  }
+
+  return textureAssetInfo.mipOffsets;
+}
+
+std::size_t getMipOffset(TextureAssetInfo const& textureAssetInfo,
+                         std::uint32_t mip) {
+  if (textureAssetInfo.mipOffsets.empty()) {
+    return getPackedMipOffsets(textureAssetInfo)[mip];
+  }
+
+  return textureAssetInfo.mipOffsets[mip];
+}
+
+// A texture has at least one mip level and at most as many as it takes to
+// halve its larger dimension down to 1.
+bool validateMipLevels(TextureAssetInfo const& textureAssetInfo) {
+  return textureAssetInfo.mipLevels > 0 &&
+         textureAssetInfo.mipLevels <=
+             static_cast<std::uint32_t>(std::bit_width(std::max(
+                 textureAssetInfo.width, textureAssetInfo.height)));
+}
+
+bool validateMipOffsets(TextureAssetInfo const& textureAssetInfo,
+                        std::span<std::size_t const> mipOffsets) {
+  if (mipOffsets.size() != textureAssetInfo.mipLevels) {
+    return false;
+  }
+
+  for (std::uint32_t i = 0; i < textureAssetInfo.mipLevels; ++i) {
+    if (mipOffsets[i] > textureAssetInfo.unpackedSize ||
+        getTextureMipSize(textureAssetInfo, i) >
+            textureAssetInfo.unpackedSize - mipOffsets[i]) {
+      return false;
+    }
+  }
 
+  return true;
+}
+
+bool readTextureAssetInfoJson(AssetMetadata const& assetMetadata,
+                              TextureAssetInfo& outTextureAssetInfo) {
   try {
-    nlohmann::json textureJson = nlohmann::json::parse(assetMetadata.json);
+    nlohmann::json textureJson = nlohmann::json::parse(assetMetadata.info);
 
     outTextureAssetInfo.unpackedSize = textureJson[unpackedSizeJsonName];
     outTextureAssetInfo.compressionMode = textureJson[compressionModeJsonName];
@@ -37,11 +115,77 @@ bool readTextureAssetInfo(AssetMetadata const& assetMetadata,
     return false;
   }
 
+  if (!validateMipLevels(outTextureAssetInfo)) {
+    OBS_LOG_ERR("Texture asset info has an invalid mip level count.");
+    return false;
+  }
+
+  outTextureAssetInfo.mipOffsets = getPackedMipOffsets(outTextureAssetInfo);
+
+  return true;
+}
+
+} /*namespace*/
+
+bool readTextureAssetInfo(AssetMetadata const& assetMetadata,
+                          TextureAssetInfo& outTextureAssetInfo) {
+  ZoneScoped;
+
+  if (isJsonAssetInfo(assetMetadata)) {
+    return readTextureAssetInfoJson(assetMetadata, outTextureAssetInfo);
+  }
+
+  BinaryInfoReader reader{assetMetadata.info};
+  TextureInfoHeader header;
+
+  if (!reader.read(header)) {
+    OBS_LOG_ERR("Texture asset info is truncated.");
+    return false;
+  }
+
+  outTextureAssetInfo.unpackedSize = header.unpackedSize;
+  outTextureAssetInfo.compressionMode = header.compressionMode;
+  outTextureAssetInfo.format = header.format;
+  outTextureAssetInfo.width = header.width;
+  outTextureAssetInfo.height = header.height;
+  outTextureAssetInfo.mipLevels = header.mipLevels;
+  outTextureAssetInfo.transparent = header.transparent;
+
+  if (!validateMipLevels(outTextureAssetInfo)) {
+    OBS_LOG_ERR("Texture asset info has an invalid mip level count.");
+    return false;
+  }
+
+  if (!hasSectionOffsets(assetMetadata)) {
+    outTextureAssetInfo.mipOffsets = getPackedMipOffsets(outTextureAssetInfo);
+    return true;
+  }
+
+  outTextureAssetInfo.mipOffsets.resize(header.mipLevels);
+
+  for (std::size_t& mipOffset : outTextureAssetInfo.mipOffsets) {
+    std::uint64_t offset;
+
+    if (!reader.read(offset)) {
+      OBS_LOG_ERR("Texture asset info is truncated.");
+      return false;
+    }
+
+    mipOffset = offset;
+  }
+
+  if (!validateMipOffsets(outTextureAssetInfo,
+                          outTextureAssetInfo.mipOffsets)) {
+    OBS_LOG_ERR("Texture asset info has an invalid mip offset.");
+    return false;
+  }
+
   return true;
 }
 
 bool packTexture(TextureAssetInfo const& textureAssetInfo,
-                 void const* pixelData, Asset& outAsset) {
+                 void const* pixelData, Asset& outAsset,
+                 PackOptions const& options) {
   ZoneScoped;
 
   if (!outAsset.metadata) {
@@ -54,6 +198,7 @@ bool packTexture(TextureAssetInfo const& textureAssetInfo,
   outAsset.metadata->type[3] = 'i';
 
   outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->dependencies.clear();
 
   if (!updateTextureAssetInfo(textureAssetInfo, outAsset)) {
     return false;
@@ -64,13 +209,16 @@ bool packTexture(TextureAssetInfo const& textureAssetInfo,
       outAsset.binaryBlob.resize(textureAssetInfo.unpackedSize);
       std::memcpy(outAsset.binaryBlob.data(), pixelData,
                   outAsset.binaryBlob.size());
-    } else if (textureAssetInfo.compressionMode == CompressionMode::LZ4) {
-      return compress(std::span(reinterpret_cast<char const*>(pixelData),
-                                textureAssetInfo.unpackedSize),
-                      outAsset.binaryBlob);
     } else {
-      OBS_LOG_ERR("Unknown compression mode.");
-      return false;
+      // Every mip level starts a new chunk, so that a range of levels can be
+      // unpacked on its own.
+      std::vector<std::size_t> const mipOffsets =
+          getMipOffsets(textureAssetInfo);
+
+      return compress(textureAssetInfo.compressionMode,
+                      std::span(reinterpret_cast<char const*>(pixelData),
+                                textureAssetInfo.unpackedSize),
+                      outAsset.binaryBlob, options, mipOffsets);
     }
   } catch (std::exception const& e) {
     OBS_LOG_ERR(e.what());
@@ -82,23 +230,109 @@ bool packTexture(TextureAssetInfo const& textureAssetInfo,
 
 bool updateTextureAssetInfo(TextureAssetInfo const& textureAssetInfo,
                             Asset& outAsset) {
-  try {
-    nlohmann::json assetJson;
-    assetJson[unpackedSizeJsonName] = textureAssetInfo.unpackedSize;
-    assetJson[formatJsonName] = textureAssetInfo.format;
-    assetJson[compressionModeJsonName] = textureAssetInfo.compressionMode;
-    assetJson[textureWidthJsonName] = textureAssetInfo.width;
-    assetJson[textureHeightJsonName] = textureAssetInfo.height;
-    assetJson[mipLevelsJsonName] = textureAssetInfo.mipLevels;
-    assetJson[transparentJsonName] = textureAssetInfo.transparent;
-
-    outAsset.metadata->json = assetJson.dump();
-  } catch (std::exception const& e) {
-    OBS_LOG_ERR(e.what());
+  std::vector<std::size_t> const mipOffsets = getMipOffsets(textureAssetInfo);
+
+  if (!validateMipOffsets(textureAssetInfo, mipOffsets)) {
+    OBS_LOG_ERR("Texture mip levels don't fit into the unpacked size.");
     return false;
   }
 
+  TextureInfoHeader header;
+  header.unpackedSize = textureAssetInfo.unpackedSize;
+  header.compressionMode = textureAssetInfo.compressionMode;
+  header.format = textureAssetInfo.format;
+  header.width = textureAssetInfo.width;
+  header.height = textureAssetInfo.height;
+  header.mipLevels = textureAssetInfo.mipLevels;
+  header.transparent = textureAssetInfo.transparent;
+
+  // Assets loaded from older files are upgraded when they are saved again.
+  outAsset.metadata->version = currentAssetVersion;
+  outAsset.metadata->info.clear();
+
+  BinaryInfoWriter writer{outAsset.metadata->info};
+  writer.write(header);
+
+  for (std::size_t const offset : mipOffsets) {
+    writer.write(static_cast<std::uint64_t>(offset));
+  }
+
   return true;
 }
 
+void cookTexture(TextureAssetInfo& textureAssetInfo, void const* pixelData,
+                 std::vector<char>& outPixelData) {
+  ZoneScoped;
+
+  textureAssetInfo.mipOffsets.clear();
+
+  std::vector<std::size_t> const packedMipOffsets =
+      getPackedMipOffsets(textureAssetInfo);
+  std::size_t offset = 0;
+
+  for (std::uint32_t i = 0; i < textureAssetInfo.mipLevels; ++i) {
+    offset = (offset + cookedSectionAlignment - 1) &
+             ~(cookedSectionAlignment - 1);
+    textureAssetInfo.mipOffsets.push_back(offset);
+    offset += getTextureMipSize(textureAssetInfo, i);
+  }
+
+  // The padding between the levels is zeroed to compress well.
+  outPixelData.assign(offset, 0);
+
+  for (std::uint32_t i = 0; i < textureAssetInfo.mipLevels; ++i) {
+    std::memcpy(outPixelData.data() + textureAssetInfo.mipOffsets[i],
+                static_cast<char const*>(pixelData) + packedMipOffsets[i],
+                getTextureMipSize(textureAssetInfo, i));
+  }
+
+  textureAssetInfo.unpackedSize = offset;
+}
+
+std::size_t getTextureMipSize(TextureAssetInfo const& textureAssetInfo,
+                              std::uint32_t mip) {
+  return std::size_t{textureAssetInfo.width >> mip} *
+         (textureAssetInfo.height >> mip) *
+         core::getFormatPixelSize(textureAssetInfo.format);
+}
+
+std::size_t getTextureMipsOffset(TextureAssetInfo const& textureAssetInfo,
+                                 std::uint32_t firstMip) {
+  assert(firstMip < textureAssetInfo.mipLevels);
+
+  return getMipOffset(textureAssetInfo, firstMip);
+}
+
+std::size_t getTextureMipsSize(TextureAssetInfo const& textureAssetInfo,
+                               std::uint32_t firstMip, std::uint32_t mipCount) {
+  assert(mipCount && firstMip + mipCount <= textureAssetInfo.mipLevels);
+
+  std::uint32_t const lastMip = firstMip + mipCount - 1;
+
+  return getMipOffset(textureAssetInfo, lastMip) +
+         getTextureMipSize(textureAssetInfo, lastMip) -
+         getMipOffset(textureAssetInfo, firstMip);
+}
+
+bool unpackTextureMips(TextureAssetInfo const& textureAssetInfo,
+                       Asset const& asset, std::uint32_t firstMip,
+                       std::uint32_t mipCount, std::span<char> dst) {
+  ZoneScoped;
+
+  if (!mipCount || firstMip >= textureAssetInfo.mipLevels ||
+      mipCount > textureAssetInfo.mipLevels - firstMip) {
+    OBS_LOG_ERR("Requested mip levels are out of the texture's mip range.");
+    return false;
+  }
+
+  if (dst.size() != getTextureMipsSize(textureAssetInfo, firstMip, mipCount)) {
+    OBS_LOG_ERR("Destination size doesn't match the requested mip levels.");
+    return false;
+  }
+
+  return unpackAssetRange(textureAssetInfo, asset,
+                          getTextureMipsOffset(textureAssetInfo, firstMip),
+                          dst);
+}
+
 } /*namespace obsidian::asset*/
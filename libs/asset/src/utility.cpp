@@ -1,13 +1,222 @@
 #include <obsidian/asset/utility.hpp>
 #include <obsidian/core/logging.hpp>
+#include <obsidian/task/task_executor.hpp>
 
 #include <lz4.h>
+#include <lz4hc.h>
+#include <tracy/Tracy.hpp>
+#include <zstd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
 #include <string>
-#include <tracy/Tracy.hpp>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
 namespace obsidian::asset {
 
+namespace {
+
+// Start of a chunked blob, followed by the end offset of every chunk
+// relative to the end of the table and then by the chunks. Chunks that are
+// split at section offsets don't all have the same unpacked size. Their
+// chunkSize is 0, and the end offsets are followed by the end of every chunk
+// in the unpacked data.
+struct ChunkTableHeader {
+  std::uint64_t unpackedSize;
+  std::uint32_t chunkSize;
+  std::uint32_t chunkCount;
+};
+
+static_assert(sizeof(ChunkTableHeader) == 16);
+
+using ChunkEnd = std::uint64_t;
+
+std::size_t getChunkTableSize(std::size_t chunkCount,
+                              bool hasUnpackedEnds = false) {
+  return sizeof(ChunkTableHeader) +
+         chunkCount * sizeof(ChunkEnd) * (hasUnpackedEnds ? 2 : 1);
+}
+
+// The chunk table of a chunked blob, validated against the blob.
+struct ChunkTable {
+  std::size_t tableSize;
+  std::vector<ChunkEnd> chunkEnds;
+  std::vector<ChunkEnd> unpackedChunkEnds;
+};
+
+bool readChunkTable(std::span<char const> src, std::size_t unpackedSize,
+                    ChunkTable& outChunkTable) {
+  ChunkTableHeader header;
+
+  if (src.size() < sizeof(header)) {
+    OBS_LOG_ERR("Chunked blob is truncated.");
+    return false;
+  }
+
+  std::memcpy(&header, src.data(), sizeof(header));
+
+  bool const hasUnpackedEnds = !header.chunkSize;
+
+  if (header.unpackedSize != unpackedSize ||
+      (!hasUnpackedEnds &&
+       header.chunkCount != (unpackedSize + header.chunkSize - 1) /
+                                header.chunkSize) ||
+      src.size() < getChunkTableSize(header.chunkCount, hasUnpackedEnds)) {
+    OBS_LOG_ERR("Chunked blob has an invalid chunk table.");
+    return false;
+  }
+
+  outChunkTable.tableSize =
+      getChunkTableSize(header.chunkCount, hasUnpackedEnds);
+  outChunkTable.chunkEnds.resize(header.chunkCount);
+  outChunkTable.unpackedChunkEnds.resize(header.chunkCount);
+
+  if (!header.chunkCount) {
+    return !unpackedSize;
+  }
+
+  char const* const ends = src.data() + sizeof(header);
+  std::memcpy(outChunkTable.chunkEnds.data(), ends,
+              header.chunkCount * sizeof(ChunkEnd));
+
+  if (hasUnpackedEnds) {
+    std::memcpy(outChunkTable.unpackedChunkEnds.data(),
+                ends + header.chunkCount * sizeof(ChunkEnd),
+                header.chunkCount * sizeof(ChunkEnd));
+  } else {
+    for (std::size_t i = 0; i < header.chunkCount; ++i) {
+      outChunkTable.unpackedChunkEnds[i] =
+          std::min<std::size_t>((i + 1) * header.chunkSize, unpackedSize);
+    }
+  }
+
+  if (!std::is_sorted(outChunkTable.chunkEnds.cbegin(),
+                      outChunkTable.chunkEnds.cend()) ||
+      outChunkTable.chunkEnds.back() > src.size() - outChunkTable.tableSize ||
+      !std::is_sorted(outChunkTable.unpackedChunkEnds.cbegin(),
+                      outChunkTable.unpackedChunkEnds.cend()) ||
+      outChunkTable.unpackedChunkEnds.back() != unpackedSize) {
+    OBS_LOG_ERR("Chunked blob has an invalid chunk table.");
+    return false;
+  }
+
+  return true;
+}
+
+// Calls func(chunkIndex) for every chunk, spread over the workers of the task
+// type if there is an executor.
+template <typename F>
+void forEachChunk(std::size_t chunkCount, task::TaskExecutor* taskExecutor,
+                  task::TaskType taskType, F&& func) {
+  if (!taskExecutor || chunkCount < 2) {
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+      func(i);
+    }
+
+    return;
+  }
+
+  taskExecutor->parallelFor(taskType, std::size_t{0}, chunkCount, 1,
+                            [&func](std::size_t begin, std::size_t end) {
+                              for (std::size_t i = begin; i < end; ++i) {
+                                func(i);
+                              }
+                            });
+}
+
+struct ZstdContextDeleter {
+  void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+  void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+};
+
+// Creating zstd contexts is expensive compared to a chunk, so every thread
+// keeps its own.
+ZSTD_CCtx* getThreadZstdCompressionContext() {
+  thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> const context{
+      ZSTD_createCCtx()};
+  return context.get();
+}
+
+ZSTD_DCtx* getThreadZstdDecompressionContext() {
+  thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> const context{
+      ZSTD_createDCtx()};
+  return context.get();
+}
+
+std::size_t getMaxCompressedChunkSize(CompressionMode mode) {
+  if (mode == CompressionMode::zstd) {
+    return ZSTD_compressBound(compressionChunkSize);
+  }
+
+  return LZ4_compressBound(compressionChunkSize);
+}
+
+// Returns the compressed size, 0 if the compression failed.
+std::size_t compressChunk(CompressionMode mode, int level,
+                          std::span<char const> chunk, char* dst,
+                          std::size_t dstCapacity) {
+  switch (mode) {
+  case CompressionMode::LZ4Chunked: {
+    int const size =
+        LZ4_compress_default(chunk.data(), dst, chunk.size(), dstCapacity);
+    return size > 0 ? size : 0;
+  }
+  case CompressionMode::LZ4HC: {
+    int const size =
+        LZ4_compress_HC(chunk.data(), dst, chunk.size(), dstCapacity,
+                        level ? level : LZ4HC_CLEVEL_DEFAULT);
+    return size > 0 ? size : 0;
+  }
+  case CompressionMode::zstd: {
+    std::size_t const size = ZSTD_compressCCtx(
+        getThreadZstdCompressionContext(), dst, dstCapacity, chunk.data(),
+        chunk.size(), level ? level : ZSTD_CLEVEL_DEFAULT);
+    return ZSTD_isError(size) ? 0 : size;
+  }
+  default:
+    return 0;
+  }
+}
+
+bool decompressChunk(CompressionMode mode, std::span<char const> chunk,
+                     std::span<char> dst) {
+  if (mode == CompressionMode::zstd) {
+    std::size_t const size =
+        ZSTD_decompressDCtx(getThreadZstdDecompressionContext(), dst.data(),
+                            dst.size(), chunk.data(), chunk.size());
+    return !ZSTD_isError(size) && size == dst.size();
+  }
+
+  int const size =
+      LZ4_decompress_safe(chunk.data(), dst.data(), chunk.size(), dst.size());
+  return size >= 0 && static_cast<std::size_t>(size) == dst.size();
+}
+
+// Chunks that didn't get smaller are stored uncompressed.
+bool unpackChunk(CompressionMode mode, std::span<char const> src,
+                 ChunkTable const& chunkTable, std::size_t i,
+                 std::span<char> dst) {
+  std::size_t const chunkBegin = i ? chunkTable.chunkEnds[i - 1] : 0;
+  std::span<char const> const chunk =
+      src.subspan(chunkTable.tableSize + chunkBegin,
+                  chunkTable.chunkEnds[i] - chunkBegin);
+
+  if (chunk.size() == dst.size()) {
+    std::memcpy(dst.data(), chunk.data(), chunk.size());
+    return true;
+  }
+
+  return decompressChunk(mode, chunk, dst);
+}
+
+} /*namespace*/
+
 bool compress(std::span<char const> src, std::vector<char>& outDst) {
   ZoneScoped;
 
@@ -30,4 +239,287 @@ bool compress(std::span<char const> src, std::vector<char>& outDst) {
   return true;
 }
 
+bool compress(CompressionMode mode, std::span<char const> src,
+              std::vector<char>& outDst, PackOptions const& options,
+              std::span<std::size_t const> sectionOffsets) {
+  switch (mode) {
+  case CompressionMode::none:
+    outDst.assign(src.begin(), src.end());
+    return true;
+  case CompressionMode::LZ4:
+    return compress(src, outDst);
+  case CompressionMode::LZ4Chunked:
+  case CompressionMode::LZ4HC:
+  case CompressionMode::zstd:
+    return compressChunked(mode, src, outDst, options, task::TaskType::general,
+                           sectionOffsets);
+  default:
+    OBS_LOG_ERR("Unknown compression mode.");
+    return false;
+  }
+}
+
+bool isChunkedCompressionMode(CompressionMode mode) {
+  return mode == CompressionMode::LZ4Chunked ||
+         mode == CompressionMode::LZ4HC || mode == CompressionMode::zstd;
+}
+
+bool compressChunked(CompressionMode mode, std::span<char const> src,
+                     std::vector<char>& outDst, PackOptions const& options,
+                     task::TaskType taskType,
+                     std::span<std::size_t const> sectionOffsets) {
+  ZoneScoped;
+
+  if (!isChunkedCompressionMode(mode)) {
+    OBS_LOG_ERR("Compression mode " + std::to_string(static_cast<int>(mode)) +
+                " isn't chunked.");
+    return false;
+  }
+
+  // Chunks are compressionChunkSize long, except for the last chunk before
+  // every section offset and the end.
+  std::vector<std::size_t> unpackedChunkEnds;
+  std::size_t sectionBegin = 0;
+
+  for (std::size_t i = 0; i <= sectionOffsets.size(); ++i) {
+    std::size_t const sectionEnd =
+        i < sectionOffsets.size() ? sectionOffsets[i] : src.size();
+
+    if (sectionEnd <= sectionBegin || sectionEnd > src.size()) {
+      continue;
+    }
+
+    for (std::size_t chunkBegin = sectionBegin; chunkBegin < sectionEnd;
+         chunkBegin += compressionChunkSize) {
+      unpackedChunkEnds.push_back(
+          std::min(chunkBegin + compressionChunkSize, sectionEnd));
+    }
+
+    sectionBegin = sectionEnd;
+  }
+
+  std::size_t const chunkCount = unpackedChunkEnds.size();
+  bool hasUnpackedEnds = false;
+
+  for (std::size_t i = 0; i < chunkCount; ++i) {
+    hasUnpackedEnds |=
+        unpackedChunkEnds[i] !=
+        std::min((i + 1) * compressionChunkSize, src.size());
+  }
+
+  std::size_t const tableSize = getChunkTableSize(chunkCount, hasUnpackedEnds);
+  std::size_t const maxChunkSize = getMaxCompressedChunkSize(mode);
+
+  // Every chunk is compressed into a slot of its own and the slots are
+  // packed together afterwards.
+  outDst.resize(tableSize + chunkCount * maxChunkSize);
+
+  std::vector<std::size_t> chunkSizes(chunkCount);
+  std::atomic<bool> failed = false;
+
+  forEachChunk(chunkCount, options.taskExecutor, taskType, [&](std::size_t i) {
+    std::size_t const chunkBegin = i ? unpackedChunkEnds[i - 1] : 0;
+    std::span<char const> const chunk =
+        src.subspan(chunkBegin, unpackedChunkEnds[i] - chunkBegin);
+    char* const slot = outDst.data() + tableSize + i * maxChunkSize;
+
+    std::size_t const compressedSize = compressChunk(
+        mode, options.compressionLevel, chunk, slot, maxChunkSize);
+
+    if (!compressedSize) {
+      failed = true;
+      return;
+    }
+
+    if (compressedSize >= chunk.size()) {
+      std::memcpy(slot, chunk.data(), chunk.size());
+      chunkSizes[i] = chunk.size();
+    } else {
+      chunkSizes[i] = compressedSize;
+    }
+  });
+
+  if (failed) {
+    OBS_LOG_ERR("Compression of a chunk failed.");
+    return false;
+  }
+
+  ChunkTableHeader const header{
+      src.size(),
+      hasUnpackedEnds ? 0 : static_cast<std::uint32_t>(compressionChunkSize),
+      static_cast<std::uint32_t>(chunkCount)};
+  std::memcpy(outDst.data(), &header, sizeof(header));
+
+  ChunkEnd chunkEnd = 0;
+
+  for (std::size_t i = 0; i < chunkCount; ++i) {
+    std::memmove(outDst.data() + tableSize + chunkEnd,
+                 outDst.data() + tableSize + i * maxChunkSize, chunkSizes[i]);
+
+    chunkEnd += chunkSizes[i];
+    std::memcpy(outDst.data() + sizeof(header) + i * sizeof(ChunkEnd),
+                &chunkEnd, sizeof(chunkEnd));
+
+    if (hasUnpackedEnds) {
+      ChunkEnd const unpackedChunkEnd = unpackedChunkEnds[i];
+      std::memcpy(outDst.data() + sizeof(header) +
+                      (chunkCount + i) * sizeof(ChunkEnd),
+                  &unpackedChunkEnd, sizeof(unpackedChunkEnd));
+    }
+  }
+
+  outDst.resize(tableSize + chunkEnd);
+
+  return true;
+}
+
+bool decompressChunked(CompressionMode mode, std::span<char const> src,
+                       std::span<char> dst, task::TaskExecutor* taskExecutor,
+                       task::TaskType taskType) {
+  ZoneScoped;
+
+  ChunkTable chunkTable;
+
+  if (!readChunkTable(src, dst.size(), chunkTable)) {
+    return false;
+  }
+
+  std::atomic<bool> failed = false;
+
+  forEachChunk(chunkTable.chunkEnds.size(), taskExecutor, taskType,
+               [&](std::size_t i) {
+                 std::size_t const chunkBegin =
+                     i ? chunkTable.unpackedChunkEnds[i - 1] : 0;
+                 std::span<char> const chunkDst = dst.subspan(
+                     chunkBegin, chunkTable.unpackedChunkEnds[i] - chunkBegin);
+
+                 if (!unpackChunk(mode, src, chunkTable, i, chunkDst)) {
+                   failed = true;
+                 }
+               });
+
+  if (failed) {
+    OBS_LOG_ERR("Decompression of a chunk failed.");
+    return false;
+  }
+
+  return true;
+}
+
+bool decompressChunkedRange(CompressionMode mode, std::span<char const> src,
+                            std::size_t unpackedSize, std::size_t offset,
+                            std::span<char> dst,
+                            task::TaskExecutor* taskExecutor,
+                            task::TaskType taskType) {
+  ZoneScoped;
+
+  if (offset > unpackedSize || dst.size() > unpackedSize - offset) {
+    OBS_LOG_ERR("Requested range is out of the bounds of the chunked blob.");
+    return false;
+  }
+
+  ChunkTable chunkTable;
+
+  if (!readChunkTable(src, unpackedSize, chunkTable)) {
+    return false;
+  }
+
+  std::vector<ChunkEnd> const& ends = chunkTable.unpackedChunkEnds;
+  std::size_t const rangeEnd = offset + dst.size();
+  std::size_t const firstChunk =
+      std::upper_bound(ends.cbegin(), ends.cend(), offset) - ends.cbegin();
+  std::size_t const lastChunk =
+      std::lower_bound(ends.cbegin(), ends.cend(), rangeEnd) - ends.cbegin();
+
+  if (!dst.size()) {
+    return true;
+  }
+
+  std::atomic<bool> failed = false;
+
+  forEachChunk(
+      lastChunk - firstChunk + 1, taskExecutor, taskType,
+      [&](std::size_t chunk) {
+        std::size_t const i = firstChunk + chunk;
+        std::size_t const chunkBegin = i ? ends[i - 1] : 0;
+        std::size_t const copyBegin = std::max<std::size_t>(chunkBegin, offset);
+        std::size_t const copyEnd = std::min<std::size_t>(ends[i], rangeEnd);
+        std::span<char> const copyDst =
+            dst.subspan(copyBegin - offset, copyEnd - copyBegin);
+
+        // Only the chunks at the edges of the range are decompressed into a
+        // temporary buffer.
+        if (copyBegin == chunkBegin && copyEnd == ends[i]) {
+          if (!unpackChunk(mode, src, chunkTable, i, copyDst)) {
+            failed = true;
+          }
+
+          return;
+        }
+
+        std::vector<char> chunkData(ends[i] - chunkBegin);
+
+        if (!unpackChunk(mode, src, chunkTable, i, chunkData)) {
+          failed = true;
+          return;
+        }
+
+        std::memcpy(copyDst.data(), chunkData.data() + copyBegin - chunkBegin,
+                    copyDst.size());
+      });
+
+  if (failed) {
+    OBS_LOG_ERR("Decompression of a chunk failed.");
+    return false;
+  }
+
+  return true;
+}
+
+bool replaceFile(std::filesystem::path const& tempPath,
+                 std::filesystem::path const& path) {
+  std::error_code errorCode;
+  std::filesystem::rename(tempPath, path, errorCode);
+
+  if (errorCode) {
+#ifdef _WIN32
+    OBS_LOG_ERR("Failed to replace " + path.string() + ": " +
+                errorCode.message() +
+                ". It can't be replaced while it is mapped by a loaded asset "
+                "or an open asset pack.");
+#else
+    OBS_LOG_ERR("Failed to replace " + path.string() + ": " +
+                errorCode.message());
+#endif
+    std::filesystem::remove(tempPath, errorCode);
+    return false;
+  }
+
+  return true;
+}
+
+void BinaryInfoWriter::writeString(std::string_view str) {
+  write(static_cast<std::uint32_t>(str.size()));
+  _info.append(str);
+}
+
+bool BinaryInfoReader::readString(std::string& outStr) {
+  std::size_t const startOffset = _offset;
+  std::uint32_t size;
+
+  if (!read(size)) {
+    return false;
+  }
+
+  if (size > _info.size() - _offset) {
+    _offset = startOffset;
+    return false;
+  }
+
+  outStr.assign(_info.substr(_offset, size));
+  _offset += size;
+
+  return true;
+}
+
 } // namespace obsidian::asset
@@ -0,0 +1,602 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/material_asset_info.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/shader_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/core/material.hpp>
+#include <obsidian/core/shader.hpp>
+#include <obsidian/core/texture_format.hpp>
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+using namespace obsidian::asset::test;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Layout of the start of asset files.
+constexpr std::size_t infoSizeOffset = 8;
+constexpr std::size_t fixedMetadataSize = 24;
+constexpr std::size_t dependencyCountOffset = fixedMetadataSize;
+constexpr std::size_t pathsSizeOffset = fixedMetadataSize + 4;
+constexpr std::size_t firstPathSizeOffset = fixedMetadataSize + 8;
+
+bool saveAndLoad(Asset const& asset, Asset& outLoadedAsset) {
+  fs::create_directories(getTestDir());
+  fs::path const path = getTestDir() / "asset.obstest";
+
+  return saveToFile(path, asset) && loadAssetFromFile(path, outLoadedAsset);
+}
+
+std::vector<char> unpack(AssetInfo const& info, Asset const& asset) {
+  std::vector<char> unpacked(info.unpackedSize);
+
+  if (!unpackAsset(info, asset, unpacked.data())) {
+    unpacked.clear();
+  }
+
+  return unpacked;
+}
+
+TextureAssetInfo makeTextureInfo(CompressionMode mode) {
+  TextureAssetInfo info;
+  info.compressionMode = mode;
+  info.format = core::TextureFormat::R8G8B8A8_SRGB;
+  info.width = 64;
+  info.height = 32;
+  info.mipLevels = 6;
+  info.transparent = true;
+  info.unpackedSize = 0;
+
+  for (std::uint32_t mip = 0; mip < info.mipLevels; ++mip) {
+    info.unpackedSize += getTextureMipSize(info, mip);
+  }
+
+  return info;
+}
+
+MaterialAssetInfo makeMaterialInfo() {
+  MaterialAssetInfo info;
+  info.unpackedSize = 0;
+  info.compressionMode = CompressionMode::none;
+  info.materialType = core::MaterialType::pbr;
+  info.materialSubtypeData = PBRMaterialAssetData{
+      "textures/albedo.obstex", "textures/normal.obstex", "",
+      "textures/roughness.obstex"};
+  info.vertexShaderPath = "shaders/pbr.vert.obsshad";
+  info.fragmentShaderPath = "shaders/pbr.frag.obsshad";
+  info.transparent = false;
+  info.hasTimer = true;
+
+  return info;
+}
+
+void expectSameMetadata(AssetMetadata const& expected,
+                        AssetMetadata const& actual) {
+  EXPECT_EQ(std::string(expected.type, 4), std::string(actual.type, 4));
+  EXPECT_EQ(expected.version, actual.version);
+  EXPECT_EQ(expected.info, actual.info);
+}
+
+} /*namespace*/
+
+TEST(asset_io, texture_round_trip) {
+  // arrange
+  TextureAssetInfo info = makeTextureInfo(CompressionMode::LZ4Chunked);
+  std::vector<char> cookedPixels;
+  cookTexture(info, makeCompressibleData(info.unpackedSize).data(),
+              cookedPixels);
+
+  Asset asset;
+  ASSERT_TRUE(packTexture(info, cookedPixels.data(), asset));
+
+  // act
+  Asset loadedAsset;
+  bool const loaded = saveAndLoad(asset, loadedAsset);
+
+  // assert
+  ASSERT_TRUE(loaded);
+  expectSameMetadata(*asset.metadata, *loadedAsset.metadata);
+  EXPECT_EQ(loadedAsset.metadata->version, currentAssetVersion);
+  EXPECT_TRUE(loadedAsset.metadata->dependencies.empty());
+
+  TextureAssetInfo loadedInfo;
+  ASSERT_TRUE(readTextureAssetInfo(*loadedAsset.metadata, loadedInfo));
+  EXPECT_EQ(loadedInfo.unpackedSize, info.unpackedSize);
+  EXPECT_EQ(loadedInfo.compressionMode, info.compressionMode);
+  EXPECT_EQ(loadedInfo.format, info.format);
+  EXPECT_EQ(loadedInfo.width, info.width);
+  EXPECT_EQ(loadedInfo.height, info.height);
+  EXPECT_EQ(loadedInfo.mipLevels, info.mipLevels);
+  EXPECT_EQ(loadedInfo.transparent, info.transparent);
+  EXPECT_EQ(loadedInfo.mipOffsets, info.mipOffsets);
+  EXPECT_EQ(unpack(loadedInfo, loadedAsset), cookedPixels);
+}
+
+TEST(asset_io, mesh_round_trip) {
+  // arrange
+  MeshAssetInfo info;
+  info.compressionMode = CompressionMode::LZ4;
+  info.vertexCount = 10;
+  info.vertexBufferSize = 10 * 8 * sizeof(float);
+  info.indexBufferSizes = {12 * sizeof(std::uint32_t),
+                           30 * sizeof(std::uint32_t)};
+  info.indexCount = 42;
+  info.defaultMatRelativePaths = {"materials/a.obsmat", "materials/b.obsmat"};
+  info.aabb.topCorner = {1.0f, 2.0f, 3.0f};
+  info.aabb.bottomCorner = {-1.0f, -2.0f, -3.0f};
+  info.hasNormals = true;
+  info.hasColors = false;
+  info.hasUV = true;
+  info.hasTangents = true;
+  cookMeshLayout(info);
+
+  std::vector<char> const meshData = makeCompressibleData(info.unpackedSize);
+
+  Asset asset;
+  ASSERT_TRUE(packMeshAsset(info, meshData, asset));
+
+  // act
+  Asset loadedAsset;
+  bool const loaded = saveAndLoad(asset, loadedAsset);
+
+  // assert
+  ASSERT_TRUE(loaded);
+  expectSameMetadata(*asset.metadata, *loadedAsset.metadata);
+
+  MeshAssetInfo loadedInfo;
+  ASSERT_TRUE(readMeshAssetInfo(*loadedAsset.metadata, loadedInfo));
+  EXPECT_EQ(loadedInfo.unpackedSize, info.unpackedSize);
+  EXPECT_EQ(loadedInfo.compressionMode, info.compressionMode);
+  EXPECT_EQ(loadedInfo.vertexCount, info.vertexCount);
+  EXPECT_EQ(loadedInfo.vertexBufferSize, info.vertexBufferSize);
+  EXPECT_EQ(loadedInfo.indexCount, info.indexCount);
+  EXPECT_EQ(loadedInfo.indexBufferSizes, info.indexBufferSizes);
+  EXPECT_EQ(loadedInfo.indexBufferOffsets, info.indexBufferOffsets);
+  EXPECT_EQ(loadedInfo.defaultMatRelativePaths, info.defaultMatRelativePaths);
+  EXPECT_EQ(loadedInfo.aabb.topCorner, info.aabb.topCorner);
+  EXPECT_EQ(loadedInfo.aabb.bottomCorner, info.aabb.bottomCorner);
+  EXPECT_EQ(loadedInfo.hasNormals, info.hasNormals);
+  EXPECT_EQ(loadedInfo.hasColors, info.hasColors);
+  EXPECT_EQ(loadedInfo.hasUV, info.hasUV);
+  EXPECT_EQ(loadedInfo.hasTangents, info.hasTangents);
+  EXPECT_EQ(unpack(loadedInfo, loadedAsset), meshData);
+}
+
+TEST(asset_io, shader_round_trip) {
+  // arrange
+  std::vector<char> const shaderData = makeCompressibleData(5000);
+
+  ShaderAssetInfo info;
+  info.unpackedSize = shaderData.size();
+  info.compressionMode = CompressionMode::LZ4;
+  info.shaderType = core::ShaderType::fragment;
+
+  Asset asset;
+  ASSERT_TRUE(packShader(info, shaderData, asset));
+
+  // act
+  Asset loadedAsset;
+  bool const loaded = saveAndLoad(asset, loadedAsset);
+
+  // assert
+  ASSERT_TRUE(loaded);
+  expectSameMetadata(*asset.metadata, *loadedAsset.metadata);
+
+  ShaderAssetInfo loadedInfo;
+  ASSERT_TRUE(readShaderAssetInfo(*loadedAsset.metadata, loadedInfo));
+  EXPECT_EQ(loadedInfo.unpackedSize, info.unpackedSize);
+  EXPECT_EQ(loadedInfo.compressionMode, info.compressionMode);
+  EXPECT_EQ(loadedInfo.shaderType, info.shaderType);
+  EXPECT_EQ(unpack(loadedInfo, loadedAsset), shaderData);
+}
+
+TEST(asset_io, material_round_trip_for_every_binary_version) {
+  MaterialAssetInfo const info = makeMaterialInfo();
+  std::vector<std::string> const dependencies = getMaterialDependencies(info);
+  fs::path const path = getTestDir() / "material.obsmat";
+
+  for (std::uint32_t version = lastJsonAssetVersion + 1;
+       version <= currentAssetVersion; ++version) {
+    // arrange
+    Asset asset;
+    ASSERT_TRUE(packMaterial(info, {}, asset));
+    asset.metadata->version = version;
+
+    // act
+    fs::create_directories(getTestDir());
+    ASSERT_TRUE(saveToFile(path, asset));
+
+    Asset loadedAsset;
+    bool const loaded = loadAssetFromFile(path, loadedAsset);
+
+    std::vector<std::string> loadedDependencies;
+    bool const dependenciesLoaded =
+        loadAssetDependenciesFromFile(path, loadedDependencies);
+
+    // assert
+    ASSERT_TRUE(loaded) << version;
+    expectSameMetadata(*asset.metadata, *loadedAsset.metadata);
+
+    // Older versions only name the dependencies in the info.
+    if (version >= firstDependencyTableAssetVersion) {
+      EXPECT_EQ(loadedAsset.metadata->dependencies, dependencies) << version;
+    } else {
+      EXPECT_TRUE(loadedAsset.metadata->dependencies.empty()) << version;
+    }
+
+    ASSERT_TRUE(dependenciesLoaded) << version;
+    EXPECT_EQ(loadedDependencies, dependencies) << version;
+
+    MaterialAssetInfo loadedInfo;
+    ASSERT_TRUE(readMaterialAssetInfo(*loadedAsset.metadata, loadedInfo));
+    EXPECT_EQ(loadedInfo.materialType, info.materialType);
+    EXPECT_EQ(loadedInfo.vertexShaderPath, info.vertexShaderPath);
+    EXPECT_EQ(loadedInfo.fragmentShaderPath, info.fragmentShaderPath);
+    EXPECT_EQ(loadedInfo.transparent, info.transparent);
+    EXPECT_EQ(loadedInfo.hasTimer, info.hasTimer);
+    EXPECT_EQ(getMaterialDependencies(loadedInfo), dependencies);
+  }
+}
+
+TEST(asset_io, texture_round_trip_without_section_offsets) {
+  TextureAssetInfo const info = makeTextureInfo(CompressionMode::LZ4Chunked);
+  std::vector<char> const pixels = makeCompressibleData(info.unpackedSize);
+
+  for (std::uint32_t version = lastJsonAssetVersion + 1;
+       version < firstSectionOffsetsAssetVersion; ++version) {
+    // arrange
+    Asset asset;
+    ASSERT_TRUE(packTexture(info, pixels.data(), asset));
+
+    // Older versions end the info before the mip offsets.
+    asset.metadata->version = version;
+    asset.metadata->info.resize(asset.metadata->info.size() -
+                                info.mipLevels * sizeof(std::uint64_t));
+
+    // act
+    Asset loadedAsset;
+    bool const loaded = saveAndLoad(asset, loadedAsset);
+
+    // assert
+    ASSERT_TRUE(loaded) << version;
+    expectSameMetadata(*asset.metadata, *loadedAsset.metadata);
+
+    TextureAssetInfo loadedInfo;
+    ASSERT_TRUE(readTextureAssetInfo(*loadedAsset.metadata, loadedInfo));
+    ASSERT_EQ(loadedInfo.mipOffsets.size(), info.mipLevels);
+    EXPECT_EQ(loadedInfo.mipOffsets[0], 0u);
+    EXPECT_EQ(loadedInfo.mipOffsets[1], getTextureMipSize(info, 0));
+    EXPECT_EQ(unpack(loadedInfo, loadedAsset), pixels);
+  }
+}
+
+TEST(asset_io, json_asset_round_trip) {
+  // arrange
+  std::vector<char> const pixels = makeCompressibleData(4 * 4 * 4);
+
+  Asset texture;
+  texture.metadata.emplace();
+  std::memcpy(texture.metadata->type, "texi", 4);
+  texture.metadata->version = lastJsonAssetVersion;
+  texture.metadata->info =
+      R"({"unpackedSize": 64, "compressionMode": 0, "format": 1, "width": 4,
+          "height": 4, "mipLevels": 1, "transparent": false})";
+  texture.binaryBlob = pixels;
+
+  Asset material;
+  material.metadata.emplace();
+  std::memcpy(material.metadata->type, "matl", 4);
+  material.metadata->version = lastJsonAssetVersion;
+  material.metadata->info =
+      R"({"unpackedSize": 0, "compressionMode": 0, "materialType": 2,
+          "vertexShader": "shaders/a.vert.obsshad",
+          "fragmentShader": "shaders/a.frag.obsshad",
+          "pbrData": {"albedoTex": "textures/a.obstex",
+                      "normalMapTex": "", "metalnessTex": "",
+                      "roughnessTex": "textures/b.obstex"},
+          "transparent": false, "hasTimer": false})";
+
+  fs::path const materialPath = getTestDir() / "material.obsmat";
+
+  // act
+  Asset loadedTexture;
+  bool const textureLoaded = saveAndLoad(texture, loadedTexture);
+
+  bool const materialSaved = saveToFile(materialPath, material);
+  std::vector<std::string> materialDependencies;
+  bool const dependenciesLoaded =
+      loadAssetDependenciesFromFile(materialPath, materialDependencies);
+
+  // assert
+  ASSERT_TRUE(textureLoaded);
+  expectSameMetadata(*texture.metadata, *loadedTexture.metadata);
+
+  TextureAssetInfo textureInfo;
+  ASSERT_TRUE(readTextureAssetInfo(*loadedTexture.metadata, textureInfo));
+  EXPECT_EQ(textureInfo.unpackedSize, pixels.size());
+  EXPECT_EQ(textureInfo.format, core::TextureFormat::R8G8B8A8_SRGB);
+  EXPECT_EQ(textureInfo.width, 4u);
+  EXPECT_EQ(textureInfo.mipOffsets, std::vector<std::size_t>{0});
+  EXPECT_EQ(unpack(textureInfo, loadedTexture), pixels);
+
+  ASSERT_TRUE(materialSaved);
+  ASSERT_TRUE(dependenciesLoaded);
+  EXPECT_EQ(materialDependencies,
+            (std::vector<std::string>{
+                "textures/a.obstex", "textures/b.obstex",
+                "shaders/a.vert.obsshad", "shaders/a.frag.obsshad"}));
+}
+
+TEST(asset_io, truncated_metadata_is_rejected) {
+  // arrange
+  Asset asset;
+  ASSERT_TRUE(packMaterial(makeMaterialInfo(), {}, asset));
+
+  fs::path const path = getTestDir() / "material.obsmat";
+  fs::path const truncatedPath = getTestDir() / "truncated.obsmat";
+  fs::create_directories(getTestDir());
+  ASSERT_TRUE(saveToFile(path, asset));
+
+  std::vector<char> const file = readFile(path);
+  AssetMetadata metadata;
+  std::vector<std::string> dependencies;
+  ASSERT_TRUE(readAssetMetadata(file, metadata));
+  ASSERT_TRUE(readAssetDependencies(file, dependencies));
+
+  // act, assert
+  for (std::size_t size = 0; size < file.size(); ++size) {
+    std::span<char const> const truncated(file.data(), size);
+
+    EXPECT_FALSE(readAssetMetadata(truncated, metadata)) << size;
+    EXPECT_FALSE(readAssetDependencies(truncated, dependencies)) << size;
+  }
+
+  // in the fixed metadata, the table header, a path and the info
+  for (std::size_t const size :
+       {std::size_t{10}, pathsSizeOffset, firstPathSizeOffset + 6,
+        file.size() - 1}) {
+    writeFile(truncatedPath, std::span(file.data(), size));
+
+    Asset loadedAsset;
+    EXPECT_FALSE(loadAssetFromFile(truncatedPath, loadedAsset)) << size;
+    EXPECT_FALSE(loadAssetMetadataFromFile(truncatedPath, metadata)) << size;
+  }
+
+  // The table is read on its own, so only cuts into it fail.
+  for (std::size_t const size :
+       {std::size_t{10}, pathsSizeOffset, firstPathSizeOffset + 6}) {
+    writeFile(truncatedPath, std::span(file.data(), size));
+
+    EXPECT_FALSE(loadAssetDependenciesFromFile(truncatedPath, dependencies))
+        << size;
+  }
+}
+
+TEST(asset_io, truncated_blob_is_rejected) {
+  // arrange
+  TextureAssetInfo const info = makeTextureInfo(CompressionMode::none);
+
+  Asset asset;
+  ASSERT_TRUE(
+      packTexture(info, makeCompressibleData(info.unpackedSize).data(), asset));
+
+  fs::path const path = getTestDir() / "texture.obstex";
+  fs::create_directories(getTestDir());
+  ASSERT_TRUE(saveToFile(path, asset));
+
+  std::vector<char> file = readFile(path);
+  file.pop_back();
+  writeFile(path, file);
+
+  // act
+  Asset loadedAsset;
+  bool const loaded = loadAssetFromFile(path, loadedAsset);
+
+  // assert
+  EXPECT_FALSE(loaded);
+}
+
+TEST(asset_io, inconsistent_dependency_table_is_rejected) {
+  // arrange
+  Asset asset;
+  ASSERT_TRUE(packMaterial(makeMaterialInfo(), {}, asset));
+
+  fs::path const path = getTestDir() / "material.obsmat";
+  fs::create_directories(getTestDir());
+  ASSERT_TRUE(saveToFile(path, asset));
+
+  std::vector<char> const file = readFile(path);
+
+  std::vector<char> pathsTooLarge = file;
+  writeAt<std::uint32_t>(pathsTooLarge, pathsSizeOffset,
+                         static_cast<std::uint32_t>(file.size()));
+
+  std::vector<char> pathTooLarge = file;
+  writeAt<std::uint32_t>(pathTooLarge, firstPathSizeOffset,
+                         static_cast<std::uint32_t>(file.size()));
+
+  std::vector<char> tooManyPaths = file;
+  writeAt<std::uint32_t>(
+      tooManyPaths, dependencyCountOffset,
+      static_cast<std::uint32_t>(asset.metadata->dependencies.size() + 1));
+
+  std::vector<char> hugePathCount = file;
+  writeAt<std::uint32_t>(hugePathCount, dependencyCountOffset, UINT32_MAX);
+
+  AssetMetadata metadata;
+  std::vector<std::string> dependencies;
+
+  // act, assert
+  for (std::vector<char> const& corrupt :
+       {pathsTooLarge, pathTooLarge, tooManyPaths, hugePathCount}) {
+    EXPECT_FALSE(readAssetMetadata(corrupt, metadata));
+    EXPECT_FALSE(readAssetDependencies(corrupt, dependencies));
+
+    writeFile(path, corrupt);
+    EXPECT_FALSE(loadAssetDependenciesFromFile(path, dependencies));
+  }
+}
+
+TEST(asset_io, oversized_info_size_is_rejected) {
+  // arrange
+  Asset asset;
+  ASSERT_TRUE(packMaterial(makeMaterialInfo(), {}, asset));
+
+  // Older versions name the dependencies in the info instead of a table.
+  Asset infoDependencyAsset = asset;
+  infoDependencyAsset.metadata->version = firstDependencyTableAssetVersion - 1;
+
+  fs::path const path = getTestDir() / "material.obsmat";
+  fs::create_directories(getTestDir());
+
+  AssetMetadata metadata;
+  std::vector<std::string> dependencies;
+
+  for (Asset const* saved : {&asset, &infoDependencyAsset}) {
+    ASSERT_TRUE(saveToFile(path, *saved));
+    std::vector<char> const file = readFile(path);
+
+    // one past the end of the file and more than can be allocated
+    for (std::uint64_t const infoSize :
+         {std::uint64_t{file.size() - fixedMetadataSize + 1},
+          std::uint64_t{1} << 48}) {
+      std::vector<char> corrupt = file;
+      writeAt<std::uint64_t>(corrupt, infoSizeOffset, infoSize);
+      writeFile(path, corrupt);
+
+      // act, assert
+      EXPECT_FALSE(loadAssetMetadataFromFile(path, metadata)) << infoSize;
+      EXPECT_FALSE(loadAssetDependenciesFromFile(path, dependencies))
+          << infoSize;
+    }
+  }
+}
+
+TEST(asset_io, unordered_index_buffer_offsets_are_rejected) {
+  // arrange
+  MeshAssetInfo info;
+  info.compressionMode = CompressionMode::none;
+  info.vertexCount = 4;
+  info.vertexBufferSize = 4 * 8 * sizeof(float);
+  info.indexBufferSizes = {6 * sizeof(std::uint32_t),
+                           6 * sizeof(std::uint32_t)};
+  info.indexCount = 12;
+  cookMeshLayout(info);
+
+  MeshAssetInfo swapped = info;
+  std::swap(swapped.indexBufferOffsets[0], swapped.indexBufferOffsets[1]);
+
+  MeshAssetInfo overlapping = info;
+  overlapping.indexBufferOffsets[1] = overlapping.indexBufferOffsets[0] + 4;
+
+  // act, assert
+  for (MeshAssetInfo const& corrupt : {swapped, overlapping}) {
+    Asset asset;
+    EXPECT_FALSE(packMeshAsset(
+        corrupt, makeCompressibleData(corrupt.unpackedSize), asset));
+  }
+}
+
+TEST(asset_io, oversized_mesh_info_counts_are_rejected) {
+  // arrange
+  // Offsets of the counts in the mesh info header.
+  constexpr std::size_t indexBufferCountOffset = 64;
+  constexpr std::size_t defaultMatPathCountOffset = 68;
+  constexpr std::uint32_t hugeCount = 0xFFFFFFFF;
+
+  MeshAssetInfo info;
+  info.compressionMode = CompressionMode::none;
+  info.vertexCount = 4;
+  info.vertexBufferSize = 4 * 8 * sizeof(float);
+  info.indexBufferSizes = {6 * sizeof(std::uint32_t)};
+  info.indexCount = 6;
+  info.defaultMatRelativePaths = {"materials/a.obsmat"};
+  cookMeshLayout(info);
+
+  Asset asset;
+  ASSERT_TRUE(
+      packMeshAsset(info, makeCompressibleData(info.unpackedSize), asset));
+
+  // act, assert
+  for (std::size_t const countOffset :
+       {indexBufferCountOffset, defaultMatPathCountOffset}) {
+    AssetMetadata corrupt = *asset.metadata;
+    std::memcpy(corrupt.info.data() + countOffset, &hugeCount,
+                sizeof(hugeCount));
+
+    MeshAssetInfo loadedInfo;
+    EXPECT_FALSE(readMeshAssetInfo(corrupt, loadedInfo)) << countOffset;
+  }
+}
+
+TEST(asset_io, invalid_texture_mip_level_count_is_rejected) {
+  // arrange
+  // Offset of the mip level count in the texture info header.
+  constexpr std::size_t mipLevelsOffset = 24;
+
+  TextureAssetInfo const info = makeTextureInfo(CompressionMode::none);
+
+  Asset asset;
+  ASSERT_TRUE(
+      packTexture(info, makeCompressibleData(info.unpackedSize).data(), asset));
+
+  // act, assert
+  // A 64x32 texture has at most 7 mip levels.
+  for (std::uint32_t const mipLevels : {0u, 8u, 40u}) {
+    AssetMetadata corrupt = *asset.metadata;
+    std::memcpy(corrupt.info.data() + mipLevelsOffset, &mipLevels,
+                sizeof(mipLevels));
+
+    TextureAssetInfo loadedInfo;
+    EXPECT_FALSE(readTextureAssetInfo(corrupt, loadedInfo)) << mipLevels;
+  }
+}
+
+TEST(asset_io, blob_size_mismatch_is_rejected) {
+  // arrange
+  std::vector<char> const shaderData = makeCompressibleData(5000);
+
+  ShaderAssetInfo info;
+  info.unpackedSize = shaderData.size();
+  info.shaderType = core::ShaderType::fragment;
+
+  info.compressionMode = CompressionMode::none;
+  Asset oversized;
+  ASSERT_TRUE(packShader(info, shaderData, oversized));
+  oversized.binaryBlob.push_back(0);
+
+  info.compressionMode = CompressionMode::LZ4;
+  Asset shortLZ4;
+  ASSERT_TRUE(packShader(info, shaderData, shortLZ4));
+
+  ShaderAssetInfo largerInfo = info;
+  largerInfo.unpackedSize = shaderData.size() + 1;
+
+  // act
+  std::vector<char> dst(largerInfo.unpackedSize);
+  info.compressionMode = CompressionMode::none;
+  bool const oversizedUnpacked = unpackAsset(info, oversized, dst.data());
+  bool const shortLZ4Unpacked = unpackAsset(largerInfo, shortLZ4, dst.data());
+
+  // assert
+  EXPECT_FALSE(oversizedUnpacked);
+  EXPECT_FALSE(shortLZ4Unpacked);
+}
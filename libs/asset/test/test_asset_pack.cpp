@@ -0,0 +1,279 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/asset_pack.hpp>
+#include <obsidian/asset/material_asset_info.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/core/material.hpp>
+#include <obsidian/core/texture_format.hpp>
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+using namespace obsidian::asset::test;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char const* texturePath = "textures/albedo.obstex";
+constexpr char const* materialPath = "materials/rock.obsmat";
+constexpr char const* meshPath = "meshes/rock.obsmesh";
+
+fs::path getPackPath() { return getTestDir() / projectAssetPackName; }
+
+// A mesh whose default material uses a texture and two shaders that aren't
+// part of the project.
+bool createProject() {
+  fs::remove_all(getTestDir());
+
+  TextureAssetInfo textureInfo;
+  textureInfo.compressionMode = CompressionMode::LZ4;
+  textureInfo.format = core::TextureFormat::R8G8B8A8_SRGB;
+  textureInfo.width = 16;
+  textureInfo.height = 16;
+  textureInfo.mipLevels = 1;
+  textureInfo.transparent = false;
+  textureInfo.unpackedSize = getTextureMipSize(textureInfo, 0);
+
+  std::vector<char> const pixels(textureInfo.unpackedSize, 7);
+  Asset texture;
+
+  MaterialAssetInfo materialInfo;
+  materialInfo.unpackedSize = 0;
+  materialInfo.compressionMode = CompressionMode::none;
+  materialInfo.materialType = core::MaterialType::unlit;
+  materialInfo.materialSubtypeData = UnlitMaterialAssetData{texturePath};
+  materialInfo.vertexShaderPath = "shaders/unlit.vert.obsshad";
+  materialInfo.fragmentShaderPath = "shaders/unlit.frag.obsshad";
+  materialInfo.transparent = false;
+  materialInfo.hasTimer = false;
+
+  Asset material;
+
+  MeshAssetInfo meshInfo;
+  meshInfo.compressionMode = CompressionMode::none;
+  meshInfo.vertexCount = 3;
+  meshInfo.vertexBufferSize = 3 * 3 * sizeof(float);
+  meshInfo.indexBufferSizes = {3 * sizeof(std::uint32_t)};
+  meshInfo.indexCount = 3;
+  meshInfo.defaultMatRelativePaths = {materialPath};
+  meshInfo.hasNormals = false;
+  meshInfo.hasColors = false;
+  meshInfo.hasUV = false;
+  meshInfo.hasTangents = false;
+  cookMeshLayout(meshInfo);
+
+  Asset mesh;
+
+  return packTexture(textureInfo, pixels.data(), texture) &&
+         saveToFile(getTestDir() / texturePath, texture) &&
+         packMaterial(materialInfo, {}, material) &&
+         saveToFile(getTestDir() / materialPath, material) &&
+         packMeshAsset(meshInfo,
+                       std::vector<char>(meshInfo.unpackedSize, 1), mesh) &&
+         saveToFile(getTestDir() / meshPath, mesh);
+}
+
+// Dependents are listed before their dependencies, so the pack has to reorder
+// them.
+bool buildProjectPack() {
+  std::array<fs::path, 3> const paths = {meshPath, materialPath, texturePath};
+
+  return createProject() &&
+         buildAssetPack(getTestDir(), paths, getPackPath());
+}
+
+} /*namespace*/
+
+TEST(asset_pack, loads_the_same_assets_as_the_loose_files) {
+  // arrange
+  ASSERT_TRUE(buildProjectPack());
+
+  AssetPack pack;
+  ASSERT_TRUE(pack.open(getPackPath()));
+
+  for (char const* const path : {texturePath, materialPath, meshPath}) {
+    // act
+    Asset packedAsset;
+    bool const packedLoaded = pack.loadAsset(path, packedAsset);
+
+    Asset looseAsset;
+    bool const looseLoaded =
+        loadAssetFromFile(getTestDir() / path, looseAsset);
+
+    // assert
+    ASSERT_TRUE(packedLoaded) << path;
+    ASSERT_TRUE(looseLoaded) << path;
+    EXPECT_EQ(packedAsset.metadata->info, looseAsset.metadata->info) << path;
+    EXPECT_EQ(packedAsset.metadata->dependencies,
+              looseAsset.metadata->dependencies)
+        << path;
+
+    std::span<char const> const packedBlob = getBinaryBlob(packedAsset);
+    std::span<char const> const looseBlob = getBinaryBlob(looseAsset);
+    EXPECT_TRUE(std::equal(packedBlob.begin(), packedBlob.end(),
+                           looseBlob.begin(), looseBlob.end()))
+        << path;
+  }
+
+  EXPECT_EQ(pack.getAssetCount(), 3u);
+}
+
+TEST(asset_pack, lookups_normalize_paths) {
+  // arrange
+  ASSERT_TRUE(buildProjectPack());
+
+  AssetPack pack;
+  ASSERT_TRUE(pack.open(getPackPath()));
+
+  std::optional<AssetPackRange> const range = pack.findAssetRange(texturePath);
+  ASSERT_TRUE(range);
+
+  // act, assert
+  for (char const* const path :
+       {"./textures/albedo.obstex", "textures/./albedo.obstex",
+        "materials/../textures/albedo.obstex", "textures//albedo.obstex"}) {
+    std::optional<AssetPackRange> const found = pack.findAssetRange(path);
+
+    ASSERT_TRUE(found) << path;
+    EXPECT_EQ(found->offset, range->offset) << path;
+    EXPECT_EQ(found->size, range->size) << path;
+  }
+
+  EXPECT_FALSE(pack.contains("textures/albedo"));
+  EXPECT_FALSE(pack.contains("textures/missing.obstex"));
+  EXPECT_FALSE(pack.contains("albedo.obstex"));
+  EXPECT_FALSE(pack.contains(""));
+}
+
+TEST(asset_pack, dependencies_are_stored_before_their_dependents) {
+  // arrange
+  ASSERT_TRUE(buildProjectPack());
+
+  AssetPack pack;
+  ASSERT_TRUE(pack.open(getPackPath()));
+
+  // act
+  std::optional<AssetPackRange> const texture =
+      pack.findAssetRange(texturePath);
+  std::optional<AssetPackRange> const material =
+      pack.findAssetRange(materialPath);
+  std::optional<AssetPackRange> const mesh = pack.findAssetRange(meshPath);
+
+  // assert
+  ASSERT_TRUE(texture && material && mesh);
+  EXPECT_LE(texture->offset + texture->size, material->offset);
+  EXPECT_LE(material->offset + material->size, mesh->offset);
+  EXPECT_EQ(texture->offset % assetPackAlignment, 0u);
+  EXPECT_EQ(material->offset % assetPackAlignment, 0u);
+  EXPECT_EQ(mesh->offset % assetPackAlignment, 0u);
+}
+
+TEST(asset_pack, lookups_compare_paths_of_equal_hashes) {
+  // arrange
+  // Two entries with the hash of a.obstex, only the second one stores it.
+  std::string const paths = "b.obstexa.obstex";
+  std::uint64_t const hash = getAssetPathHash("a.obstex");
+
+  AssetPackHeader header;
+  std::memcpy(header.magic, "obpk", 4);
+  header.version = currentAssetPackVersion;
+  header.assetCount = 2;
+  header.tocOffset = assetPackAlignment;
+  header.pathsOffset = header.tocOffset + 2 * sizeof(AssetPackTocEntry);
+
+  std::size_t const firstAssetOffset = 4 * assetPackAlignment;
+  std::array<AssetPackTocEntry, 2> const toc = {
+      {{hash, firstAssetOffset, 10, 0, 8},
+       {hash, firstAssetOffset + assetPackAlignment, 20, 8, 8}}};
+
+  std::vector<char> file(6 * assetPackAlignment);
+  std::memcpy(file.data(), &header, sizeof(header));
+  std::memcpy(file.data() + header.tocOffset, toc.data(), sizeof(toc));
+  std::memcpy(file.data() + header.pathsOffset, paths.data(), paths.size());
+
+  fs::create_directories(getTestDir());
+  writeFile(getPackPath(), file);
+
+  AssetPack pack;
+  ASSERT_TRUE(pack.open(getPackPath()));
+
+  // act
+  std::optional<AssetPackRange> const found = pack.findAssetRange("a.obstex");
+
+  // assert
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found->offset, firstAssetOffset + assetPackAlignment);
+  EXPECT_EQ(found->size, 20u);
+  EXPECT_FALSE(pack.contains("b.obstex"));
+}
+
+TEST(asset_pack, corrupt_toc_is_rejected) {
+  // arrange
+  ASSERT_TRUE(buildProjectPack());
+
+  std::vector<char> const file = readFile(getPackPath());
+  std::size_t const tocOffset =
+      readAt<std::uint64_t>(file, offsetof(AssetPackHeader, tocOffset));
+  std::size_t const entryOffset =
+      tocOffset + offsetof(AssetPackTocEntry, offset);
+  std::size_t const entrySize = tocOffset + offsetof(AssetPackTocEntry, size);
+  std::size_t const entryPathOffset =
+      tocOffset + offsetof(AssetPackTocEntry, pathOffset);
+
+  std::vector<std::vector<char>> corruptPacks;
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint64_t>(corruptPacks.back(), entryOffset, file.size() + 1);
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint64_t>(corruptPacks.back(), entrySize, file.size());
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint64_t>(corruptPacks.back(), entryOffset, UINT64_MAX);
+  writeAt<std::uint64_t>(corruptPacks.back(), entrySize, 2);
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint32_t>(corruptPacks.back(), entryPathOffset,
+                         static_cast<std::uint32_t>(file.size()));
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint64_t>(corruptPacks.back(),
+                         offsetof(AssetPackHeader, tocOffset),
+                         file.size() + assetPackAlignment);
+
+  corruptPacks.push_back(file);
+  writeAt<std::uint64_t>(corruptPacks.back(),
+                         offsetof(AssetPackHeader, assetCount),
+                         file.size() / sizeof(AssetPackTocEntry));
+
+  corruptPacks.emplace_back(file.begin(), file.begin() + tocOffset + 10);
+
+  AssetPack pack;
+
+  for (std::size_t i = 0; i < corruptPacks.size(); ++i) {
+    writeFile(getPackPath(), corruptPacks[i]);
+
+    // act
+    bool const opened = pack.open(getPackPath());
+
+    // assert
+    EXPECT_FALSE(opened) << i;
+    EXPECT_FALSE(pack.isOpen()) << i;
+  }
+}
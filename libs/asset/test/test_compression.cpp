@@ -0,0 +1,286 @@
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+using namespace obsidian::asset::test;
+
+namespace {
+
+constexpr std::array<CompressionMode, 5> allCompressionModes = {
+    CompressionMode::none, CompressionMode::LZ4, CompressionMode::LZ4Chunked,
+    CompressionMode::LZ4HC, CompressionMode::zstd};
+
+constexpr std::array<CompressionMode, 3> chunkedCompressionModes = {
+    CompressionMode::LZ4Chunked, CompressionMode::LZ4HC,
+    CompressionMode::zstd};
+
+// Layout of the chunk table at the start of chunked blobs.
+constexpr std::size_t chunkSizeOffset = 8;
+constexpr std::size_t chunkCountOffset = 12;
+constexpr std::size_t chunkEndsOffset = 16;
+
+std::vector<char> makeRandomData(std::size_t size) {
+  std::mt19937 rng{size};
+  std::uniform_int_distribution<int> byte{0, 255};
+  std::vector<char> data(size);
+
+  for (char& c : data) {
+    c = static_cast<char>(byte(rng));
+  }
+
+  return data;
+}
+
+bool roundTrips(CompressionMode mode, std::vector<char> const& data) {
+  std::vector<char> packed;
+
+  if (!compress(mode, data, packed)) {
+    return false;
+  }
+
+  AssetInfo const info{data.size(), mode};
+  std::vector<char> unpacked(data.size());
+
+  return unpackAsset(info, packed.data(), packed.size(), unpacked.data()) &&
+         unpacked == data;
+}
+
+std::vector<char> makeChunkedBlob(std::vector<char> const& data) {
+  std::vector<char> packed;
+  compressChunked(CompressionMode::LZ4Chunked, data, packed);
+  return packed;
+}
+
+bool decompresses(std::vector<char> const& packed, std::size_t unpackedSize) {
+  std::vector<char> unpacked(unpackedSize);
+  return decompressChunked(CompressionMode::LZ4Chunked, packed, unpacked);
+}
+
+} /*namespace*/
+
+TEST(compression, round_trip_empty_data) {
+  for (CompressionMode const mode : allCompressionModes) {
+    EXPECT_TRUE(roundTrips(mode, {})) << static_cast<int>(mode);
+  }
+}
+
+TEST(compression, round_trip_data_smaller_than_a_chunk) {
+  std::vector<char> const data = makeCompressibleData(1000);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    EXPECT_TRUE(roundTrips(mode, data)) << static_cast<int>(mode);
+  }
+}
+
+TEST(compression, round_trip_whole_chunks) {
+  std::vector<char> const data =
+      makeCompressibleData(3 * compressionChunkSize);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    EXPECT_TRUE(roundTrips(mode, data)) << static_cast<int>(mode);
+  }
+}
+
+TEST(compression, round_trip_partial_last_chunk) {
+  std::vector<char> const data =
+      makeCompressibleData(2 * compressionChunkSize + 12345);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    EXPECT_TRUE(roundTrips(mode, data)) << static_cast<int>(mode);
+  }
+}
+
+TEST(compression, round_trip_chunks_split_at_sections) {
+  // arrange
+  std::vector<char> const data =
+      makeCompressibleData(2 * compressionChunkSize + 12345);
+  std::array<std::size_t, 3> const sectionOffsets = {
+      100, compressionChunkSize + 7, compressionChunkSize + 8};
+
+  for (CompressionMode const mode : chunkedCompressionModes) {
+    // act
+    std::vector<char> packed;
+    bool const compressed =
+        compressChunked(mode, data, packed, {}, task::TaskType::general,
+                        sectionOffsets);
+
+    std::vector<char> unpacked(data.size());
+    bool const decompressed = decompressChunked(mode, packed, unpacked);
+
+    // assert
+    ASSERT_TRUE(compressed);
+    EXPECT_EQ(readAt<std::uint32_t>(packed, chunkSizeOffset), 0);
+    EXPECT_TRUE(decompressed);
+    EXPECT_EQ(unpacked, data);
+  }
+}
+
+TEST(compression, round_trip_in_parallel) {
+  // arrange
+  task::TaskExecutor executor;
+  executor.initAndRun({{task::TaskType::general, 3}});
+
+  std::vector<char> const data =
+      makeCompressibleData(8 * compressionChunkSize + 1);
+
+  for (CompressionMode const mode : chunkedCompressionModes) {
+    // act
+    std::vector<char> packed;
+    bool const compressed = compressChunked(mode, data, packed,
+                                            {.taskExecutor = &executor});
+
+    std::vector<char> unpacked(data.size());
+    bool const decompressed = decompressChunked(
+        mode, packed, unpacked, &executor, task::TaskType::general);
+
+    // assert
+    EXPECT_TRUE(compressed);
+    EXPECT_TRUE(decompressed);
+    EXPECT_EQ(unpacked, data);
+  }
+
+  executor.shutdown();
+}
+
+TEST(compression, uncompressible_chunks_are_stored_raw) {
+  // arrange
+  std::vector<char> const data =
+      makeRandomData(2 * compressionChunkSize + 12345);
+  std::size_t const chunkCount = 3;
+
+  for (CompressionMode const mode : chunkedCompressionModes) {
+    // act
+    std::vector<char> packed;
+    bool const compressed = compressChunked(mode, data, packed);
+
+    std::vector<char> unpacked(data.size());
+    bool const decompressed = decompressChunked(mode, packed, unpacked);
+
+    // assert
+    ASSERT_TRUE(compressed);
+    ASSERT_EQ(readAt<std::uint32_t>(packed, chunkCountOffset), chunkCount);
+    EXPECT_EQ(packed.size(),
+              chunkEndsOffset + chunkCount * sizeof(std::uint64_t) +
+                  data.size());
+    EXPECT_EQ(readAt<std::uint64_t>(packed, chunkEndsOffset),
+              compressionChunkSize);
+    EXPECT_TRUE(decompressed);
+    EXPECT_EQ(unpacked, data);
+  }
+}
+
+TEST(compression, non_chunked_mode_is_rejected) {
+  std::vector<char> packed;
+
+  EXPECT_FALSE(compressChunked(CompressionMode::LZ4, makeCompressibleData(10),
+                               packed));
+}
+
+TEST(compression, truncated_chunk_table_is_rejected) {
+  // arrange
+  std::vector<char> const data =
+      makeCompressibleData(3 * compressionChunkSize + 100);
+  std::vector<char> const packed = makeChunkedBlob(data);
+
+  std::vector<char> const truncatedHeader(packed.begin(),
+                                          packed.begin() + chunkEndsOffset - 1);
+  std::vector<char> const truncatedEnds(
+      packed.begin(), packed.begin() + chunkEndsOffset + sizeof(std::uint64_t));
+  std::vector<char> const truncatedChunks(packed.begin(), packed.end() - 1);
+
+  // act, assert
+  EXPECT_TRUE(decompresses(packed, data.size()));
+  EXPECT_FALSE(decompresses({}, data.size()));
+  EXPECT_FALSE(decompresses(truncatedHeader, data.size()));
+  EXPECT_FALSE(decompresses(truncatedEnds, data.size()));
+  EXPECT_FALSE(decompresses(truncatedChunks, data.size()));
+}
+
+TEST(compression, inconsistent_chunk_table_is_rejected) {
+  // arrange
+  std::vector<char> const data =
+      makeCompressibleData(3 * compressionChunkSize + 100);
+  std::vector<char> const packed = makeChunkedBlob(data);
+
+  std::vector<char> wrongChunkCount = packed;
+  writeAt<std::uint32_t>(wrongChunkCount, chunkCountOffset, 3);
+
+  std::vector<char> wrongChunkSize = packed;
+  writeAt<std::uint32_t>(wrongChunkSize, chunkSizeOffset,
+                         compressionChunkSize / 2);
+
+  std::vector<char> unsortedEnds = packed;
+  writeAt<std::uint64_t>(unsortedEnds, chunkEndsOffset,
+                         readAt<std::uint64_t>(packed, chunkEndsOffset + 8) +
+                             1);
+
+  // act, assert
+  EXPECT_FALSE(decompresses(packed, data.size() - 1));
+  EXPECT_FALSE(decompresses(packed, data.size() + 1));
+  EXPECT_FALSE(decompresses(wrongChunkCount, data.size()));
+  EXPECT_FALSE(decompresses(wrongChunkSize, data.size()));
+  EXPECT_FALSE(decompresses(unsortedEnds, data.size()));
+}
+
+TEST(compression, inconsistent_unpacked_chunk_ends_are_rejected) {
+  // arrange
+  std::vector<char> const data =
+      makeCompressibleData(2 * compressionChunkSize + 100);
+  std::array<std::size_t, 1> const sectionOffsets = {1000};
+
+  std::vector<char> packed;
+  ASSERT_TRUE(compressChunked(CompressionMode::LZ4Chunked, data, packed, {},
+                              task::TaskType::general, sectionOffsets));
+
+  std::uint32_t const chunkCount =
+      readAt<std::uint32_t>(packed, chunkCountOffset);
+  std::size_t const unpackedEndsOffset =
+      chunkEndsOffset + chunkCount * sizeof(std::uint64_t);
+  std::size_t const lastUnpackedEndOffset =
+      unpackedEndsOffset + (chunkCount - 1) * sizeof(std::uint64_t);
+
+  std::vector<char> shortEnd = packed;
+  writeAt<std::uint64_t>(shortEnd, lastUnpackedEndOffset, data.size() - 1);
+
+  std::vector<char> unsortedEnds = packed;
+  writeAt<std::uint64_t>(unsortedEnds, unpackedEndsOffset, data.size());
+
+  std::vector<char> const truncatedEnds(
+      packed.begin(), packed.begin() + lastUnpackedEndOffset);
+
+  // act, assert
+  EXPECT_TRUE(decompresses(packed, data.size()));
+  EXPECT_FALSE(decompresses(shortEnd, data.size()));
+  EXPECT_FALSE(decompresses(unsortedEnds, data.size()));
+  EXPECT_FALSE(decompresses(truncatedEnds, data.size()));
+}
+
+TEST(compression, corrupt_chunk_is_rejected) {
+  // arrange
+  std::vector<char> const data = makeCompressibleData(compressionChunkSize);
+  std::vector<char> packed = makeChunkedBlob(data);
+
+  // The chunk compressed well, so it can't be mistaken for a raw one.
+  ASSERT_LT(packed.size(), data.size() / 2);
+
+  for (std::size_t i = chunkEndsOffset + sizeof(std::uint64_t);
+       i < packed.size(); ++i) {
+    packed[i] = static_cast<char>(0xff);
+  }
+
+  // act, assert
+  EXPECT_FALSE(decompresses(packed, data.size()));
+}
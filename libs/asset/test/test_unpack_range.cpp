@@ -0,0 +1,262 @@
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
+#include <obsidian/asset/mesh_asset_info.hpp>
+#include <obsidian/asset/texture_asset_info.hpp>
+#include <obsidian/asset/utility.hpp>
+#include <obsidian/core/texture_format.hpp>
+
+#include "test_utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::asset;
+using namespace obsidian::asset::test;
+
+namespace {
+
+constexpr std::array<CompressionMode, 5> allCompressionModes = {
+    CompressionMode::none, CompressionMode::LZ4, CompressionMode::LZ4Chunked,
+    CompressionMode::LZ4HC, CompressionMode::zstd};
+
+constexpr std::size_t unpackedSize = 3 * compressionChunkSize + 1000;
+
+Asset packAsset(CompressionMode mode, std::vector<char> const& data,
+                std::span<std::size_t const> sectionOffsets = {}) {
+  Asset asset;
+  compress(mode, data, asset.binaryBlob, {}, sectionOffsets);
+  return asset;
+}
+
+// Unpacks the range and compares it with the same range of the data the asset
+// was packed from.
+void expectRangeMatches(AssetInfo const& info, Asset const& asset,
+                        std::vector<char> const& data, std::size_t offset,
+                        std::size_t size) {
+  std::vector<char> range(size);
+
+  ASSERT_TRUE(unpackAssetRange(info, asset, offset, range))
+      << "mode " << static_cast<int>(info.compressionMode) << ", offset "
+      << offset << ", size " << size;
+  EXPECT_TRUE(std::equal(range.cbegin(), range.cend(), data.cbegin() + offset))
+      << "mode " << static_cast<int>(info.compressionMode) << ", offset "
+      << offset << ", size " << size;
+}
+
+struct Range {
+  std::size_t offset;
+  std::size_t size;
+};
+
+void expectRangesMatch(std::span<Range const> ranges,
+                       std::span<std::size_t const> sectionOffsets = {}) {
+  std::vector<char> const data = makeCompressibleData(unpackedSize);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    Asset const asset = packAsset(mode, data, sectionOffsets);
+    AssetInfo const info{unpackedSize, mode};
+
+    std::vector<char> unpacked(unpackedSize);
+    ASSERT_TRUE(unpackAsset(info, asset, unpacked.data()));
+    ASSERT_EQ(unpacked, data);
+
+    for (Range const range : ranges) {
+      expectRangeMatches(info, asset, data, range.offset, range.size);
+    }
+  }
+}
+
+} /*namespace*/
+
+TEST(unpack_range, range_inside_one_chunk) {
+  std::array<Range, 3> const ranges = {{{100, 1000},
+                                        {compressionChunkSize + 5, 300},
+                                        {compressionChunkSize, 1}}};
+
+  expectRangesMatch(ranges);
+}
+
+TEST(unpack_range, range_across_chunk_edges) {
+  std::array<Range, 3> const ranges = {
+      {{compressionChunkSize - 10, 20},
+       {compressionChunkSize - 1, compressionChunkSize + 2},
+       {compressionChunkSize, 2 * compressionChunkSize}}};
+
+  expectRangesMatch(ranges);
+}
+
+TEST(unpack_range, range_at_offset_zero) {
+  std::array<Range, 3> const ranges = {
+      {{0, 1}, {0, compressionChunkSize}, {0, unpackedSize}}};
+
+  expectRangesMatch(ranges);
+}
+
+TEST(unpack_range, range_ending_at_unpacked_size) {
+  std::array<Range, 3> const ranges = {
+      {{unpackedSize - 1, 1},
+       {unpackedSize - 1000, 1000},
+       {compressionChunkSize - 1, unpackedSize - compressionChunkSize + 1}}};
+
+  expectRangesMatch(ranges);
+}
+
+TEST(unpack_range, zero_length_ranges) {
+  std::array<Range, 4> const ranges = {{{0, 0},
+                                        {compressionChunkSize, 0},
+                                        {compressionChunkSize + 5, 0},
+                                        {unpackedSize, 0}}};
+
+  expectRangesMatch(ranges);
+}
+
+TEST(unpack_range, ranges_of_blob_split_at_sections) {
+  std::array<std::size_t, 3> const sectionOffsets = {
+      1000, compressionChunkSize + 1000, compressionChunkSize + 1256};
+  std::array<Range, 6> const ranges = {{{0, 1000},
+                                        {999, 2},
+                                        {1000, compressionChunkSize},
+                                        {compressionChunkSize + 1000, 256},
+                                        {500, unpackedSize - 500},
+                                        {compressionChunkSize + 1000, 0}}};
+
+  expectRangesMatch(ranges, sectionOffsets);
+}
+
+TEST(unpack_range, out_of_bounds_range_is_rejected) {
+  // arrange
+  std::vector<char> const data = makeCompressibleData(unpackedSize);
+  std::vector<char> range(10);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    Asset const asset = packAsset(mode, data);
+    AssetInfo const info{unpackedSize, mode};
+
+    // act, assert
+    EXPECT_FALSE(unpackAssetRange(info, asset, unpackedSize - 9, range));
+    EXPECT_FALSE(unpackAssetRange(info, asset, unpackedSize + 1, {}));
+    EXPECT_FALSE(unpackAssetRange(info, asset, SIZE_MAX, range));
+  }
+}
+
+TEST(unpack_range, texture_mips_match_full_unpack) {
+  // arrange
+  TextureAssetInfo info;
+  info.format = core::TextureFormat::R8G8B8A8_SRGB;
+  info.width = 512;
+  info.height = 512;
+  info.mipLevels = 10;
+  info.transparent = false;
+
+  std::size_t packedSize = 0;
+
+  for (std::uint32_t mip = 0; mip < info.mipLevels; ++mip) {
+    packedSize += getTextureMipSize(info, mip);
+  }
+
+  std::vector<char> const pixels = makeCompressibleData(packedSize);
+  std::vector<char> cookedPixels;
+  cookTexture(info, pixels.data(), cookedPixels);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    info.compressionMode = mode;
+
+    Asset asset;
+    ASSERT_TRUE(packTexture(info, cookedPixels.data(), asset));
+
+    std::vector<char> unpacked(info.unpackedSize);
+    ASSERT_TRUE(unpackAsset(info, asset, unpacked.data()));
+    ASSERT_EQ(unpacked, cookedPixels);
+
+    for (std::uint32_t firstMip = 0; firstMip < info.mipLevels; ++firstMip) {
+      for (std::uint32_t mipCount : {1u, info.mipLevels - firstMip}) {
+        // act
+        std::vector<char> mips(getTextureMipsSize(info, firstMip, mipCount));
+        bool const success =
+            unpackTextureMips(info, asset, firstMip, mipCount, mips);
+
+        // assert
+        ASSERT_TRUE(success) << static_cast<int>(mode) << ", mip " << firstMip;
+        EXPECT_TRUE(std::equal(mips.cbegin(), mips.cend(),
+                               unpacked.cbegin() +
+                                   getTextureMipsOffset(info, firstMip)))
+            << static_cast<int>(mode) << ", mip " << firstMip;
+      }
+    }
+
+    std::vector<char> tooSmall(getTextureMipSize(info, 0) - 1);
+    EXPECT_FALSE(unpackTextureMips(info, asset, 0, 1, tooSmall));
+    EXPECT_FALSE(unpackTextureMips(info, asset, 0, info.mipLevels + 1,
+                                   tooSmall));
+    EXPECT_FALSE(unpackTextureMips(info, asset, info.mipLevels, 1, tooSmall));
+  }
+}
+
+TEST(unpack_range, mesh_buffers_match_full_unpack) {
+  // arrange
+  MeshAssetInfo info;
+  info.vertexCount = 100;
+  info.vertexBufferSize = compressionChunkSize + 1000;
+  info.indexBufferSizes = {600, 2 * compressionChunkSize + 4, 12};
+  info.indexCount = 0;
+  info.hasNormals = true;
+  info.hasColors = false;
+  info.hasUV = true;
+  info.hasTangents = false;
+
+  for (std::size_t const size : info.indexBufferSizes) {
+    info.indexCount += size / sizeof(std::uint32_t);
+  }
+
+  cookMeshLayout(info);
+  std::vector<char> const meshData = makeCompressibleData(info.unpackedSize);
+
+  for (CompressionMode const mode : allCompressionModes) {
+    info.compressionMode = mode;
+
+    Asset asset;
+    ASSERT_TRUE(packMeshAsset(info, meshData, asset));
+
+    std::vector<char> unpacked(info.unpackedSize);
+    ASSERT_TRUE(unpackAsset(info, asset, unpacked.data()));
+    ASSERT_EQ(unpacked, meshData);
+
+    // act
+    std::vector<char> vertexBuffer(info.vertexBufferSize);
+    bool const vertexBufferUnpacked =
+        unpackMeshVertexBuffer(info, asset, vertexBuffer);
+
+    // assert
+    ASSERT_TRUE(vertexBufferUnpacked) << static_cast<int>(mode);
+    EXPECT_TRUE(std::equal(vertexBuffer.cbegin(), vertexBuffer.cend(),
+                           unpacked.cbegin()))
+        << static_cast<int>(mode);
+
+    for (std::size_t i = 0; i < info.indexBufferSizes.size(); ++i) {
+      // act
+      std::vector<char> indexBuffer(info.indexBufferSizes[i]);
+      bool const indexBufferUnpacked =
+          unpackMeshIndexBuffer(info, asset, i, indexBuffer);
+
+      // assert
+      ASSERT_TRUE(indexBufferUnpacked) << static_cast<int>(mode) << ", " << i;
+      EXPECT_TRUE(std::equal(indexBuffer.cbegin(), indexBuffer.cend(),
+                             unpacked.cbegin() + info.indexBufferOffsets[i]))
+          << static_cast<int>(mode) << ", " << i;
+    }
+
+    std::vector<char> wrongSize(info.indexBufferSizes[0] + 1);
+    EXPECT_FALSE(unpackMeshIndexBuffer(info, asset, 0, wrongSize));
+    EXPECT_FALSE(unpackMeshIndexBuffer(info, asset,
+                                       info.indexBufferSizes.size(),
+                                       wrongSize));
+    EXPECT_FALSE(unpackMeshVertexBuffer(info, asset, wrongSize));
+  }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace obsidian::asset::test {
+
+// A temporary directory of the running test, so that tests don't overwrite
+// each other's files when they run in parallel.
+inline std::filesystem::path getTestDir() {
+  ::testing::TestInfo const* testInfo =
+      ::testing::UnitTest::GetInstance()->current_test_info();
+
+  return std::filesystem::temp_directory_path() /
+         (std::string{"obsidian_test_"} + testInfo->test_suite_name() + "_" +
+          testInfo->name());
+}
+
+// A slow ramp with a little noise, which compresses well.
+inline std::vector<char> makeCompressibleData(std::size_t size) {
+  std::mt19937 rng{static_cast<std::mt19937::result_type>(size)};
+  std::uniform_int_distribution<int> noise{0, 3};
+  std::vector<char> data(size);
+
+  for (std::size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<char>(i / 64 % 200 + (i % 32 ? 0 : noise(rng)));
+  }
+
+  return data;
+}
+
+inline std::vector<char> readFile(std::filesystem::path const& path) {
+  std::ifstream file{path, std::ios_base::in | std::ios_base::binary};
+  return {std::istreambuf_iterator<char>(file),
+          std::istreambuf_iterator<char>()};
+}
+
+inline void writeFile(std::filesystem::path const& path,
+                      std::span<char const> data) {
+  std::ofstream file{path, std::ios_base::out | std::ios_base::binary};
+  file.write(data.data(), data.size());
+}
+
+template <typename T> T readAt(std::vector<char> const& data, std::size_t at) {
+  T value;
+  std::memcpy(&value, data.data() + at, sizeof(value));
+  return value;
+}
+
+template <typename T>
+void writeAt(std::vector<char>& data, std::size_t at, T value) {
+  std::memcpy(data.data() + at, &value, sizeof(value));
+}
+
+} /*namespace obsidian::asset::test*/
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_info.hpp>
 #include <obsidian/asset/texture_asset_info.hpp>
 #include <obsidian/asset_converter/vertex_content_info.hpp>
 #include <obsidian/core/material.hpp>
@@ -34,6 +36,12 @@ public:
   using TextureAssetInfoMap =
       std::unordered_map<std::string, std::optional<asset::TextureAssetInfo>>;
 
+  struct CompressionSettings {
+    asset::CompressionMode mode;
+    // See asset::PackOptions::compressionLevel.
+    int level = 0;
+  };
+
   AssetConverter(task::TaskExecutor& taskExecutor);
 
   bool convertAsset(std::filesystem::path const& srcFilePath,
@@ -41,6 +49,11 @@ public:
 
   void setMaterialType(core::MaterialType matType);
 
+  // Applies to the assets of the type converted from now on. Textures and
+  // meshes default to chunked LZ4, shaders and materials aren't compressed.
+  void setCompression(asset::AssetType assetType,
+                      CompressionSettings compressionSettings);
+
 private:
   std::optional<asset::TextureAssetInfo> convertImgToAsset(
       std::filesystem::path const& srcPath,
@@ -79,8 +92,17 @@ private:
       std::filesystem::path const& dstPath,
       std::optional<core::TextureFormat> overrideTextureFormat = std::nullopt);
 
+  asset::CompressionMode getCompressionMode(asset::AssetType assetType) const;
+  asset::PackOptions getPackOptions(asset::AssetType assetType) const;
+
   task::TaskExecutor& _taskExecutor;
   core::MaterialType _materialType = core::MaterialType::unlit;
+  std::unordered_map<asset::AssetType, CompressionSettings>
+      _compressionSettings = {
+          {asset::AssetType::texture, {asset::CompressionMode::LZ4Chunked}},
+          {asset::AssetType::mesh, {asset::CompressionMode::LZ4Chunked}},
+          {asset::AssetType::shader, {asset::CompressionMode::none}},
+          {asset::AssetType::material, {asset::CompressionMode::none}}};
 };
 
 } /*namespace obsidian::asset_converter*/
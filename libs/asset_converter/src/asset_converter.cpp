@@ -19,6 +19,7 @@
 #include <obsidian/globals/file_extensions.hpp>
 #include <obsidian/task/task.hpp>
 #include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
 #include <obsidian/task/task_type.hpp>
 
 #include <glm/glm.hpp>
@@ -35,7 +36,6 @@
 #include <filesystem>
 #include <fstream>
 #include <memory>
-#include <numeric>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -99,6 +99,8 @@ std::optional<asset::TextureAssetInfo> AssetConverter::convertImgToAsset(
   }
 
   constexpr int maxTextureSize = 1024;
+  // destination rows reduced by a single task
+  constexpr std::size_t rowGrainSize = 16;
   bool const reduceSize =
       (w > maxTextureSize) && core::isPowerOfTwo(w) && core::isPowerOfTwo(h);
 
@@ -132,8 +134,15 @@ std::optional<asset::TextureAssetInfo> AssetConverter::convertImgToAsset(
     modifiedImageBuffer.resize(resultW * resultH * channelCnt *
                                (willGenerateMips ? 2 : 1));
 
-    core::utils::reduceTextureSize(data, modifiedImageBuffer.data(), channelCnt,
-                                   w, h, reductionFactor, nonLinearChannelCnt);
+    unsigned char* const dstData = modifiedImageBuffer.data();
+
+    _taskExecutor.parallelFor(
+        task::TaskType::general, std::size_t{0}, resultH, rowGrainSize,
+        [=](std::size_t rowBegin, std::size_t rowEnd) {
+          core::utils::reduceTextureSize(data, dstData, channelCnt, w, h,
+                                         reductionFactor, nonLinearChannelCnt,
+                                         rowBegin, rowEnd);
+        });
 
     data = modifiedImageBuffer.data();
   }
@@ -155,9 +164,16 @@ std::optional<asset::TextureAssetInfo> AssetConverter::convertImgToAsset(
 
     while ((srcLevelW > 1) && (srcLevelH > 1)) {
       if (core::isPowerOfTwo(w) && core::isPowerOfTwo(h)) {
-        core::utils::reduceTextureSize(data + srcOffset, data + dstOffset,
-                                       channelCnt, srcLevelW, srcLevelH, 2,
-                                       nonLinearChannelCnt);
+        unsigned char const* const srcLevelData = data + srcOffset;
+        unsigned char* const dstLevelData = data + dstOffset;
+
+        _taskExecutor.parallelFor(
+            task::TaskType::general, std::size_t{0}, srcLevelH / 2,
+            rowGrainSize, [=](std::size_t rowBegin, std::size_t rowEnd) {
+              core::utils::reduceTextureSize(
+                  srcLevelData, dstLevelData, channelCnt, srcLevelW, srcLevelH,
+                  2, nonLinearChannelCnt, rowBegin, rowEnd);
+            });
       } else {
         OBS_LOG_WARN("Image at " + srcPath.string() +
                      " will be imported without size reduction because "
@@ -179,7 +195,8 @@ std::optional<asset::TextureAssetInfo> AssetConverter::convertImgToAsset(
   asset::TextureAssetInfo textureAssetInfo;
   textureAssetInfo.unpackedSize =
       resultW * resultH * channelCnt * (willGenerateMips ? 2 : 1);
-  textureAssetInfo.compressionMode = asset::CompressionMode::LZ4;
+  textureAssetInfo.compressionMode =
+      getCompressionMode(asset::AssetType::texture);
   textureAssetInfo.format = textureFormat;
 
   if (textureAssetInfo.format == core::TextureFormat::unknown) {
@@ -206,7 +223,13 @@ std::optional<asset::TextureAssetInfo> AssetConverter::convertImgToAsset(
   textureAssetInfo.height = resultH;
   textureAssetInfo.mipLevels = mipLevels;
 
-  bool const packResult = asset::packTexture(textureAssetInfo, data, outAsset);
+  // The levels are stored where the RHI copies them from.
+  std::vector<char> cookedPixels;
+  asset::cookTexture(textureAssetInfo, data, cookedPixels);
+
+  bool const packResult =
+      asset::packTexture(textureAssetInfo, cookedPixels.data(), outAsset,
+                         getPackOptions(asset::AssetType::texture));
 
   if (!packResult) {
     return std::nullopt;
@@ -226,7 +249,7 @@ bool AssetConverter::convertObjToAsset(fs::path const& srcPath,
   ZoneScoped;
 
   asset::MeshAssetInfo meshAssetInfo;
-  meshAssetInfo.compressionMode = asset::CompressionMode::LZ4;
+  meshAssetInfo.compressionMode = getCompressionMode(asset::AssetType::mesh);
 
   tinyobj::attrib_t attrib;
   std::vector<tinyobj::shape_t> shapes;
@@ -258,13 +281,37 @@ bool AssetConverter::convertObjToAsset(fs::path const& srcPath,
       materials.size() ? materials.size() : 1};
   std::size_t vertexCount;
 
-  std::future<void> genVertFuture =
-      _taskExecutor.enqueue(task::TaskType::general, [&]() {
+  task::TaskHandle<void> const genVertHandle =
+      _taskExecutor.spawn(task::TaskType::general, [&]() {
         vertexCount = callGenerateVerticesFromObj(meshAssetInfo, attrib, shapes,
                                                   outVertices, outSurfaces,
                                                   meshAssetInfo.aabb);
       });
 
+  // Appending the index buffers only needs the generated vertices, so it runs
+  // as soon as they are ready while the materials are still being extracted.
+  task::TaskHandle<void> const meshBufferHandle =
+      _taskExecutor.then(genVertHandle, task::TaskType::general, [&]() {
+        meshAssetInfo.vertexCount = vertexCount;
+        meshAssetInfo.vertexBufferSize = outVertices.size();
+        meshAssetInfo.indexCount = 0;
+
+        for (auto const& outSurface : outSurfaces) {
+          meshAssetInfo.indexBufferSizes.push_back(
+              sizeof(core::MeshIndexType) * outSurface.size());
+          meshAssetInfo.indexCount += outSurface.size();
+        }
+
+        // The index buffers are stored where the RHI copies them from.
+        asset::cookMeshLayout(meshAssetInfo);
+        outVertices.resize(meshAssetInfo.unpackedSize);
+
+        for (std::size_t i = 0; i < outSurfaces.size(); ++i) {
+          std::memcpy(outVertices.data() + meshAssetInfo.indexBufferOffsets[i],
+                      outSurfaces[i].data(), meshAssetInfo.indexBufferSizes[i]);
+        }
+      });
+
   VertexContentInfo const vertInfo = {
       meshAssetInfo.hasNormals, meshAssetInfo.hasColors, meshAssetInfo.hasUV,
       meshAssetInfo.hasTangents};
@@ -292,42 +339,15 @@ bool AssetConverter::convertObjToAsset(fs::path const& srcPath,
     meshAssetInfo.defaultMatRelativePaths.push_back(path);
   }
 
-  genVertFuture.wait();
-
-  meshAssetInfo.vertexCount = vertexCount;
-  meshAssetInfo.vertexBufferSize = outVertices.size();
-  meshAssetInfo.indexCount = 0;
-
-  for (auto const& outSurface : outSurfaces) {
-    meshAssetInfo.indexBufferSizes.push_back(sizeof(core::MeshIndexType) *
-                                             outSurface.size());
-    meshAssetInfo.indexCount += outSurface.size();
-  }
+  _taskExecutor.wait(meshBufferHandle);
 
   meshAssetInfo.defaultMatRelativePaths.resize(
       meshAssetInfo.indexBufferSizes.size());
 
-  std::size_t const totalIndexBufferSize =
-      std::accumulate(meshAssetInfo.indexBufferSizes.cbegin(),
-                      meshAssetInfo.indexBufferSizes.cend(), std::size_t{0});
-  meshAssetInfo.unpackedSize =
-      meshAssetInfo.vertexBufferSize + totalIndexBufferSize;
-  outVertices.resize(outVertices.size() + totalIndexBufferSize);
-
-  char* indCopyDest = outVertices.data() + meshAssetInfo.vertexBufferSize;
-
-  for (std::size_t i = 0; i < outSurfaces.size(); ++i) {
-    auto const& surface = outSurfaces[i];
-    std::size_t const surfaceBufferSize = meshAssetInfo.indexBufferSizes[i];
-    std::memcpy(indCopyDest, surface.data(), surfaceBufferSize);
-    indCopyDest += surfaceBufferSize;
-  }
-
-  (void)indCopyDest;
-
   asset::Asset meshAsset;
 
-  if (!asset::packMeshAsset(meshAssetInfo, std::move(outVertices), meshAsset)) {
+  if (!asset::packMeshAsset(meshAssetInfo, std::move(outVertices), meshAsset,
+                            getPackOptions(asset::AssetType::mesh))) {
     OBS_LOG_ERR("Failed to convert " + srcPath.string() + " to asset.");
     return false;
   }
@@ -374,12 +394,26 @@ bool AssetConverter::convertGltfToAsset(fs::path const& srcPath,
   std::vector<asset::MeshAssetInfo> meshAssetInfoPerMesh;
   meshAssetInfoPerMesh.resize(meshCount);
 
-  std::vector<std::future<void>> generateVericesFutures;
-  generateVericesFutures.reserve(meshCount);
+  // capturing vector members by reference won't cause problems because the
+  // vectors are not resized after this point
+  auto const makeGenerateVerticesFunc = [&](std::size_t meshInd) {
+    return [meshInd, &meshAssetInfo = meshAssetInfoPerMesh[meshInd],
+            &vertexCount = vertexCountPerMesh[meshInd], &model,
+            &outVertices = outVerticesPerMesh[meshInd],
+            &outSurfaces = outSurfacesPerMesh[meshInd]]() {
+      vertexCount = callGenerateVerticesFromGltfMesh(
+          meshAssetInfo, model, meshInd, outVertices, outSurfaces,
+          meshAssetInfo.aabb);
+    };
+  };
+
+  std::vector<decltype(makeGenerateVerticesFunc(0))> generateVerticesFuncs;
+  generateVerticesFuncs.reserve(meshCount);
 
   for (std::size_t i = 0; i < model.meshes.size(); ++i) {
     asset::MeshAssetInfo& meshAssetInfo = meshAssetInfoPerMesh[i];
-    meshAssetInfo.compressionMode = asset::CompressionMode::LZ4;
+    meshAssetInfo.compressionMode =
+        getCompressionMode(asset::AssetType::mesh);
 
     meshAssetInfo.hasNormals = std::all_of(
         model.meshes[i].primitives.cbegin(), model.meshes[i].primitives.cend(),
@@ -393,20 +427,15 @@ bool AssetConverter::convertGltfToAsset(fs::path const& srcPath,
 
     meshAssetInfo.hasTangents = meshAssetInfo.hasNormals && meshAssetInfo.hasUV;
 
-    generateVericesFutures.push_back(_taskExecutor.enqueue(
-        task::TaskType::general,
-        // capturing vector members by reference won't cause problems because
-        // the vector memory was reserved in advance
-        [meshInd = i, &meshAssetInfo, &vertexCount = vertexCountPerMesh[i],
-         &model, &outVertices = outVerticesPerMesh[i],
-         &outSurfaces = outSurfacesPerMesh[i]]() {
-          std::size_t const materialCnt = model.materials.size();
-          vertexCount = callGenerateVerticesFromGltfMesh(
-              meshAssetInfo, model, meshInd, outVertices, outSurfaces,
-              meshAssetInfo.aabb);
-        }));
+    generateVerticesFuncs.push_back(makeGenerateVerticesFunc(i));
   }
 
+  // Queued at once so that large scenes don't pay a lock and a wakeup per
+  // mesh.
+  std::vector<task::TaskHandle<void>> const generateVerticesHandles =
+      _taskExecutor.spawnBatch(task::TaskType::general,
+                               std::move(generateVerticesFuncs));
+
   std::vector<GltfMaterialWrapper> requestedMaterials;
 
   std::vector<std::vector<int>> materialIndicesPerMesh;
@@ -439,9 +468,7 @@ bool AssetConverter::convertGltfToAsset(fs::path const& srcPath,
       extractMaterials(srcPath, projectPath, texAssetInfoMap,
                        requestedMaterials, model.materials.size());
 
-  for (auto& f : generateVericesFutures) {
-    f.wait();
-  }
+  _taskExecutor.wait(task::whenAll(generateVerticesHandles));
 
   bool exportSuccess = true;
 
@@ -481,28 +508,19 @@ bool AssetConverter::convertGltfToAsset(fs::path const& srcPath,
       }
     }
 
-    std::size_t const totalIndexBufferSize =
-        std::accumulate(meshAssetInfo.indexBufferSizes.cbegin(),
-                        meshAssetInfo.indexBufferSizes.cend(), std::size_t{0});
-    meshAssetInfo.unpackedSize =
-        meshAssetInfo.vertexBufferSize + totalIndexBufferSize;
-    outVertices.resize(outVertices.size() + totalIndexBufferSize);
-
-    char* indCopyDest = outVertices.data() + meshAssetInfo.vertexBufferSize;
+    asset::cookMeshLayout(meshAssetInfo);
+    outVertices.resize(meshAssetInfo.unpackedSize);
 
     for (std::size_t j = 0; j < outSurfaces.size(); ++j) {
-      auto const& surface = outSurfaces[j];
-      std::size_t const surfaceBufferSize = meshAssetInfo.indexBufferSizes[j];
-      std::memcpy(indCopyDest, surface.data(), surfaceBufferSize);
-      indCopyDest += surfaceBufferSize;
+      std::memcpy(outVertices.data() + meshAssetInfo.indexBufferOffsets[j],
+                  outSurfaces[j].data(), meshAssetInfo.indexBufferSizes[j]);
     }
 
-    (void)indCopyDest;
-
     asset::Asset meshAsset;
 
     if (!asset::packMeshAsset(meshAssetInfo, std::move(outVertices),
-                              meshAsset)) {
+                              meshAsset,
+                              getPackOptions(asset::AssetType::mesh))) {
       exportSuccess = false;
       break;
     }
@@ -601,10 +619,12 @@ bool AssetConverter::convertSpirvToAsset(fs::path const& srcPath,
   asset::Asset shaderAsset;
   asset::ShaderAssetInfo shaderAssetInfo;
   shaderAssetInfo.unpackedSize = buffer.size();
-  shaderAssetInfo.compressionMode = asset::CompressionMode::none;
+  shaderAssetInfo.compressionMode =
+      getCompressionMode(asset::AssetType::shader);
 
   bool const packResult =
-      asset::packShader(shaderAssetInfo, std::move(buffer), shaderAsset);
+      asset::packShader(shaderAssetInfo, std::move(buffer), shaderAsset,
+                        getPackOptions(asset::AssetType::shader));
 
   if (!packResult) {
     OBS_LOG_ERR("Failed to convert " + srcPath.string() + " to asset format.");
@@ -644,6 +664,36 @@ void AssetConverter::setMaterialType(core::MaterialType matType) {
   _materialType = matType;
 }
 
+void AssetConverter::setCompression(asset::AssetType assetType,
+                                    CompressionSettings compressionSettings) {
+  _compressionSettings[assetType] = compressionSettings;
+}
+
+asset::CompressionMode
+AssetConverter::getCompressionMode(asset::AssetType assetType) const {
+  auto const it = _compressionSettings.find(assetType);
+
+  if (it == _compressionSettings.cend()) {
+    return asset::CompressionMode::none;
+  }
+
+  return it->second.mode;
+}
+
+asset::PackOptions
+AssetConverter::getPackOptions(asset::AssetType assetType) const {
+  asset::PackOptions options;
+  options.taskExecutor = &_taskExecutor;
+
+  auto const it = _compressionSettings.find(assetType);
+
+  if (it != _compressionSettings.cend()) {
+    options.compressionLevel = it->second.level;
+  }
+
+  return options;
+}
+
 std::optional<asset::TextureAssetInfo> AssetConverter::getOrImportTexture(
     fs::path const& srcPath, fs::path const& dstPath,
     std::optional<core::TextureFormat> overrideTextureFormat) {
@@ -680,12 +730,13 @@ AssetConverter::TextureAssetInfoMap AssetConverter::extractTexturesForMaterials(
     texDir = fs::directory_entry{srcDirPath};
   }
 
-  using TextureFuture = std::future<std::optional<asset::TextureAssetInfo>>;
-  std::unordered_map<std::string, TextureFuture> textureLoadFutures;
+  using TextureHandle =
+      task::TaskHandle<std::optional<asset::TextureAssetInfo>>;
+  std::unordered_map<std::string, TextureHandle> textureLoadHandles;
 
-  auto const addTex = [this, &textureLoadFutures, &texDir, &projectPath](
+  auto const addTex = [this, &textureLoadHandles, &texDir, &projectPath](
                           std::string texName, core::TextureFormat texFormat) {
-    if (texName.empty() || textureLoadFutures.contains(texName)) {
+    if (texName.empty() || textureLoadHandles.contains(texName)) {
       return;
     }
 
@@ -693,7 +744,7 @@ AssetConverter::TextureAssetInfoMap AssetConverter::extractTexturesForMaterials(
     fs::path dstPath = projectPath / texName;
     dstPath.replace_extension(globals::textureAssetExt);
 
-    textureLoadFutures[texName] = _taskExecutor.enqueue(
+    textureLoadHandles[texName] = _taskExecutor.spawn(
         task::TaskType::general, [this, srcPath, dstPath, texFormat]() {
           return getOrImportTexture(srcPath, dstPath, texFormat);
         });
@@ -710,7 +761,8 @@ AssetConverter::TextureAssetInfoMap AssetConverter::extractTexturesForMaterials(
 
   TextureAssetInfoMap resultTextureInfos;
 
-  for (auto& t : textureLoadFutures) {
+  for (auto& t : textureLoadHandles) {
+    _taskExecutor.wait(t.second);
     std::optional<asset::TextureAssetInfo> texInfoOpt = t.second.get();
     resultTextureInfos[t.first] = texInfoOpt;
   }
@@ -878,7 +930,8 @@ AssetConverter::extractMaterials(fs::path const& srcDirPath,
 
     MaterialType const& mat = materials[i];
     asset::MaterialAssetInfo newMatAssetInfo;
-    newMatAssetInfo.compressionMode = asset::CompressionMode::none;
+    newMatAssetInfo.compressionMode =
+        getCompressionMode(asset::AssetType::material);
 
     VertexContentInfo const vertInfo = getVertInfo(mat);
 
@@ -914,7 +967,8 @@ AssetConverter::extractMaterials(fs::path const& srcDirPath,
         mat, newMatAssetInfo.materialType, core::ShaderType::fragment);
 
     asset::Asset matAsset;
-    if (asset::packMaterial(newMatAssetInfo, {}, matAsset)) {
+    if (asset::packMaterial(newMatAssetInfo, {}, matAsset,
+                            getPackOptions(asset::AssetType::material))) {
       fs::path materialPath = projectPath / getMaterialName(mat, vertInfo);
       materialPath.replace_extension(".obsmat");
 
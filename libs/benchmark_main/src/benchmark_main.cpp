@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+// Like benchmark_main, but prints JSON unless another format is requested,
+// so that runs can be stored and compared with benchmark's compare.py.
+int main(int argc, char** argv) {
+  static char jsonFormatArg[] = "--benchmark_format=json";
+
+  std::vector<char*> args{argv, argv + argc};
+
+  bool const hasFormatArg =
+      std::any_of(args.cbegin(), args.cend(), [](char const* arg) {
+        return std::string_view{arg}.starts_with("--benchmark_format");
+      });
+
+  if (!hasFormatArg) {
+    args.insert(args.cbegin() + 1, jsonFormatArg);
+  }
+
+  int argCount = static_cast<int>(args.size());
+  args.push_back(nullptr);
+
+  benchmark::Initialize(&argCount, args.data());
+
+  if (benchmark::ReportUnrecognizedArguments(argCount, args.data())) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <future>
+#include <functional>
 #include <type_traits>
 
 namespace obsidian::core {
@@ -14,16 +14,24 @@ template <typename R, typename... Args> constexpr bool returnsVoid(R(Args...)) {
 }
 
 template <typename F>
-using ResultOf = typename decltype(std::function(std::declval<F>()))::result_type;
+using FunctionOf = decltype(std::function(std::declval<F>()));
 
-template <typename R, typename Arg>
-void invokeTask(std::packaged_task<R(Arg)>& task, void const* argP) {
-  task(*reinterpret_cast<Arg const*>(argP));
-}
+template <typename F> using ResultOf = typename FunctionOf<F>::result_type;
+
+template <typename F> struct TaskArgOf { using type = void; };
+
+template <typename R, typename Arg> struct TaskArgOf<std::function<R(Arg)>> {
+  using type = std::decay_t<Arg>;
+};
+
+template <typename F> decltype(auto) invokeTask(F& func, void const* argP) {
+  using Arg = typename TaskArgOf<FunctionOf<F>>::type;
 
-template <typename R>
-void invokeTask(std::packaged_task<R(void)>& task, void const* argP) {
-  task();
+  if constexpr (std::is_void_v<Arg>) {
+    return func();
+  } else {
+    return func(*reinterpret_cast<Arg const*>(argP));
+  }
 }
 
 } /*namespace obsidian::core */
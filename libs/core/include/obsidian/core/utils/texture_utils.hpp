@@ -9,4 +9,12 @@ void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
                        std::size_t reductionFactor,
                        std::size_t nonLinearChannelCnt);
 
+// Only writes the destination rows [dstRowBegin, dstRowEnd), so disjoint row
+// ranges of the same texture can be reduced concurrently.
+void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
+                       std::size_t channelCnt, std::size_t w, std::size_t h,
+                       std::size_t reductionFactor,
+                       std::size_t nonLinearChannelCnt,
+                       std::size_t dstRowBegin, std::size_t dstRowEnd);
+
 } // namespace obsidian::core::utils
@@ -1,6 +1,7 @@
 #include <obsidian/core/utils/texture_utils.hpp>
 #include <obsidian/core/utils/utils.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <vector>
@@ -11,6 +12,15 @@ void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
                        std::size_t channelCnt, std::size_t w, std::size_t h,
                        std::size_t reductionFactor,
                        std::size_t nonLinearChannelCnt) {
+  reduceTextureSize(srcData, dstData, channelCnt, w, h, reductionFactor,
+                    nonLinearChannelCnt, 0, h / reductionFactor);
+}
+
+void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
+                       std::size_t channelCnt, std::size_t w, std::size_t h,
+                       std::size_t reductionFactor,
+                       std::size_t nonLinearChannelCnt,
+                       std::size_t dstRowBegin, std::size_t dstRowEnd) {
   assert(isPowerOfTwo(w) && isPowerOfTwo(h));
   assert(nonLinearChannelCnt <= channelCnt);
 
@@ -25,13 +35,16 @@ void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
                                     : std::pow(v, 1 / 2.4f) * 1.055f - 0.055f;
   };
 
-  int const newW = w / reductionFactor;
-  int const newH = h / reductionFactor;
+  std::size_t const newW = w / reductionFactor;
+  [[maybe_unused]] std::size_t const newH = h / reductionFactor;
+
+  assert(dstRowBegin <= dstRowEnd && dstRowEnd <= newH);
+
+  std::vector<float> sumPix(channelCnt);
 
-  for (std::size_t y = 0; y < newH; ++y) {
+  for (std::size_t y = dstRowBegin; y < dstRowEnd; ++y) {
     for (std::size_t x = 0; x < newW; ++x) {
-      std::vector<float> sumPix;
-      sumPix.resize(channelCnt, 0.0f);
+      std::fill(sumPix.begin(), sumPix.end(), 0.0f);
 
       for (std::size_t blockX = 0; blockX < reductionFactor; ++blockX) {
         for (std::size_t blockY = 0; blockY < reductionFactor; ++blockY) {
@@ -50,7 +63,7 @@ void reduceTextureSize(unsigned char const* srcData, unsigned char* dstData,
         }
       }
 
-      unsigned char* const dstPixData = dstData + channelCnt * ((y * newH) + x);
+      unsigned char* const dstPixData = dstData + channelCnt * ((y * newW) + x);
       for (std::size_t i = 0; i < nonLinearChannelCnt; ++i) {
         float const delinearized =
             delinearizeF(sumPix[i] / (reductionFactor * reductionFactor)) *
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <cstddef>
+#include <vector>
 
 struct Pixel {
   unsigned char r, g, b, a;
@@ -88,3 +89,39 @@ TEST(texture_utils, reduce_non_linear_texture_size) {
     }
   }
 }
+
+TEST(texture_utils, reduce_texture_size_by_row_ranges) {
+  // arrange
+  constexpr std::size_t w = 8, h = 4;
+  constexpr std::size_t reductionFactor = 2;
+  constexpr std::size_t newW = w / reductionFactor;
+  constexpr std::size_t newH = h / reductionFactor;
+
+  std::array<Pixel, w * h> pixels;
+  for (std::size_t i = 0; i < pixels.size(); ++i) {
+    unsigned char const v = static_cast<unsigned char>(i);
+    pixels[i] = Pixel{v, v, v, 255};
+  }
+
+  std::vector<unsigned char> expected(sizeof(Pixel) * newW * newH);
+  obsidian::core::utils::reduceTextureSize(
+      reinterpret_cast<unsigned char const*>(pixels.data()), expected.data(),
+      sizeof(Pixel), w, h, reductionFactor, 0);
+
+  // act
+  std::vector<unsigned char> result(expected.size());
+  for (std::size_t row = 0; row < newH; ++row) {
+    obsidian::core::utils::reduceTextureSize(
+        reinterpret_cast<unsigned char const*>(pixels.data()), result.data(),
+        sizeof(Pixel), w, h, reductionFactor, 0, row, row + 1);
+  }
+
+  // assert
+  Pixel const* resultData = reinterpret_cast<Pixel const*>(result.data());
+
+  ASSERT_EQ(result, expected);
+  // top left block averages pixels 0, 1, 8 and 9
+  EXPECT_EQ(resultData[0].r, 4);
+  // bottom right block averages pixels 22, 23, 30 and 31
+  EXPECT_EQ(resultData[newW * newH - 1].r, 26);
+}
@@ -27,10 +27,9 @@ struct ObsidianEngineContext {
   ObsidianEngineContext(ObsidianEngineContext const& other) = delete;
 
   task::TaskExecutor taskExecutor;
-  task::TaskExecutor rhiMainThreadExecutor;
   input::InputContext inputContext;
   window::Window window;
-  vk_rhi::VulkanRHI vulkanRHI;
+  vk_rhi::VulkanRHI vulkanRHI{taskExecutor};
   project::Project project;
   runtime_resource::RuntimeResourceManager resourceManager;
   scene::Scene scene;
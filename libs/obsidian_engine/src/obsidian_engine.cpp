@@ -1,12 +1,17 @@
 #include <obsidian/asset/material_asset_info.hpp>
 #include <obsidian/core/light_types.hpp>
 #include <obsidian/core/logging.hpp>
+#include <obsidian/platform/cpu_topology.hpp>
 #include <obsidian/obsidian_engine/obsidian_engine.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/rhi/rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/scene/game_object.hpp>
 #include <obsidian/scene/scene.hpp>
+#include <obsidian/serialization/scene_data_serialization.hpp>
+#include <obsidian/task/cpu_allocator.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_stats.hpp>
 #include <obsidian/task/task_type.hpp>
 #include <obsidian/window/window.hpp>
 #include <obsidian/window/window_backend.hpp>
@@ -18,7 +23,8 @@
 #include <vulkan/vulkan.h>
 
 #include <algorithm>
-#include <thread>
+#include <cstddef>
+#include <utility>
 
 using namespace obsidian;
 
@@ -55,45 +61,41 @@ bool ObsidianEngine::init(IWindowBackendProvider const& windowBackendProvider,
   extent.width = windowParams.width;
   extent.height = windowParams.height;
 
-  _context.rhiMainThreadExecutor.initAndRun({{task::TaskType::rhiMain, 1}});
-
-  std::future<void> const vkRhiInitFuture =
-      _context.rhiMainThreadExecutor.enqueue(
-          task::TaskType::rhiMain, [this, extent]() {
-            _context.vulkanRHI.init(extent, _context.window.getWindowBackend());
-          });
+  std::future<void> const vkRhiInitFuture = _context.taskExecutor.enqueue(
+      task::TaskType::rhiMain, [this, extent]() {
+        _context.vulkanRHI.init(extent, _context.window.getWindowBackend());
+      });
 
   vkRhiInitFuture.wait();
 
-  _context.rhiMainThreadExecutor.enqueue(
-      task::TaskType::rhiMain, [this, extent]() {
-        std::unique_lock l{_renderLoopMutex, std::defer_lock};
+  _context.taskExecutor.enqueue(task::TaskType::rhiMain, [this, extent]() {
+    std::unique_lock l{_renderLoopMutex, std::defer_lock};
 
-        while (!_shutdownRequested.test()) {
-          l.lock();
+    while (!_shutdownRequested.test()) {
+      l.lock();
 
-          _renderLoopCondVar.wait(
-              l, [&]() { return _readyToRender || _shutdownRequested.test(); });
+      _renderLoopCondVar.wait(
+          l, [&]() { return _readyToRender || _shutdownRequested.test(); });
 
-          if (!_shutdownRequested.test()) {
-            ZoneScopedN("RHI draw");
+      if (!_shutdownRequested.test()) {
+        ZoneScopedN("RHI draw");
 
-            rhi::SceneGlobalParams sceneGlobalParams;
-            scene::SceneState const& sceneState = _context.scene.getState();
-            sceneGlobalParams.ambientColor = sceneState.ambientColor;
-            sceneGlobalParams.cameraPos = sceneState.camera.pos;
-            sceneGlobalParams.cameraRotationRad = sceneState.camera.rotationRad;
+        rhi::SceneGlobalParams sceneGlobalParams;
+        scene::SceneState const& sceneState = _context.scene.getState();
+        sceneGlobalParams.ambientColor = sceneState.ambientColor;
+        sceneGlobalParams.cameraPos = sceneState.camera.pos;
+        sceneGlobalParams.cameraRotationRad = sceneState.camera.rotationRad;
 
-            _context.vulkanRHI.draw(sceneGlobalParams);
-          }
+        _context.vulkanRHI.draw(sceneGlobalParams);
+      }
 
-          _readyToRender = false;
+      _readyToRender = false;
 
-          l.unlock();
+      l.unlock();
 
-          _renderLoopCondVar.notify_all();
-        }
-      });
+      _renderLoopCondVar.notify_all();
+    }
+  });
 
   _context.inputContext.windowEventEmitter.subscribeToWindowResizedEvent(
       [this](std::size_t w, std::size_t h) {
@@ -114,20 +116,19 @@ bool ObsidianEngine::init(IWindowBackendProvider const& windowBackendProvider,
 }
 
 void ObsidianEngine::cleanup() {
-  _context.taskExecutor.waitIdle();
+  _context.resourceManager.cancelPendingLoads();
+  _context.resourceManager.waitPendingLoads();
   _context.scene.resetState();
   _context.inputContext.keyInputEmitter.cleanup();
   _context.inputContext.mouseEventEmitter.cleanup();
   _context.inputContext.windowEventEmitter.cleanup();
   _context.resourceManager.cleanup();
 
-  std::future<void> const cleanupFuture =
-      _context.rhiMainThreadExecutor.enqueue(
-          task::TaskType::rhiMain, [this]() { _context.vulkanRHI.cleanup(); });
+  std::future<void> const cleanupFuture = _context.taskExecutor.enqueue(
+      task::TaskType::rhiMain, [this]() { _context.vulkanRHI.cleanup(); });
   cleanupFuture.wait();
 
   _context.taskExecutor.shutdown();
-  _context.rhiMainThreadExecutor.shutdown();
 }
 
 ObsidianEngineContext& ObsidianEngine::getContext() { return _context; }
@@ -147,11 +148,15 @@ void ObsidianEngine::prepareRenderData() {
     return;
   }
 
+  _context.taskExecutor.plotStats();
+
   {
     ZoneScopedN("Draw call recursion");
 
+    serialization::CameraData const& camera = _context.scene.getState().camera;
+
     for (auto& gameObject : _context.scene.getGameObjects()) {
-      gameObject.draw(glm::mat4{1.0f});
+      gameObject.draw(glm::mat4{1.0f}, camera);
     }
   }
 
@@ -179,11 +184,9 @@ void ObsidianEngine::requestShutdown() {
 }
 
 void ObsidianEngine::openProject(std::filesystem::path projectPath) {
-  _context.taskExecutor.waitIdle();
+  _context.resourceManager.cancelPendingLoads();
+  _context.resourceManager.waitPendingLoads();
   _context.scene.resetState();
-  _context.taskExecutor.shutdown();
-  initTaskExecutor();
-
   _context.resourceManager.cleanup();
   _context.project.open(projectPath);
   _context.resourceManager.init(_context.vulkanRHI, _context.project,
@@ -191,11 +194,38 @@ void ObsidianEngine::openProject(std::filesystem::path projectPath) {
 }
 
 void ObsidianEngine::initTaskExecutor() {
-  int nCores =
-      std::max(static_cast<int>(std::thread::hardware_concurrency()), 2);
-
+  // A single executor serves the whole engine. The render thread and the
+  // resource transfer workers get cores of their own and the other workers
+  // share the rest with the main thread, so there is one thread per cpu. The
+  // transfer and upload workers run general tasks while their own queue is
+  // empty.
+  task::CpuAllocator cpuAllocator{platform::readCpuTopology()};
+  platform::CpuSet const rhiMainThreadCpus = cpuAllocator.reserveCores(1);
+  platform::CpuSet transferThreadCpus = cpuAllocator.reserveCores(1);
+
+  unsigned int const transferThreadCount = static_cast<unsigned int>(
+      std::max<std::size_t>(transferThreadCpus.size(), 1));
+  // one shared cpu each for the main thread and the upload worker
+  unsigned int const generalThreadCount = static_cast<unsigned int>(
+      std::max<std::size_t>(cpuAllocator.getSharedCpus().size(), 3) - 2);
+
+  task::ThreadInitInfo transferInitInfo =
+      _context.vulkanRHI.getTransferThreadInitInfo(
+          transferThreadCount, std::move(transferThreadCpus));
+  transferInitInfo.helpedTaskTypes = {task::TaskType::general};
+
+  // Cheap enough to keep on, shows up in Tracy when it is enabled.
+  _context.taskExecutor.setStatsMode(task::TaskStatsMode::sampled);
   _context.taskExecutor.initAndRun(
-      {{task::TaskType::resourceUpload, 1},
-       {task::TaskType::general,
-        static_cast<unsigned>(std::max(nCores - 6, 2))}});
+      {{task::TaskType::rhiMain, 1, {}, 0, {}, {rhiMainThreadCpus}},
+       std::move(transferInitInfo),
+       {task::TaskType::resourceUpload,
+        1,
+        {},
+        0,
+        {},
+        {cpuAllocator.getSharedCpus()},
+        {task::TaskType::general}},
+       {task::TaskType::general, generalThreadCount, {}, 0, {},
+        cpuAllocator.spreadThreads(generalThreadCount)}});
 }
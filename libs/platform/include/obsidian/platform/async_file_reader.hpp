@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace obsidian::platform {
+
+class FileReaderBackend;
+
+// Reads file ranges without blocking the threads that request them. On Linux
+// the reads go through io_uring: a single reader thread submits every read
+// requested since it last woke up with one system call and runs the callbacks
+// as the reads complete. Where io_uring isn't available, a few reader
+// threads do plain blocking reads instead. If the ring fails while in use,
+// the reads in flight fail and the later ones go to such threads.
+class AsyncFileReader {
+public:
+  enum class Backend { none, ioUring, threadPool };
+
+  // Runs on a reader thread, so it should only hand the data over. The data
+  // is empty if the range couldn't be read completely.
+  using Callback = std::function<void(bool success, std::vector<char> data)>;
+
+  AsyncFileReader();
+  AsyncFileReader(AsyncFileReader const& other) = delete;
+  ~AsyncFileReader();
+
+  AsyncFileReader& operator=(AsyncFileReader const& other) = delete;
+
+  // At most queueDepth reads are in flight at once, the rest wait for them.
+  // The thread pool backend uses threadCount threads and is used right away
+  // if preferIoUring is false.
+  void init(unsigned int queueDepth = 64, unsigned int threadCount = 2,
+            bool preferIoUring = true);
+  // Fails the reads that didn't start yet and waits for the others.
+  void shutdown();
+
+  Backend getBackend() const;
+
+  void read(std::filesystem::path path, std::uint64_t offset,
+            std::size_t size, Callback callback);
+
+private:
+  std::unique_ptr<FileReaderBackend> _backend;
+  Backend _backendType = Backend::none;
+};
+
+} /*namespace obsidian::platform*/
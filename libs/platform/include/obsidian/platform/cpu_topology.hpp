@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+namespace obsidian::platform {
+
+// Logical cpu ids, as used for thread affinity.
+using CpuSet = std::vector<unsigned int>;
+
+struct LogicalCpu {
+  unsigned int id = 0;
+  // Logical cpus with the same core and package id are hyperthreads of one
+  // physical core.
+  unsigned int coreId = 0;
+  unsigned int packageId = 0;
+  // Logical cpus with the same id share the last level cache.
+  unsigned int cacheDomainId = 0;
+  unsigned int numaNode = 0;
+};
+
+struct CpuTopology {
+  // the online cpus, ordered by id
+  std::vector<LogicalCpu> cpus;
+};
+
+// Reads the topology of the online cpus from sysfs. Where that isn't
+// available, every cpu is reported as a separate core and all of them share
+// one cache domain and NUMA node.
+CpuTopology readCpuTopology();
+
+// Parses cpu lists in the format the kernel uses, such as "0-3,8,10-11".
+CpuSet parseCpuList(std::string_view cpuList);
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace obsidian::platform {
+
+// Reports the changes in a directory tree as they happen, with inotify on
+// Linux. Directories created in the tree are watched as well. Not
+// thread-safe.
+class DirectoryWatcher {
+public:
+  enum class ChangeType {
+    // created, written or moved into the tree
+    fileChanged,
+    // deleted or moved out of the tree
+    fileRemoved,
+    // created or moved into the tree, its files aren't reported separately
+    directoryAdded,
+    directoryRemoved,
+    // changes were lost, everything has to be checked again
+    overflow
+  };
+
+  struct Change {
+    ChangeType type;
+    // relative to the watched directory
+    std::filesystem::path path;
+  };
+
+  DirectoryWatcher() = default;
+  DirectoryWatcher(DirectoryWatcher const& other) = delete;
+  ~DirectoryWatcher();
+
+  DirectoryWatcher& operator=(DirectoryWatcher const& other) = delete;
+
+  // Stops watching the previous directory, if any. Returns false if the
+  // platform can't watch directories.
+  bool watch(std::filesystem::path const& rootPath);
+  void stop();
+
+  bool isWatching() const;
+
+  // Appends the changes since the last call without blocking.
+  void pollChanges(std::vector<Change>& outChanges);
+
+private:
+  void addWatches(std::filesystem::path const& relativePath);
+  void removeWatches(std::filesystem::path const& relativePath);
+
+  int _fd = -1;
+  std::filesystem::path _rootPath;
+  // watch descriptors to directories relative to the root
+  std::unordered_map<int, std::filesystem::path> _watchedDirs;
+};
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace obsidian::platform {
+
+// Read-only mapping of a whole file. Empty files can't be mapped.
+class MappedFile {
+public:
+  enum class AccessHint {
+    // the range is read front to back, pages behind it can be dropped early
+    sequential,
+    // the range is read soon, the kernel starts reading it ahead
+    willNeed,
+    // only small parts of the range are read, the kernel doesn't read ahead
+    random
+  };
+
+  MappedFile() = default;
+  MappedFile(MappedFile const& other) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+
+  ~MappedFile();
+
+  MappedFile& operator=(MappedFile const& other) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // Unmaps the previously mapped file, if any. Returns false if the file
+  // can't be opened or mapped.
+  bool map(std::filesystem::path const& path);
+  void unmap();
+
+  bool isMapped() const;
+  std::span<char const> getData() const;
+
+  // Only a hint, ignored where the platform has no equivalent. The range is
+  // clamped to the mapping.
+  void advise(AccessHint hint, std::size_t offset, std::size_t size) const;
+
+private:
+  char const* _data = nullptr;
+  std::size_t _size = 0;
+};
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <obsidian/platform/cpu_topology.hpp>
+
+#include <string>
+
+namespace obsidian::platform {
+
+// Restricts the calling thread to the given cpus. Returns false if the
+// platform doesn't support it or refused.
+bool setCurrentThreadAffinity(CpuSet const& cpus);
+
+// The name shown by debuggers and tools like top. Linux only keeps the first
+// 15 characters.
+void setCurrentThreadName(std::string const& name);
+
+} /*namespace obsidian::platform*/
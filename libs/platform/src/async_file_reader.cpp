@@ -0,0 +1,687 @@
+#include <obsidian/platform/async_file_reader.hpp>
+#include <obsidian/platform/thread.hpp>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::platform {
+
+struct ReadRequest {
+  fs::path path;
+  std::uint64_t offset;
+  std::size_t size;
+  AsyncFileReader::Callback callback;
+};
+
+class FileReaderBackend {
+public:
+  virtual ~FileReaderBackend() = default;
+
+  virtual void read(ReadRequest request) = 0;
+  virtual void shutdown() = 0;
+};
+
+namespace {
+
+void failRequest(ReadRequest& request) { request.callback(false, {}); }
+
+// The readers run outside of any task, so a size that can't be allocated
+// fails the read instead of throwing.
+bool allocateReadBuffer(std::size_t size, std::vector<char>& outData) {
+  try {
+    outData.resize(size);
+  } catch (std::bad_alloc const&) {
+    return false;
+  } catch (std::length_error const&) {
+    return false;
+  }
+
+  return true;
+}
+
+// Plain blocking reads on a few threads of its own, works everywhere.
+class ThreadPoolFileReader : public FileReaderBackend {
+public:
+  explicit ThreadPoolFileReader(unsigned int threadCount) {
+    for (unsigned int i = 0; i < threadCount; ++i) {
+      _threads.emplace_back([this]() {
+        setCurrentThreadName("obs-file-read");
+        run();
+      });
+    }
+  }
+
+  ~ThreadPoolFileReader() override { shutdown(); }
+
+  void read(ReadRequest request) override {
+    {
+      std::scoped_lock l{_mutex};
+
+      if (!_stopping) {
+        _requests.push_back(std::move(request));
+        _condVar.notify_one();
+        return;
+      }
+    }
+
+    failRequest(request);
+  }
+
+  void shutdown() override {
+    std::deque<ReadRequest> notStarted;
+
+    {
+      std::scoped_lock l{_mutex};
+      _stopping = true;
+      notStarted.swap(_requests);
+    }
+
+    _condVar.notify_all();
+
+    for (ReadRequest& request : notStarted) {
+      failRequest(request);
+    }
+
+    for (std::thread& thread : _threads) {
+      thread.join();
+    }
+
+    _threads.clear();
+  }
+
+private:
+  void run() {
+    std::unique_lock l{_mutex};
+
+    while (true) {
+      _condVar.wait(l, [this]() { return _stopping || !_requests.empty(); });
+
+      if (_requests.empty()) {
+        return;
+      }
+
+      ReadRequest request = std::move(_requests.front());
+      _requests.pop_front();
+
+      l.unlock();
+      readBlocking(request);
+      l.lock();
+    }
+  }
+
+  static void readBlocking(ReadRequest& request) {
+    std::vector<char> data;
+
+    if (!allocateReadBuffer(request.size, data)) {
+      failRequest(request);
+      return;
+    }
+
+    std::ifstream inputFileStream{request.path,
+                                  std::ios_base::in | std::ios_base::binary};
+
+    bool const success =
+        inputFileStream &&
+        inputFileStream.seekg(static_cast<std::streamoff>(request.offset)) &&
+        inputFileStream.read(data.data(), data.size());
+
+    request.callback(success, success ? std::move(data) : std::vector<char>{});
+  }
+
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _condVar;
+  std::deque<ReadRequest> _requests;
+  bool _stopping = false;
+};
+
+#ifdef __linux__
+
+int ioUringSetup(unsigned int entries, io_uring_params& params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int ioUringEnter(int ringFd, unsigned int toSubmit, unsigned int minComplete,
+                 unsigned int flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit,
+                                  minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ringFd, unsigned int opcode, void* arg,
+                    unsigned int argCount) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, ringFd, opcode, arg, argCount));
+}
+
+// The rings are shared with the kernel, so their indices are read and
+// published with acquire and release ordering.
+unsigned int loadAcquire(unsigned int* value) {
+  return std::atomic_ref<unsigned int>{*value}.load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned int* value, unsigned int newValue) {
+  std::atomic_ref<unsigned int>{*value}.store(newValue,
+                                              std::memory_order_release);
+}
+
+// Every read is an openat followed by as many reads as the range needs. The
+// reader thread is the only one touching the rings. Requests wake it up
+// through an eventfd whose read is always queued in the ring, so new
+// requests and completions are waited for with the same system call, which
+// also submits everything queued since the last one.
+class IoUringFileReader : public FileReaderBackend {
+public:
+  ~IoUringFileReader() override {
+    shutdown();
+    unmapRing();
+  }
+
+  // Returns false if the kernel doesn't support io_uring or the operations
+  // used here, or if something like a seccomp filter blocks it. If the ring
+  // fails later on, the reads go to threadCount threads instead.
+  bool init(unsigned int queueDepth, unsigned int threadCount) {
+    _fallbackThreadCount = threadCount;
+    io_uring_params params = {};
+    // one entry is kept for the wake up read
+    _ringFd = ioUringSetup(std::max(queueDepth, 2u), params);
+
+    if (_ringFd < 0 || !supportsOperations() || !mapRing(params)) {
+      return false;
+    }
+
+    _eventFd = eventfd(0, EFD_CLOEXEC);
+
+    if (_eventFd < 0) {
+      return false;
+    }
+
+    _thread = std::thread{[this]() {
+      setCurrentThreadName("obs-io-uring");
+      run();
+    }};
+
+    return true;
+  }
+
+  void read(ReadRequest request) override {
+    bool accepted = false;
+    bool wakeUp = false;
+    FileReaderBackend* fallback = nullptr;
+
+    {
+      std::scoped_lock l{_mutex};
+
+      if (_fallback) {
+        fallback = _fallback.get();
+      } else if (!_stopping) {
+        // Requests coming in while the reader is awake are picked up without
+        // waking it again.
+        accepted = true;
+        wakeUp = _requests.empty();
+        _requests.push_back(std::move(request));
+      }
+    }
+
+    if (fallback) {
+      fallback->read(std::move(request));
+    } else if (!accepted) {
+      failRequest(request);
+    } else if (wakeUp) {
+      signalWakeUp();
+    }
+  }
+
+  void shutdown() override {
+    {
+      std::scoped_lock l{_mutex};
+      _stopping = true;
+    }
+
+    if (_thread.joinable()) {
+      signalWakeUp();
+      _thread.join();
+    }
+
+    if (_fallback) {
+      _fallback->shutdown();
+    }
+  }
+
+private:
+  struct Operation {
+    ReadRequest request;
+    std::vector<char> data;
+    std::size_t bytesRead = 0;
+    int fd = -1;
+  };
+
+  static constexpr std::uint64_t wakeUpUserData = 0;
+  // the length of a single read is 32-bit
+  static constexpr std::size_t maxReadSize = std::size_t{1} << 30;
+
+  bool supportsOperations() const {
+    constexpr unsigned int probeOpCount = 256;
+
+    std::vector<char> probeBuffer(sizeof(io_uring_probe) +
+                                  probeOpCount * sizeof(io_uring_probe_op));
+    io_uring_probe* const probe =
+        reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+
+    if (ioUringRegister(_ringFd, IORING_REGISTER_PROBE, probe, probeOpCount) <
+        0) {
+      return false;
+    }
+
+    auto const isSupported = [probe](unsigned int op) {
+      return op <= probe->last_op &&
+             (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+
+    return isSupported(IORING_OP_OPENAT) && isSupported(IORING_OP_READ);
+  }
+
+  bool mapRing(io_uring_params const& params) {
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool const singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+
+    if (singleMapping) {
+      _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+    }
+
+    auto const mapRegion = [this](std::size_t size, off_t offset) -> char* {
+      void* const region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+      return region == MAP_FAILED ? nullptr : static_cast<char*>(region);
+    };
+
+    _sqRing = mapRegion(_sqRingSize, IORING_OFF_SQ_RING);
+    _cqRing =
+        singleMapping ? _sqRing : mapRegion(_cqRingSize, IORING_OFF_CQ_RING);
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = reinterpret_cast<io_uring_sqe*>(
+        mapRegion(_sqesSize, IORING_OFF_SQES));
+
+    if (!_sqRing || !_cqRing || !_sqes) {
+      return false;
+    }
+
+    _sqHead = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.head);
+    _sqTail = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.tail);
+    _sqMask = *reinterpret_cast<unsigned int*>(_sqRing +
+                                               params.sq_off.ring_mask);
+    _sqArray = reinterpret_cast<unsigned int*>(_sqRing + params.sq_off.array);
+    _sqEntries = params.sq_entries;
+    _sqLocalTail = *_sqTail;
+
+    _cqHead = reinterpret_cast<unsigned int*>(_cqRing + params.cq_off.head);
+    _cqTail = reinterpret_cast<unsigned int*>(_cqRing + params.cq_off.tail);
+    _cqMask = *reinterpret_cast<unsigned int*>(_cqRing +
+                                               params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(_cqRing + params.cq_off.cqes);
+
+    return true;
+  }
+
+  void unmapRing() {
+    if (_sqes) {
+      munmap(_sqes, _sqesSize);
+    }
+
+    if (_cqRing && _cqRing != _sqRing) {
+      munmap(_cqRing, _cqRingSize);
+    }
+
+    if (_sqRing) {
+      munmap(_sqRing, _sqRingSize);
+    }
+
+    if (_eventFd >= 0) {
+      close(_eventFd);
+    }
+
+    if (_ringFd >= 0) {
+      close(_ringFd);
+    }
+
+    _sqes = nullptr;
+    _cqRing = _sqRing = nullptr;
+    _eventFd = _ringFd = -1;
+  }
+
+  void signalWakeUp() {
+    std::uint64_t const value = 1;
+    [[maybe_unused]] ssize_t const written =
+        ::write(_eventFd, &value, sizeof(value));
+  }
+
+  void run() {
+    prepareWakeUpRead();
+
+    while (true) {
+      std::vector<ReadRequest> requests;
+      bool stopping;
+
+      {
+        std::scoped_lock l{_mutex};
+        requests.swap(_requests);
+        stopping = _stopping;
+      }
+
+      for (ReadRequest& request : requests) {
+        _waiting.push_back(std::move(request));
+      }
+
+      if (stopping) {
+        for (ReadRequest& request : _waiting) {
+          failRequest(request);
+        }
+
+        _waiting.clear();
+
+        if (_inFlight == 1) {
+          // only the wake up read is left, closing the ring cancels it
+          return;
+        }
+      }
+
+      while (!_waiting.empty() && _inFlight < _sqEntries) {
+        Operation* const operation =
+            new Operation{std::move(_waiting.front()), {}};
+        _waiting.pop_front();
+        _operations.insert(operation);
+        prepareOpen(*operation);
+      }
+
+      storeRelease(_sqTail, _sqLocalTail);
+
+      int const submitted =
+          ioUringEnter(_ringFd, _toSubmit, 1, IORING_ENTER_GETEVENTS);
+
+      if (submitted >= 0) {
+        _toSubmit -= static_cast<unsigned int>(submitted);
+      } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        // Only interruptions and the kernel being short on resources for the
+        // moment are worth retrying.
+        abandonRing();
+        return;
+      }
+
+      reapCompletions();
+    }
+  }
+
+  // The ring can't be used anymore. The reads in flight fail, the others and
+  // every later one go to a thread pool reader.
+  void abandonRing() {
+    std::vector<ReadRequest> requests;
+    FileReaderBackend* fallback = nullptr;
+
+    {
+      std::scoped_lock l{_mutex};
+
+      if (!_stopping) {
+        _fallback =
+            std::make_unique<ThreadPoolFileReader>(_fallbackThreadCount);
+        fallback = _fallback.get();
+      }
+
+      requests.swap(_requests);
+    }
+
+    for (ReadRequest& request : requests) {
+      _waiting.push_back(std::move(request));
+    }
+
+    for (ReadRequest& request : _waiting) {
+      if (fallback) {
+        fallback->read(std::move(request));
+      } else {
+        failRequest(request);
+      }
+    }
+
+    _waiting.clear();
+
+    for (Operation* const operation : _operations) {
+      if (operation->fd >= 0) {
+        close(operation->fd);
+        operation->fd = -1;
+      }
+
+      operation->request.callback(false, {});
+      // The kernel may still write to the buffer until the ring is closed.
+      _abandonedOperations.emplace_back(operation);
+    }
+
+    _operations.clear();
+  }
+
+  io_uring_sqe& getSqe() {
+    // The in flight limit keeps the ring from filling up.
+    assert(_sqLocalTail - loadAcquire(_sqHead) < _sqEntries);
+
+    unsigned int const index = _sqLocalTail & _sqMask;
+    _sqArray[index] = index;
+    ++_sqLocalTail;
+    ++_toSubmit;
+    ++_inFlight;
+
+    io_uring_sqe& sqe = _sqes[index];
+    sqe = {};
+
+    return sqe;
+  }
+
+  void prepareWakeUpRead() {
+    io_uring_sqe& sqe = getSqe();
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = _eventFd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&_wakeUpValue);
+    sqe.len = sizeof(_wakeUpValue);
+    sqe.user_data = wakeUpUserData;
+  }
+
+  void prepareOpen(Operation& operation) {
+    io_uring_sqe& sqe = getSqe();
+    sqe.opcode = IORING_OP_OPENAT;
+    sqe.fd = AT_FDCWD;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(operation.request.path.c_str());
+    sqe.open_flags = O_RDONLY | O_CLOEXEC;
+    sqe.user_data = reinterpret_cast<std::uintptr_t>(&operation);
+  }
+
+  void prepareRead(Operation& operation) {
+    std::size_t const remaining =
+        operation.request.size - operation.bytesRead;
+
+    io_uring_sqe& sqe = getSqe();
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = operation.fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(operation.data.data() +
+                                                operation.bytesRead);
+    sqe.len = static_cast<std::uint32_t>(std::min(remaining, maxReadSize));
+    sqe.off = operation.request.offset + operation.bytesRead;
+    sqe.user_data = reinterpret_cast<std::uintptr_t>(&operation);
+  }
+
+  void reapCompletions() {
+    unsigned int head = *_cqHead;
+    unsigned int const tail = loadAcquire(_cqTail);
+
+    for (; head != tail; ++head) {
+      io_uring_cqe const& cqe = _cqes[head & _cqMask];
+      std::uint64_t const userData = cqe.user_data;
+      int const result = cqe.res;
+
+      --_inFlight;
+
+      if (userData == wakeUpUserData) {
+        prepareWakeUpRead();
+      } else {
+        advance(*reinterpret_cast<Operation*>(userData), result);
+      }
+    }
+
+    storeRelease(_cqHead, head);
+  }
+
+  void advance(Operation& operation, int result) {
+    if (operation.fd < 0) {
+      if (result < 0) {
+        finish(operation, false);
+        return;
+      }
+
+      operation.fd = result;
+
+      if (!allocateReadBuffer(operation.request.size, operation.data)) {
+        finish(operation, false);
+        return;
+      }
+    } else if (result <= 0) {
+      // failed or the file ended before the range
+      finish(operation, false);
+      return;
+    } else {
+      operation.bytesRead += static_cast<std::size_t>(result);
+    }
+
+    if (operation.bytesRead < operation.request.size) {
+      prepareRead(operation);
+    } else {
+      finish(operation, true);
+    }
+  }
+
+  void finish(Operation& operation, bool success) {
+    std::unique_ptr<Operation> const ownedOperation{&operation};
+    _operations.erase(&operation);
+
+    if (operation.fd >= 0) {
+      close(operation.fd);
+    }
+
+    operation.request.callback(success, success ? std::move(operation.data)
+                                                : std::vector<char>{});
+  }
+
+  int _ringFd = -1;
+  int _eventFd = -1;
+
+  char* _sqRing = nullptr;
+  char* _cqRing = nullptr;
+  io_uring_sqe* _sqes = nullptr;
+  std::size_t _sqRingSize = 0;
+  std::size_t _cqRingSize = 0;
+  std::size_t _sqesSize = 0;
+
+  unsigned int* _sqHead = nullptr;
+  unsigned int* _sqTail = nullptr;
+  unsigned int* _sqArray = nullptr;
+  unsigned int _sqMask = 0;
+  unsigned int _sqEntries = 0;
+  unsigned int* _cqHead = nullptr;
+  unsigned int* _cqTail = nullptr;
+  io_uring_cqe* _cqes = nullptr;
+  unsigned int _cqMask = 0;
+
+  // only used by the reader thread
+  unsigned int _sqLocalTail = 0;
+  unsigned int _toSubmit = 0;
+  unsigned int _inFlight = 0;
+  std::deque<ReadRequest> _waiting;
+  std::unordered_set<Operation*> _operations;
+  std::vector<std::unique_ptr<Operation>> _abandonedOperations;
+  std::uint64_t _wakeUpValue = 0;
+
+  std::mutex _mutex;
+  std::vector<ReadRequest> _requests;
+  bool _stopping = false;
+  unsigned int _fallbackThreadCount = 1;
+  std::unique_ptr<FileReaderBackend> _fallback;
+  std::thread _thread;
+};
+
+#endif
+
+} /*namespace*/
+
+AsyncFileReader::AsyncFileReader() = default;
+
+AsyncFileReader::~AsyncFileReader() { shutdown(); }
+
+void AsyncFileReader::init(unsigned int queueDepth, unsigned int threadCount,
+                           bool preferIoUring) {
+  shutdown();
+
+#ifdef __linux__
+  if (preferIoUring) {
+    auto ioUringReader = std::make_unique<IoUringFileReader>();
+
+    if (ioUringReader->init(queueDepth, std::max(threadCount, 1u))) {
+      _backend = std::move(ioUringReader);
+      _backendType = Backend::ioUring;
+      return;
+    }
+  }
+#endif
+
+  _backend = std::make_unique<ThreadPoolFileReader>(std::max(threadCount, 1u));
+  _backendType = Backend::threadPool;
+}
+
+void AsyncFileReader::shutdown() {
+  if (_backend) {
+    _backend->shutdown();
+    _backend.reset();
+  }
+
+  _backendType = Backend::none;
+}
+
+AsyncFileReader::Backend AsyncFileReader::getBackend() const {
+  return _backendType;
+}
+
+void AsyncFileReader::read(fs::path path, std::uint64_t offset,
+                           std::size_t size, Callback callback) {
+  ReadRequest request{std::move(path), offset, size, std::move(callback)};
+
+  if (!_backend) {
+    failRequest(request);
+    return;
+  }
+
+  _backend->read(std::move(request));
+}
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,210 @@
+#include <obsidian/platform/cpu_topology.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::platform {
+
+namespace {
+
+bool parseUnsigned(std::string_view str, unsigned int& outValue) {
+  char const* const end = str.data() + str.size();
+  auto const result = std::from_chars(str.data(), end, outValue);
+
+  return result.ec == std::errc{} && result.ptr == end;
+}
+
+bool readLine(fs::path const& path, std::string& outLine) {
+  std::ifstream file{path};
+
+  return file && std::getline(file, outLine);
+}
+
+bool readUnsigned(fs::path const& path, unsigned int& outValue) {
+  std::string line;
+
+  return readLine(path, line) && parseUnsigned(line, outValue);
+}
+
+CpuTopology makeFallbackTopology() {
+  CpuTopology topology;
+  unsigned int const cpuCount =
+      std::max(std::thread::hardware_concurrency(), 1u);
+
+  for (unsigned int i = 0; i < cpuCount; ++i) {
+    LogicalCpu& cpu = topology.cpus.emplace_back();
+    cpu.id = i;
+    cpu.coreId = i;
+  }
+
+  return topology;
+}
+
+#ifdef __linux__
+
+// The lowest cpu that shares the last level cache with the given cpu.
+bool readCacheDomainId(fs::path const& cpuPath, unsigned int& outDomainId) {
+  std::error_code ec;
+  unsigned int lastLevel = 0;
+  bool found = false;
+
+  for (fs::directory_entry const& entry :
+       fs::directory_iterator{cpuPath / "cache", ec}) {
+    if (!entry.path().filename().string().starts_with("index")) {
+      continue;
+    }
+
+    unsigned int level;
+    std::string sharedCpuList;
+
+    if (!readUnsigned(entry.path() / "level", level) ||
+        !readLine(entry.path() / "shared_cpu_list", sharedCpuList) ||
+        (found && level <= lastLevel)) {
+      continue;
+    }
+
+    CpuSet const sharedCpus = parseCpuList(sharedCpuList);
+
+    if (!sharedCpus.empty()) {
+      lastLevel = level;
+      outDomainId = sharedCpus.front();
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+void readNumaNodes(CpuTopology& topology) {
+  std::error_code ec;
+
+  for (fs::directory_entry const& entry :
+       fs::directory_iterator{"/sys/devices/system/node", ec}) {
+    std::string const name = entry.path().filename().string();
+    unsigned int node;
+    std::string cpuList;
+
+    if (!name.starts_with("node") ||
+        !parseUnsigned(std::string_view{name}.substr(4), node) ||
+        !readLine(entry.path() / "cpulist", cpuList)) {
+      continue;
+    }
+
+    for (unsigned int const cpuId : parseCpuList(cpuList)) {
+      auto const cpu = std::lower_bound(
+          topology.cpus.begin(), topology.cpus.end(), cpuId,
+          [](LogicalCpu const& c, unsigned int id) { return c.id < id; });
+
+      if (cpu != topology.cpus.end() && cpu->id == cpuId) {
+        cpu->numaNode = node;
+      }
+    }
+  }
+}
+
+#endif
+
+} /*namespace*/
+
+CpuTopology readCpuTopology() {
+#ifdef __linux__
+  fs::path const cpuRootPath = "/sys/devices/system/cpu";
+  std::string onlineCpuList;
+
+  if (!readLine(cpuRootPath / "online", onlineCpuList)) {
+    return makeFallbackTopology();
+  }
+
+  CpuTopology topology;
+
+  for (unsigned int const cpuId : parseCpuList(onlineCpuList)) {
+    fs::path const cpuPath = cpuRootPath / ("cpu" + std::to_string(cpuId));
+    LogicalCpu& cpu = topology.cpus.emplace_back();
+    cpu.id = cpuId;
+
+    if (!readUnsigned(cpuPath / "topology" / "core_id", cpu.coreId)) {
+      cpu.coreId = cpuId;
+    }
+
+    if (!readUnsigned(cpuPath / "topology" / "physical_package_id",
+                      cpu.packageId)) {
+      cpu.packageId = 0;
+    }
+
+    if (!readCacheDomainId(cpuPath, cpu.cacheDomainId)) {
+      cpu.cacheDomainId = cpu.packageId;
+    }
+  }
+
+  if (topology.cpus.empty()) {
+    return makeFallbackTopology();
+  }
+
+  readNumaNodes(topology);
+
+  return topology;
+#else
+  return makeFallbackTopology();
+#endif
+}
+
+CpuSet parseCpuList(std::string_view cpuList) {
+  CpuSet result;
+
+  while (!cpuList.empty()) {
+    std::size_t const separatorPos = cpuList.find(',');
+    std::string_view range = cpuList.substr(0, separatorPos);
+
+    cpuList = separatorPos == std::string_view::npos
+                  ? std::string_view{}
+                  : cpuList.substr(separatorPos + 1);
+
+    std::size_t const rangeBegin = range.find_first_not_of(" \n");
+    std::size_t const rangeEnd = range.find_last_not_of(" \n");
+
+    range = rangeBegin == std::string_view::npos
+                ? std::string_view{}
+                : range.substr(rangeBegin, rangeEnd - rangeBegin + 1);
+
+    std::size_t const dashPos = range.find('-');
+    unsigned int first;
+    unsigned int last;
+
+    if (dashPos == std::string_view::npos) {
+      if (!parseUnsigned(range, first)) {
+        continue;
+      }
+
+      last = first;
+    } else if (!parseUnsigned(range.substr(0, dashPos), first) ||
+               !parseUnsigned(range.substr(dashPos + 1), last)) {
+      continue;
+    }
+
+    if (last < first) {
+      continue;
+    }
+
+    for (unsigned int cpu = first; cpu != last; ++cpu) {
+      result.push_back(cpu);
+    }
+
+    result.push_back(last);
+  }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+
+  return result;
+}
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,173 @@
+#include <obsidian/platform/directory_watcher.hpp>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::platform {
+
+DirectoryWatcher::~DirectoryWatcher() { stop(); }
+
+bool DirectoryWatcher::watch(fs::path const& rootPath) {
+  stop();
+
+#ifdef __linux__
+  _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  if (_fd < 0) {
+    return false;
+  }
+
+  _rootPath = rootPath;
+  addWatches({});
+
+  if (_watchedDirs.empty()) {
+    stop();
+    return false;
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void DirectoryWatcher::stop() {
+#ifdef __linux__
+  if (_fd >= 0) {
+    // Closing the descriptor removes its watches.
+    close(_fd);
+  }
+#endif
+
+  _fd = -1;
+  _rootPath.clear();
+  _watchedDirs.clear();
+}
+
+bool DirectoryWatcher::isWatching() const { return _fd >= 0; }
+
+void DirectoryWatcher::addWatches(fs::path const& relativePath) {
+#ifdef __linux__
+  constexpr std::uint32_t mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE |
+                                 IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+  fs::path const dirPath = _rootPath / relativePath;
+  int const wd = inotify_add_watch(_fd, dirPath.c_str(), mask);
+
+  if (wd < 0) {
+    return;
+  }
+
+  _watchedDirs[wd] = relativePath;
+
+  // Directories created after the watch is added get reported and watched
+  // when the events are polled, so none of them are missed.
+  std::error_code ec;
+
+  for (fs::recursive_directory_iterator it{dirPath, ec}, end; !ec && it != end;
+       it.increment(ec)) {
+    if (it->is_directory(ec) && !it->is_symlink(ec)) {
+      int const subdirWd = inotify_add_watch(_fd, it->path().c_str(), mask);
+
+      if (subdirWd >= 0) {
+        _watchedDirs[subdirWd] = it->path().lexically_relative(_rootPath);
+      }
+    }
+  }
+#endif
+}
+
+void DirectoryWatcher::removeWatches(fs::path const& relativePath) {
+#ifdef __linux__
+  for (auto it = _watchedDirs.begin(); it != _watchedDirs.end();) {
+    auto const [mismatch, _] =
+        std::mismatch(relativePath.begin(), relativePath.end(),
+                      it->second.begin(), it->second.end());
+
+    if (mismatch == relativePath.end()) {
+      inotify_rm_watch(_fd, it->first);
+      it = _watchedDirs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+#endif
+}
+
+void DirectoryWatcher::pollChanges(std::vector<Change>& outChanges) {
+#ifdef __linux__
+  if (_fd < 0) {
+    return;
+  }
+
+  alignas(inotify_event) char buffer[16 * 1024];
+
+  while (true) {
+    ssize_t const readSize = read(_fd, buffer, sizeof(buffer));
+
+    if (readSize <= 0) {
+      if (readSize < 0 && errno == EINTR) {
+        continue;
+      }
+
+      // EAGAIN once every event was read
+      return;
+    }
+
+    for (std::size_t offset = 0; offset < static_cast<std::size_t>(readSize);) {
+      inotify_event event;
+      std::memcpy(&event, buffer + offset, sizeof(event));
+      char const* const name = buffer + offset + sizeof(event);
+      offset += sizeof(event) + event.len;
+
+      if (event.mask & IN_Q_OVERFLOW) {
+        outChanges.push_back({ChangeType::overflow, {}});
+        continue;
+      }
+
+      if (event.mask & IN_IGNORED) {
+        // The directory was deleted or moved out of the tree.
+        _watchedDirs.erase(event.wd);
+        continue;
+      }
+
+      auto const dirIt = _watchedDirs.find(event.wd);
+
+      if (dirIt == _watchedDirs.cend() || !event.len) {
+        continue;
+      }
+
+      fs::path const path = dirIt->second / name;
+
+      if (event.mask & IN_ISDIR) {
+        if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+          addWatches(path);
+          outChanges.push_back({ChangeType::directoryAdded, path});
+        } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+          // Moved directories keep their watches, which would report their
+          // old paths.
+          removeWatches(path);
+          outChanges.push_back({ChangeType::directoryRemoved, path});
+        }
+      } else if (event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+        outChanges.push_back({ChangeType::fileChanged, path});
+      } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+        outChanges.push_back({ChangeType::fileRemoved, path});
+      }
+    }
+  }
+#endif
+}
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,163 @@
+#include <obsidian/platform/mapped_file.hpp>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif _WIN32
+#include <Windows.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::platform {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)},
+      _size{std::exchange(other._size, 0)} {}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+  }
+
+  return *this;
+}
+
+bool MappedFile::map(fs::path const& path) {
+  unmap();
+
+#ifdef __linux__
+  int const fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat fileStat;
+
+  if (fstat(fd, &fileStat) || fileStat.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+
+  std::size_t const size = static_cast<std::size_t>(fileStat.st_size);
+  void* const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // The mapping keeps the file referenced.
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  _data = static_cast<char const*>(data);
+  _size = size;
+
+  return true;
+#elif _WIN32
+  HANDLE const file =
+      CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE const mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+
+  if (!mapping) {
+    return false;
+  }
+
+  void const* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+  // The view keeps the mapping referenced.
+  CloseHandle(mapping);
+
+  if (!data) {
+    return false;
+  }
+
+  _data = static_cast<char const*>(data);
+  _size = static_cast<std::size_t>(fileSize.QuadPart);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void MappedFile::unmap() {
+  if (!_data) {
+    return;
+  }
+
+#ifdef __linux__
+  munmap(const_cast<char*>(_data), _size);
+#elif _WIN32
+  UnmapViewOfFile(_data);
+#endif
+
+  _data = nullptr;
+  _size = 0;
+}
+
+bool MappedFile::isMapped() const { return _data; }
+
+std::span<char const> MappedFile::getData() const { return {_data, _size}; }
+
+void MappedFile::advise(AccessHint hint, std::size_t offset,
+                        std::size_t size) const {
+  if (offset >= _size) {
+    return;
+  }
+
+  size = std::min(size, _size - offset);
+
+#ifdef __linux__
+  // madvise needs a page aligned start.
+  std::uintptr_t const pageSize =
+      static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+  std::uintptr_t const start =
+      reinterpret_cast<std::uintptr_t>(_data + offset);
+  std::uintptr_t const alignedStart = start & ~(pageSize - 1);
+
+  int advice = MADV_WILLNEED;
+
+  if (hint == AccessHint::sequential) {
+    advice = MADV_SEQUENTIAL;
+  } else if (hint == AccessHint::random) {
+    advice = MADV_RANDOM;
+  }
+
+  madvise(reinterpret_cast<void*>(alignedStart), size + (start - alignedStart),
+          advice);
+#elif _WIN32
+  if (hint == AccessHint::willNeed) {
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<char*>(_data + offset), size};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#endif
+}
+
+} /*namespace obsidian::platform*/
@@ -0,0 +1,59 @@
+#include <obsidian/platform/thread.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif _WIN32
+#include <Windows.h>
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace obsidian::platform {
+
+bool setCurrentThreadAffinity(CpuSet const& cpus) {
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+
+  for (unsigned int const cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpuSet);
+    }
+  }
+
+  if (!CPU_COUNT(&cpuSet)) {
+    return false;
+  }
+
+  return !pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#elif _WIN32
+  // Only the cpus of the calling thread's processor group can be used.
+  DWORD_PTR mask = 0;
+
+  for (unsigned int const cpu : cpus) {
+    if (cpu < sizeof(DWORD_PTR) * 8) {
+      mask |= DWORD_PTR{1} << cpu;
+    }
+  }
+
+  return mask && SetThreadAffinityMask(GetCurrentThread(), mask);
+#else
+  return false;
+#endif
+}
+
+void setCurrentThreadName(std::string const& name) {
+#ifdef __linux__
+  constexpr std::size_t maxNameLength = 15;
+
+  pthread_setname_np(pthread_self(), name.substr(0, maxNameLength).c_str());
+#elif _WIN32
+  std::wstring const wideName{name.cbegin(), name.cend()};
+
+  SetThreadDescription(GetCurrentThread(), wideName.c_str());
+#endif
+}
+
+} /*namespace obsidian::platform*/
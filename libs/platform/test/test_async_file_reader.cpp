@@ -0,0 +1,205 @@
+#include <obsidian/platform/async_file_reader.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+using namespace obsidian::platform;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::size_t fileSize = 1024 * 1024 + 123;
+
+struct ReadResult {
+  bool success;
+  std::vector<char> data;
+};
+
+char getFileByte(std::size_t offset) {
+  return static_cast<char>(offset * 7 + offset / 4096);
+}
+
+fs::path getTestFilePath() {
+  fs::path const dir =
+      fs::temp_directory_path() / "obsidian_test_async_file_reader";
+  fs::path const path = dir / "file.bin";
+
+  if (!fs::exists(path)) {
+    fs::create_directories(dir);
+
+    std::vector<char> data(fileSize);
+
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      data[i] = getFileByte(i);
+    }
+
+    std::ofstream file{path, std::ios_base::out | std::ios_base::binary};
+    file.write(data.data(), data.size());
+  }
+
+  return path;
+}
+
+bool matchesFile(std::vector<char> const& data, std::size_t offset) {
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    if (data[i] != getFileByte(offset + i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+ReadResult readAndWait(AsyncFileReader& reader, fs::path const& path,
+                       std::uint64_t offset, std::size_t size) {
+  std::promise<ReadResult> promise;
+  std::future<ReadResult> result = promise.get_future();
+
+  reader.read(path, offset, size,
+              [&promise](bool success, std::vector<char> data) {
+                promise.set_value({success, std::move(data)});
+              });
+
+  return result.get();
+}
+
+std::string getBackendName(
+    testing::TestParamInfo<AsyncFileReader::Backend> const& info) {
+  return info.param == AsyncFileReader::Backend::ioUring ? "io_uring"
+                                                         : "thread_pool";
+}
+
+// Runs every test with both backends. The io_uring tests are skipped where
+// the reader falls back to the thread pool.
+class async_file_reader
+    : public testing::TestWithParam<AsyncFileReader::Backend> {
+protected:
+  void SetUp() override {
+    bool const preferIoUring = GetParam() == AsyncFileReader::Backend::ioUring;
+    _reader.init(queueDepth, 2, preferIoUring);
+
+    if (_reader.getBackend() != GetParam()) {
+      GTEST_SKIP() << "io_uring isn't available.";
+    }
+  }
+
+  static constexpr unsigned int queueDepth = 4;
+
+  AsyncFileReader _reader;
+};
+
+} /*namespace*/
+
+TEST_P(async_file_reader, reads_ranges_at_offsets) {
+  // arrange
+  fs::path const path = getTestFilePath();
+
+  struct Range {
+    std::uint64_t offset;
+    std::size_t size;
+  };
+
+  std::vector<Range> const ranges = {
+      {0, 1}, {0, fileSize}, {4095, 2}, {100000, 300000}, {fileSize - 1, 1}};
+
+  for (Range const range : ranges) {
+    // act
+    ReadResult const result =
+        readAndWait(_reader, path, range.offset, range.size);
+
+    // assert
+    ASSERT_TRUE(result.success) << range.offset << ", " << range.size;
+    ASSERT_EQ(result.data.size(), range.size);
+    EXPECT_TRUE(matchesFile(result.data, range.offset))
+        << range.offset << ", " << range.size;
+  }
+}
+
+TEST_P(async_file_reader, zero_size_read_succeeds) {
+  // arrange
+  fs::path const path = getTestFilePath();
+
+  // act
+  ReadResult const atStart = readAndWait(_reader, path, 0, 0);
+  ReadResult const atEnd = readAndWait(_reader, path, fileSize, 0);
+
+  // assert
+  EXPECT_TRUE(atStart.success);
+  EXPECT_TRUE(atStart.data.empty());
+  EXPECT_TRUE(atEnd.success);
+  EXPECT_TRUE(atEnd.data.empty());
+}
+
+TEST_P(async_file_reader, read_past_end_of_file_fails) {
+  // arrange
+  fs::path const path = getTestFilePath();
+
+  // act
+  ReadResult const overlapping = readAndWait(_reader, path, fileSize - 10, 11);
+  ReadResult const behind = readAndWait(_reader, path, fileSize + 10, 1);
+
+  // assert
+  EXPECT_FALSE(overlapping.success);
+  EXPECT_TRUE(overlapping.data.empty());
+  EXPECT_FALSE(behind.success);
+  EXPECT_TRUE(behind.data.empty());
+}
+
+TEST_P(async_file_reader, read_of_missing_file_fails) {
+  // act
+  ReadResult const result = readAndWait(
+      _reader, getTestFilePath().parent_path() / "missing.bin", 0, 10);
+
+  // assert
+  EXPECT_FALSE(result.success);
+  EXPECT_TRUE(result.data.empty());
+}
+
+TEST_P(async_file_reader, shutdown_completes_queued_reads) {
+  // arrange
+  fs::path const path = getTestFilePath();
+  constexpr std::size_t readCount = 64;
+
+  std::atomic<std::size_t> completed = 0;
+  std::atomic<std::size_t> corrupt = 0;
+
+  // Many more reads than the queue depth, so that most of them still wait
+  // when the reader shuts down.
+  for (std::size_t i = 0; i < readCount; ++i) {
+    std::uint64_t const offset = i * 1000;
+
+    _reader.read(path, offset, fileSize - offset,
+                 [&, offset](bool success, std::vector<char> data) {
+                   if (success) {
+                     corrupt += !matchesFile(data, offset);
+                   }
+                   ++completed;
+                 });
+  }
+
+  // act
+  _reader.shutdown();
+
+  // assert
+  EXPECT_EQ(completed, readCount);
+  EXPECT_EQ(corrupt, 0u);
+  EXPECT_EQ(_reader.getBackend(), AsyncFileReader::Backend::none);
+
+  ReadResult const afterShutdown = readAndWait(_reader, path, 0, 10);
+  EXPECT_FALSE(afterShutdown.success);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    backends, async_file_reader,
+    testing::Values(AsyncFileReader::Backend::threadPool,
+                    AsyncFileReader::Backend::ioUring),
+    getBackendName);
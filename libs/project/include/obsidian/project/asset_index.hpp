@@ -0,0 +1,104 @@
+#pragma once
+
+#include <obsidian/platform/directory_watcher.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace obsidian::project {
+
+// The index of a project's assets, kept in the project root.
+constexpr char const* projectAssetIndexName = ".asset_index.obsidx";
+
+static constexpr std::uint32_t currentAssetIndexVersion = 0;
+
+enum class AssetFileType : std::uint32_t {
+  texture,
+  mesh,
+  shader,
+  material,
+  prefab,
+  scene
+};
+
+static constexpr std::size_t assetFileTypeCount = 6;
+
+// The type of the asset file by its extension, empty for other files.
+std::optional<AssetFileType>
+getAssetFileType(std::filesystem::path const& path);
+
+struct AssetIndexEntry {
+  AssetFileType type;
+  std::uint64_t size;
+  // ticks of the file clock
+  std::int64_t lastWriteTime;
+  // hash of the file content, changes only when the content does
+  std::uint64_t contentHash;
+};
+
+// Keeps track of the asset files in a project so that they can be listed by
+// type without walking the project. The index is saved in the project root
+// when it's closed, and opening it again only rehashes the files whose size
+// or last write time changed since. While it's open, the project is watched
+// and the index follows the changes to its files, where the platform
+// supports it. Not thread-safe.
+class AssetIndex {
+public:
+  AssetIndex() = default;
+  AssetIndex(AssetIndex const& other) = delete;
+  ~AssetIndex();
+
+  AssetIndex& operator=(AssetIndex const& other) = delete;
+
+  // Closes the previously opened index, if any. A missing or outdated index
+  // file is rebuilt from the project files.
+  bool open(std::filesystem::path projectRootPath);
+  // Saves the index if it changed since it was last saved.
+  void close();
+
+  bool isOpen() const;
+  // Whether update follows the changes to the project files. Otherwise, the
+  // index only changes with rescan.
+  bool isWatching() const;
+
+  // Applies the changes to the project files since the last call without
+  // walking the project. Returns true if the index changed.
+  bool update();
+  // Walks the whole project and brings the index up to date. Returns true if
+  // the index changed.
+  bool rescan();
+
+  bool save();
+
+  std::size_t getAssetCount() const;
+  AssetIndexEntry const*
+  findAsset(std::filesystem::path const& relativePath) const;
+
+  // Paths relative to the project root, sorted.
+  std::vector<std::filesystem::path> getAssetPaths(AssetFileType type) const;
+
+private:
+  bool load();
+  // Returns true if the entry for the file changed.
+  bool updateAsset(std::filesystem::path const& relativePath);
+  bool removeAsset(std::string const& key);
+  bool scanDirectory(std::filesystem::path const& relativePath);
+  bool removeDirectory(std::filesystem::path const& relativePath);
+
+  std::filesystem::path _projectRootPath;
+  // keyed by the generic form of the paths relative to the project root
+  std::unordered_map<std::string, AssetIndexEntry> _assets;
+  std::array<std::set<std::string>, assetFileTypeCount> _assetPathsByType;
+  platform::DirectoryWatcher _watcher;
+  std::vector<platform::DirectoryWatcher::Change> _changes;
+  bool _dirty = false;
+};
+
+} /*namespace obsidian::project*/
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <obsidian/project/asset_index.hpp>
+
 #include <filesystem>
 #include <string_view>
 #include <vector>
@@ -18,11 +20,20 @@ public:
   std::filesystem::path
   getRelativeToProjectRootPath(std::filesystem::path const& absolutePath) const;
 
+  // Asset files are listed from the asset index once it's open, other files
+  // by walking the project.
   std::vector<std::filesystem::path>
   getAllFilesWithExtension(std::string_view extension) const;
 
+  // Opens the index on first use, since it walks the project and watches its
+  // directories. Projects that never ask for it, like the runtime's, don't
+  // pay for that.
+  AssetIndex& getAssetIndex();
+
 private:
   std::filesystem::path _projectRootPath;
+  AssetIndex _assetIndex;
+  bool _assetIndexOpenFailed = false;
 };
 
 } /*namespace obsidian::project*/
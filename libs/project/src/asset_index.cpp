@@ -0,0 +1,490 @@
+#include <obsidian/core/logging.hpp>
+#include <obsidian/globals/file_extensions.hpp>
+#include <obsidian/platform/mapped_file.hpp>
+#include <obsidian/project/asset_index.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <span>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace obsidian::project {
+
+namespace {
+
+constexpr char assetIndexMagic[4] = {'o', 'b', 'a', 'i'};
+
+struct AssetIndexFileHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint64_t assetCount;
+};
+
+// Followed by the path of the asset.
+struct AssetIndexFileEntry {
+  std::uint64_t size;
+  std::int64_t lastWriteTime;
+  std::uint64_t contentHash;
+  std::uint32_t type;
+  std::uint32_t pathSize;
+};
+
+std::string getAssetKey(fs::path const& relativePath) {
+  return relativePath.lexically_normal().generic_string();
+}
+
+// Whether the path is the directory or inside of it.
+bool isInDirectory(std::string const& key, std::string const& directoryKey) {
+  return key.starts_with(directoryKey) &&
+         (key.size() == directoryKey.size() ||
+          key[directoryKey.size()] == '/');
+}
+
+// FNV-1a over 64-bit words, which is only used to tell the file contents
+// apart and reads large files several times faster than hashing bytes.
+std::uint64_t hashFileContent(std::span<char const> data) {
+  constexpr std::uint64_t prime = 1099511628211ull;
+  std::uint64_t hash = 14695981039346656037ull ^ data.size();
+
+  std::size_t i = 0;
+
+  for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    std::memcpy(&word, data.data() + i, sizeof(word));
+    hash = (hash ^ word) * prime;
+  }
+
+  for (; i < data.size(); ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+  }
+
+  return hash;
+}
+
+} /*namespace*/
+
+std::optional<AssetFileType> getAssetFileType(fs::path const& path) {
+  fs::path const extension = path.extension();
+
+  if (extension == globals::textureAssetExt) {
+    return AssetFileType::texture;
+  } else if (extension == globals::meshAssetExt) {
+    return AssetFileType::mesh;
+  } else if (extension == globals::shaderAssetExt) {
+    return AssetFileType::shader;
+  } else if (extension == globals::materialAssetExt) {
+    return AssetFileType::material;
+  } else if (extension == globals::prefabAssetExt) {
+    return AssetFileType::prefab;
+  } else if (path.filename().string().ends_with(globals::sceneAssetExt)) {
+    return AssetFileType::scene;
+  }
+
+  return std::nullopt;
+}
+
+AssetIndex::~AssetIndex() { close(); }
+
+bool AssetIndex::open(fs::path projectRootPath) {
+  close();
+
+  if (!fs::is_directory(projectRootPath)) {
+    OBS_LOG_ERR("Project path " + projectRootPath.string() +
+                " is not a directory.");
+    return false;
+  }
+
+  _projectRootPath = std::move(projectRootPath);
+
+  if (!load()) {
+    _assets.clear();
+
+    for (std::set<std::string>& paths : _assetPathsByType) {
+      paths.clear();
+    }
+  }
+
+  // Watched before the scan, so that the changes made during it aren't
+  // missed.
+  if (!_watcher.watch(_projectRootPath)) {
+    OBS_LOG_MSG("The project files can't be watched, the asset index is "
+                "only updated by rescanning the project.");
+  }
+
+  rescan();
+
+  if (_dirty) {
+    save();
+  }
+
+  return true;
+}
+
+void AssetIndex::close() {
+  if (!isOpen()) {
+    return;
+  }
+
+  if (_dirty) {
+    save();
+  }
+
+  _watcher.stop();
+  _changes.clear();
+  _assets.clear();
+
+  for (std::set<std::string>& paths : _assetPathsByType) {
+    paths.clear();
+  }
+
+  _projectRootPath.clear();
+  _dirty = false;
+}
+
+bool AssetIndex::isOpen() const { return !_projectRootPath.empty(); }
+
+bool AssetIndex::isWatching() const { return _watcher.isWatching(); }
+
+bool AssetIndex::update() {
+  if (!isWatching()) {
+    return false;
+  }
+
+  _changes.clear();
+  _watcher.pollChanges(_changes);
+
+  bool changed = false;
+
+  for (platform::DirectoryWatcher::Change const& change : _changes) {
+    switch (change.type) {
+    case platform::DirectoryWatcher::ChangeType::fileChanged:
+      changed |= updateAsset(change.path);
+      break;
+    case platform::DirectoryWatcher::ChangeType::fileRemoved:
+      changed |= removeAsset(getAssetKey(change.path));
+      break;
+    case platform::DirectoryWatcher::ChangeType::directoryAdded:
+      changed |= scanDirectory(change.path);
+      break;
+    case platform::DirectoryWatcher::ChangeType::directoryRemoved:
+      changed |= removeDirectory(change.path);
+      break;
+    case platform::DirectoryWatcher::ChangeType::overflow:
+      OBS_LOG_WARN("Lost track of the project file changes, rescanning the "
+                   "project.");
+      return rescan() || changed;
+    }
+  }
+
+  return changed;
+}
+
+bool AssetIndex::rescan() {
+  if (!isOpen()) {
+    OBS_LOG_WARN("Asset index not open.");
+    return false;
+  }
+
+  std::unordered_set<std::string> foundKeys;
+  foundKeys.reserve(_assets.size());
+
+  bool changed = false;
+  std::error_code errorCode;
+
+  for (fs::recursive_directory_iterator it{_projectRootPath, errorCode}, end;
+       !errorCode && it != end; it.increment(errorCode)) {
+    if (!it->is_regular_file(errorCode) || !getAssetFileType(it->path())) {
+      continue;
+    }
+
+    fs::path const relativePath =
+        it->path().lexically_relative(_projectRootPath);
+    changed |= updateAsset(relativePath);
+    foundKeys.insert(getAssetKey(relativePath));
+  }
+
+  if (errorCode) {
+    OBS_LOG_WARN("Failed to scan the project " + _projectRootPath.string() +
+                 ": " + errorCode.message());
+    // Entries of files that weren't reached are kept.
+    return changed;
+  }
+
+  std::vector<std::string> removedKeys;
+
+  for (auto const& [key, entry] : _assets) {
+    if (!foundKeys.contains(key)) {
+      removedKeys.push_back(key);
+    }
+  }
+
+  for (std::string const& key : removedKeys) {
+    changed |= removeAsset(key);
+  }
+
+  return changed;
+}
+
+bool AssetIndex::save() {
+  if (!isOpen()) {
+    OBS_LOG_WARN("Asset index not open.");
+    return false;
+  }
+
+  fs::path const indexPath = _projectRootPath / projectAssetIndexName;
+  fs::path tempPath = indexPath;
+  tempPath += ".tmp";
+
+  AssetIndexFileHeader header;
+  std::memcpy(header.magic, assetIndexMagic, sizeof(header.magic));
+  header.version = currentAssetIndexVersion;
+  header.assetCount = _assets.size();
+
+  std::ofstream outputFileStream;
+  outputFileStream.exceptions(std::ios_base::failbit);
+
+  try {
+    outputFileStream.open(tempPath,
+                          std::ios_base::out | std::ios_base::binary);
+    outputFileStream.write(reinterpret_cast<char const*>(&header),
+                           sizeof(header));
+
+    for (auto const& [key, entry] : _assets) {
+      AssetIndexFileEntry const fileEntry = {
+          entry.size, entry.lastWriteTime, entry.contentHash,
+          static_cast<std::uint32_t>(entry.type),
+          static_cast<std::uint32_t>(key.size())};
+
+      outputFileStream.write(reinterpret_cast<char const*>(&fileEntry),
+                             sizeof(fileEntry));
+      outputFileStream.write(key.data(), key.size());
+    }
+
+    outputFileStream.close();
+  } catch (std::ios_base::failure const& e) {
+    OBS_LOG_ERR("Failed to write asset index " + tempPath.string() + ": " +
+                e.what());
+    return false;
+  }
+
+  std::error_code errorCode;
+  fs::rename(tempPath, indexPath, errorCode);
+
+  if (errorCode) {
+    OBS_LOG_ERR("Failed to replace " + indexPath.string() + ": " +
+                errorCode.message());
+    fs::remove(tempPath, errorCode);
+    return false;
+  }
+
+  _dirty = false;
+
+  return true;
+}
+
+std::size_t AssetIndex::getAssetCount() const { return _assets.size(); }
+
+AssetIndexEntry const*
+AssetIndex::findAsset(fs::path const& relativePath) const {
+  auto const it = _assets.find(getAssetKey(relativePath));
+  return it == _assets.cend() ? nullptr : &it->second;
+}
+
+std::vector<fs::path> AssetIndex::getAssetPaths(AssetFileType type) const {
+  std::set<std::string> const& paths =
+      _assetPathsByType[static_cast<std::size_t>(type)];
+
+  return {paths.cbegin(), paths.cend()};
+}
+
+bool AssetIndex::load() {
+  fs::path const indexPath = _projectRootPath / projectAssetIndexName;
+
+  if (!fs::exists(indexPath)) {
+    return false;
+  }
+
+  platform::MappedFile indexFile;
+
+  if (!indexFile.map(indexPath)) {
+    OBS_LOG_WARN("Failed to read asset index " + indexPath.string());
+    return false;
+  }
+
+  std::span<char const> data = indexFile.getData();
+
+  AssetIndexFileHeader header;
+
+  if (data.size() < sizeof(header)) {
+    OBS_LOG_WARN("Asset index " + indexPath.string() + " is corrupted.");
+    return false;
+  }
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  data = data.subspan(sizeof(header));
+
+  if (std::memcmp(header.magic, assetIndexMagic, sizeof(header.magic)) ||
+      header.version != currentAssetIndexVersion) {
+    OBS_LOG_MSG("Asset index " + indexPath.string() +
+                " is outdated, rebuilding it.");
+    return false;
+  }
+
+  _assets.reserve(header.assetCount);
+
+  for (std::uint64_t i = 0; i < header.assetCount; ++i) {
+    AssetIndexFileEntry fileEntry;
+
+    if (data.size() < sizeof(fileEntry)) {
+      OBS_LOG_WARN("Asset index " + indexPath.string() + " is corrupted.");
+      return false;
+    }
+
+    std::memcpy(&fileEntry, data.data(), sizeof(fileEntry));
+    data = data.subspan(sizeof(fileEntry));
+
+    if (data.size() < fileEntry.pathSize ||
+        fileEntry.type >= assetFileTypeCount) {
+      OBS_LOG_WARN("Asset index " + indexPath.string() + " is corrupted.");
+      return false;
+    }
+
+    std::string key{data.data(), fileEntry.pathSize};
+    data = data.subspan(fileEntry.pathSize);
+
+    AssetFileType const type = static_cast<AssetFileType>(fileEntry.type);
+
+    _assetPathsByType[fileEntry.type].insert(key);
+    _assets.emplace(std::move(key),
+                    AssetIndexEntry{type, fileEntry.size,
+                                    fileEntry.lastWriteTime,
+                                    fileEntry.contentHash});
+  }
+
+  return true;
+}
+
+bool AssetIndex::updateAsset(fs::path const& relativePath) {
+  std::optional<AssetFileType> const type = getAssetFileType(relativePath);
+
+  if (!type) {
+    return false;
+  }
+
+  std::string key = getAssetKey(relativePath);
+  fs::path const absolutePath = _projectRootPath / relativePath;
+
+  std::error_code errorCode;
+  fs::file_status const status = fs::status(absolutePath, errorCode);
+
+  if (errorCode || !fs::is_regular_file(status)) {
+    return removeAsset(key);
+  }
+
+  std::uint64_t const size = fs::file_size(absolutePath, errorCode);
+  fs::file_time_type const lastWriteTime =
+      fs::last_write_time(absolutePath, errorCode);
+
+  if (errorCode) {
+    return removeAsset(key);
+  }
+
+  AssetIndexEntry entry = {
+      *type, size,
+      static_cast<std::int64_t>(lastWriteTime.time_since_epoch().count()), 0};
+
+  auto const it = _assets.find(key);
+
+  if (it != _assets.cend() && it->second.type == entry.type &&
+      it->second.size == entry.size &&
+      it->second.lastWriteTime == entry.lastWriteTime) {
+    return false;
+  }
+
+  if (size) {
+    platform::MappedFile file;
+
+    if (!file.map(absolutePath)) {
+      OBS_LOG_WARN("Failed to read " + absolutePath.string() +
+                   " for the asset index.");
+      return removeAsset(key);
+    }
+
+    file.advise(platform::MappedFile::AccessHint::sequential, 0, size);
+    entry.contentHash = hashFileContent(file.getData());
+  } else {
+    entry.contentHash = hashFileContent({});
+  }
+
+  _dirty = true;
+
+  if (it != _assets.cend()) {
+    it->second = entry;
+    return true;
+  }
+
+  _assetPathsByType[static_cast<std::size_t>(entry.type)].insert(key);
+  _assets.emplace(std::move(key), entry);
+
+  return true;
+}
+
+bool AssetIndex::removeAsset(std::string const& key) {
+  auto const it = _assets.find(key);
+
+  if (it == _assets.cend()) {
+    return false;
+  }
+
+  _assetPathsByType[static_cast<std::size_t>(it->second.type)].erase(key);
+  _assets.erase(it);
+  _dirty = true;
+
+  return true;
+}
+
+bool AssetIndex::scanDirectory(fs::path const& relativePath) {
+  bool changed = false;
+  std::error_code errorCode;
+
+  for (fs::recursive_directory_iterator it{_projectRootPath / relativePath,
+                                           errorCode},
+       end;
+       !errorCode && it != end; it.increment(errorCode)) {
+    if (it->is_regular_file(errorCode) && getAssetFileType(it->path())) {
+      changed |=
+          updateAsset(it->path().lexically_relative(_projectRootPath));
+    }
+  }
+
+  return changed;
+}
+
+bool AssetIndex::removeDirectory(fs::path const& relativePath) {
+  std::string const directoryKey = getAssetKey(relativePath);
+  std::vector<std::string> removedKeys;
+
+  for (auto const& [key, entry] : _assets) {
+    if (isInDirectory(key, directoryKey)) {
+      removedKeys.push_back(key);
+    }
+  }
+
+  for (std::string const& key : removedKeys) {
+    removeAsset(key);
+  }
+
+  return !removedKeys.empty();
+}
+
+} /*namespace obsidian::project*/
@@ -5,6 +5,8 @@
 
 #include <exception>
 #include <filesystem>
+#include <optional>
+#include <string>
 
 using namespace obsidian;
 using namespace obsidian::project;
@@ -49,6 +51,9 @@ bool Project::open(fs::path projectRootPath) {
     return false;
   }
 
+  // Reopened for the new project when it's asked for.
+  _assetIndex.close();
+  _assetIndexOpenFailed = false;
   _projectRootPath = std::move(projectRootPath);
 
   return true;
@@ -73,6 +78,16 @@ Project::getAllFilesWithExtension(std::string_view extension) const {
     OBS_LOG_WARN("Project not open.");
     return {};
   }
+
+  // Matched as a file name, since the scene extension includes the stem.
+  fs::path const extensionFile = std::string{"file"}.append(extension);
+
+  if (std::optional<AssetFileType> const type =
+          getAssetFileType(extensionFile);
+      type && _assetIndex.isOpen()) {
+    return _assetIndex.getAssetPaths(*type);
+  }
+
   std::vector<fs::path> result;
 
   for (fs::directory_entry const& p :
@@ -88,3 +103,14 @@ Project::getAllFilesWithExtension(std::string_view extension) const {
 
   return result;
 }
+
+AssetIndex& Project::getAssetIndex() {
+  if (!_assetIndex.isOpen() && !_assetIndexOpenFailed &&
+      !_projectRootPath.empty() && !_assetIndex.open(_projectRootPath)) {
+    OBS_LOG_ERR("Failed to open the asset index of project " +
+                _projectRootPath.string());
+    _assetIndexOpenFailed = true;
+  }
+
+  return _assetIndex;
+}
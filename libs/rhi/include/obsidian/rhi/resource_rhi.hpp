@@ -3,13 +3,14 @@
 #include <obsidian/core/material.hpp>
 #include <obsidian/core/shapes.hpp>
 #include <obsidian/core/texture_format.hpp>
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_handle.hpp>
 
 #include <glm/glm.hpp>
 
 #include <atomic>
 #include <cstdint>
 #include <functional>
-#include <future>
 #include <variant>
 #include <vector>
 
@@ -31,6 +32,10 @@ struct UploadTextureRHI {
   std::uint32_t width;
   std::uint32_t height;
   std::uint32_t mipLevels;
+  // Size of what unpackFunc writes and where every mip level starts in it.
+  // The levels are copied to the image from there.
+  std::size_t textureDataSize;
+  std::vector<std::size_t> mipOffsets;
   std::function<void(char*)> unpackFunc;
   char const* debugName = nullptr;
 };
@@ -40,6 +45,11 @@ struct UploadMeshRHI {
   std::size_t vertexBufferSize;
   std::size_t indexCount;
   std::vector<std::size_t> indexBufferSizes;
+  // Size of what unpackFunc writes, which starts with the vertex buffer, and
+  // where every index buffer starts in it. Everything from the first index
+  // buffer on is copied to the index buffer as it is.
+  std::size_t meshDataSize;
+  std::vector<std::size_t> indexBufferOffsets;
   std::function<void(char*)> unpackFunc;
   core::Box3D aabb;
   bool hasNormals;
@@ -94,13 +104,18 @@ struct UploadMaterialRHI {
 class ResourceTransferRHI {
 public:
   ResourceTransferRHI() = default;
-  explicit ResourceTransferRHI(std::future<void> transferCompletedFuture);
+  explicit ResourceTransferRHI(task::TaskHandle<void> transferHandle);
 
   bool transferStarted() const;
   void waitCompleted() const;
+  task::TaskHandle<void> const& getTaskHandle() const;
+
+  // Resumes the awaiting coroutine on the thread that completes the transfer.
+  // Doesn't suspend if no transfer was started.
+  task::TaskHandleAwaiter<void> operator co_await() const;
 
 private:
-  std::future<void> _transferCompletedFuture;
+  task::TaskHandle<void> _transferHandle;
 };
 
 struct InitResourcesRHI {
@@ -1,21 +1,34 @@
 #include <obsidian/core/logging.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_handle.hpp>
+
+#include <utility>
 
 using namespace obsidian::rhi;
 
-ResourceTransferRHI::ResourceTransferRHI(
-    std::future<void> transferCompletedFuture)
-    : _transferCompletedFuture{std::move(transferCompletedFuture)} {}
+ResourceTransferRHI::ResourceTransferRHI(task::TaskHandle<void> transferHandle)
+    : _transferHandle{std::move(transferHandle)} {}
 
 bool ResourceTransferRHI::transferStarted() const {
-  return _transferCompletedFuture.valid();
+  return _transferHandle.valid();
 }
 
 void ResourceTransferRHI::waitCompleted() const {
-  if (!_transferCompletedFuture.valid()) {
+  if (!_transferHandle.valid()) {
     OBS_LOG_WARN("waitCompleted called on transfer that wasn't in progress");
     return;
   }
 
-  _transferCompletedFuture.wait();
+  _transferHandle.wait();
+}
+
+obsidian::task::TaskHandle<void> const&
+ResourceTransferRHI::getTaskHandle() const {
+  return _transferHandle;
+}
+
+obsidian::task::TaskHandleAwaiter<void>
+ResourceTransferRHI::operator co_await() const {
+  return task::TaskHandleAwaiter<void>{_transferHandle};
 }
@@ -2,8 +2,12 @@
 
 #include <obsidian/asset/asset.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 
 #include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <mutex>
@@ -17,6 +21,12 @@ class RHI;
 
 } /*namespace obsidian::rhi*/
 
+namespace obsidian::task {
+
+class TaskExecutor;
+
+} /*namespace obsidian::task*/
+
 namespace obsidian::runtime_resource {
 
 class RuntimeResourceManager;
@@ -69,14 +79,29 @@ public:
   RuntimeResourceState getResourceState() const;
   bool isResourceReady() const;
   rhi::ResourceIdRHI getResourceId() const;
-  void requestLoad();
+  // Dependencies that aren't loaded yet are requested with the same priority.
+  void requestLoad(task::TaskPriority priority = task::TaskPriority::normal);
   std::filesystem::path getRelativePath() const;
 
 private:
   void acquireRef();
   void releaseRef();
   void releaseFromRHI();
-  bool performAssetLoad();
+  // Reads the asset with the loader's file reader and continues on a worker
+  // of the given target, no thread blocks on the disk meanwhile. Completes
+  // with whether the asset got loaded. If the token gets cancelled before the
+  // read started, the load is cancelled instead.
+  task::TaskHandle<bool> performAssetLoad(task::TaskExecutor& executor,
+                                          task::TaskTarget target,
+                                          task::CancellationToken token,
+                                          std::uint32_t loadGeneration);
+  // Returns a resource whose load was dropped before the upload to its
+  // initial state. Does nothing if the resource went back to its initial
+  // state since loadGeneration was read, so that a dropped load can't reset
+  // a newer one.
+  void cancelLoad(std::uint32_t loadGeneration);
+  // Returns to the initial state and advances the load generation.
+  void resetLoadState();
   void releaseAsset();
   void performUploadToRHI();
   std::span<RuntimeResourceRef> fetchDependencies();
@@ -95,7 +120,11 @@ private:
   std::atomic<RuntimeResourceState> _resourceState =
       RuntimeResourceState::initial;
   std::atomic<std::uint32_t> _refCount = 0;
+  // Advances every time the resource returns to its initial state.
+  std::atomic<std::uint32_t> _loadGeneration = 0;
   rhi::ResourceTransferRHI _transferRHI;
+  // Completes when the upload to the RHI finished or was skipped.
+  task::TaskHandle<void> _uploadHandle;
 
   friend class RuntimeResourceLoader;
   friend class RuntimeResourceRef;
@@ -1,10 +1,15 @@
 #pragma once
 
-#include <condition_variable>
-#include <filesystem>
+#include <obsidian/platform/async_file_reader.hpp>
+#include <obsidian/runtime_resource/runtime_resource.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <unordered_set>
 #include <vector>
 
 namespace obsidian::task {
@@ -15,8 +20,6 @@ class TaskExecutor;
 
 namespace obsidian::runtime_resource {
 
-class RuntimeResource;
-
 class RuntimeResourceLoader {
 public:
   RuntimeResourceLoader() = default;
@@ -28,20 +31,45 @@ public:
 
   RuntimeResourceLoader& operator=(RuntimeResourceLoader const& other) = delete;
 
-  bool loadResource(RuntimeResource& runtimeResource);
+  // Schedules the asset load and the RHI upload of the resource. The upload
+  // waits for the load and for the uploads of all the resource's
+  // dependencies without blocking any thread in between. Both are queued with
+  // the given priority, so loads the current frame needs can overtake
+  // background prefetching.
+  bool loadResource(RuntimeResource& runtimeResource,
+                    task::TaskPriority priority);
+
+  // Drops the loads that didn't finish yet, for example because the scene
+  // that requested them was unloaded. Loads that already started reading or
+  // uploading finish their current step first. The dropped resources go back
+  // to their initial state and can be requested again.
+  void cancelPendingLoads();
+
+  // Waits only for the loads, not for the rest of the executor's work.
+  void waitPendingLoads();
+
+  // The executor passed to run, only valid while the loader is running.
+  task::TaskExecutor& getTaskExecutor() const;
+
+  // Reads the assets of the loads, so the workers don't wait for the disk.
+  platform::AsyncFileReader& getFileReader();
 
 private:
-  bool loadResImpl(RuntimeResource& runtimeResource);
-  void uploaderFunc();
-  void joinLoaderThread();
-
-  task::TaskExecutor* _taskExecutor;
-  std::mutex _queueMutex;
-  std::condition_variable _queueMutexCondVar;
-  std::thread _loaderThread;
-  std::vector<RuntimeResource*> _assetLoadQueue;
-  std::vector<RuntimeResource*> _rhiUploadQueue;
-  bool _running = false;
+  task::TaskHandle<void>
+  loadAndUpload(RuntimeResource* r, task::TaskPriority priority,
+                task::CancellationToken token, std::uint32_t loadGeneration,
+                std::vector<RuntimeResourceRef> deps,
+                std::vector<task::TaskHandle<void>> depUploadHandles);
+
+  task::TaskExecutor* _taskExecutor = nullptr;
+  platform::AsyncFileReader _fileReader;
+  // every load that didn't finish yet, including the cancelled ones
+  std::unique_ptr<task::TaskGroup> _allLoadsGroup;
+  // the loads requested since the last cancelPendingLoads call
+  std::unique_ptr<task::TaskGroup> _currentLoadsGroup;
+  // guards the upload handles of the resources and the load groups
+  std::mutex _uploadHandleMutex;
+  std::atomic<bool> _running = false;
 };
 
 } /*namespace obsidian::runtime_resource*/
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <obsidian/asset/asset.hpp>
+#include <obsidian/asset/asset_pack.hpp>
 #include <obsidian/project/project.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/runtime_resource/runtime_resource_loader.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 
 #include <filesystem>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace obsidian::rhi {
 
@@ -20,11 +27,11 @@ class Project;
 
 } /*namespace obsidian::project */
 
-namespace task {
+namespace obsidian::task {
 
 class TaskExecutor;
 
-} /*namespace task */
+} /*namespace obsidian::task*/
 
 namespace obsidian::runtime_resource {
 
@@ -43,14 +50,36 @@ public:
 
   void cleanup();
 
+  // See RuntimeResourceLoader::cancelPendingLoads.
+  void cancelPendingLoads();
+  void waitPendingLoads();
+
   RuntimeResourceRef getResource(std::filesystem::path const& path);
 
+  // Read the asset at the absolute path through the project's asset pack if
+  // the pack contains it, and from the loose file otherwise.
+  bool loadAsset(std::filesystem::path const& path,
+                 asset::Asset& outAsset) const;
+  bool loadAssetMetadata(std::filesystem::path const& path,
+                         asset::AssetMetadata& outAssetMetadata) const;
+  bool loadAssetDependencies(std::filesystem::path const& path,
+                             std::vector<std::string>& outDependencies) const;
+  // Same as loadAsset, but the asset is read by the loader's file reader and
+  // the returned handle completes on a worker of the given target. See
+  // asset::readAssetAsync.
+  task::TaskHandle<bool> loadAssetAsync(task::TaskExecutor& executor,
+                                        task::TaskTarget target,
+                                        std::filesystem::path const& path,
+                                        asset::Asset& outAsset,
+                                        task::CancellationToken token);
+
   project::Project const& getProject() const;
 
 private:
   rhi::RHI* _rhi = nullptr;
   project::Project* _project = nullptr;
   task::TaskExecutor* _taskExecutor = nullptr;
+  asset::AssetPack _assetPack;
   std::unordered_map<std::filesystem::path, RuntimeResource> _runtimeResources;
   RuntimeResourceLoader _resourceLoader;
 };
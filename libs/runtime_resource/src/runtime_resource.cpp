@@ -7,16 +7,21 @@
 #include <obsidian/asset/texture_asset_info.hpp>
 #include <obsidian/core/logging.hpp>
 #include <obsidian/core/material.hpp>
-#include <obsidian/core/utils/visitor.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/rhi/rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/runtime_resource/runtime_resource_loader.hpp>
 #include <obsidian/runtime_resource/runtime_resource_manager.hpp>
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_type.hpp>
 
 #include <cassert>
 #include <memory>
+#include <string>
 #include <variant>
+#include <vector>
 
 using namespace obsidian;
 using namespace obsidian::runtime_resource;
@@ -129,7 +134,7 @@ rhi::ResourceIdRHI RuntimeResource::getResourceId() const {
   return _resourceRHI ? _resourceRHI->id : rhi::rhiIdUninitialized;
 }
 
-void RuntimeResource::requestLoad() {
+void RuntimeResource::requestLoad(task::TaskPriority priority) {
   RuntimeResourceState expected = RuntimeResourceState::initial;
 
   if (_resourceState.compare_exchange_strong(
@@ -138,11 +143,11 @@ void RuntimeResource::requestLoad() {
 
     for (RuntimeResourceRef& d : deps) {
       if (d->getResourceState() == RuntimeResourceState::initial) {
-        d->requestLoad();
+        d->requestLoad(priority);
       }
     }
 
-    _runtimeResourceLoader.loadResource(*this);
+    _runtimeResourceLoader.loadResource(*this, priority);
     return;
   }
 
@@ -153,14 +158,14 @@ void RuntimeResource::requestLoad() {
            "RuntimeResourceState::assetLoadingFailed implies "
            "the rhi resource was not created.");
     releaseAsset();
-    _resourceState = RuntimeResourceState::initial;
+    resetLoadState();
   } else if (_resourceState == RuntimeResourceState::uploadedToRhi &&
              _resourceRHI &&
              _resourceRHI->state == rhi::ResourceState::invalid) {
     assert(!_asset && "RuntimeResourceState::uploadedToRhi implies the asset "
                       "is released from main memory.");
     releaseFromRHI();
-    _resourceState = RuntimeResourceState::initial;
+    resetLoadState();
   }
 }
 
@@ -179,7 +184,7 @@ void RuntimeResource::releaseRef() {
   if (!cnt) {
     releaseFromRHI();
     _dependencies.reset();
-    _resourceState = RuntimeResourceState::initial;
+    resetLoadState();
   }
 }
 
@@ -196,31 +201,76 @@ void RuntimeResource::releaseFromRHI() {
   }
 }
 
-bool RuntimeResource::performAssetLoad() {
-  std::scoped_lock l{_resourceMutex};
+task::TaskHandle<bool>
+RuntimeResource::performAssetLoad(task::TaskExecutor& executor,
+                                  task::TaskTarget target,
+                                  task::CancellationToken token,
+                                  std::uint32_t loadGeneration) {
+  // Keeps the asset alive while it is read, the lock isn't held in between.
+  std::shared_ptr<asset::Asset> asset;
+
+  {
+    std::scoped_lock l{_resourceMutex};
+
+    if (_resourceState != RuntimeResourceState::pendingLoad) {
+      OBS_LOG_ERR("Expected resource state in the method performAssetLoad is "
+                  "RuntimeResourceState::pendingLoad. The actual state is " +
+                  std::to_string((int)_resourceState.load()));
+      co_return false;
+    }
 
-  if (_resourceState != RuntimeResourceState::pendingLoad) {
-    OBS_LOG_ERR("Expected resource state in the method performAssetLoad is "
-                "RuntimeResourceState::pendingLoad. The actual state is " +
-                std::to_string((int)_resourceState.load()));
-    return false;
+    if (!_asset) {
+      _asset = std::make_shared<asset::Asset>();
+    }
+
+    asset = _asset;
+    _resourceState = RuntimeResourceState::assetLoading;
   }
 
-  if (!_asset) {
-    _asset = std::make_shared<asset::Asset>();
+  bool loadResult = asset->isLoaded;
+
+  if (!loadResult) {
+    loadResult = co_await _runtimeResourceManager.loadAssetAsync(
+        executor, target, _path, *asset, token);
   }
 
-  bool const loadResult =
-      _asset->isLoaded || asset::loadAssetFromFile(_path, *_asset);
+  if (token.isCancelled()) {
+    cancelLoad(loadGeneration);
+    co_return false;
+  }
 
   if (!loadResult) {
     OBS_LOG_ERR("Failed to load asset on path " + _path.string());
   }
 
+  std::scoped_lock l{_resourceMutex};
+
   _resourceState = loadResult ? RuntimeResourceState::assetLoaded
                               : RuntimeResourceState::assetLoadingFailed;
 
-  return loadResult;
+  co_return loadResult;
+}
+
+void RuntimeResource::cancelLoad(std::uint32_t loadGeneration) {
+  std::scoped_lock l{_resourceMutex};
+
+  if (loadGeneration != _loadGeneration) {
+    return;
+  }
+
+  RuntimeResourceState const state = _resourceState;
+
+  if (state == RuntimeResourceState::pendingLoad ||
+      state == RuntimeResourceState::assetLoading ||
+      state == RuntimeResourceState::assetLoaded) {
+    releaseAsset();
+    resetLoadState();
+  }
+}
+
+void RuntimeResource::resetLoadState() {
+  ++_loadGeneration;
+  _resourceState = RuntimeResourceState::initial;
 }
 
 void RuntimeResource::releaseAsset() {
@@ -271,6 +321,8 @@ void RuntimeResource::performUploadToRHI() {
     uploadMesh.vertexBufferSize = info.vertexBufferSize;
     uploadMesh.indexCount = info.indexCount;
     uploadMesh.indexBufferSizes = info.indexBufferSizes;
+    uploadMesh.meshDataSize = info.unpackedSize;
+    uploadMesh.indexBufferOffsets = info.indexBufferOffsets;
     uploadMesh.unpackFunc = getUnpackFunc(info);
 
     uploadMesh.aabb = info.aabb;
@@ -301,6 +353,8 @@ void RuntimeResource::performUploadToRHI() {
     uploadTexture.width = info.width;
     uploadTexture.height = info.height;
     uploadTexture.mipLevels = info.mipLevels;
+    uploadTexture.textureDataSize = info.unpackedSize;
+    uploadTexture.mipOffsets = info.mipOffsets;
     uploadTexture.unpackFunc = getUnpackFunc(info);
     std::string const debugNameStr = _path.stem().string();
     uploadTexture.debugName = debugNameStr.c_str();
@@ -456,62 +510,22 @@ std::span<RuntimeResourceRef> RuntimeResource::fetchDependencies() {
   if (!_dependencies) {
     _dependencies.emplace();
 
-    if (!_asset) {
-      _asset = std::make_shared<asset::Asset>();
-    }
+    // Only the dependency table is read, the asset info is parsed later by
+    // the worker that loads the asset.
+    std::vector<std::string> dependencyPaths;
 
-    if (!_asset->metadata) {
-      _asset->metadata.emplace();
-      if (!asset::loadAssetMetadataFromFile(_path, *_asset->metadata)) {
-        OBS_LOG_WARN("Failed to load asset metadata file at path " +
-                     _path.string());
-        return *_dependencies;
-      }
+    if (!_runtimeResourceManager.loadAssetDependencies(_path,
+                                                       dependencyPaths)) {
+      OBS_LOG_WARN("Failed to load asset dependencies of the file at path " +
+                   _path.string());
+      return *_dependencies;
     }
 
-    if (asset::getAssetType(_asset->metadata->type) ==
-        asset::AssetType::material) {
-      asset::MaterialAssetInfo materialAssetInfo;
-      asset::readMaterialAssetInfo(*_asset->metadata, materialAssetInfo);
-
-      std::visit(
-          core::visitor{
-              [this](asset::UnlitMaterialAssetData const& unlitData) {
-                if (!unlitData.colorTexturePath.empty()) {
-                  _dependencies->push_back(_runtimeResourceManager.getResource(
-                      unlitData.colorTexturePath));
-                }
-              },
-              [this](asset::LitMaterialAssetData const& litData) {
-                if (!litData.diffuseTexturePath.empty()) {
-                  _dependencies->push_back(_runtimeResourceManager.getResource(
-                      litData.diffuseTexturePath));
-                }
-
-                if (!litData.normalMapTexturePath.empty()) {
-                  _dependencies->push_back(_runtimeResourceManager.getResource(
-                      litData.normalMapTexturePath));
-                }
-              },
-              [this](asset::PBRMaterialAssetData const& pbrData) {
-                _dependencies->push_back(_runtimeResourceManager.getResource(
-                    pbrData.albedoTexturePath));
-                _dependencies->push_back(_runtimeResourceManager.getResource(
-                    pbrData.normalMapTexturePath));
-                _dependencies->push_back(_runtimeResourceManager.getResource(
-                    pbrData.metalnessTexturePath));
-
-                if (!pbrData.roughnessTexturePath.empty()) {
-                  _dependencies->push_back(_runtimeResourceManager.getResource(
-                      pbrData.roughnessTexturePath));
-                }
-              }},
-          materialAssetInfo.materialSubtypeData);
-
-      _dependencies->push_back(_runtimeResourceManager.getResource(
-          materialAssetInfo.vertexShaderPath));
-      _dependencies->push_back(_runtimeResourceManager.getResource(
-          materialAssetInfo.fragmentShaderPath));
+    _dependencies->reserve(dependencyPaths.size());
+
+    for (std::string const& dependencyPath : dependencyPaths) {
+      _dependencies->push_back(
+          _runtimeResourceManager.getResource(dependencyPath));
     }
   }
 
@@ -525,8 +539,11 @@ std::function<void(char*)> RuntimeResource::getUnpackFunc(auto const& info) {
       return;
     }
 
-    asset::unpackAsset(info, _asset->binaryBlob.data(),
-                       _asset->binaryBlob.size(), dst);
+    // Chunked blobs are unpacked in parallel by the general workers, with
+    // the calling transfer worker taking part.
+    asset::unpackAsset(info, *_asset, dst,
+                       _runtimeResourceLoader.getTaskExecutor(),
+                       task::TaskType::general);
     releaseAsset();
   };
 }
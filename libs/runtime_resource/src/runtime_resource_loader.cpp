@@ -1,13 +1,21 @@
 #include <obsidian/core/logging.hpp>
+#include <obsidian/platform/async_file_reader.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/runtime_resource/runtime_resource_loader.hpp>
+#include <obsidian/task/task_coroutine.hpp>
 #include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 #include <obsidian/task/task_type.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <memory>
 #include <mutex>
-#include <thread>
+#include <span>
+#include <vector>
 
 using namespace obsidian::runtime_resource;
 
@@ -16,104 +24,138 @@ RuntimeResourceLoader::~RuntimeResourceLoader() { cleanup(); }
 void RuntimeResourceLoader::run(task::TaskExecutor& taskExecutor) {
   _running = true;
   _taskExecutor = &taskExecutor;
-  _loaderThread = std::thread{[this]() { uploaderFunc(); }};
+  _fileReader.init();
+  _allLoadsGroup = std::make_unique<task::TaskGroup>(taskExecutor);
+  _currentLoadsGroup = std::make_unique<task::TaskGroup>(taskExecutor);
 }
 
 void RuntimeResourceLoader::cleanup() {
-  joinLoaderThread();
+  _running = false;
+
+  if (_allLoadsGroup) {
+    cancelPendingLoads();
+    waitPendingLoads();
+  }
+
+  _fileReader.shutdown();
+  _allLoadsGroup.reset();
+  _currentLoadsGroup.reset();
   _taskExecutor = nullptr;
 }
 
-bool RuntimeResourceLoader::loadResource(RuntimeResource& runtimeResource) {
-  std::unique_lock l{_queueMutex};
+void RuntimeResourceLoader::cancelPendingLoads() {
+  std::scoped_lock l{_uploadHandleMutex};
 
-  bool const uploadAppended = loadResImpl(runtimeResource);
+  if (!_currentLoadsGroup) {
+    return;
+  }
 
-  l.unlock();
+  _currentLoadsGroup->cancel();
+  // The cancelled loads keep the old group's state alive until they return.
+  _currentLoadsGroup = std::make_unique<task::TaskGroup>(*_taskExecutor);
+}
 
-  if (uploadAppended) {
-    _queueMutexCondVar.notify_one();
+void RuntimeResourceLoader::waitPendingLoads() {
+  if (_allLoadsGroup) {
+    _allLoadsGroup->wait();
   }
+}
 
-  return uploadAppended;
+obsidian::task::TaskExecutor& RuntimeResourceLoader::getTaskExecutor() const {
+  assert(_taskExecutor);
+  return *_taskExecutor;
 }
 
-bool RuntimeResourceLoader::loadResImpl(RuntimeResource& runtimeResource) {
-  if (runtimeResource.getResourceState() != RuntimeResourceState::pendingLoad) {
+obsidian::platform::AsyncFileReader& RuntimeResourceLoader::getFileReader() {
+  return _fileReader;
+}
+
+bool RuntimeResourceLoader::loadResource(RuntimeResource& runtimeResource,
+                                         task::TaskPriority priority) {
+  if (!_running ||
+      runtimeResource.getResourceState() != RuntimeResourceState::pendingLoad) {
     return false;
   }
 
-  _assetLoadQueue.push_back(&runtimeResource);
-  return true;
-}
+  assert(_taskExecutor);
 
-void RuntimeResourceLoader::uploaderFunc() {
-  while (_running) {
-    std::unique_lock l{_queueMutex};
+  RuntimeResource* const r = &runtimeResource;
 
-    _queueMutexCondVar.wait(l, [this]() {
-      return !_running || _assetLoadQueue.size() || _rhiUploadQueue.size();
-    });
+  std::span<RuntimeResourceRef> const deps = r->fetchDependencies();
+  std::vector<RuntimeResourceRef> depsVec{deps.begin(), deps.end()};
 
-    if (!_running) {
-      return;
-    }
+  std::scoped_lock l{_uploadHandleMutex};
 
-    static std::vector<RuntimeResource*> resources;
+  std::vector<task::TaskHandle<void>> depUploadHandles;
+  depUploadHandles.reserve(depsVec.size());
 
-    resources.swap(_rhiUploadQueue);
+  for (RuntimeResourceRef& dep : depsVec) {
+    depUploadHandles.push_back(dep->_uploadHandle);
+  }
 
-    for (RuntimeResource* r : resources) {
-      if (r->getResourceState() != RuntimeResourceState::assetLoaded) {
-        _rhiUploadQueue.push_back(r);
-        continue;
-      }
+  // Only a stale load can reset the resource before this, and its
+  // cancelLoad is ignored once the generation advanced.
+  std::uint32_t const loadGeneration = r->_loadGeneration;
 
-      std::span<RuntimeResourceRef> const deps = r->fetchDependencies();
-      std::vector<RuntimeResourceRef> depsVec{deps.begin(), deps.end()};
+  r->_uploadHandle = loadAndUpload(r, priority, _currentLoadsGroup->getToken(),
+                                   loadGeneration, std::move(depsVec),
+                                   std::move(depUploadHandles));
+  _allLoadsGroup->add(r->_uploadHandle);
+  _currentLoadsGroup->add(r->_uploadHandle);
 
-      bool const depsReady = std::all_of(
-          depsVec.begin(), depsVec.end(),
-          [](RuntimeResourceRef& r) { return r->isResourceReady(); });
+  return true;
+}
 
-      if (depsReady) {
-        _taskExecutor->enqueue(
-            task::TaskType::resourceUpload,
-            [r, /*hold references so they don't get deallocated*/ depsV =
-                    std::move(depsVec)] { r->performUploadToRHI(); });
-      } else {
-        _rhiUploadQueue.push_back(r);
-      }
-    }
+obsidian::task::TaskHandle<void> RuntimeResourceLoader::loadAndUpload(
+    RuntimeResource* r, task::TaskPriority priority,
+    task::CancellationToken token, std::uint32_t loadGeneration,
+    /*hold references so they don't get deallocated*/
+    std::vector<RuntimeResourceRef> deps,
+    std::vector<task::TaskHandle<void>> depUploadHandles) {
+  task::TaskExecutor& executor = *_taskExecutor;
 
-    resources.clear();
+  co_await r->performAssetLoad(executor, {task::TaskType::general, priority},
+                               token, loadGeneration);
 
-    resources.swap(_assetLoadQueue);
+  // A material is uploaded after the textures and shaders it refers to.
+  co_await task::whenAll(depUploadHandles);
 
-    for (RuntimeResource* r : resources) {
-      if (r->getResourceState() == RuntimeResourceState::pendingLoad) {
-        _taskExecutor->enqueue(task::TaskType::general,
-                               [r]() { r->performAssetLoad(); });
-        _rhiUploadQueue.push_back(r);
-      } else {
-        _assetLoadQueue.push_back(r);
-      }
-    }
+  co_await executor.schedule({task::TaskType::resourceUpload, priority});
 
-    resources.clear();
+  if (token.isCancelled()) {
+    r->cancelLoad(loadGeneration);
+    co_return;
   }
-}
 
-void RuntimeResourceLoader::joinLoaderThread() {
-  std::unique_lock l{_queueMutex};
+  if (!_running || r->_loadGeneration != loadGeneration ||
+      r->getResourceState() != RuntimeResourceState::assetLoaded) {
+    co_return;
+  }
 
-  _running = false;
+  bool const depsReady =
+      std::all_of(deps.begin(), deps.end(), [](RuntimeResourceRef const& d) {
+        return d->isResourceReady();
+      });
+
+  bool const depsCancelled =
+      std::any_of(deps.begin(), deps.end(), [](RuntimeResourceRef const& d) {
+        return d->getResourceState() == RuntimeResourceState::initial;
+      });
+
+  if (!depsReady && depsCancelled) {
+    // A dependency shared with a cancelled load was dropped, so this resource
+    // has to be requested again.
+    r->cancelLoad(loadGeneration);
+    co_return;
+  }
 
-  l.unlock();
+  if (!depsReady) {
+    OBS_LOG_ERR("Resource " + r->_path.string() +
+                " won't be uploaded because its dependencies failed to load.");
+    co_return;
+  }
 
-  _queueMutexCondVar.notify_one();
+  r->performUploadToRHI();
 
-  if (_loaderThread.joinable()) {
-    _loaderThread.join();
-  }
+  co_await r->_transferRHI;
 }
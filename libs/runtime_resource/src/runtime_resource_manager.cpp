@@ -1,16 +1,24 @@
 #include <obsidian/asset/asset.hpp>
 #include <obsidian/asset/asset_info.hpp>
 #include <obsidian/asset/asset_io.hpp>
+#include <obsidian/asset/asset_pack.hpp>
 #include <obsidian/asset/shader_asset_info.hpp>
 #include <obsidian/core/logging.hpp>
+#include <obsidian/platform/async_file_reader.hpp>
 #include <obsidian/project/project.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/rhi/rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/runtime_resource/runtime_resource_manager.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <system_error>
 #include <tuple>
 #include <utility>
 
@@ -24,6 +32,14 @@ void RuntimeResourceManager::init(rhi::RHI& rhi, project::Project& project,
   _rhi = &rhi;
   _project = &project;
   _taskExecutor = &taskExecutor;
+
+  fs::path const assetPackPath =
+      project.getAbsolutePath(asset::projectAssetPackName);
+
+  if (fs::exists(assetPackPath) && !_assetPack.open(assetPackPath)) {
+    OBS_LOG_WARN("Reading the loose asset files instead of the asset pack.");
+  }
+
   _resourceLoader.run(taskExecutor);
 }
 
@@ -32,8 +48,7 @@ void RuntimeResourceManager::uploadInitRHIResources() {
   auto const loadShaderFunc = [this](rhi::UploadShaderRHI& uploadRHI,
                                      char const* path) {
     asset::Asset asset;
-    bool result =
-        asset::loadAssetFromFile(_project->getAbsolutePath(path), asset);
+    bool result = loadAsset(_project->getAbsolutePath(path), asset);
 
     assert(result && "Shader asset failed to load");
 
@@ -45,8 +60,7 @@ void RuntimeResourceManager::uploadInitRHIResources() {
     uploadRHI.shaderDataSize = assetInfo.unpackedSize;
     uploadRHI.unpackFunc = [asset = std::move(asset),
                             assetInfo = std::move(assetInfo)](char* dst) {
-      asset::unpackAsset(assetInfo, asset.binaryBlob.data(),
-                         asset.binaryBlob.size(), dst);
+      asset::unpackAsset(assetInfo, asset, dst);
     };
   };
 
@@ -74,6 +88,16 @@ void RuntimeResourceManager::cleanup() {
   if (_runtimeResources.size()) {
     _runtimeResources.clear();
   }
+
+  _assetPack.close();
+}
+
+void RuntimeResourceManager::cancelPendingLoads() {
+  _resourceLoader.cancelPendingLoads();
+}
+
+void RuntimeResourceManager::waitPendingLoads() {
+  _resourceLoader.waitPendingLoads();
 }
 
 RuntimeResourceRef RuntimeResourceManager::getResource(fs::path const& path) {
@@ -92,6 +116,67 @@ RuntimeResourceRef RuntimeResourceManager::getResource(fs::path const& path) {
   return RuntimeResourceRef{resourceIter->second};
 }
 
+bool RuntimeResourceManager::loadAsset(fs::path const& path,
+                                       asset::Asset& outAsset) const {
+  if (_assetPack.isOpen() &&
+      _assetPack.loadAsset(
+          path.lexically_relative(_project->getOpenProjectPath()), outAsset)) {
+    return true;
+  }
+
+  return asset::loadAssetFromFile(path, outAsset);
+}
+
+bool RuntimeResourceManager::loadAssetMetadata(
+    fs::path const& path, asset::AssetMetadata& outAssetMetadata) const {
+  if (_assetPack.isOpen() &&
+      _assetPack.loadAssetMetadata(
+          path.lexically_relative(_project->getOpenProjectPath()),
+          outAssetMetadata)) {
+    return true;
+  }
+
+  return asset::loadAssetMetadataFromFile(path, outAssetMetadata);
+}
+
+bool RuntimeResourceManager::loadAssetDependencies(
+    fs::path const& path, std::vector<std::string>& outDependencies) const {
+  if (_assetPack.isOpen() &&
+      _assetPack.loadAssetDependencies(
+          path.lexically_relative(_project->getOpenProjectPath()),
+          outDependencies)) {
+    return true;
+  }
+
+  return asset::loadAssetDependenciesFromFile(path, outDependencies);
+}
+
+task::TaskHandle<bool> RuntimeResourceManager::loadAssetAsync(
+    task::TaskExecutor& executor, task::TaskTarget target,
+    fs::path const& path, asset::Asset& outAsset,
+    task::CancellationToken token) {
+  platform::AsyncFileReader& reader = _resourceLoader.getFileReader();
+
+  if (_assetPack.isOpen()) {
+    std::optional<asset::AssetPackRange> const packRange =
+        _assetPack.findAssetRange(
+            path.lexically_relative(_project->getOpenProjectPath()));
+
+    if (packRange) {
+      return asset::readAssetAsync(executor, target, reader,
+                                   _assetPack.getPath(), packRange->offset,
+                                   packRange->size, outAsset, std::move(token));
+    }
+  }
+
+  // A file that can't be stat'ed has no room for an asset, the read fails.
+  std::error_code ec;
+  std::uintmax_t const fileSize = fs::file_size(path, ec);
+
+  return asset::readAssetAsync(executor, target, reader, path, 0,
+                               ec ? 0 : fileSize, outAsset, std::move(token));
+}
+
 project::Project const& RuntimeResourceManager::getProject() const {
   assert(_project);
   return *_project;
@@ -6,6 +6,7 @@
 #include <obsidian/runtime_resource/runtime_resource.hpp>
 #include <obsidian/runtime_resource/runtime_resource_manager.hpp>
 #include <obsidian/serialization/game_object_data_serialization.hpp>
+#include <obsidian/serialization/scene_data_serialization.hpp>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -87,7 +88,10 @@ public:
 
   serialization::GameObjectData getGameObjectData() const;
 
-  void draw(glm::mat4 const& parentTransform);
+  // Resources of objects in front of the camera are requested with high
+  // priority, the ones of objects behind it are loaded in the background.
+  void draw(glm::mat4 const& parentTransform,
+            serialization::CameraData const& camera);
 
   void populate(serialization::GameObjectData const& gameObjectData);
 
@@ -61,8 +61,8 @@ public:
 private:
   SceneState _state = {};
   bool _leftClickDown = false;
-  rhi::RHI* _rhi;
-  runtime_resource::RuntimeResourceManager* _resourceManager;
+  rhi::RHI* _rhi = nullptr;
+  runtime_resource::RuntimeResourceManager* _resourceManager = nullptr;
 };
 
 } /*namespace obsidian::scene*/
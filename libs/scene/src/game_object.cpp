@@ -1,8 +1,10 @@
 #include <obsidian/core/logging.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/runtime_resource/runtime_resource.hpp>
+#include <obsidian/scene/camera.hpp>
 #include <obsidian/scene/game_object.hpp>
 #include <obsidian/serialization/game_object_data_serialization.hpp>
+#include <obsidian/task/task_priority.hpp>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -260,9 +262,18 @@ serialization::GameObjectData GameObject::getGameObjectData() const {
   return result;
 }
 
-void GameObject::draw(glm::mat4 const& parentTransform) {
+void GameObject::draw(glm::mat4 const& parentTransform,
+                      serialization::CameraData const& camera) {
   glm::mat4 transform = parentTransform * getTransform();
 
+  // Bounds aren't known before the mesh is loaded, so the object's origin
+  // decides whether it is likely to be visible.
+  glm::vec3 const toObject = glm::vec3{transform[3]} - camera.pos;
+  task::TaskPriority const loadPriority =
+      glm::dot(toObject, forward(camera)) >= 0.0f
+          ? task::TaskPriority::high
+          : task::TaskPriority::background;
+
   bool meshReady = false;
 
   if (_meshResourceRef) {
@@ -271,7 +282,7 @@ void GameObject::draw(glm::mat4 const& parentTransform) {
     if (meshResource.isResourceReady()) {
       meshReady = true;
     } else {
-      meshResource.requestLoad();
+      meshResource.requestLoad(loadPriority);
     }
   }
 
@@ -279,7 +290,7 @@ void GameObject::draw(glm::mat4 const& parentTransform) {
 
   for (auto& matRef : _materialResourceRefs) {
     if (!matRef->isResourceReady()) {
-      matRef->requestLoad();
+      matRef->requestLoad(loadPriority);
       materialsReady = false;
     }
   }
@@ -311,7 +322,7 @@ void GameObject::draw(glm::mat4 const& parentTransform) {
   }
 
   for (auto& child : getChildren()) {
-    child.draw(transform);
+    child.draw(transform, camera);
   }
 }
 
@@ -132,4 +132,11 @@ void Scene::destroyGameObject(GameObject::GameObjectId id) {
 
 void Scene::destroyAllGameObjects() { _state.gameObjects.clear(); }
 
-void Scene::resetState() { _state = {}; }
+void Scene::resetState() {
+  if (_resourceManager) {
+    // Nothing is going to draw the objects whose loads are still queued.
+    _resourceManager->cancelPendingLoads();
+  }
+
+  _state = {};
+}
@@ -0,0 +1,134 @@
+#include <obsidian/task/task.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <new>
+
+using namespace obsidian::task;
+
+namespace {
+
+// Counts every allocation of the BenchTaskAllocations executable, which
+// replaces the global operator new so that the other benchmarks don't pay
+// for the counting.
+std::atomic<std::size_t> allocationCount = 0;
+
+// Mirrors the task storage used before tasks were pooled: a heap allocated
+// task wrapping a std::packaged_task.
+template <typename F> class PackagedTask {
+public:
+  explicit PackagedTask(F&& func) : _packagedTask{std::forward<F>(func)} {}
+  virtual ~PackagedTask() = default;
+
+  auto getFuture() { return _packagedTask.get_future(); }
+
+  virtual void execute() { _packagedTask(); }
+
+private:
+  std::packaged_task<void()> _packagedTask;
+};
+
+struct Payload {
+  std::size_t* counter;
+  std::size_t delta;
+
+  void operator()() const { *counter += delta; }
+};
+
+void setAllocationCounter(benchmark::State& state, std::size_t allocations) {
+  state.counters["allocsPerEnqueue"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+} /*namespace*/
+
+void* operator new(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* const ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+static void BM_task_packaged_task_storage(benchmark::State& state) {
+  std::size_t counter = 0;
+  std::size_t const allocationsBefore = allocationCount;
+
+  for (auto _ : state) {
+    auto task =
+        std::make_unique<PackagedTask<Payload>>(Payload{&counter, 1});
+    auto future = task->getFuture();
+    task->execute();
+    future.get();
+  }
+
+  setAllocationCounter(state, allocationCount - allocationsBefore);
+  benchmark::DoNotOptimize(counter);
+}
+
+BENCHMARK(BM_task_packaged_task_storage);
+
+static void BM_task_pooled_storage(benchmark::State& state) {
+  std::size_t counter = 0;
+  std::size_t const allocationsBefore = allocationCount;
+
+  for (auto _ : state) {
+    std::unique_ptr<Task<Payload>> task = std::make_unique<Task<Payload>>(
+        TaskType::general, Payload{&counter, 1});
+    auto future = task->getFuture();
+    task->execute();
+    future.get();
+  }
+
+  setAllocationCounter(state, allocationCount - allocationsBefore);
+  benchmark::DoNotOptimize(counter);
+}
+
+BENCHMARK(BM_task_pooled_storage);
+
+static void BM_task_executor_enqueue(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 1}});
+
+  std::size_t counter = 0;
+  std::size_t const allocationsBefore = allocationCount;
+
+  for (auto _ : state) {
+    executor.enqueue(TaskType::general, Payload{&counter, 1}).wait();
+  }
+
+  setAllocationCounter(state, allocationCount - allocationsBefore);
+  benchmark::DoNotOptimize(counter);
+}
+
+BENCHMARK(BM_task_executor_enqueue)->UseRealTime();
+
+static void BM_task_executor_enqueue_detached(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 1}});
+
+  std::size_t counter = 0;
+  std::size_t const allocationsBefore = allocationCount;
+
+  for (auto _ : state) {
+    executor.enqueueDetached(TaskType::general, Payload{&counter, 1});
+  }
+
+  executor.waitIdle();
+
+  setAllocationCounter(state, allocationCount - allocationsBefore);
+  benchmark::DoNotOptimize(counter);
+}
+
+BENCHMARK(BM_task_executor_enqueue_detached)->UseRealTime();
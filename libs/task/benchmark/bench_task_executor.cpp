@@ -0,0 +1,251 @@
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_stats.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+namespace {
+
+// Tasks a producer keeps in flight before it waits for them, so that the
+// queues stay bounded however fast the producers are.
+constexpr std::size_t producerBatchSize = 256;
+
+std::unique_ptr<TaskExecutor> sharedExecutor;
+
+int getMaxThreadCount() {
+  unsigned int const hardwareThreads = std::thread::hardware_concurrency();
+  return hardwareThreads ? static_cast<int>(hardwareThreads) : 1;
+}
+
+unsigned int getWorkerCount() {
+  return static_cast<unsigned int>(getMaxThreadCount());
+}
+
+// Roughly a microsecond of work that the compiler can't remove.
+void spin() {
+  std::size_t value = 0;
+
+  for (std::size_t i = 0; i < 256; ++i) {
+    benchmark::DoNotOptimize(value += i);
+  }
+}
+
+struct CountDown {
+  std::atomic<std::size_t>* remaining;
+
+  void operator()() const {
+    if (remaining->fetch_sub(1) == 1) {
+      remaining->notify_one();
+    }
+  }
+};
+
+struct SpinCountDown {
+  std::atomic<std::size_t>* remaining;
+
+  void operator()() const {
+    spin();
+    CountDown{remaining}();
+  }
+};
+
+// Enqueues producerBatchSize detached tasks and blocks until all of them ran.
+template <typename F>
+void runProducerBatch(TaskExecutor& executor, TaskType taskType,
+                      std::atomic<std::size_t>& remaining) {
+  remaining = producerBatchSize;
+
+  for (std::size_t i = 0; i < producerBatchSize; ++i) {
+    executor.enqueueDetached(taskType, F{&remaining});
+  }
+
+  std::size_t current = remaining.load();
+
+  while (current) {
+    remaining.wait(current);
+    current = remaining.load();
+  }
+}
+
+void createGeneralExecutor(benchmark::State const& state) {
+  sharedExecutor = std::make_unique<TaskExecutor>();
+  sharedExecutor->initAndRun({{TaskType::general, getWorkerCount()}});
+}
+
+// The same lanes as the engine uses. With range(0) set the transfer and
+// upload workers help the general queue.
+void createMixedExecutor(benchmark::State const& state) {
+  std::vector<TaskType> helpedTaskTypes;
+
+  if (state.range(0)) {
+    helpedTaskTypes.push_back(TaskType::general);
+  }
+
+  unsigned int const generalThreadCount =
+      std::max(getWorkerCount(), 3u) - 2;
+
+  sharedExecutor = std::make_unique<TaskExecutor>();
+  sharedExecutor->initAndRun(
+      {{TaskType::rhiTransfer, 1, {}, 0, {}, {}, helpedTaskTypes},
+       {TaskType::resourceUpload, 1, {}, 0, {}, {}, helpedTaskTypes},
+       {TaskType::general, generalThreadCount}});
+}
+
+void destroySharedExecutor(benchmark::State const& state) {
+  sharedExecutor->waitIdle();
+  sharedExecutor.reset();
+}
+
+} /*namespace*/
+
+// Every benchmark thread is a producer of empty tasks, so the producers and
+// the workers mostly contend on the queue itself.
+static void BM_task_executor_enqueue_throughput(benchmark::State& state) {
+  TaskExecutor& executor = *sharedExecutor;
+  std::atomic<std::size_t> remaining = 0;
+
+  for (auto _ : state) {
+    runProducerBatch<CountDown>(executor, TaskType::general, remaining);
+  }
+
+  state.SetItemsProcessed(state.iterations() * producerBatchSize);
+}
+
+BENCHMARK(BM_task_executor_enqueue_throughput)
+    ->Setup(createGeneralExecutor)
+    ->Teardown(destroySharedExecutor)
+    ->ThreadRange(1, getMaxThreadCount())
+    ->UseRealTime();
+
+// Round trip of an empty task from an outside thread, including waking a
+// sleeping worker. The start latency percentiles come from the executor's
+// own stats and are upper bounds of their histogram bucket.
+static void BM_task_executor_empty_task_latency(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun(
+      {{TaskType::general, static_cast<unsigned int>(state.range(0))}});
+  executor.setStatsMode(TaskStatsMode::full);
+
+  for (auto _ : state) {
+    executor.enqueue(TaskType::general, []() {}).get();
+  }
+
+  TaskDurationHistogram const startLatency =
+      executor.getStats(TaskType::general).startLatency;
+
+  state.counters["startLatencyP50Us"] =
+      static_cast<double>(startLatency.percentile(0.5).count());
+  state.counters["startLatencyP99Us"] =
+      static_cast<double>(startLatency.percentile(0.99).count());
+}
+
+BENCHMARK(BM_task_executor_empty_task_latency)
+    ->Arg(1)
+    ->Arg(getMaxThreadCount())
+    ->UseRealTime();
+
+// A root task spawns range(0) small tasks and waits for all of them, which
+// keeps the waiting worker busy with the spawned tasks meanwhile.
+static void BM_task_executor_fan_out_fan_in(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, getWorkerCount()}});
+
+  std::size_t const fanOut = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    executor
+        .enqueue(TaskType::general,
+                 [&executor, fanOut]() {
+                   std::vector<void (*)()> leaves(fanOut, &spin);
+                   TaskHandle<void> const allDone = whenAll(
+                       executor.spawnBatch(TaskType::general, leaves));
+                   executor.wait(allDone);
+                 })
+        .get();
+  }
+
+  state.SetItemsProcessed(state.iterations() * fanOut);
+}
+
+BENCHMARK(BM_task_executor_fan_out_fan_in)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096)
+    ->UseRealTime();
+
+static void BM_task_executor_wait_idle_when_idle(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, getWorkerCount()}});
+
+  for (auto _ : state) {
+    executor.waitIdle();
+  }
+}
+
+BENCHMARK(BM_task_executor_wait_idle_when_idle)->UseRealTime();
+
+// Only the time from the last enqueue until waitIdle returns is measured, so
+// the result is the cost of draining range(0) queued tasks plus the wake up.
+static void BM_task_executor_wait_idle_after_batch(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, getWorkerCount()}});
+
+  std::size_t const taskCount = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < taskCount; ++i) {
+      executor.enqueueDetached(TaskType::general, &spin);
+    }
+
+    Clock::time_point const start = Clock::now();
+    executor.waitIdle();
+
+    state.SetIterationTime(
+        std::chrono::duration<double>(Clock::now() - start).count());
+  }
+}
+
+BENCHMARK(BM_task_executor_wait_idle_after_batch)
+    ->RangeMultiplier(8)
+    ->Range(1, 4096)
+    ->UseManualTime();
+
+// One producer per queue, each enqueueing small tasks into the general,
+// transfer and upload queues of an engine like executor. range(0) toggles
+// whether the single threaded lanes help the general queue.
+static void BM_task_executor_mixed_task_types(benchmark::State& state) {
+  constexpr std::array<TaskType, 3> taskTypes = {
+      TaskType::general, TaskType::rhiTransfer, TaskType::resourceUpload};
+
+  TaskExecutor& executor = *sharedExecutor;
+  TaskType const taskType = taskTypes[state.thread_index() % taskTypes.size()];
+  std::atomic<std::size_t> remaining = 0;
+
+  for (auto _ : state) {
+    runProducerBatch<SpinCountDown>(executor, taskType, remaining);
+  }
+
+  state.SetItemsProcessed(state.iterations() * producerBatchSize);
+}
+
+BENCHMARK(BM_task_executor_mixed_task_types)
+    ->Setup(createMixedExecutor)
+    ->Teardown(destroySharedExecutor)
+    ->ArgName("helpers")
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(3)
+    ->UseRealTime();
@@ -0,0 +1,94 @@
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+namespace {
+
+constexpr std::size_t elementCount = 1 << 22;
+constexpr std::size_t grainSize = 4096;
+
+void applyWork(std::vector<float>& data, std::size_t b, std::size_t e) {
+  for (std::size_t i = b; i < e; ++i) {
+    data[i] = std::sqrt(data[i] * 1.0001f + 1.0f);
+  }
+}
+
+int getMaxThreadCount() {
+  unsigned int const hardwareThreads = std::thread::hardware_concurrency();
+  return hardwareThreads ? static_cast<int>(hardwareThreads) : 1;
+}
+
+} /*namespace*/
+
+static void BM_parallel_for_serial_baseline(benchmark::State& state) {
+  std::vector<float> data(elementCount, 1.0f);
+
+  for (auto _ : state) {
+    applyWork(data, 0, data.size());
+    benchmark::DoNotOptimize(data.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * elementCount);
+}
+
+BENCHMARK(BM_parallel_for_serial_baseline)->UseRealTime();
+
+// The calling thread joins in, so with N workers up to N + 1 threads process
+// the range.
+static void BM_parallel_for_scaling(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun(
+      {{TaskType::general, static_cast<unsigned int>(state.range(0))}});
+
+  std::vector<float> data(elementCount, 1.0f);
+
+  for (auto _ : state) {
+    executor.parallelFor(TaskType::general, std::size_t{0}, data.size(),
+                         grainSize, [&data](std::size_t b, std::size_t e) {
+                           applyWork(data, b, e);
+                         });
+    benchmark::DoNotOptimize(data.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * elementCount);
+}
+
+BENCHMARK(BM_parallel_for_scaling)
+    ->DenseRange(1, getMaxThreadCount())
+    ->UseRealTime();
+
+static void BM_parallel_reduce_scaling(benchmark::State& state) {
+  TaskExecutor executor;
+  executor.initAndRun(
+      {{TaskType::general, static_cast<unsigned int>(state.range(0))}});
+
+  std::vector<float> data(elementCount, 1.0f);
+
+  for (auto _ : state) {
+    double const sum = executor.parallelReduce(
+        TaskType::general, std::size_t{0}, data.size(), grainSize, 0.0,
+        [&data](std::size_t b, std::size_t e) {
+          double partialSum = 0.0;
+          for (std::size_t i = b; i < e; ++i) {
+            partialSum += std::sqrt(data[i]);
+          }
+          return partialSum;
+        },
+        [](double a, double b) { return a + b; });
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * elementCount);
+}
+
+BENCHMARK(BM_parallel_reduce_scaling)
+    ->DenseRange(1, getMaxThreadCount())
+    ->UseRealTime();
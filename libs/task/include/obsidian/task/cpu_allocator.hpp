@@ -0,0 +1,44 @@
+#pragma once
+
+#include <obsidian/platform/cpu_topology.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace obsidian::task {
+
+// Hands out the cores of the machine to thread pools, so that threads which
+// need a core of their own get one and the pools sharing the rest don't
+// oversubscribe it or bounce between last level caches.
+class CpuAllocator {
+public:
+  CpuAllocator() = default;
+  explicit CpuAllocator(platform::CpuTopology const& topology);
+
+  // Takes whole physical cores out of the shared ones and returns their cpus.
+  // The cores are taken from the end of the last cache domain so that they
+  // share a cache. At least one core always stays shared, so fewer cores are
+  // returned when there aren't enough, and an empty set, meaning the thread
+  // isn't pinned, if there are none to spare.
+  platform::CpuSet reserveCores(std::size_t coreCount);
+
+  std::size_t getSharedCoreCount() const;
+  platform::CpuSet getSharedCpus() const;
+
+  // Affinity masks for threadCount threads running on the shared cores. The
+  // threads are spread over the cache domains in proportion to their shared
+  // cores, and each can run on any shared cpu of its domain. Consecutive
+  // threads alternate between the domains.
+  std::vector<platform::CpuSet> spreadThreads(std::size_t threadCount) const;
+
+private:
+  struct Core {
+    unsigned int cacheDomainId;
+    platform::CpuSet cpus;
+  };
+
+  // ordered by cache domain
+  std::vector<Core> _sharedCores;
+};
+
+} /*namespace obsidian::task*/
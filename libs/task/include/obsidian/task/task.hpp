@@ -2,13 +2,21 @@
 
 #include <obsidian/core/logging.hpp>
 #include <obsidian/core/utils/functions.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+#include <obsidian/task/task_priority.hpp>
 #include <obsidian/task/task_type.hpp>
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
+#include <new>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -31,25 +39,92 @@ public:
 
   bool isDone() const;
 
+  TaskPriority getPriority() const;
+  TaskDeadline getDeadline() const;
+  // Has to be called before the task is queued.
+  void setTarget(TaskTarget const& target);
+
+  // Set by the executor for the tasks it collects stats for, otherwise left
+  // at the epoch.
+  std::chrono::steady_clock::time_point getEnqueueTime() const;
+  void setEnqueueTime(std::chrono::steady_clock::time_point enqueueTime);
+
+  // The completion is signalled by the executor after the task executed. Only
+  // tasks that continuations can be attached to have one.
+  void setCompletion(std::shared_ptr<TaskCompletion> completion);
+  void signalCompletion();
+
+  // Tasks created with new are placed in the TaskPool slabs.
+  static void* operator new(std::size_t size);
+  static void* operator new(std::size_t size, std::align_val_t alignment);
+  static void operator delete(void* ptr, std::size_t size) noexcept;
+  static void operator delete(void* ptr, std::size_t size,
+                              std::align_val_t alignment) noexcept;
+
 protected:
   std::shared_ptr<void const> _argPtr = nullptr;
   std::atomic<bool> _done = false;
+  std::shared_ptr<TaskCompletion> _completion = nullptr;
 
 private:
   static std::atomic<TaskId> nextTaskId;
 
   std::atomic<TaskId> _taskId;
   std::atomic<TaskType> _type;
+  TaskPriority _priority = TaskPriority::normal;
+  TaskDeadline _deadline = noTaskDeadline;
+  std::chrono::steady_clock::time_point _enqueueTime = {};
 };
 
 template <typename F> class Task : public TaskBase {
-  using PackagedTaskType = decltype(std::packaged_task(std::declval<F>()));
+  using FunctionType = std::decay_t<F>;
+  using ResultType = core::ResultOf<FunctionType>;
 
 public:
   Task(TaskType type, F&& func)
-      : TaskBase(type), _packagedTask{std::forward<F>(func)} {}
+      : TaskBase(type), _func{std::forward<F>(func)},
+        _promise{std::allocator_arg, TaskPoolAllocator<ResultType>{}} {}
+
+  std::future<ResultType> getFuture() { return _promise.get_future(); }
+
+  TaskHandle<ResultType> getHandle() {
+    std::shared_ptr<TaskCompletion> completion = makeTaskCompletion();
+    setCompletion(completion);
+    return {getFuture().share(), std::move(completion)};
+  }
+
+  void execute() override {
+    if (_done) {
+      OBS_LOG_ERR("Trying to execute a task that is already done.");
+      return;
+    }
+
+    try {
+      if constexpr (std::is_void_v<ResultType>) {
+        core::invokeTask(_func, _argPtr.get());
+        _promise.set_value();
+      } else {
+        _promise.set_value(core::invokeTask(_func, _argPtr.get()));
+      }
+    } catch (...) {
+      _promise.set_exception(std::current_exception());
+    }
 
-  auto getFuture() { return _packagedTask.get_future(); }
+    _done = true;
+  }
+
+private:
+  FunctionType _func;
+  std::promise<ResultType> _promise;
+};
+
+// Task without a future, for work whose completion nobody waits on.
+template <typename F> class DetachedTask : public TaskBase {
+  using FunctionType = std::decay_t<F>;
+
+public:
+  DetachedTask(TaskType type, F&& func)
+      : TaskBase(type), _func{std::forward<F>(func)} {}
 
   void execute() override {
     if (_done) {
@@ -57,13 +132,34 @@ public:
       return;
     }
 
-    core::invokeTask(_packagedTask, _argPtr.get());
+    try {
+      core::invokeTask(_func, _argPtr.get());
+    } catch (std::exception const& e) {
+      OBS_LOG_ERR(std::string{"Detached task threw an exception: "} +
+                  e.what());
+    } catch (...) {
+      OBS_LOG_ERR("Detached task threw an unknown exception.");
+    }
 
     _done = true;
   }
 
 private:
-  PackagedTaskType _packagedTask;
+  FunctionType _func;
+};
+
+// Resumes a suspended coroutine on the worker that executes it. A coroutine
+// whose task is destroyed without executing, for example on shutdown, is
+// destroyed together with the task.
+class ResumeTask : public TaskBase {
+public:
+  ResumeTask(TaskType type, std::coroutine_handle<> coroutine);
+  ~ResumeTask() override;
+
+  void execute() override;
+
+private:
+  std::coroutine_handle<> _coroutine;
 };
 
 } /*namespace obsidian::task*/
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace obsidian::task {
+
+// Suspends the awaiting coroutine until the completion is signalled. Returns
+// false if it was signalled in the meantime and the coroutine shouldn't
+// suspend at all.
+bool suspendUntilCompleted(TaskCompletion& completion,
+                           std::coroutine_handle<> coroutine);
+
+template <typename T> class TaskHandlePromise;
+
+template <typename T> class TaskHandlePromiseBase {
+public:
+  TaskHandle<T> get_return_object() { return _state.getHandle(); }
+
+  std::suspend_never initial_suspend() const noexcept { return {}; }
+
+  // The coroutine frame is destroyed before the completion is signalled, so
+  // continuations don't observe the coroutine's locals anymore.
+  auto final_suspend() const noexcept {
+    struct FinalAwaiter {
+      bool await_ready() const noexcept { return false; }
+
+      void await_suspend(
+          std::coroutine_handle<TaskHandlePromise<T>> coroutine) noexcept {
+        std::shared_ptr<TaskCompletion> const completion =
+            coroutine.promise()._state.completion;
+        coroutine.destroy();
+        completion->complete();
+      }
+
+      void await_resume() const noexcept {}
+    };
+
+    return FinalAwaiter{};
+  }
+
+  void unhandled_exception() {
+    _state.promise.set_exception(std::current_exception());
+  }
+
+  // Coroutine frames are placed in the TaskPool slabs like tasks.
+  static void* operator new(std::size_t size) {
+    return TaskPool::allocate(size);
+  }
+
+  static void operator delete(void* ptr, std::size_t size) noexcept {
+    TaskPool::deallocate(ptr, size);
+  }
+
+protected:
+  TaskHandleState<T> _state;
+};
+
+// Lets coroutines return a TaskHandle. The coroutine starts running on the
+// calling thread and its handle completes when it returns.
+template <typename T>
+class TaskHandlePromise : public TaskHandlePromiseBase<T> {
+public:
+  template <typename U> void return_value(U&& value) {
+    this->_state.promise.set_value(std::forward<U>(value));
+  }
+};
+
+template <>
+class TaskHandlePromise<void> : public TaskHandlePromiseBase<void> {
+public:
+  void return_void() { _state.promise.set_value(); }
+};
+
+// co_await on a TaskHandle resumes the coroutine on the thread that completes
+// the handle, or right away if it already completed. Await
+// TaskExecutor::schedule afterwards to continue on a specific queue. Awaiting
+// an invalid handle of type void doesn't suspend.
+template <typename T> class TaskHandleAwaiter {
+public:
+  explicit TaskHandleAwaiter(TaskHandle<T> handle)
+      : _handle{std::move(handle)} {}
+
+  bool await_ready() const {
+    if constexpr (std::is_void_v<T>) {
+      if (!_handle.valid()) {
+        return true;
+      }
+    }
+
+    return _handle.isDone();
+  }
+
+  bool await_suspend(std::coroutine_handle<> coroutine) {
+    return suspendUntilCompleted(*_handle.getCompletion(), coroutine);
+  }
+
+  T await_resume() const {
+    if constexpr (std::is_void_v<T>) {
+      if (_handle.valid()) {
+        _handle.get();
+      }
+    } else {
+      return _handle.get();
+    }
+  }
+
+private:
+  TaskHandle<T> _handle;
+};
+
+template <typename T>
+TaskHandleAwaiter<T> operator co_await(TaskHandle<T> const& handle) {
+  return TaskHandleAwaiter<T>{handle};
+}
+
+} /*namespace obsidian::task*/
+
+template <typename T, typename... Args>
+struct std::coroutine_traits<obsidian::task::TaskHandle<T>, Args...> {
+  using promise_type = obsidian::task::TaskHandlePromise<T>;
+};
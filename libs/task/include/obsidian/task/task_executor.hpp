@@ -1,17 +1,33 @@
 #pragma once
 
+#include <obsidian/platform/cpu_topology.hpp>
 #include <obsidian/task/task.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
+#include <obsidian/task/task_stats.hpp>
 #include <obsidian/task/task_type.hpp>
+#include <obsidian/task/timer_wheel.hpp>
+#include <obsidian/task/work_stealing_deque.hpp>
 
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <iterator>
 #include <mutex>
+#include <span>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -21,62 +37,547 @@ struct ThreadInitInfo {
   using CallOnIntervalFunction = std::function<void(void)>;
   TaskType taskType;
   unsigned int threadCount;
+  // Called on every worker thread of the queue each time the interval
+  // passes, for per-thread housekeeping. Workers aren't woken in between.
   CallOnIntervalFunction callOnInterval;
   std::size_t intervalMilliseconds = 0;
+  // The workers are named after it and their index, as shown in Tracy and
+  // top. Defaults to the name of the task type.
+  std::string threadName;
+  // Worker i runs on the cpus of cpuAffinity[i % cpuAffinity.size()], so a
+  // single set applies to all of them. Empty means not pinned.
+  std::vector<platform::CpuSet> cpuAffinity;
+  // Once their own queue is empty the workers run the tasks of these queues,
+  // so a dedicated lane helps out instead of idling. Each type needs its own
+  // entry in the init info, which may have 0 threads if the queue is only
+  // served by helpers.
+  std::vector<TaskType> helpedTaskTypes;
+};
+
+// Shared between the executor's timer thread and the handles of a periodic
+// timer.
+struct PeriodicTimer {
+  std::chrono::steady_clock::duration period;
+  // called on the timer thread every time the period passes
+  std::function<void()> dispatch;
+  std::atomic<bool> cancelled = false;
+};
+
+// Stops a timer created with TaskExecutor::enqueueEvery. Destroying the
+// handle doesn't stop the timer.
+class TimerHandle {
+public:
+  TimerHandle() = default;
+
+  bool valid() const;
+  // Runs that were already queued still execute.
+  void cancel();
+
+private:
+  explicit TimerHandle(std::shared_ptr<PeriodicTimer> timer);
+
+  std::shared_ptr<PeriodicTimer> _timer;
+
+  friend class TaskExecutor;
+};
+
+// Calls waiting for a single worker thread, run between two tasks.
+struct WorkerCalls {
+  // set by the timer when the worker is due to call its interval function
+  std::atomic<bool> intervalCallDue = false;
+  std::atomic<bool> hasPendingCalls = false;
+  std::mutex pendingCallsMutex;
+  std::vector<std::function<void()>> pendingCalls;
+};
+
+struct TaskQueue;
+
+// Lets callbacks that can outlive the executor, like the ones subscribed to
+// task completions, wake the workers of a queue.
+struct TaskQueueWaker {
+  std::mutex mutex;
+  // reset when the executor shuts down
+  TaskQueue* queue = nullptr;
 };
 
 struct TaskQueue {
-  std::vector<std::unique_ptr<TaskBase>> tasks;
+  // one deque per worker thread serving this queue, holding normal priority
+  // tasks without a deadline that the worker enqueued itself
+  std::vector<std::unique_ptr<WorkStealingDeque<TaskBase*>>> workerDeques;
+  // all the other tasks, indexed by priority
+  std::array<std::deque<TaskBase*>, taskPriorityCount> injectedTasks;
+  // min-heaps ordered by deadline, indexed by priority
+  std::array<std::vector<TaskBase*>, taskPriorityCount> deadlineTasks;
+  std::mutex injectedTasksMutex;
+  std::atomic<std::size_t> injectedTaskCount = 0;
+  std::atomic<std::size_t> queuedTaskCount = 0;
+  std::atomic<std::size_t> tasksInProgress = 0;
+  std::mutex taskQueueMutex;
   std::condition_variable taskQueueCondVar;
-  std::size_t tasksInProgress = 0;
+  std::atomic<std::size_t> sleepingWorkerCount = 0;
+  // sleeping workers that wait on a future, woken whenever a task finishes
+  std::atomic<std::size_t> futureWaiterCount = 0;
+  std::shared_ptr<TaskQueueWaker> waker;
+  // one per worker thread, in the same order as the deques
+  std::vector<std::unique_ptr<WorkerIdleTime>> workerIdleTimes;
+  // one per worker thread, in the same order as the deques
+  std::vector<std::unique_ptr<WorkerCalls>> workerCalls;
+  // queues whose tasks the workers of this queue run when it is empty
+  std::vector<TaskQueue*> helpedQueues;
+  // queues whose workers run the tasks of this queue when they are idle
+  std::vector<TaskQueue*> helperQueues;
+  TaskQueueStatsCounters stats;
 };
 
 class TaskExecutor {
 public:
+  class ScheduleAwaiter {
+  public:
+    ScheduleAwaiter(TaskExecutor& executor, TaskTarget const& target);
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    void await_resume() const noexcept {}
+
+  private:
+    TaskExecutor& _executor;
+    TaskTarget _target;
+  };
+
   ~TaskExecutor();
 
   void initAndRun(std::vector<ThreadInitInfo> threadInit);
 
-  template <typename F> auto enqueue(TaskType type, F&& func) {
-    auto const queue = _taskQueues.find(type);
+  // Tasks of a higher priority are started first. Within a priority, tasks
+  // with a deadline start earliest deadline first, ahead of the ones without
+  // a deadline, which start in the order they were enqueued. A task whose
+  // deadline passed is started before any other task of its queue. Tasks that
+  // a worker enqueues into its own queue with normal priority and without a
+  // deadline are kept in the worker's deque and keep their order relative to
+  // each other only.
+  template <typename F> auto enqueue(TaskTarget const& target, F&& func) {
+    auto const queue = _taskQueues.find(target.type);
 
     assert(queue != _taskQueues.cend());
 
-    std::unique_lock l{_taskQueueMutex};
+    auto newTask = makeTask<Task<decltype(std::forward<F>(func))>>(
+        target, std::forward<F>(func));
+    auto future = newTask->getFuture();
 
-    using TaskType = Task<decltype(std::forward<F>(func))>;
+    pushTask(queue->second, std::move(newTask));
 
-    TaskBase& newTask = *queue->second.tasks.emplace_back(
-        std::make_unique<TaskType>(type, std::forward<F>(func)));
+    return future;
+  }
 
-    auto future = dynamic_cast<TaskType&>(newTask).getFuture();
+  template <typename F>
+  void enqueueDetached(TaskTarget const& target, F&& func) {
+    auto const queue = _taskQueues.find(target.type);
 
-    l.unlock();
+    assert(queue != _taskQueues.cend());
+
+    pushTask(queue->second,
+             makeTask<DetachedTask<decltype(std::forward<F>(func))>>(
+                 target, std::forward<F>(func)));
+  }
 
-    queue->second.taskQueueCondVar.notify_one();
+  // Like enqueue, but the task is queued only once the delay passed, without
+  // occupying a worker in the meantime. waitIdle doesn't wait for tasks whose
+  // delay didn't pass yet, and tasks still waiting on shutdown are destroyed.
+  template <typename F>
+  auto enqueueAfter(TaskTarget const& target,
+                    std::chrono::steady_clock::duration delay, F&& func) {
+    assert(_taskQueues.contains(target.type));
+
+    auto newTask = makeTask<Task<decltype(std::forward<F>(func))>>(
+        target, std::forward<F>(func));
+    auto future = newTask->getFuture();
+
+    addTimer({std::chrono::steady_clock::now() + delay, std::move(newTask),
+              nullptr});
 
     return future;
   }
 
-  void workerFunc(TaskType taskType,
+  // Queues func as a detached task each time the period passes, the first
+  // time one period from now, until the returned handle is cancelled or the
+  // executor shuts down. A run is skipped if the previous one is still queued
+  // or running, so slow runs don't pile up.
+  template <typename F>
+  TimerHandle enqueueEvery(TaskTarget const& target,
+                           std::chrono::steady_clock::duration period,
+                           F&& func) {
+    assert(_taskQueues.contains(target.type));
+
+    struct PeriodicFunction {
+      std::decay_t<F> func;
+      std::atomic<bool> queued = false;
+    };
+
+    auto const periodicFunction =
+        std::make_shared<PeriodicFunction>(std::forward<F>(func));
+
+    return addPeriodicTimer(period, [this, target, periodicFunction]() {
+      if (periodicFunction->queued.exchange(true)) {
+        return;
+      }
+
+      enqueueDetached(target, [periodicFunction]() {
+        try {
+          periodicFunction->func();
+        } catch (...) {
+          periodicFunction->queued = false;
+          throw;
+        }
+
+        periodicFunction->queued = false;
+      });
+    });
+  }
+
+  // Like enqueue, but returns a handle that continuations can be attached to.
+  template <typename F> auto spawn(TaskTarget const& target, F&& func) {
+    auto const queue = _taskQueues.find(target.type);
+
+    assert(queue != _taskQueues.cend());
+
+    auto newTask = makeTask<Task<decltype(std::forward<F>(func))>>(
+        target, std::forward<F>(func));
+    auto handle = newTask->getHandle();
+
+    pushTask(queue->second, std::move(newTask));
+
+    return handle;
+  }
+
+  // Queues a task for every callable in the range and returns their futures
+  // in the same order. The whole batch is published under a single lock and
+  // at most as many sleeping workers are woken as there are tasks. The
+  // callables are moved out of the range if it is an rvalue and copied
+  // otherwise.
+  template <typename Funcs>
+  auto enqueueBatch(TaskTarget const& target, Funcs&& funcs) {
+    return pushBatch(target, std::forward<Funcs>(funcs),
+                     [](auto& task) { return task.getFuture(); });
+  }
+
+  // Like enqueueBatch, but returns handles that continuations can be attached
+  // to, for example with whenAll.
+  template <typename Funcs>
+  auto spawnBatch(TaskTarget const& target, Funcs&& funcs) {
+    return pushBatch(target, std::forward<Funcs>(funcs),
+                     [](auto& task) { return task.getHandle(); });
+  }
+
+  // Queues func once the antecedent completed, without blocking any thread in
+  // the meantime. func receives the antecedent's result unless it is void. If
+  // the antecedent failed, its exception is forwarded to the returned handle
+  // and func is not called. When func returns a TaskHandle, the returned
+  // handle completes together with that handle instead, and an invalid handle
+  // returned by func completes it right away.
+  template <typename T, typename F>
+  auto then(TaskHandle<T> const& antecedent, TaskTarget const& target,
+            F&& func) {
+    assert(antecedent.valid());
+
+    auto continuation = [future = antecedent.getFuture(),
+                         func = std::forward<F>(func)]() mutable
+        -> decltype(auto) {
+      if constexpr (std::is_void_v<T>) {
+        future.get();
+        return func();
+      } else {
+        return func(future.get());
+      }
+    };
+
+    auto newTask =
+        makeTask<Task<decltype(continuation)>>(target, std::move(continuation));
+    auto handle = newTask->getHandle();
+
+    pushTaskAfter(*antecedent.getCompletion(), std::move(newTask));
+
+    if constexpr (IsTaskHandle<typename decltype(handle)::ValueType>::value) {
+      return unwrap(handle);
+    } else {
+      return handle;
+    }
+  }
+
+  // co_await executor.schedule(target) suspends the calling coroutine and
+  // queues its continuation as a task, so that it resumes on a worker of the
+  // target's queue.
+  ScheduleAwaiter schedule(TaskTarget const& target);
+
+  // Blocks until the awaited task is done. When called from one of this
+  // executor's workers, the worker keeps executing tasks from its own queue in
+  // the meantime instead of idling, so tasks that wait for their subtasks
+  // can't exhaust the workers of a queue.
+  template <typename T> void wait(TaskHandle<T> const& handle) {
+    assert(handle.valid());
+
+    waitImpl(handle.getFuture(), handle.getCompletion().get());
+  }
+
+  // Futures can't notify a waiting worker, so the worker is woken whenever a
+  // task of this executor finishes instead. When called from a worker, the
+  // future has to belong to one of this executor's tasks. Prefer waiting on a
+  // TaskHandle.
+  template <typename Future> void wait(Future const& future) {
+    waitImpl(future, nullptr);
+  }
+
+  // Calls func(rangeBegin, rangeEnd) on disjoint subranges that together
+  // cover [begin, end), spread over the workers of the given task type. The
+  // calling thread processes subranges as well and the call returns once the
+  // whole range is done, so it is safe to call from inside a task. Subranges
+  // start large and shrink towards grainSize as the range is used up. If func
+  // throws, the unclaimed subranges are skipped and the first exception is
+  // rethrown to the caller. The helping tasks are queued with the target's
+  // priority and deadline.
+  template <typename Index, typename F>
+  void parallelFor(TaskTarget const& target, Index begin,
+                   std::type_identity_t<Index> end, std::size_t grainSize,
+                   F&& func) {
+    static_assert(std::is_integral_v<Index>);
+
+    if (end <= begin) {
+      return;
+    }
+
+    auto const rangeFunc = [begin, &func](std::size_t b, std::size_t e) {
+      func(static_cast<Index>(begin + b), static_cast<Index>(begin + e));
+    };
+
+    runParallelRange(target, static_cast<std::size_t>(end - begin), grainSize,
+                     &invokeRangeFunction<decltype(rangeFunc)>, &rangeFunc);
+  }
+
+  // Maps each subrange to a partial result with mapFunc(rangeBegin, rangeEnd)
+  // and combines the partial results with reduceFunc, starting from identity.
+  // The order in which partial results are combined is unspecified, so
+  // reduceFunc has to be associative and commutative.
+  template <typename Index, typename T, typename MapF, typename ReduceF>
+  T parallelReduce(TaskTarget const& target, Index begin,
+                   std::type_identity_t<Index> end, std::size_t grainSize,
+                   T identity, MapF&& mapFunc, ReduceF&& reduceFunc) {
+    T result = std::move(identity);
+    std::mutex resultMutex;
+
+    parallelFor(target, begin, end, grainSize, [&](Index b, Index e) {
+      T partialResult = mapFunc(b, e);
+
+      std::scoped_lock l{resultMutex};
+      result = reduceFunc(std::move(result), std::move(partialResult));
+    });
+
+    return result;
+  }
+
+  void workerFunc(TaskType taskType, std::size_t workerIndex,
                   ThreadInitInfo::CallOnIntervalFunction intervalFunc,
                   std::size_t intervalMilliseconds);
 
   void waitIdle() const;
 
+  // Running tasks finish, but no queued task starts once the executor shuts
+  // down. Those and the tasks enqueued while shutting down are destroyed,
+  // which breaks their promises.
   void shutdown();
 
   bool shutdownComplete() const;
 
   std::size_t getPendingAndUncompletedTasksCount() const;
 
+  // Calls func once on every worker thread of the queue, between two of its
+  // tasks, and blocks until all the calls returned. Meant for per-thread
+  // state that has to be released before the executor shuts down. Mustn't
+  // be called from a worker of the same queue.
+  void runOnEachWorker(TaskType taskType, std::function<void()> const& func);
+
+  // In the sampled mode only every samplingInterval-th task enqueued on a
+  // thread contributes to the latency and execution time histograms. Queue
+  // depths and the busy ratio are tracked in both modes. Changing the mode
+  // doesn't reset the stats collected so far.
+  void setStatsMode(TaskStatsMode mode, std::size_t samplingInterval =
+                                            defaultStatsSamplingInterval);
+  TaskStatsMode getStatsMode() const;
+  TaskQueueStats getStats(TaskType taskType) const;
+  void resetStats();
+  // Emits the stats of every queue as Tracy plots. Meant to be called once
+  // per frame, from one thread.
+  void plotStats() const;
+
 private:
+  using TimerClock = std::chrono::steady_clock;
+
+  struct TimerEntry {
+    TimerClock::time_point due;
+    // set for tasks queued by enqueueAfter
+    std::unique_ptr<TaskBase> task;
+    // set for periodic timers
+    std::shared_ptr<PeriodicTimer> periodicTimer;
+  };
+
+  template <typename T, typename F>
+  static std::unique_ptr<T> makeTask(TaskTarget const& target, F&& func) {
+    auto newTask = std::make_unique<T>(target.type, std::forward<F>(func));
+    newTask->setTarget(target);
+
+    return newTask;
+  }
+
+  template <typename Funcs, typename GetResult>
+  auto pushBatch(TaskTarget const& target, Funcs&& funcs,
+                 GetResult getResult) {
+    auto const queue = _taskQueues.find(target.type);
+
+    assert(queue != _taskQueues.cend());
+
+    using FunctionType = std::decay_t<decltype(*std::begin(funcs))>;
+    using FunctionRef =
+        std::conditional_t<std::is_lvalue_reference_v<Funcs>,
+                           FunctionType const&, FunctionType&&>;
+    using BatchTask = Task<FunctionRef>;
+
+    std::vector<std::unique_ptr<TaskBase>> tasks;
+    std::vector<decltype(getResult(std::declval<BatchTask&>()))> results;
+    tasks.reserve(std::size(funcs));
+    results.reserve(std::size(funcs));
+
+    for (auto& func : funcs) {
+      auto newTask =
+          makeTask<BatchTask>(target, static_cast<FunctionRef>(func));
+      results.push_back(getResult(*newTask));
+      tasks.push_back(std::move(newTask));
+    }
+
+    pushTasks(queue->second, tasks);
+
+    return results;
+  }
+
+  using ParallelRangeFunction = void (*)(void const* context, std::size_t b,
+                                         std::size_t e);
+
+  template <typename R>
+  static void invokeRangeFunction(void const* context, std::size_t b,
+                                  std::size_t e) {
+    (*static_cast<R const*>(context))(b, e);
+  }
+
+  template <typename T>
+  static TaskHandle<T> unwrap(TaskHandle<TaskHandle<T>> const& outer) {
+    auto const state = std::allocate_shared<TaskHandleState<T>>(
+        TaskPoolAllocator<TaskHandleState<T>>{});
+    TaskHandle<T> result = state->getHandle();
+
+    outer.getCompletion()->subscribe([state, outerFuture = outer.getFuture()]() {
+      TaskHandle<T> inner;
+
+      try {
+        inner = outerFuture.get();
+      } catch (...) {
+        state->promise.set_exception(std::current_exception());
+        state->completion->complete();
+        return;
+      }
+
+      if (!inner.valid()) {
+        if constexpr (std::is_void_v<T>) {
+          state->promise.set_value();
+        } else {
+          state->promise.set_value(T{});
+        }
+
+        state->completion->complete();
+        return;
+      }
+
+      inner.getCompletion()->subscribe(
+          [state, innerFuture = inner.getFuture()]() {
+            forwardTaskResult(innerFuture, state->promise);
+            state->completion->complete();
+          });
+    });
+
+    return result;
+  }
+
+  using ReadyCheckFunction = bool (*)(void const* context);
+
+  template <typename R> static bool invokeReadyCheck(void const* context) {
+    return (*static_cast<R const*>(context))();
+  }
+
+  template <typename Future>
+  void waitImpl(Future const& future, TaskCompletion* completion) {
+    assert(future.valid());
+
+    if (!isOwnWorkerThread()) {
+      future.wait();
+      return;
+    }
+
+    auto const isReady = [&future]() {
+      return future.wait_for(std::chrono::seconds{0}) ==
+             std::future_status::ready;
+    };
+
+    runTasksUntil(&invokeReadyCheck<decltype(isReady)>, &isReady, completion);
+  }
+
+  bool isOwnWorkerThread() const;
+  void runTasksUntil(ReadyCheckFunction isReady, void const* context,
+                     TaskCompletion* completion);
+
+  void runParallelRange(TaskTarget const& target, std::size_t count,
+                        std::size_t grainSize, ParallelRangeFunction func,
+                        void const* context);
+  void pushTask(TaskQueue& queue, std::unique_ptr<TaskBase> task);
+  void pushTasks(TaskQueue& queue, std::span<std::unique_ptr<TaskBase>> tasks);
+  void pushTaskAfter(TaskCompletion& dependency,
+                     std::unique_ptr<TaskBase> task);
+  // The queue the task was taken from is returned in outTaskQueue, it is
+  // one of the helped queues if the worker's own queue is empty.
+  TaskBase* findTask(TaskQueue& queue, std::size_t workerIndex,
+                     TaskQueue*& outTaskQueue);
+  TaskBase* findTaskToHelp(TaskQueue& queue);
+  static bool hasTasksToRun(TaskQueue const& queue);
+  static void runPendingCalls(WorkerCalls& calls);
+  TaskBase* takeInjectedTask(TaskQueue& queue, TaskPriority minPriority);
+  void executeTask(TaskQueue& queue, TaskBase* task);
+  // Destroys the tasks of every queue that didn't start and wakes the workers
+  // that might wait on them.
+  void destroyQueuedTasks();
+  // Helpers are only woken for the tasks that the queue's own sleeping
+  // workers can't take.
+  void wakeWorkers(TaskQueue& queue, std::size_t taskCount);
+  void addTimer(TimerEntry entry);
+  TimerHandle addPeriodicTimer(TimerClock::duration period,
+                               std::function<void()> dispatch);
+  TimerWheel<TimerEntry>::Tick getTimerTick(TimerClock::time_point time,
+                                            bool roundUp) const;
+  void timerFunc();
+  WorkerIdleTime* getIdleTimeToTrack(TaskQueue& queue,
+                                     std::size_t workerIndex) const;
+
   std::map<TaskType, TaskQueue> _taskQueues;
   std::vector<std::thread> _threads;
-  mutable std::mutex _taskQueueMutex;
+  TimerWheel<TimerEntry> _timerWheel;
+  TimerClock::time_point _timerStart;
+  std::mutex _timerMutex;
+  std::condition_variable _timerCondVar;
+  std::thread _timerThread;
+  std::atomic<std::size_t> _pendingTaskCount = 0;
+  // sum of the futureWaiterCount of all queues
+  std::atomic<std::size_t> _futureWaiterCount = 0;
+  mutable std::mutex _waitIdleMutex;
   mutable std::condition_variable _waitIdleCondVar;
   std::atomic<bool> _running = false;
   std::atomic<bool> _shutdownComplete = false;
+  std::atomic<TaskStatsMode> _statsMode = TaskStatsMode::disabled;
+  std::atomic<std::size_t> _statsSamplingInterval =
+      defaultStatsSamplingInterval;
 };
 
 } /*namespace obsidian::task*/
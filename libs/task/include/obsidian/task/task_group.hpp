@@ -0,0 +1,99 @@
+#pragma once
+
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_priority.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace obsidian::task {
+
+struct TaskGroupState;
+
+// The result of a task whose group was cancelled before the task started.
+class TaskCancelledError : public std::runtime_error {
+public:
+  TaskCancelledError();
+};
+
+// Lets running tasks check whether their group was cancelled. A default
+// constructed token is never cancelled.
+class CancellationToken {
+public:
+  CancellationToken() = default;
+
+  bool isCancelled() const;
+  void throwIfCancelled() const;
+
+private:
+  explicit CancellationToken(std::shared_ptr<TaskGroupState const> state);
+
+  std::shared_ptr<TaskGroupState const> _state;
+
+  friend class TaskGroup;
+};
+
+// Tracks a set of tasks so that they can be waited for and cancelled
+// independently of the rest of the executor's work. Destroying the group
+// neither waits for nor cancels its tasks.
+class TaskGroup {
+public:
+  explicit TaskGroup(TaskExecutor& executor);
+  TaskGroup(TaskGroup const& other) = delete;
+
+  TaskGroup& operator=(TaskGroup const& other) = delete;
+
+  // Like TaskExecutor::spawn, for a task that belongs to the group. func can
+  // take a CancellationToken to stop early once the group is cancelled. If
+  // the group was cancelled before the task started, func isn't called and
+  // the handle fails with TaskCancelledError.
+  template <typename F> auto spawn(TaskTarget const& target, F&& func) {
+    auto task = [token = getToken(),
+                 func = std::forward<F>(func)]() mutable -> decltype(auto) {
+      token.throwIfCancelled();
+
+      if constexpr (std::is_invocable_v<std::decay_t<F>&,
+                                        CancellationToken const&>) {
+        return func(token);
+      } else {
+        return func();
+      }
+    };
+
+    auto handle = _executor.spawn(target, std::move(task));
+    add(handle);
+
+    return handle;
+  }
+
+  // Makes the group wait for work that wasn't spawned through it, such as a
+  // coroutine. Such work has to check the group's token itself.
+  template <typename T> void add(TaskHandle<T> const& handle) {
+    if (handle.valid()) {
+      addCompletion(*handle.getCompletion());
+    }
+  }
+
+  // Waits only for the tasks of this group, including the ones added while
+  // waiting. Workers of the executor keep running tasks in the meantime.
+  void wait();
+
+  // Tasks that didn't start yet won't run and the tokens of the running ones
+  // report the cancellation. The tasks stay in their queues until a worker
+  // drops them, so wait for the group to know when they are gone.
+  void cancel();
+
+  bool isCancelled() const;
+  CancellationToken getToken() const;
+
+private:
+  void addCompletion(TaskCompletion& completion);
+
+  TaskExecutor& _executor;
+  std::shared_ptr<TaskGroupState> _state;
+};
+
+} /*namespace obsidian::task*/
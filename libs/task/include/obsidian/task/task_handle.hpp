@@ -0,0 +1,167 @@
+#pragma once
+
+#include <obsidian/task/task_pool.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace obsidian::task {
+
+// Signalled once when the task it belongs to finished executing. Subscribed
+// callbacks run on the thread that signals the completion, or right away on
+// the subscribing thread if the completion was already signalled. Callbacks
+// that never ran are destroyed together with the completion.
+class TaskCompletion {
+public:
+  using Callback = std::function<void()>;
+
+  void subscribe(Callback callback);
+  void complete();
+  bool isCompleted() const;
+
+private:
+  mutable std::mutex _mutex;
+  bool _completed = false;
+  std::vector<Callback> _callbacks;
+};
+
+std::shared_ptr<TaskCompletion> makeTaskCompletion();
+
+template <typename T> class TaskHandle {
+public:
+  using ValueType = T;
+
+  TaskHandle() = default;
+
+  TaskHandle(std::shared_future<T> future,
+             std::shared_ptr<TaskCompletion> completion)
+      : _future{std::move(future)}, _completion{std::move(completion)} {}
+
+  bool valid() const { return _completion != nullptr; }
+
+  bool isDone() const { return _completion && _completion->isCompleted(); }
+
+  void wait() const { _future.wait(); }
+
+  decltype(auto) get() const { return _future.get(); }
+
+  std::shared_future<T> const& getFuture() const { return _future; }
+
+  std::shared_ptr<TaskCompletion> const& getCompletion() const {
+    return _completion;
+  }
+
+private:
+  std::shared_future<T> _future;
+  std::shared_ptr<TaskCompletion> _completion;
+};
+
+template <typename T> struct IsTaskHandle : std::false_type {};
+
+template <typename T> struct IsTaskHandle<TaskHandle<T>> : std::true_type {};
+
+// Result and completion of a handle that is not backed by a single task.
+template <typename T> struct TaskHandleState {
+  std::promise<T> promise{std::allocator_arg, TaskPoolAllocator<T>{}};
+  std::shared_ptr<TaskCompletion> completion = makeTaskCompletion();
+
+  TaskHandle<T> getHandle() {
+    return {promise.get_future().share(), completion};
+  }
+};
+
+template <typename T>
+void forwardTaskResult(std::shared_future<T> const& from,
+                       std::promise<T>& to) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      from.get();
+      to.set_value();
+    } else {
+      to.set_value(from.get());
+    }
+  } catch (...) {
+    to.set_exception(std::current_exception());
+  }
+}
+
+// Completes once every handle in the range completed. Failures of the
+// individual tasks are not forwarded, check the handles for their results.
+template <typename Handles> TaskHandle<void> whenAll(Handles const& handles) {
+  struct WhenAllState : TaskHandleState<void> {
+    std::atomic<std::size_t> remaining;
+  };
+
+  auto const state =
+      std::allocate_shared<WhenAllState>(TaskPoolAllocator<WhenAllState>{});
+  TaskHandle<void> result = state->getHandle();
+
+  // The extra count keeps the state from completing while still subscribing.
+  state->remaining = std::size(handles) + 1;
+
+  auto const onCompleted = [state]() {
+    if (--state->remaining == 0) {
+      state->promise.set_value();
+      state->completion->complete();
+    }
+  };
+
+  for (auto const& handle : handles) {
+    if (handle.valid()) {
+      handle.getCompletion()->subscribe(onCompleted);
+    } else {
+      onCompleted();
+    }
+  }
+
+  onCompleted();
+
+  return result;
+}
+
+// Completes with the index of the first handle in the range that completed.
+template <typename Handles>
+TaskHandle<std::size_t> whenAny(Handles const& handles) {
+  assert(std::size(handles) && "whenAny needs at least one handle.");
+
+  struct WhenAnyState : TaskHandleState<std::size_t> {
+    std::atomic<bool> completed = false;
+  };
+
+  auto const state =
+      std::allocate_shared<WhenAnyState>(TaskPoolAllocator<WhenAnyState>{});
+  TaskHandle<std::size_t> result = state->getHandle();
+
+  std::size_t i = 0;
+
+  for (auto const& handle : handles) {
+    auto const onCompleted = [state, i]() {
+      if (!state->completed.exchange(true)) {
+        state->promise.set_value(i);
+        state->completion->complete();
+      }
+    };
+
+    if (handle.valid()) {
+      handle.getCompletion()->subscribe(onCompleted);
+    } else {
+      onCompleted();
+    }
+
+    ++i;
+  }
+
+  return result;
+}
+
+} /*namespace obsidian::task*/
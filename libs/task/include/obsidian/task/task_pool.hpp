@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace obsidian::task {
+
+// Slab allocator for task objects and the shared states of their futures.
+// Freed blocks are cached on the freeing thread and moved between threads in
+// batches, so enqueueing a task normally neither locks nor calls the global
+// allocator. Requests bigger than the largest block fall back to operator new.
+class TaskPool {
+public:
+  static constexpr std::size_t maxBlockSize = 256;
+
+  static void* allocate(std::size_t size);
+  static void deallocate(void* ptr, std::size_t size) noexcept;
+};
+
+template <typename T> struct TaskPoolAllocator {
+  using value_type = T;
+
+  TaskPoolAllocator() = default;
+
+  template <typename U>
+  TaskPoolAllocator(TaskPoolAllocator<U> const&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      return static_cast<T*>(
+          ::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    } else {
+      return static_cast<T*>(TaskPool::allocate(n * sizeof(T)));
+    }
+  }
+
+  void deallocate(T* ptr, std::size_t n) noexcept {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      ::operator delete(ptr, n * sizeof(T), std::align_val_t{alignof(T)});
+    } else {
+      TaskPool::deallocate(ptr, n * sizeof(T));
+    }
+  }
+
+  template <typename U>
+  bool operator==(TaskPoolAllocator<U> const& other) const noexcept {
+    return true;
+  }
+};
+
+} /*namespace obsidian::task*/
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <obsidian/task/task_type.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace obsidian::task {
+
+enum class TaskPriority : std::uint8_t { background, normal, high };
+
+constexpr std::size_t taskPriorityCount = 3;
+
+using TaskDeadline = std::chrono::steady_clock::time_point;
+
+constexpr TaskDeadline noTaskDeadline = TaskDeadline::max();
+
+// Where and how urgently a task runs. Converts implicitly from a TaskType so
+// that plain enqueues stay normal priority tasks without a deadline.
+struct TaskTarget {
+  TaskTarget(TaskType type, TaskPriority priority = TaskPriority::normal,
+             TaskDeadline deadline = noTaskDeadline)
+      : type{type}, priority{priority}, deadline{deadline} {}
+
+  TaskType type;
+  TaskPriority priority;
+  TaskDeadline deadline;
+};
+
+} /*namespace obsidian::task*/
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace obsidian::task {
+
+enum class TaskStatsMode {
+  disabled,
+  // Only every n-th task enqueued on a thread is timed, cheap enough to stay
+  // on in release builds.
+  sampled,
+  // Every task is timed.
+  full
+};
+
+constexpr std::size_t defaultStatsSamplingInterval = 64;
+
+// Durations in power of two buckets: bucket 0 counts everything below 1 µs,
+// bucket i the range [2^(i-1), 2^i) µs and the last bucket everything above.
+struct TaskDurationHistogram {
+  static constexpr std::size_t bucketCount = 24;
+
+  std::array<std::uint64_t, bucketCount> buckets = {};
+  std::uint64_t sampleCount = 0;
+  std::chrono::nanoseconds total{0};
+  std::chrono::nanoseconds max{0};
+
+  static std::size_t getBucketIndex(std::chrono::nanoseconds duration);
+  // Upper bound of the bucket.
+  static std::chrono::microseconds getBucketLimit(std::size_t bucketIndex);
+
+  std::chrono::nanoseconds mean() const;
+  // Upper bound of the bucket that contains the given percentile, p in [0, 1].
+  std::chrono::microseconds percentile(double p) const;
+};
+
+struct TaskQueueStats {
+  // from the moment a task was enqueued until a worker started it
+  TaskDurationHistogram startLatency;
+  TaskDurationHistogram executionTime;
+  std::size_t queuedTaskCount = 0;
+  std::size_t tasksInProgress = 0;
+  std::size_t workerCount = 0;
+  // share of the worker time since the stats were reset that wasn't spent
+  // sleeping on the queue, only tracked while stats are enabled
+  double busyRatio = 0.0;
+};
+
+// Histogram that workers record into concurrently.
+class AtomicTaskDurationHistogram {
+public:
+  void record(std::chrono::nanoseconds duration);
+  void reset();
+  TaskDurationHistogram snapshot() const;
+
+private:
+  std::array<std::atomic<std::uint64_t>, TaskDurationHistogram::bucketCount>
+      _buckets = {};
+  std::atomic<std::uint64_t> _sampleCount = 0;
+  std::atomic<std::int64_t> _totalNanoseconds = 0;
+  std::atomic<std::int64_t> _maxNanoseconds = 0;
+};
+
+// Time a single worker spent sleeping on its queue.
+struct WorkerIdleTime {
+  std::atomic<std::int64_t> idleNanoseconds = 0;
+  // 0 while the worker is awake
+  std::atomic<std::int64_t> sleepStartNanoseconds = 0;
+};
+
+struct TaskQueueStatsCounters {
+  AtomicTaskDurationHistogram startLatency;
+  AtomicTaskDurationHistogram executionTime;
+  std::atomic<std::int64_t> resetTimeNanoseconds = 0;
+};
+
+} /*namespace obsidian::task*/
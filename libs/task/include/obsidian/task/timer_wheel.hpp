@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace obsidian::task {
+
+// Hierarchical timing wheel in the style of "Hashed and Hierarchical Timing
+// Wheels" (Varghese, Lauck). Every level has slotCount slots, each covering
+// slotCount times the ticks of a slot on the level below. Entries are placed
+// on the lowest level whose range covers them and move down a level when
+// the wheel reaches their slot, so inserting and expiring an entry doesn't
+// depend on the number of entries. Not thread-safe.
+template <typename T> class TimerWheel {
+public:
+  using Tick = std::uint64_t;
+
+  static constexpr std::size_t slotBits = 6;
+  static constexpr std::size_t slotCount = std::size_t{1} << slotBits;
+  static constexpr std::size_t levelCount = 4;
+
+  Tick getCurrentTick() const { return _currentTick; }
+  std::size_t size() const { return _size; }
+  bool empty() const { return !_size; }
+
+  // An entry due at or before the current tick is returned by the next call
+  // to advance.
+  void insert(Tick dueTick, T value) {
+    place({dueTick, std::move(value)});
+    ++_size;
+  }
+
+  // Moves the wheel forward to tick and appends the entries that became due
+  // to outDue. Ticks without any entries are skipped, so the cost doesn't
+  // depend on how far the wheel moves.
+  void advance(Tick tick, std::vector<T>& outDue) {
+    collectExpired(outDue);
+
+    while (_currentTick < tick) {
+      std::optional<Tick> const nextTick = getNextEventTick();
+
+      if (!nextTick || *nextTick > tick) {
+        _currentTick = tick;
+        break;
+      }
+
+      _currentTick = *nextTick;
+
+      if (!(_currentTick & getLevelMask(levelCount))) {
+        Slot overflow;
+        overflow.swap(_overflow);
+
+        for (Entry& entry : overflow) {
+          place(std::move(entry));
+        }
+      }
+
+      // Higher levels first, their entries might land in a lower level slot
+      // that starts at the same tick.
+      for (std::size_t level = levelCount; level-- > 1;) {
+        if (!(_currentTick & getLevelMask(level))) {
+          cascade(level);
+        }
+      }
+
+      Slot& slot = _levels[0][_currentTick & (slotCount - 1)];
+
+      for (Entry& entry : slot) {
+        _expired.push_back(std::move(entry));
+      }
+
+      slot.clear();
+      collectExpired(outDue);
+    }
+  }
+
+  // The earliest tick at which an entry becomes due or entries have to move
+  // down a level, empty if there are no entries.
+  std::optional<Tick> getNextEventTick() const {
+    if (!_expired.empty()) {
+      return _currentTick;
+    }
+
+    // The slots of a level all start before the next slot of the level
+    // above, so the first occupied slot found is the earliest.
+    for (std::size_t level = 0; level < levelCount; ++level) {
+      std::size_t const shift = slotBits * level;
+      std::size_t const currentSlot =
+          (_currentTick >> shift) & (slotCount - 1);
+      Tick const blockStart = _currentTick & ~getLevelMask(level + 1);
+
+      for (std::size_t i = currentSlot + 1; i < slotCount; ++i) {
+        if (!_levels[level][i].empty()) {
+          return blockStart + (Tick{i} << shift);
+        }
+      }
+    }
+
+    if (!_overflow.empty()) {
+      return (_currentTick | getLevelMask(levelCount)) + 1;
+    }
+
+    return std::nullopt;
+  }
+
+  void clear() {
+    for (auto& level : _levels) {
+      for (Slot& slot : level) {
+        slot.clear();
+      }
+    }
+
+    _overflow.clear();
+    _expired.clear();
+    _currentTick = 0;
+    _size = 0;
+  }
+
+private:
+  struct Entry {
+    Tick dueTick;
+    T value;
+  };
+
+  using Slot = std::vector<Entry>;
+
+  // The bits of a tick that select the slot within each level below level.
+  static constexpr Tick getLevelMask(std::size_t level) {
+    return (Tick{1} << (slotBits * level)) - 1;
+  }
+
+  void place(Entry entry) {
+    if (entry.dueTick <= _currentTick) {
+      _expired.push_back(std::move(entry));
+      return;
+    }
+
+    for (std::size_t level = 0; level < levelCount; ++level) {
+      std::size_t const shift = slotBits * (level + 1);
+
+      if ((entry.dueTick >> shift) == (_currentTick >> shift)) {
+        std::size_t const slot =
+            (entry.dueTick >> (slotBits * level)) & (slotCount - 1);
+        _levels[level][slot].push_back(std::move(entry));
+        return;
+      }
+    }
+
+    _overflow.push_back(std::move(entry));
+  }
+
+  void cascade(std::size_t level) {
+    Slot entries;
+    entries.swap(
+        _levels[level][(_currentTick >> (slotBits * level)) & (slotCount - 1)]);
+
+    for (Entry& entry : entries) {
+      place(std::move(entry));
+    }
+  }
+
+  void collectExpired(std::vector<T>& outDue) {
+    for (Entry& entry : _expired) {
+      outDue.push_back(std::move(entry.value));
+    }
+
+    _size -= _expired.size();
+    _expired.clear();
+  }
+
+  std::array<std::array<Slot, slotCount>, levelCount> _levels;
+  // entries beyond the range of the top level
+  Slot _overflow;
+  // entries due at or before the current tick
+  Slot _expired;
+  Tick _currentTick = 0;
+  std::size_t _size = 0;
+};
+
+} /*namespace obsidian::task*/
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace obsidian::task {
+
+// Lock-free Chase-Lev deque as described in "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli).
+// Only the owning thread may call push and pop, any thread may call steal.
+template <typename T> class WorkStealingDeque {
+  static_assert(std::is_pointer_v<T>,
+                "WorkStealingDeque only supports pointer elements.");
+
+  struct Buffer {
+    explicit Buffer(std::int64_t capacity)
+        : capacity{capacity}, items{new std::atomic<T>[capacity]} {}
+
+    T get(std::int64_t i) const {
+      return items[i & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t i, T item) {
+      items[i & (capacity - 1)].store(item, std::memory_order_relaxed);
+    }
+
+    std::int64_t const capacity;
+    std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+public:
+  explicit WorkStealingDeque(std::int64_t initialCapacity = 256) {
+    assert(initialCapacity > 0 &&
+           (initialCapacity & (initialCapacity - 1)) == 0 &&
+           "Capacity has to be a power of two.");
+
+    _buffers.push_back(std::make_unique<Buffer>(initialCapacity));
+    _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(WorkStealingDeque const& other) = delete;
+
+  WorkStealingDeque& operator=(WorkStealingDeque const& other) = delete;
+
+  void push(T item) {
+    std::int64_t const b = _bottom.load(std::memory_order_relaxed);
+    std::int64_t const t = _top.load(std::memory_order_acquire);
+    Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+
+    if (b - t > buffer->capacity - 1) {
+      buffer = grow(buffer, b, t);
+    }
+
+    buffer->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  T pop() {
+    std::int64_t const b = _bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* const buffer = _buffer.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = _top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      _bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T item = buffer->get(b);
+
+    if (t == b) {
+      // last element, race against the thieves
+      if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return item;
+  }
+
+  T steal() {
+    std::int64_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t const b = _bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return nullptr;
+    }
+
+    T const item = _buffer.load(std::memory_order_acquire)->get(t);
+
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+
+    return item;
+  }
+
+  bool empty() const { return sizeApprox() == 0; }
+
+  std::size_t sizeApprox() const {
+    std::int64_t const b = _bottom.load(std::memory_order_relaxed);
+    std::int64_t const t = _top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0;
+  }
+
+private:
+  Buffer* grow(Buffer* oldBuffer, std::int64_t b, std::int64_t t) {
+    auto newBuffer = std::make_unique<Buffer>(oldBuffer->capacity * 2);
+
+    for (std::int64_t i = t; i < b; ++i) {
+      newBuffer->put(i, oldBuffer->get(i));
+    }
+
+    Buffer* const result = newBuffer.get();
+
+    // Thieves might still be reading from the old buffer so it is kept alive
+    // until the deque is destroyed.
+    _buffers.push_back(std::move(newBuffer));
+    _buffer.store(result, std::memory_order_release);
+
+    return result;
+  }
+
+  alignas(64) std::atomic<std::int64_t> _top = 0;
+  alignas(64) std::atomic<std::int64_t> _bottom = 0;
+  alignas(64) std::atomic<Buffer*> _buffer = nullptr;
+  std::vector<std::unique_ptr<Buffer>> _buffers;
+};
+
+} /*namespace obsidian::task*/
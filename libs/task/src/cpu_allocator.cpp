@@ -0,0 +1,136 @@
+#include <obsidian/task/cpu_allocator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::task;
+
+CpuAllocator::CpuAllocator(platform::CpuTopology const& topology) {
+  // Hyperthreads of a physical core have the same package and core id.
+  std::map<std::pair<unsigned int, unsigned int>, Core> cores;
+
+  for (platform::LogicalCpu const& cpu : topology.cpus) {
+    Core& core = cores[{cpu.packageId, cpu.coreId}];
+    core.cacheDomainId = cpu.cacheDomainId;
+    core.cpus.push_back(cpu.id);
+  }
+
+  for (auto& corePair : cores) {
+    _sharedCores.push_back(std::move(corePair.second));
+  }
+
+  std::sort(_sharedCores.begin(), _sharedCores.end(),
+            [](Core const& lhs, Core const& rhs) {
+              if (lhs.cacheDomainId != rhs.cacheDomainId) {
+                return lhs.cacheDomainId < rhs.cacheDomainId;
+              }
+
+              return lhs.cpus.front() < rhs.cpus.front();
+            });
+}
+
+platform::CpuSet CpuAllocator::reserveCores(std::size_t coreCount) {
+  coreCount = std::min(coreCount, std::max<std::size_t>(
+                                      _sharedCores.size(), 1) - 1);
+
+  platform::CpuSet result;
+
+  for (std::size_t i = 0; i < coreCount; ++i) {
+    platform::CpuSet const& cpus = _sharedCores.back().cpus;
+    result.insert(result.end(), cpus.cbegin(), cpus.cend());
+    _sharedCores.pop_back();
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+std::size_t CpuAllocator::getSharedCoreCount() const {
+  return _sharedCores.size();
+}
+
+platform::CpuSet CpuAllocator::getSharedCpus() const {
+  platform::CpuSet result;
+
+  for (Core const& core : _sharedCores) {
+    result.insert(result.end(), core.cpus.cbegin(), core.cpus.cend());
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+std::vector<platform::CpuSet>
+CpuAllocator::spreadThreads(std::size_t threadCount) const {
+  struct CacheDomain {
+    platform::CpuSet cpus;
+    std::size_t coreCount = 0;
+    std::size_t threadCount = 0;
+    std::size_t remainder = 0;
+  };
+
+  std::vector<CacheDomain> domains;
+
+  for (std::size_t i = 0; i < _sharedCores.size(); ++i) {
+    if (!i ||
+        _sharedCores[i].cacheDomainId != _sharedCores[i - 1].cacheDomainId) {
+      domains.emplace_back();
+    }
+
+    platform::CpuSet const& cpus = _sharedCores[i].cpus;
+    domains.back().cpus.insert(domains.back().cpus.end(), cpus.cbegin(),
+                               cpus.cend());
+    ++domains.back().coreCount;
+  }
+
+  if (domains.empty()) {
+    return {};
+  }
+
+  // Largest remainder apportionment of the threads to the domains.
+  std::size_t assignedCount = 0;
+
+  for (CacheDomain& domain : domains) {
+    std::sort(domain.cpus.begin(), domain.cpus.end());
+
+    std::size_t const share = threadCount * domain.coreCount;
+    domain.threadCount = share / _sharedCores.size();
+    domain.remainder = share % _sharedCores.size();
+    assignedCount += domain.threadCount;
+  }
+
+  std::vector<CacheDomain*> byRemainder;
+
+  for (CacheDomain& domain : domains) {
+    byRemainder.push_back(&domain);
+  }
+
+  std::stable_sort(byRemainder.begin(), byRemainder.end(),
+                   [](CacheDomain const* lhs, CacheDomain const* rhs) {
+                     return lhs->remainder > rhs->remainder;
+                   });
+
+  for (std::size_t i = 0; assignedCount < threadCount; ++i, ++assignedCount) {
+    ++byRemainder[i % byRemainder.size()]->threadCount;
+  }
+
+  std::vector<platform::CpuSet> result;
+  result.reserve(threadCount);
+
+  while (result.size() < threadCount) {
+    for (CacheDomain& domain : domains) {
+      if (domain.threadCount) {
+        result.push_back(domain.cpus);
+        --domain.threadCount;
+      }
+    }
+  }
+
+  return result;
+}
@@ -1,4 +1,12 @@
 #include <obsidian/task/task.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <new>
+#include <utility>
 
 using namespace obsidian::task;
 
@@ -15,3 +23,69 @@ TaskId TaskBase::getId() const { return _taskId; };
 TaskType TaskBase::getType() const { return _type; }
 
 bool TaskBase::isDone() const { return _done; }
+
+TaskPriority TaskBase::getPriority() const { return _priority; }
+
+TaskDeadline TaskBase::getDeadline() const { return _deadline; }
+
+void TaskBase::setTarget(TaskTarget const& target) {
+  _type = target.type;
+  _priority = target.priority;
+  _deadline = target.deadline;
+}
+
+std::chrono::steady_clock::time_point TaskBase::getEnqueueTime() const {
+  return _enqueueTime;
+}
+
+void TaskBase::setEnqueueTime(
+    std::chrono::steady_clock::time_point enqueueTime) {
+  _enqueueTime = enqueueTime;
+}
+
+void TaskBase::setCompletion(std::shared_ptr<TaskCompletion> completion) {
+  _completion = std::move(completion);
+}
+
+void TaskBase::signalCompletion() {
+  if (_completion) {
+    _completion->complete();
+    _completion.reset();
+  }
+}
+
+void* TaskBase::operator new(std::size_t size) {
+  return TaskPool::allocate(size);
+}
+
+void* TaskBase::operator new(std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void TaskBase::operator delete(void* ptr, std::size_t size) noexcept {
+  TaskPool::deallocate(ptr, size);
+}
+
+void TaskBase::operator delete(void* ptr, std::size_t size,
+                               std::align_val_t alignment) noexcept {
+  ::operator delete(ptr, size, alignment);
+}
+
+ResumeTask::ResumeTask(TaskType type, std::coroutine_handle<> coroutine)
+    : TaskBase(type), _coroutine{coroutine} {}
+
+ResumeTask::~ResumeTask() {
+  if (_coroutine) {
+    _coroutine.destroy();
+  }
+}
+
+void ResumeTask::execute() {
+  if (_done) {
+    OBS_LOG_ERR("Trying to execute a task that is already done.");
+    return;
+  }
+
+  _done = true;
+  std::exchange(_coroutine, nullptr).resume();
+}
@@ -0,0 +1,32 @@
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+
+using namespace obsidian::task;
+
+bool obsidian::task::suspendUntilCompleted(TaskCompletion& completion,
+                                           std::coroutine_handle<> coroutine) {
+  struct ResumeState {
+    std::coroutine_handle<> coroutine;
+    std::atomic<bool> arrived = false;
+  };
+
+  auto const state =
+      std::allocate_shared<ResumeState>(TaskPoolAllocator<ResumeState>{});
+  state->coroutine = coroutine;
+
+  // Whichever of the callback and the awaiting thread arrives second decides:
+  // the callback resumes the coroutine, the awaiting thread just doesn't
+  // suspend.
+  completion.subscribe([state]() {
+    if (state->arrived.exchange(true)) {
+      state->coroutine.resume();
+    }
+  });
+
+  return !state->arrived.exchange(true);
+}
@@ -1,26 +1,298 @@
+#include <obsidian/core/logging.hpp>
+#include <obsidian/platform/thread.hpp>
 #include <obsidian/task/task.hpp>
 #include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_stats.hpp>
 
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <latch>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+using namespace obsidian;
 using namespace obsidian::task;
 
-void TaskExecutor::initAndRun(std::vector<ThreadInitInfo> threadInit) {
-  std::scoped_lock l{_taskQueueMutex};
+namespace {
+
+struct WorkerContext {
+  TaskExecutor const* executor = nullptr;
+  TaskQueue* queue = nullptr;
+  std::size_t workerIndex = 0;
+};
+
+thread_local WorkerContext currentWorker;
+
+// Counts the tasks enqueued on this thread while stats are sampled.
+thread_local std::size_t enqueuedTaskCounter = 0;
+
+std::int64_t nowNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Accounts the time a worker spends sleeping on its queue as idle. Does
+// nothing if idleTime is null.
+class IdleTimeScope {
+public:
+  IdleTimeScope(WorkerIdleTime* idleTime, TaskQueueStatsCounters const& stats)
+      : _idleTime{idleTime}, _stats{stats} {
+    if (_idleTime) {
+      _idleTime->sleepStartNanoseconds = nowNanoseconds();
+    }
+  }
+
+  IdleTimeScope(IdleTimeScope const& other) = delete;
+
+  ~IdleTimeScope() {
+    if (_idleTime) {
+      // Only the part of the sleep after the last reset counts.
+      std::int64_t const sleepStart =
+          std::max(_idleTime->sleepStartNanoseconds.exchange(0),
+                   _stats.resetTimeNanoseconds.load());
+      _idleTime->idleNanoseconds += std::max<std::int64_t>(
+          nowNanoseconds() - sleepStart, 0);
+    }
+  }
+
+  IdleTimeScope& operator=(IdleTimeScope const& other) = delete;
+
+private:
+  WorkerIdleTime* _idleTime;
+  TaskQueueStatsCounters const& _stats;
+};
+
+char const* getDefaultThreadName(TaskType taskType) {
+  switch (taskType) {
+  case TaskType::general:
+    return "general";
+  case TaskType::rhiMain:
+    return "rhi main";
+  case TaskType::rhiTransfer:
+    return "rhi transfer";
+  case TaskType::resourceUpload:
+    return "upload";
+  }
+
+  return "worker";
+}
+
+void initThread(std::string const& name, platform::CpuSet const& cpus) {
+  platform::setCurrentThreadName(name);
+
+#ifdef TRACY_ENABLE
+  tracy::SetThreadName(name.c_str());
+#endif
+
+  if (!cpus.empty() && !platform::setCurrentThreadAffinity(cpus)) {
+    OBS_LOG_WARN("Failed to set the cpu affinity of thread " + name);
+  }
+}
+
+#ifdef TRACY_ENABLE
+
+struct TaskTypePlotNames {
+  char const* queuedTaskCount;
+  char const* tasksInProgress;
+  char const* busyRatio;
+  char const* startLatency;
+  char const* executionTime;
+};
+
+// Tracy keeps the plot names by pointer, so they have to be literals.
+TaskTypePlotNames getPlotNames(TaskType taskType) {
+  switch (taskType) {
+  case TaskType::general:
+    return {"general queued tasks", "general tasks in progress",
+            "general busy %", "general start latency us",
+            "general execution time us"};
+  case TaskType::rhiMain:
+    return {"rhiMain queued tasks", "rhiMain tasks in progress",
+            "rhiMain busy %", "rhiMain start latency us",
+            "rhiMain execution time us"};
+  case TaskType::rhiTransfer:
+    return {"rhiTransfer queued tasks", "rhiTransfer tasks in progress",
+            "rhiTransfer busy %", "rhiTransfer start latency us",
+            "rhiTransfer execution time us"};
+  case TaskType::resourceUpload:
+    return {"resourceUpload queued tasks", "resourceUpload tasks in progress",
+            "resourceUpload busy %", "resourceUpload start latency us",
+            "resourceUpload execution time us"};
+  }
+
+  return {"unknown queued tasks", "unknown tasks in progress",
+          "unknown busy %", "unknown start latency us",
+          "unknown execution time us"};
+}
+
+#endif
+
+// Orders the deadline heaps so that the earliest deadline is on top.
+bool laterDeadline(TaskBase const* lhs, TaskBase const* rhs) {
+  return lhs->getDeadline() > rhs->getDeadline();
+}
+
+struct ParallelRangeState {
+  std::size_t count;
+  std::size_t grainSize;
+  std::size_t participantCount;
+  void (*func)(void const* context, std::size_t b, std::size_t e);
+  void const* context;
+  std::atomic<std::size_t> next = 0;
+  std::atomic<std::size_t> processed = 0;
+  std::mutex exceptionMutex;
+  std::exception_ptr exception;
+};
+
+// Guided self-scheduling: every claim takes a share of what is left so that
+// the first subranges are big and the last ones even out the load.
+bool claimSubrange(ParallelRangeState& state, std::size_t& outBegin,
+                   std::size_t& outEnd) {
+  std::size_t begin = state.next.load(std::memory_order_relaxed);
+  std::size_t end;
+
+  do {
+    if (begin >= state.count) {
+      return false;
+    }
+
+    std::size_t const remaining = state.count - begin;
+    std::size_t const size =
+        std::max(state.grainSize, remaining / (2 * state.participantCount));
+    end = begin + std::min(size, remaining);
+  } while (!state.next.compare_exchange_weak(begin, end,
+                                             std::memory_order_relaxed));
+
+  outBegin = begin;
+  outEnd = end;
+  return true;
+}
+
+void markProcessed(ParallelRangeState& state, std::size_t count) {
+  if (state.processed.fetch_add(count) + count == state.count) {
+    state.processed.notify_all();
+  }
+}
+
+void processSubranges(ParallelRangeState& state) {
+  std::size_t begin;
+  std::size_t end;
+
+  while (claimSubrange(state, begin, end)) {
+    try {
+      state.func(state.context, begin, end);
+    } catch (...) {
+      {
+        std::scoped_lock l{state.exceptionMutex};
+        if (!state.exception) {
+          state.exception = std::current_exception();
+        }
+      }
+
+      std::size_t const claimed = state.next.exchange(state.count);
+
+      if (claimed < state.count) {
+        markProcessed(state, state.count - claimed);
+      }
+    }
+
+    markProcessed(state, end - begin);
+  }
+}
 
+} /*namespace*/
+
+void TaskExecutor::initAndRun(std::vector<ThreadInitInfo> threadInit) {
   _shutdownComplete = false;
   _running = true;
 
+  // All the queues have to exist before the first worker starts since the
+  // workers look them up without locking.
   for (ThreadInitInfo const& initInfo : threadInit) {
     auto const iter = _taskQueues.try_emplace(initInfo.taskType);
     assert(iter.second);
 
+    TaskQueue& queue = iter.first->second;
+
+    for (std::size_t i = 0; i < initInfo.threadCount; ++i) {
+      queue.workerDeques.push_back(
+          std::make_unique<WorkStealingDeque<TaskBase*>>());
+      queue.workerIdleTimes.push_back(std::make_unique<WorkerIdleTime>());
+      queue.workerCalls.push_back(std::make_unique<WorkerCalls>());
+    }
+
+    queue.stats.resetTimeNanoseconds = nowNanoseconds();
+    queue.waker = std::make_shared<TaskQueueWaker>();
+    queue.waker->queue = &queue;
+
+    assert(!initInfo.callOnInterval || initInfo.intervalMilliseconds != 0);
+  }
+
+  for (ThreadInitInfo const& initInfo : threadInit) {
+    TaskQueue& queue = _taskQueues.at(initInfo.taskType);
+
+    for (TaskType const helpedTaskType : initInfo.helpedTaskTypes) {
+      assert(helpedTaskType != initInfo.taskType);
+
+      TaskQueue& helpedQueue = _taskQueues.at(helpedTaskType);
+      queue.helpedQueues.push_back(&helpedQueue);
+      helpedQueue.helperQueues.push_back(&queue);
+    }
+  }
+
+  _timerStart = TimerClock::now();
+  _timerThread = std::thread{[this]() {
+    initThread("timer", {});
+    timerFunc();
+  }};
+
+  for (ThreadInitInfo const& initInfo : threadInit) {
+    if (!initInfo.callOnInterval) {
+      continue;
+    }
+
+    TaskQueue& queue = _taskQueues.at(initInfo.taskType);
+
+    addPeriodicTimer(
+        std::chrono::milliseconds{initInfo.intervalMilliseconds},
+        [&queue]() {
+          for (auto const& calls : queue.workerCalls) {
+            calls->intervalCallDue = true;
+          }
+
+          { std::scoped_lock l{queue.taskQueueMutex}; }
+          queue.taskQueueCondVar.notify_all();
+        });
+  }
+
+  for (ThreadInitInfo const& initInfo : threadInit) {
     for (std::size_t i = 0; i < initInfo.threadCount; ++i) {
-      _threads.emplace_back([this, initInfo]() {
-        workerFunc(initInfo.taskType, initInfo.callOnInterval,
+      _threads.emplace_back([this, initInfo, i]() {
+        std::string const name = (initInfo.threadName.empty()
+                                      ? getDefaultThreadName(initInfo.taskType)
+                                      : initInfo.threadName) +
+                                 ' ' + std::to_string(i);
+
+        std::size_t const affinityCount = initInfo.cpuAffinity.size();
+
+        initThread(name, affinityCount
+                             ? initInfo.cpuAffinity[i % affinityCount]
+                             : platform::CpuSet{});
+
+        workerFunc(initInfo.taskType, i, initInfo.callOnInterval,
                    initInfo.intervalMilliseconds);
       });
     }
@@ -34,70 +306,59 @@ TaskExecutor::~TaskExecutor() {
 }
 
 void TaskExecutor::workerFunc(
-    TaskType taskType, ThreadInitInfo::CallOnIntervalFunction intervalFunc,
+    TaskType taskType, std::size_t workerIndex,
+    ThreadInitInfo::CallOnIntervalFunction intervalFunc,
     std::size_t intervalMilliseconds) {
-  using namespace std::chrono;
-  using Clock = high_resolution_clock;
-  Clock::time_point lastTime = Clock::now();
-  duration<std::size_t, std::milli> const interval(
-      intervalFunc ? intervalMilliseconds : 10'000'000'000'000);
-
   assert(!intervalFunc || intervalMilliseconds != 0);
 
-  std::unique_lock lock{_taskQueueMutex};
-
   TaskQueue& taskQueue = _taskQueues.at(taskType);
 
-  lock.unlock();
-  bool notifyWait;
-
-  while (true) {
-    notifyWait = false;
+  currentWorker = {this, &taskQueue, workerIndex};
 
-    lock.lock();
+  WorkerCalls& calls = *taskQueue.workerCalls[workerIndex];
 
-    taskQueue.taskQueueCondVar.wait_until(
-        lock, lastTime + interval, [this, &taskQueue]() {
-          return !_running || taskQueue.tasks.size() > 0;
-        });
+  auto const canWake = [this, &taskQueue, &calls]() {
+    return !_running || hasTasksToRun(taskQueue) || calls.intervalCallDue ||
+           calls.hasPendingCalls;
+  };
 
-    if (!_running) {
-      return;
-    }
-
-    if (intervalFunc && Clock::now() > lastTime + interval) {
-      intervalFunc();
-      lastTime = Clock::now();
-    }
-
-    if (!taskQueue.tasks.empty()) {
-      std::unique_ptr<TaskBase> task = std::move(taskQueue.tasks.back());
-      taskQueue.tasks.pop_back();
+  while (true) {
+    TaskQueue* sourceQueue = nullptr;
+    TaskBase* const task =
+        _running ? findTask(taskQueue, workerIndex, sourceQueue) : nullptr;
 
-      ++taskQueue.tasksInProgress;
+    if (task) {
+      executeTask(*sourceQueue, task);
+    } else {
+      std::unique_lock l{taskQueue.taskQueueMutex};
 
-      lock.unlock();
-      taskQueue.taskQueueCondVar.notify_one();
+      ++taskQueue.sleepingWorkerCount;
 
-      task->execute();
+      IdleTimeScope const idleTimeScope{
+          getIdleTimeToTrack(taskQueue, workerIndex), taskQueue.stats};
 
-      lock.lock();
+      taskQueue.taskQueueCondVar.wait(l, canWake);
 
-      --taskQueue.tasksInProgress;
+      --taskQueue.sleepingWorkerCount;
     }
 
-    notifyWait = !getPendingAndUncompletedTasksCount();
-
-    lock.unlock();
+    if (!_running) {
+      break;
+    }
 
-    if (notifyWait) {
-      _waitIdleCondVar.notify_all();
+    if (intervalFunc && calls.intervalCallDue) {
+      calls.intervalCallDue = false;
+      intervalFunc();
     }
+
+    runPendingCalls(calls);
   }
+
+  currentWorker = {};
 }
 
 void TaskExecutor::waitIdle() const {
-  std::unique_lock l{_taskQueueMutex};
+  std::unique_lock l{_waitIdleMutex};
 
   _waitIdleCondVar.wait(
       l, [this]() { return !getPendingAndUncompletedTasksCount(); });
@@ -106,7 +367,21 @@ void TaskExecutor::waitIdle() const {
 void TaskExecutor::shutdown() {
   _running = false;
 
+  { std::scoped_lock l{_timerMutex}; }
+  _timerCondVar.notify_all();
+
+  if (_timerThread.joinable()) {
+    _timerThread.join();
+  }
+
+  // Tasks whose delay didn't pass are destroyed like the queued ones.
+  _timerWheel.clear();
+
+  // Before joining, since a worker might be waiting on one of them.
+  destroyQueuedTasks();
+
   for (auto& queuePair : _taskQueues) {
+    { std::scoped_lock l{queuePair.second.taskQueueMutex}; }
     queuePair.second.taskQueueCondVar.notify_all();
   }
 
@@ -114,8 +389,21 @@ void TaskExecutor::shutdown() {
     t.join();
   }
 
+  destroyQueuedTasks();
+
+  {
+    std::scoped_lock l{_waitIdleMutex};
+    _pendingTaskCount = 0;
+  }
+
   _waitIdleCondVar.notify_all();
 
+  // Completions that waiting workers subscribed to can outlive the queues.
+  for (auto& queuePair : _taskQueues) {
+    std::scoped_lock l{queuePair.second.waker->mutex};
+    queuePair.second.waker->queue = nullptr;
+  }
+
   _taskQueues.clear();
   _threads.clear();
   _shutdownComplete = true;
@@ -124,12 +412,791 @@ void TaskExecutor::shutdown() {
 bool TaskExecutor::shutdownComplete() const { return _shutdownComplete; }
 
 std::size_t TaskExecutor::getPendingAndUncompletedTasksCount() const {
-  std::size_t cnt = 0;
+  return _pendingTaskCount;
+}
+
+void TaskExecutor::runOnEachWorker(TaskType taskType,
+                                   std::function<void()> const& func) {
+  TaskQueue& queue = _taskQueues.at(taskType);
+
+  assert(!isOwnWorkerThread() || currentWorker.queue != &queue);
+
+  std::latch callsDone{static_cast<std::ptrdiff_t>(queue.workerCalls.size())};
+
+  for (auto const& calls : queue.workerCalls) {
+    {
+      std::scoped_lock l{calls->pendingCallsMutex};
+      calls->pendingCalls.push_back([&func, &callsDone]() {
+        try {
+          func();
+        } catch (std::exception const& e) {
+          OBS_LOG_ERR(std::string{"Worker call threw an exception: "} +
+                      e.what());
+        } catch (...) {
+          OBS_LOG_ERR("Worker call threw an unknown exception.");
+        }
+
+        callsDone.count_down();
+      });
+    }
+
+    calls->hasPendingCalls = true;
+  }
+
+  { std::scoped_lock l{queue.taskQueueMutex}; }
+  queue.taskQueueCondVar.notify_all();
+
+  callsDone.wait();
+}
+
+void TaskExecutor::setStatsMode(TaskStatsMode mode,
+                                std::size_t samplingInterval) {
+  _statsSamplingInterval = std::max<std::size_t>(samplingInterval, 1);
+  _statsMode = mode;
+}
+
+TaskStatsMode TaskExecutor::getStatsMode() const { return _statsMode; }
+
+TaskQueueStats TaskExecutor::getStats(TaskType taskType) const {
+  auto const queueIter = _taskQueues.find(taskType);
+
+  if (queueIter == _taskQueues.cend()) {
+    return {};
+  }
+
+  TaskQueue const& queue = queueIter->second;
+  TaskQueueStats result;
+
+  result.startLatency = queue.stats.startLatency.snapshot();
+  result.executionTime = queue.stats.executionTime.snapshot();
+  result.queuedTaskCount = queue.queuedTaskCount;
+  result.tasksInProgress = queue.tasksInProgress;
+  result.workerCount = queue.workerDeques.size();
+
+  std::int64_t const now = nowNanoseconds();
+  std::int64_t const resetTime = queue.stats.resetTimeNanoseconds;
+  std::int64_t idleTime = 0;
+
+  for (auto const& workerIdleTime : queue.workerIdleTimes) {
+    idleTime += workerIdleTime->idleNanoseconds;
+
+    // Workers that are asleep right now didn't account their sleep yet.
+    if (std::int64_t const sleepStart = workerIdleTime->sleepStartNanoseconds) {
+      idleTime += std::max<std::int64_t>(now - std::max(sleepStart, resetTime),
+                                         0);
+    }
+  }
+
+  double const workerTime =
+      static_cast<double>(now - resetTime) * result.workerCount;
+
+  if (workerTime > 0.0) {
+    result.busyRatio =
+        std::clamp(1.0 - static_cast<double>(idleTime) / workerTime, 0.0, 1.0);
+  }
+
+  return result;
+}
+
+void TaskExecutor::resetStats() {
+  for (auto& queuePair : _taskQueues) {
+    TaskQueue& queue = queuePair.second;
+
+    queue.stats.startLatency.reset();
+    queue.stats.executionTime.reset();
+    queue.stats.resetTimeNanoseconds = nowNanoseconds();
+
+    for (auto& workerIdleTime : queue.workerIdleTimes) {
+      workerIdleTime->idleNanoseconds = 0;
+    }
+  }
+}
+
+void TaskExecutor::plotStats() const {
+#ifdef TRACY_ENABLE
+  using Microseconds = std::chrono::duration<double, std::micro>;
+
+  for (auto const& queuePair : _taskQueues) {
+    TaskTypePlotNames const names = getPlotNames(queuePair.first);
+    TaskQueueStats const stats = getStats(queuePair.first);
+
+    TracyPlot(names.queuedTaskCount,
+              static_cast<std::int64_t>(stats.queuedTaskCount));
+    TracyPlot(names.tasksInProgress,
+              static_cast<std::int64_t>(stats.tasksInProgress));
+    TracyPlot(names.busyRatio, stats.busyRatio * 100.0);
+    TracyPlot(names.startLatency,
+              Microseconds{stats.startLatency.mean()}.count());
+    TracyPlot(names.executionTime,
+              Microseconds{stats.executionTime.mean()}.count());
+  }
+#endif
+}
+
+TimerHandle::TimerHandle(std::shared_ptr<PeriodicTimer> timer)
+    : _timer{std::move(timer)} {}
+
+bool TimerHandle::valid() const { return _timer != nullptr; }
+
+void TimerHandle::cancel() {
+  if (_timer) {
+    _timer->cancelled = true;
+  }
+}
+
+TaskExecutor::ScheduleAwaiter::ScheduleAwaiter(TaskExecutor& executor,
+                                               TaskTarget const& target)
+    : _executor{executor}, _target{target} {}
+
+void TaskExecutor::ScheduleAwaiter::await_suspend(
+    std::coroutine_handle<> coroutine) {
+  auto const queue = _executor._taskQueues.find(_target.type);
+
+  assert(queue != _executor._taskQueues.cend());
+
+  auto task = std::make_unique<ResumeTask>(_target.type, coroutine);
+  task->setTarget(_target);
+
+  // The coroutine may resume and destroy this awaiter as soon as the task is
+  // queued.
+  _executor.pushTask(queue->second, std::move(task));
+}
+
+TaskExecutor::ScheduleAwaiter TaskExecutor::schedule(TaskTarget const& target) {
+  return {*this, target};
+}
+
+bool TaskExecutor::isOwnWorkerThread() const {
+  return currentWorker.executor == this;
+}
+
+void TaskExecutor::runTasksUntil(ReadyCheckFunction isReady,
+                                 void const* context,
+                                 TaskCompletion* completion) {
+  assert(isOwnWorkerThread());
+
+  TaskQueue& queue = *currentWorker.queue;
+  std::size_t const workerIndex = currentWorker.workerIndex;
+
+  if (completion) {
+    // Wakes this worker if it went to sleep on its queue in the meantime. The
+    // callback stays with the completion until it's signalled, which may be
+    // after the executor is gone.
+    completion->subscribe([waker = queue.waker]() {
+      std::scoped_lock l{waker->mutex};
+
+      if (waker->queue) {
+        { std::scoped_lock queueLock{waker->queue->taskQueueMutex}; }
+        waker->queue->taskQueueCondVar.notify_all();
+      }
+    });
+  }
+
+  WorkerCalls& calls = *queue.workerCalls[workerIndex];
+
+  while (!isReady(context)) {
+    // A worker waiting here mustn't hold up runOnEachWorker.
+    runPendingCalls(calls);
+
+    bool const running = _running;
+
+    if (running) {
+      TaskQueue* sourceQueue = nullptr;
+
+      if (TaskBase* const task = findTask(queue, workerIndex, sourceQueue)) {
+        executeTask(*sourceQueue, task);
+        continue;
+      }
+    } else {
+      // Nothing starts the awaited task any more if it's still queued, it is
+      // destroyed instead, which breaks its promise.
+      destroyQueuedTasks();
+    }
+
+    // Once shut down, whoever queues a task destroys it right away, so there
+    // are no tasks left to wake up for.
+    auto const canWake = [this, &queue, &calls, isReady, context, running]() {
+      return _running != running || (running && hasTasksToRun(queue)) ||
+             calls.hasPendingCalls || isReady(context);
+    };
+
+    // Counted before checking the future, so that a task finishing in
+    // between either sees the count or is seen by the check.
+    if (!completion) {
+      ++queue.futureWaiterCount;
+      ++_futureWaiterCount;
+    }
+
+    std::unique_lock l{queue.taskQueueMutex};
+
+    ++queue.sleepingWorkerCount;
+
+    {
+      IdleTimeScope const idleTimeScope{getIdleTimeToTrack(queue, workerIndex),
+                                        queue.stats};
+
+      queue.taskQueueCondVar.wait(l, canWake);
+    }
+
+    --queue.sleepingWorkerCount;
+
+    if (!completion) {
+      --queue.futureWaiterCount;
+      --_futureWaiterCount;
+    }
+  }
+}
+
+void TaskExecutor::runParallelRange(TaskTarget const& target,
+                                    std::size_t count, std::size_t grainSize,
+                                    ParallelRangeFunction func,
+                                    void const* context) {
+  auto const queue = _taskQueues.find(target.type);
+
+  assert(queue != _taskQueues.cend());
+
+  grainSize = std::max<std::size_t>(grainSize, 1);
+
+  // Helpers count as well, the caller only if it is one of the workers.
+  std::size_t workerCount = queue->second.workerDeques.size();
+  bool isOwnWorker = currentWorker.executor == this &&
+                     currentWorker.queue == &queue->second;
+
+  for (TaskQueue const* const helperQueue : queue->second.helperQueues) {
+    workerCount += helperQueue->workerDeques.size();
+    isOwnWorker = isOwnWorker || (currentWorker.executor == this &&
+                                  currentWorker.queue == helperQueue);
+  }
 
-  for (auto const& taskQueueEntry : _taskQueues) {
-    cnt += (taskQueueEntry.second.tasksInProgress +
-            taskQueueEntry.second.tasks.size());
+  std::size_t const availableWorkers = workerCount - (isOwnWorker ? 1 : 0);
+  std::size_t const maxSubranges = (count + grainSize - 1) / grainSize;
+  std::size_t const helperCount =
+      std::min(availableWorkers, maxSubranges - 1);
+
+  if (!helperCount) {
+    func(context, 0, count);
+    return;
+  }
+
+  auto const state = std::allocate_shared<ParallelRangeState>(
+      TaskPoolAllocator<ParallelRangeState>{});
+  state->count = count;
+  state->grainSize = grainSize;
+  state->participantCount = helperCount + 1;
+  state->func = func;
+  state->context = context;
+
+  for (std::size_t i = 0; i < helperCount; ++i) {
+    auto helper = [state]() { processSubranges(*state); };
+
+    auto helperTask = std::make_unique<DetachedTask<decltype(helper)>>(
+        target.type, std::move(helper));
+    helperTask->setTarget(target);
+
+    pushTask(queue->second, std::move(helperTask));
+  }
+
+  processSubranges(*state);
+
+  // Helpers that claimed a subrange might still be running it.
+  std::size_t processed = state->processed.load();
+
+  while (processed != count) {
+    state->processed.wait(processed);
+    processed = state->processed.load();
+  }
+
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+void TaskExecutor::pushTask(TaskQueue& queue, std::unique_ptr<TaskBase> task) {
+  pushTasks(queue, {&task, 1});
+}
+
+void TaskExecutor::pushTasks(TaskQueue& queue,
+                             std::span<std::unique_ptr<TaskBase>> tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  _pendingTaskCount += tasks.size();
+
+  if (TaskStatsMode const statsMode = _statsMode;
+      statsMode != TaskStatsMode::disabled) {
+    auto const now = std::chrono::steady_clock::now();
+    std::size_t const samplingInterval =
+        statsMode == TaskStatsMode::full ? 1 : _statsSamplingInterval.load();
+
+    for (std::unique_ptr<TaskBase>& task : tasks) {
+      if (enqueuedTaskCounter++ % samplingInterval == 0) {
+        task->setEnqueueTime(now);
+      }
+    }
+  }
+
+  bool const isOwnWorker =
+      currentWorker.executor == this && currentWorker.queue == &queue;
+
+  // Taken the first time a task has to be injected and held for the rest of
+  // the batch.
+  std::unique_lock injectedLock{queue.injectedTasksMutex, std::defer_lock};
+
+  for (std::unique_ptr<TaskBase>& task : tasks) {
+    TaskPriority const priority = task->getPriority();
+    bool const hasDeadline = task->getDeadline() != noTaskDeadline;
+
+    if (isOwnWorker && priority == TaskPriority::normal && !hasDeadline) {
+      queue.workerDeques[currentWorker.workerIndex]->push(task.release());
+      continue;
+    }
+
+    if (!injectedLock.owns_lock()) {
+      injectedLock.lock();
+    }
+
+    std::size_t const priorityIndex = static_cast<std::size_t>(priority);
+
+    if (hasDeadline) {
+      auto& deadlineTasks = queue.deadlineTasks[priorityIndex];
+      deadlineTasks.push_back(task.release());
+      std::push_heap(deadlineTasks.begin(), deadlineTasks.end(),
+                     laterDeadline);
+    } else {
+      queue.injectedTasks[priorityIndex].push_back(task.release());
+    }
+
+    ++queue.injectedTaskCount;
+  }
+
+  if (injectedLock.owns_lock()) {
+    injectedLock.unlock();
+  }
+
+  queue.queuedTaskCount += tasks.size();
+
+  wakeWorkers(queue, tasks.size());
+
+  // Checked after queueing, so that either this or the shutdown sees the
+  // tasks.
+  if (!_running) {
+    destroyQueuedTasks();
+  }
+}
+
+void TaskExecutor::pushTaskAfter(TaskCompletion& dependency,
+                                 std::unique_ptr<TaskBase> task) {
+  struct PendingTask {
+    TaskExecutor* executor;
+    std::unique_ptr<TaskBase> task;
+  };
+
+  // Shared so that the subscribed callback stays copyable. If the dependency
+  // is destroyed without completing, the task is destroyed with the callback.
+  auto const pendingTask =
+      std::allocate_shared<PendingTask>(TaskPoolAllocator<PendingTask>{});
+  pendingTask->executor = this;
+  pendingTask->task = std::move(task);
+
+  dependency.subscribe([pendingTask]() {
+    TaskExecutor& executor = *pendingTask->executor;
+    auto const queue =
+        executor._taskQueues.find(pendingTask->task->getType());
+
+    assert(queue != executor._taskQueues.cend());
+
+    executor.pushTask(queue->second, std::move(pendingTask->task));
+  });
+}
+
+TaskBase* TaskExecutor::findTask(TaskQueue& queue, std::size_t workerIndex,
+                                 TaskQueue*& outTaskQueue) {
+  TaskBase* task = takeInjectedTask(queue, TaskPriority::high);
+
+  // The owner takes from the same end as thieves so that its own tasks run in
+  // the order they were enqueued.
+  if (!task) {
+    task = queue.workerDeques[workerIndex]->steal();
+  }
+
+  if (!task) {
+    task = takeInjectedTask(queue, TaskPriority::normal);
+  }
+
+  std::size_t const workerCount = queue.workerDeques.size();
+
+  for (std::size_t i = 1; !task && i < workerCount; ++i) {
+    if (!queue.queuedTaskCount) {
+      break;
+    }
+
+    task = queue.workerDeques[(workerIndex + i) % workerCount]->steal();
+  }
+
+  if (!task) {
+    task = takeInjectedTask(queue, TaskPriority::background);
+  }
+
+  if (task) {
+    --queue.queuedTaskCount;
+    ++queue.tasksInProgress;
+    outTaskQueue = &queue;
+
+    return task;
+  }
+
+  for (TaskQueue* const helpedQueue : queue.helpedQueues) {
+    if (TaskBase* const helpedTask = findTaskToHelp(*helpedQueue)) {
+      outTaskQueue = helpedQueue;
+
+      return helpedTask;
+    }
+  }
+
+  return nullptr;
+}
+
+TaskBase* TaskExecutor::findTaskToHelp(TaskQueue& queue) {
+  if (!queue.queuedTaskCount) {
+    return nullptr;
+  }
+
+  TaskBase* task = takeInjectedTask(queue, TaskPriority::background);
+
+  for (std::size_t i = 0; !task && i < queue.workerDeques.size(); ++i) {
+    task = queue.workerDeques[i]->steal();
+  }
+
+  if (task) {
+    --queue.queuedTaskCount;
+    ++queue.tasksInProgress;
+  }
+
+  return task;
+}
+
+bool TaskExecutor::hasTasksToRun(TaskQueue const& queue) {
+  if (queue.queuedTaskCount > 0) {
+    return true;
+  }
+
+  return std::any_of(queue.helpedQueues.cbegin(), queue.helpedQueues.cend(),
+                     [](TaskQueue const* const helpedQueue) {
+                       return helpedQueue->queuedTaskCount > 0;
+                     });
+}
+
+void TaskExecutor::runPendingCalls(WorkerCalls& calls) {
+  if (!calls.hasPendingCalls) {
+    return;
+  }
+
+  std::vector<std::function<void()>> pendingCalls;
+
+  {
+    std::scoped_lock l{calls.pendingCallsMutex};
+    pendingCalls.swap(calls.pendingCalls);
+    calls.hasPendingCalls = false;
+  }
+
+  for (std::function<void()> const& call : pendingCalls) {
+    call();
+  }
+}
+
+TaskBase* TaskExecutor::takeInjectedTask(TaskQueue& queue,
+                                         TaskPriority minPriority) {
+  if (!queue.injectedTaskCount) {
+    return nullptr;
+  }
+
+  std::scoped_lock l{queue.injectedTasksMutex};
+
+  auto const popDeadlineTask = [&queue](std::size_t priorityIndex) {
+    auto& deadlineTasks = queue.deadlineTasks[priorityIndex];
+    std::pop_heap(deadlineTasks.begin(), deadlineTasks.end(), laterDeadline);
+    TaskBase* const task = deadlineTasks.back();
+    deadlineTasks.pop_back();
+    --queue.injectedTaskCount;
+    return task;
+  };
+
+  TaskDeadline const now = std::chrono::steady_clock::now();
+  TaskBase* overdueTask = nullptr;
+  std::size_t overduePriorityIndex = 0;
+
+  for (std::size_t i = 0; i < taskPriorityCount; ++i) {
+    auto const& deadlineTasks = queue.deadlineTasks[i];
+
+    if (!deadlineTasks.empty() && deadlineTasks.front()->getDeadline() <= now &&
+        (!overdueTask || laterDeadline(overdueTask, deadlineTasks.front()))) {
+      overdueTask = deadlineTasks.front();
+      overduePriorityIndex = i;
+    }
+  }
+
+  if (overdueTask) {
+    return popDeadlineTask(overduePriorityIndex);
   }
 
-  return cnt;
+  std::size_t const minPriorityIndex = static_cast<std::size_t>(minPriority);
+
+  for (std::size_t i = taskPriorityCount; i-- > minPriorityIndex;) {
+    if (!queue.deadlineTasks[i].empty()) {
+      return popDeadlineTask(i);
+    }
+
+    auto& injectedTasks = queue.injectedTasks[i];
+
+    if (!injectedTasks.empty()) {
+      TaskBase* const task = injectedTasks.front();
+      injectedTasks.pop_front();
+      --queue.injectedTaskCount;
+      return task;
+    }
+  }
+
+  return nullptr;
+}
+
+void TaskExecutor::executeTask(TaskQueue& queue, TaskBase* task) {
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point const enqueueTime = task->getEnqueueTime();
+
+  if (enqueueTime != Clock::time_point{}) {
+    Clock::time_point const startTime = Clock::now();
+    task->execute();
+    Clock::time_point const endTime = Clock::now();
+
+    queue.stats.startLatency.record(startTime - enqueueTime);
+    queue.stats.executionTime.record(endTime - startTime);
+  } else {
+    task->execute();
+  }
+
+  // Continuations are queued before the task stops counting as pending so
+  // that waitIdle can't return in between.
+  task->signalCompletion();
+  delete task;
+
+  // The finished task might be the one a worker waits on with a future.
+  if (_futureWaiterCount) {
+    for (auto& queuePair : _taskQueues) {
+      TaskQueue& waitingQueue = queuePair.second;
+
+      if (waitingQueue.futureWaiterCount) {
+        { std::scoped_lock l{waitingQueue.taskQueueMutex}; }
+        waitingQueue.taskQueueCondVar.notify_all();
+      }
+    }
+  }
+
+  --queue.tasksInProgress;
+
+  if (--_pendingTaskCount == 0) {
+    { std::scoped_lock l{_waitIdleMutex}; }
+    _waitIdleCondVar.notify_all();
+  }
+}
+
+void TaskExecutor::destroyQueuedTasks() {
+  std::vector<TaskBase*> tasks;
+  bool destroyedAny = false;
+
+  for (auto& queuePair : _taskQueues) {
+    TaskQueue& queue = queuePair.second;
+
+    for (auto const& deque : queue.workerDeques) {
+      // A failed steal means that another thread took the task.
+      while (!deque->empty()) {
+        if (TaskBase* const task = deque->steal()) {
+          tasks.push_back(task);
+        }
+      }
+    }
+
+    {
+      std::scoped_lock l{queue.injectedTasksMutex};
+
+      for (auto& injectedTasks : queue.injectedTasks) {
+        tasks.insert(tasks.end(), injectedTasks.cbegin(), injectedTasks.cend());
+        injectedTasks.clear();
+      }
+
+      for (auto& deadlineTasks : queue.deadlineTasks) {
+        tasks.insert(tasks.end(), deadlineTasks.cbegin(), deadlineTasks.cend());
+        deadlineTasks.clear();
+      }
+
+      queue.injectedTaskCount = 0;
+    }
+
+    if (tasks.empty()) {
+      continue;
+    }
+
+    queue.queuedTaskCount -= tasks.size();
+
+    // Outside of the lock, destroying a coroutine might queue tasks.
+    for (TaskBase* const task : tasks) {
+      delete task;
+    }
+
+    if ((_pendingTaskCount -= tasks.size()) == 0) {
+      { std::scoped_lock l{_waitIdleMutex}; }
+      _waitIdleCondVar.notify_all();
+    }
+
+    tasks.clear();
+    destroyedAny = true;
+  }
+
+  if (!destroyedAny) {
+    return;
+  }
+
+  // The destroyed tasks broke their promises, the workers of any queue might
+  // be waiting on them.
+  for (auto& queuePair : _taskQueues) {
+    { std::scoped_lock l{queuePair.second.taskQueueMutex}; }
+    queuePair.second.taskQueueCondVar.notify_all();
+  }
+}
+
+void TaskExecutor::addTimer(TimerEntry entry) {
+  auto const dueTick = getTimerTick(entry.due, true);
+
+  {
+    std::scoped_lock l{_timerMutex};
+
+    std::optional<TimerWheel<TimerEntry>::Tick> const nextTick =
+        _timerWheel.getNextEventTick();
+
+    _timerWheel.insert(dueTick, std::move(entry));
+
+    // The timer thread sleeps until the next event it knows of.
+    if (nextTick && *nextTick <= dueTick) {
+      return;
+    }
+  }
+
+  _timerCondVar.notify_all();
+}
+
+TimerHandle TaskExecutor::addPeriodicTimer(TimerClock::duration period,
+                                           std::function<void()> dispatch) {
+  assert(period > TimerClock::duration::zero());
+
+  auto const periodicTimer = std::make_shared<PeriodicTimer>();
+  periodicTimer->period = period;
+  periodicTimer->dispatch = std::move(dispatch);
+
+  addTimer({TimerClock::now() + period, nullptr, periodicTimer});
+
+  return TimerHandle{periodicTimer};
+}
+
+TimerWheel<TaskExecutor::TimerEntry>::Tick
+TaskExecutor::getTimerTick(TimerClock::time_point time, bool roundUp) const {
+  using namespace std::chrono;
+
+  if (time <= _timerStart) {
+    return 0;
+  }
+
+  return static_cast<TimerWheel<TimerEntry>::Tick>(
+      roundUp ? ceil<milliseconds>(time - _timerStart).count()
+              : floor<milliseconds>(time - _timerStart).count());
+}
+
+void TaskExecutor::timerFunc() {
+  std::vector<TimerEntry> dueEntries;
+  std::unique_lock l{_timerMutex};
+
+  while (_running) {
+    _timerWheel.advance(getTimerTick(TimerClock::now(), false), dueEntries);
+
+    if (!dueEntries.empty()) {
+      l.unlock();
+
+      TimerClock::time_point const now = TimerClock::now();
+
+      for (TimerEntry& entry : dueEntries) {
+        if (entry.task) {
+          auto const queue = _taskQueues.find(entry.task->getType());
+
+          assert(queue != _taskQueues.cend());
+
+          pushTask(queue->second, std::move(entry.task));
+        } else if (!entry.periodicTimer->cancelled) {
+          entry.periodicTimer->dispatch();
+          // Keeps the original phase unless the timer fell behind.
+          entry.due = std::max(entry.due + entry.periodicTimer->period, now);
+        }
+      }
+
+      l.lock();
+
+      for (TimerEntry& entry : dueEntries) {
+        if (entry.periodicTimer && !entry.periodicTimer->cancelled) {
+          TimerWheel<TimerEntry>::Tick const dueTick =
+              getTimerTick(entry.due, true);
+          _timerWheel.insert(dueTick, std::move(entry));
+        }
+      }
+
+      dueEntries.clear();
+      continue;
+    }
+
+    std::optional<TimerWheel<TimerEntry>::Tick> const nextTick =
+        _timerWheel.getNextEventTick();
+
+    if (nextTick) {
+      _timerCondVar.wait_until(
+          l, _timerStart + std::chrono::milliseconds{*nextTick});
+    } else {
+      _timerCondVar.wait(l);
+    }
+  }
+}
+
+WorkerIdleTime*
+TaskExecutor::getIdleTimeToTrack(TaskQueue& queue,
+                                 std::size_t workerIndex) const {
+  if (_statsMode == TaskStatsMode::disabled) {
+    return nullptr;
+  }
+
+  return queue.workerIdleTimes[workerIndex].get();
+}
+
+void TaskExecutor::wakeWorkers(TaskQueue& queue, std::size_t taskCount) {
+  auto const wake = [](TaskQueue& sleepingQueue, std::size_t count) {
+    std::size_t const sleepingWorkerCount = sleepingQueue.sleepingWorkerCount;
+
+    if (!sleepingWorkerCount || !count) {
+      return std::size_t{0};
+    }
+
+    { std::scoped_lock l{sleepingQueue.taskQueueMutex}; }
+
+    if (count >= sleepingWorkerCount) {
+      sleepingQueue.taskQueueCondVar.notify_all();
+    } else {
+      for (std::size_t i = 0; i < count; ++i) {
+        sleepingQueue.taskQueueCondVar.notify_one();
+      }
+    }
+
+    return std::min(count, sleepingWorkerCount);
+  };
+
+  taskCount -= wake(queue, taskCount);
+
+  for (TaskQueue* const helperQueue : queue.helperQueues) {
+    taskCount -= wake(*helperQueue, taskCount);
+  }
 }
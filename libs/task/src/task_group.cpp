@@ -0,0 +1,102 @@
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace obsidian::task {
+
+struct TaskGroupState {
+  std::atomic<bool> cancelled = false;
+  std::mutex mutex;
+  std::size_t pendingCount = 0;
+  // Exists while someone waits for the group, completed when it drains.
+  std::optional<TaskHandleState<void>> idle;
+  TaskHandle<void> idleHandle;
+};
+
+} /*namespace obsidian::task*/
+
+using namespace obsidian::task;
+
+TaskCancelledError::TaskCancelledError()
+    : std::runtime_error{"Task group was cancelled before the task started."} {}
+
+CancellationToken::CancellationToken(
+    std::shared_ptr<TaskGroupState const> state)
+    : _state{std::move(state)} {}
+
+bool CancellationToken::isCancelled() const {
+  return _state && _state->cancelled.load(std::memory_order_relaxed);
+}
+
+void CancellationToken::throwIfCancelled() const {
+  if (isCancelled()) {
+    throw TaskCancelledError{};
+  }
+}
+
+TaskGroup::TaskGroup(TaskExecutor& executor)
+    : _executor{executor},
+      _state{std::allocate_shared<TaskGroupState>(
+          TaskPoolAllocator<TaskGroupState>{})} {}
+
+void TaskGroup::wait() {
+  TaskHandle<void> idleHandle;
+
+  {
+    std::scoped_lock l{_state->mutex};
+
+    if (!_state->pendingCount) {
+      return;
+    }
+
+    if (!_state->idle) {
+      _state->idle.emplace();
+      _state->idleHandle = _state->idle->getHandle();
+    }
+
+    idleHandle = _state->idleHandle;
+  }
+
+  _executor.wait(idleHandle);
+}
+
+void TaskGroup::cancel() { _state->cancelled = true; }
+
+bool TaskGroup::isCancelled() const { return _state->cancelled; }
+
+CancellationToken TaskGroup::getToken() const {
+  return CancellationToken{_state};
+}
+
+void TaskGroup::addCompletion(TaskCompletion& completion) {
+  {
+    std::scoped_lock l{_state->mutex};
+    ++_state->pendingCount;
+  }
+
+  completion.subscribe([state = _state]() {
+    std::optional<TaskHandleState<void>> idle;
+
+    {
+      std::scoped_lock l{state->mutex};
+
+      if (--state->pendingCount || !state->idle) {
+        return;
+      }
+
+      idle = std::move(state->idle);
+      state->idle.reset();
+      state->idleHandle = {};
+    }
+
+    idle->promise.set_value();
+    idle->completion->complete();
+  });
+}
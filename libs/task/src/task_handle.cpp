@@ -0,0 +1,49 @@
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_pool.hpp>
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace obsidian::task;
+
+void TaskCompletion::subscribe(Callback callback) {
+  {
+    std::scoped_lock l{_mutex};
+
+    if (!_completed) {
+      _callbacks.push_back(std::move(callback));
+      return;
+    }
+  }
+
+  callback();
+}
+
+void TaskCompletion::complete() {
+  std::vector<Callback> callbacks;
+
+  {
+    std::scoped_lock l{_mutex};
+
+    assert(!_completed && "Task completion signalled twice.");
+
+    _completed = true;
+    callbacks.swap(_callbacks);
+  }
+
+  for (Callback& callback : callbacks) {
+    callback();
+  }
+}
+
+bool TaskCompletion::isCompleted() const {
+  std::scoped_lock l{_mutex};
+  return _completed;
+}
+
+std::shared_ptr<TaskCompletion> obsidian::task::makeTaskCompletion() {
+  return std::allocate_shared<TaskCompletion>(
+      TaskPoolAllocator<TaskCompletion>{});
+}
@@ -0,0 +1,155 @@
+#include <obsidian/task/task_pool.hpp>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace obsidian::task;
+
+namespace {
+
+constexpr std::array<std::size_t, 3> blockSizes = {64, 128,
+                                                   TaskPool::maxBlockSize};
+constexpr std::size_t blocksPerSlab = 64;
+constexpr std::size_t transferBatchSize = 32;
+constexpr std::size_t maxThreadCachedBlocks = 4 * transferBatchSize;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  std::size_t count = 0;
+
+  void push(FreeBlock* block) {
+    block->next = head;
+    head = block;
+    ++count;
+  }
+
+  FreeBlock* pop() {
+    FreeBlock* const block = head;
+    head = block->next;
+    --count;
+    return block;
+  }
+
+  // Moves up to maxCount blocks from this list to the other list.
+  void moveTo(FreeList& other, std::size_t maxCount) {
+    for (std::size_t i = 0; i < maxCount && head; ++i) {
+      other.push(pop());
+    }
+  }
+};
+
+struct SizeClass {
+  std::mutex mutex;
+  FreeList freeList;
+  std::vector<std::unique_ptr<std::byte[]>> slabs;
+};
+
+struct GlobalPool {
+  std::array<SizeClass, blockSizes.size()> sizeClasses;
+};
+
+GlobalPool& getGlobalPool() {
+  // Intentionally never destroyed because thread caches return their blocks
+  // to it on thread exit, which can happen after static destruction started.
+  static GlobalPool* const globalPool = new GlobalPool{};
+  return *globalPool;
+}
+
+struct ThreadCache {
+  std::array<FreeList, blockSizes.size()> freeLists;
+
+  ~ThreadCache() {
+    GlobalPool& globalPool = getGlobalPool();
+
+    for (std::size_t i = 0; i < freeLists.size(); ++i) {
+      std::scoped_lock l{globalPool.sizeClasses[i].mutex};
+      freeLists[i].moveTo(globalPool.sizeClasses[i].freeList,
+                          freeLists[i].count);
+    }
+  }
+};
+
+thread_local ThreadCache threadCache;
+
+std::size_t getSizeClassIndex(std::size_t size) {
+  std::size_t i = 0;
+
+  while (blockSizes[i] < size) {
+    ++i;
+  }
+
+  return i;
+}
+
+void refill(std::size_t sizeClassIndex, FreeList& outFreeList) {
+  SizeClass& sizeClass = getGlobalPool().sizeClasses[sizeClassIndex];
+
+  std::scoped_lock l{sizeClass.mutex};
+
+  if (!sizeClass.freeList.count) {
+    std::size_t const blockSize = blockSizes[sizeClassIndex];
+    std::byte* const slab = sizeClass.slabs
+                                .emplace_back(std::make_unique<std::byte[]>(
+                                    blockSize * blocksPerSlab))
+                                .get();
+
+    for (std::size_t i = 0; i < blocksPerSlab; ++i) {
+      outFreeList.push(reinterpret_cast<FreeBlock*>(slab + i * blockSize));
+    }
+
+    return;
+  }
+
+  sizeClass.freeList.moveTo(outFreeList, transferBatchSize);
+}
+
+void release(std::size_t sizeClassIndex, FreeList& freeList) {
+  SizeClass& sizeClass = getGlobalPool().sizeClasses[sizeClassIndex];
+
+  std::scoped_lock l{sizeClass.mutex};
+  freeList.moveTo(sizeClass.freeList, transferBatchSize);
+}
+
+} /*namespace*/
+
+void* TaskPool::allocate(std::size_t size) {
+  if (size > maxBlockSize) {
+    return ::operator new(size);
+  }
+
+  std::size_t const sizeClassIndex = getSizeClassIndex(size);
+  FreeList& freeList = threadCache.freeLists[sizeClassIndex];
+
+  if (!freeList.head) {
+    refill(sizeClassIndex, freeList);
+  }
+
+  return freeList.pop();
+}
+
+void TaskPool::deallocate(void* ptr, std::size_t size) noexcept {
+  if (!ptr) {
+    return;
+  }
+
+  if (size > maxBlockSize) {
+    ::operator delete(ptr, size);
+    return;
+  }
+
+  std::size_t const sizeClassIndex = getSizeClassIndex(size);
+  FreeList& freeList = threadCache.freeLists[sizeClassIndex];
+
+  freeList.push(static_cast<FreeBlock*>(ptr));
+
+  if (freeList.count > maxThreadCachedBlocks) {
+    release(sizeClassIndex, freeList);
+  }
+}
@@ -0,0 +1,98 @@
+#include <obsidian/task/task_stats.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+using namespace obsidian::task;
+
+std::size_t
+TaskDurationHistogram::getBucketIndex(std::chrono::nanoseconds duration) {
+  auto const microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+  if (microseconds <= 0) {
+    return 0;
+  }
+
+  return std::min<std::size_t>(
+      std::bit_width(static_cast<std::uint64_t>(microseconds)),
+      bucketCount - 1);
+}
+
+std::chrono::microseconds
+TaskDurationHistogram::getBucketLimit(std::size_t bucketIndex) {
+  return std::chrono::microseconds{std::int64_t{1} << bucketIndex};
+}
+
+std::chrono::nanoseconds TaskDurationHistogram::mean() const {
+  if (!sampleCount) {
+    return std::chrono::nanoseconds{0};
+  }
+
+  return total / static_cast<std::int64_t>(sampleCount);
+}
+
+std::chrono::microseconds TaskDurationHistogram::percentile(double p) const {
+  if (!sampleCount) {
+    return std::chrono::microseconds{0};
+  }
+
+  auto const rank = static_cast<std::uint64_t>(
+      std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(sampleCount)));
+  std::uint64_t count = 0;
+
+  for (std::size_t i = 0; i < bucketCount; ++i) {
+    count += buckets[i];
+
+    if (count >= rank && count) {
+      return getBucketLimit(i);
+    }
+  }
+
+  return getBucketLimit(bucketCount - 1);
+}
+
+void AtomicTaskDurationHistogram::record(std::chrono::nanoseconds duration) {
+  constexpr std::memory_order relaxed = std::memory_order_relaxed;
+
+  _buckets[TaskDurationHistogram::getBucketIndex(duration)].fetch_add(1,
+                                                                      relaxed);
+  _sampleCount.fetch_add(1, relaxed);
+  _totalNanoseconds.fetch_add(duration.count(), relaxed);
+
+  std::int64_t max = _maxNanoseconds.load(relaxed);
+
+  while (duration.count() > max &&
+         !_maxNanoseconds.compare_exchange_weak(max, duration.count(),
+                                                relaxed)) {
+  }
+}
+
+void AtomicTaskDurationHistogram::reset() {
+  for (std::atomic<std::uint64_t>& bucket : _buckets) {
+    bucket = 0;
+  }
+
+  _sampleCount = 0;
+  _totalNanoseconds = 0;
+  _maxNanoseconds = 0;
+}
+
+TaskDurationHistogram AtomicTaskDurationHistogram::snapshot() const {
+  TaskDurationHistogram result;
+
+  for (std::size_t i = 0; i < _buckets.size(); ++i) {
+    result.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+  }
+
+  result.sampleCount = _sampleCount.load(std::memory_order_relaxed);
+  result.total = std::chrono::nanoseconds{_totalNanoseconds.load()};
+  result.max = std::chrono::nanoseconds{_maxNanoseconds.load()};
+
+  return result;
+}
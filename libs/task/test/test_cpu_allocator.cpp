@@ -0,0 +1,77 @@
+#include <obsidian/platform/cpu_topology.hpp>
+#include <obsidian/task/cpu_allocator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+using namespace obsidian;
+using namespace obsidian::task;
+
+namespace {
+
+// Two cache domains of four cores with two hyperthreads each. The
+// hyperthreads of core c are cpus c and c + 8.
+platform::CpuTopology makeTopology() {
+  platform::CpuTopology topology;
+
+  for (unsigned int id = 0; id < 16; ++id) {
+    platform::LogicalCpu& cpu = topology.cpus.emplace_back();
+    cpu.id = id;
+    cpu.coreId = id % 8;
+    cpu.cacheDomainId = id % 8 < 4 ? 0 : 4;
+  }
+
+  return topology;
+}
+
+} /*namespace*/
+
+TEST(task, cpu_allocator_reserve_whole_cores) {
+  // arrange
+  CpuAllocator allocator{makeTopology()};
+
+  // act
+  platform::CpuSet const firstCore = allocator.reserveCores(1);
+  platform::CpuSet const nextCores = allocator.reserveCores(2);
+
+  // assert
+  ASSERT_EQ(firstCore, platform::CpuSet({7, 15}));
+  ASSERT_EQ(nextCores, platform::CpuSet({5, 6, 13, 14}));
+  ASSERT_EQ(allocator.getSharedCoreCount(), 5);
+  ASSERT_EQ(allocator.getSharedCpus(),
+            platform::CpuSet({0, 1, 2, 3, 4, 8, 9, 10, 11, 12}));
+}
+
+TEST(task, cpu_allocator_keeps_one_shared_core) {
+  // arrange
+  CpuAllocator allocator{makeTopology()};
+
+  // act
+  platform::CpuSet const reserved = allocator.reserveCores(100);
+  platform::CpuSet const noneLeft = allocator.reserveCores(1);
+
+  // assert
+  ASSERT_EQ(reserved.size(), 14);
+  ASSERT_TRUE(noneLeft.empty());
+  ASSERT_EQ(allocator.getSharedCoreCount(), 1);
+}
+
+TEST(task, cpu_allocator_spread_threads_over_cache_domains) {
+  // arrange
+  CpuAllocator allocator{makeTopology()};
+  allocator.reserveCores(2);
+
+  // act
+  std::vector<platform::CpuSet> const affinities = allocator.spreadThreads(6);
+
+  // assert
+  platform::CpuSet const firstDomain = {0, 1, 2, 3, 8, 9, 10, 11};
+  platform::CpuSet const secondDomain = {4, 5, 12, 13};
+  std::vector<platform::CpuSet> const expected = {
+      firstDomain, secondDomain, firstDomain,
+      secondDomain, firstDomain, firstDomain};
+
+  ASSERT_EQ(affinities, expected);
+}
@@ -2,6 +2,8 @@
 #include <obsidian/task/task_type.hpp>
 
 #include <gtest/gtest.h>
+
+#include <stdexcept>
 #include <type_traits>
 
 using namespace obsidian::task;
@@ -47,3 +49,29 @@ TEST(task, task_execute_ret_val) {
   auto future = t.getFuture();
   EXPECT_EQ(val, future.get());
 }
+
+TEST(task, task_execute_exception_forwarded_to_future) {
+  // arrange
+  Task t{TaskType::general, []() -> int { throw std::runtime_error{"fail"}; }};
+  auto future = t.getFuture();
+
+  // act
+  t.execute();
+
+  // assert
+  EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(task, detached_task_execute) {
+  // arrange
+  int modify = 0;
+
+  DetachedTask t{TaskType::general, [&modify]() { modify = 1; }};
+
+  // act
+  t.execute();
+
+  // assert
+  EXPECT_EQ(modify, 1);
+  EXPECT_TRUE(t.isDone());
+}
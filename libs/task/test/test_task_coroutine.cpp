@@ -0,0 +1,115 @@
+#include <obsidian/task/task_coroutine.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+namespace {
+
+TaskHandle<std::thread::id> getWorkerThreadId(TaskExecutor& executor,
+                                              TaskType taskType) {
+  co_await executor.schedule(taskType);
+
+  co_return std::this_thread::get_id();
+}
+
+TaskHandle<int> addOneToTaskResult(TaskExecutor& executor, TaskType taskType) {
+  int const value = co_await executor.spawn(taskType, []() { return 41; });
+
+  co_return value + 1;
+}
+
+TaskHandle<void> throwOnWorker(TaskExecutor& executor, TaskType taskType) {
+  co_await executor.schedule(taskType);
+
+  throw std::runtime_error("coroutine failed");
+}
+
+TaskHandle<std::size_t> sumOnWorkers(TaskExecutor& executor, TaskType taskType,
+                                     std::size_t count) {
+  std::vector<TaskHandle<std::size_t>> handles;
+
+  for (std::size_t i = 0; i < count; ++i) {
+    handles.push_back(executor.spawn(taskType, [i]() { return i; }));
+  }
+
+  co_await whenAll(handles);
+
+  std::size_t sum = 0;
+
+  for (TaskHandle<std::size_t> const& handle : handles) {
+    sum += co_await handle;
+  }
+
+  co_return sum;
+}
+
+} /*namespace*/
+
+TEST(task, task_coroutine_schedule_resumes_on_worker) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  // act
+  TaskHandle<std::thread::id> const handle =
+      getWorkerThreadId(executor, taskType);
+
+  // assert
+  ASSERT_NE(handle.get(), std::this_thread::get_id());
+}
+
+TEST(task, task_coroutine_await_task_handle) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  // act
+  TaskHandle<int> const handle = addOneToTaskResult(executor, taskType);
+
+  // assert
+  ASSERT_EQ(handle.get(), 42);
+}
+
+TEST(task, task_coroutine_exception_forwarded) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  // act
+  TaskHandle<void> const handle = throwOnWorker(executor, taskType);
+
+  // assert
+  ASSERT_THROW(handle.get(), std::runtime_error);
+}
+
+TEST(task, task_coroutine_continuation_and_when_all) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t count = 100;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  // act
+  TaskHandle<std::size_t> const doubledSum =
+      executor.then(sumOnWorkers(executor, taskType, count), taskType,
+                    [](std::size_t sum) { return 2 * sum; });
+
+  // assert
+  ASSERT_EQ(doubledSum.get(), count * (count - 1));
+}
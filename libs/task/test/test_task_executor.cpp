@@ -6,8 +6,12 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
@@ -43,3 +47,633 @@ TEST(task, task_executor_basic_execution) {
 
   ASSERT_EQ(cnt, deltaPerTask * numberOfTasks);
 }
+
+TEST(task, task_executor_nested_enqueue) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  std::atomic<int> cnt = 0;
+  constexpr int numberOfTasks = 64;
+  constexpr int subtasksPerTask = 64;
+
+  // act
+  for (std::size_t i = 0; i < numberOfTasks; ++i) {
+    executor.enqueue(taskType, [&executor, &cnt]() {
+      for (std::size_t j = 0; j < subtasksPerTask; ++j) {
+        executor.enqueue(taskType, [&cnt]() { ++cnt; });
+      }
+    });
+  }
+
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(cnt, numberOfTasks * subtasksPerTask);
+  ASSERT_EQ(executor.getPendingAndUncompletedTasksCount(), 0);
+}
+
+TEST(task, task_executor_multiple_task_types) {
+  // arrange
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 2}, {TaskType::rhiTransfer, 1}});
+
+  std::thread::id generalThreadId;
+  std::thread::id transferThreadId;
+
+  // act
+  executor
+      .enqueue(TaskType::rhiTransfer,
+               [&]() { transferThreadId = std::this_thread::get_id(); })
+      .wait();
+
+  executor
+      .enqueue(TaskType::general,
+               [&]() { generalThreadId = std::this_thread::get_id(); })
+      .wait();
+
+  // assert
+  EXPECT_NE(generalThreadId, std::thread::id{});
+  EXPECT_NE(transferThreadId, std::thread::id{});
+  EXPECT_NE(generalThreadId, transferThreadId);
+}
+
+TEST(task, task_executor_enqueue_detached) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  std::atomic<int> cnt = 0;
+  constexpr int numberOfTasks = 1000;
+
+  // act
+  for (std::size_t i = 0; i < numberOfTasks; ++i) {
+    executor.enqueueDetached(taskType, [&cnt]() { ++cnt; });
+  }
+
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(cnt, numberOfTasks);
+}
+
+TEST(task, task_executor_parallel_for_covers_range_once) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  constexpr int rangeBegin = 17;
+  constexpr int rangeEnd = 10017;
+  std::vector<std::atomic<int>> visits(rangeEnd);
+
+  // act
+  executor.parallelFor(taskType, rangeBegin, rangeEnd, 16, [&](int b, int e) {
+    for (int i = b; i < e; ++i) {
+      ++visits[i];
+    }
+  });
+
+  // assert
+  for (int i = 0; i < rangeEnd; ++i) {
+    ASSERT_EQ(visits[i], i < rangeBegin ? 0 : 1);
+  }
+}
+
+TEST(task, task_executor_parallel_reduce_sum) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 8}});
+
+  constexpr std::size_t count = 1000000;
+
+  // act
+  std::size_t const sum = executor.parallelReduce(
+      taskType, std::size_t{0}, count, 1024, std::size_t{0},
+      [](std::size_t b, std::size_t e) {
+        std::size_t partialSum = 0;
+        for (std::size_t i = b; i < e; ++i) {
+          partialSum += i;
+        }
+        return partialSum;
+      },
+      [](std::size_t a, std::size_t b) { return a + b; });
+
+  // assert
+  ASSERT_EQ(sum, count * (count - 1) / 2);
+}
+
+TEST(task, task_executor_parallel_for_nested_in_single_worker_queue) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  std::atomic<int> cnt = 0;
+
+  // act
+  executor
+      .enqueue(taskType,
+               [&]() {
+                 executor.parallelFor(taskType, 0, 1000, 1, [&](int b, int e) {
+                   cnt += e - b;
+                 });
+               })
+      .get();
+
+  // assert
+  ASSERT_EQ(cnt, 1000);
+}
+
+TEST(task, task_executor_parallel_for_exception_forwarded_to_caller) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  // act
+  auto const act = [&]() {
+    executor.parallelFor(taskType, 0, 1000, 1, [](int b, int e) {
+      if (b <= 500 && 500 < e) {
+        throw std::runtime_error("parallel for failure");
+      }
+    });
+  };
+
+  // assert
+  ASSERT_THROW(act(), std::runtime_error);
+  executor.waitIdle();
+  ASSERT_EQ(executor.getPendingAndUncompletedTasksCount(), 0);
+}
+
+TEST(task, task_executor_wait_runs_subtasks_on_single_worker) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  // act
+  TaskHandle<int> const task = executor.spawn(taskType, [&executor]() {
+    TaskHandle<int> const subtask =
+        executor.spawn(taskType, []() { return 42; });
+    executor.wait(subtask);
+    return subtask.get();
+  });
+
+  int const result = task.get();
+
+  // assert
+  ASSERT_EQ(result, 42);
+}
+
+TEST(task, task_executor_wait_future_runs_subtasks_on_single_worker) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  std::atomic<int> cnt = 0;
+  constexpr int subtaskCount = 16;
+
+  // act
+  executor
+      .enqueue(taskType,
+               [&]() {
+                 std::vector<std::future<void>> futures;
+
+                 for (int i = 0; i < subtaskCount; ++i) {
+                   futures.push_back(
+                       executor.enqueue(taskType, [&cnt]() { ++cnt; }));
+                 }
+
+                 for (auto const& f : futures) {
+                   executor.wait(f);
+                 }
+               })
+      .get();
+
+  // assert
+  ASSERT_EQ(cnt, subtaskCount);
+}
+
+TEST(task, task_executor_wait_future_of_other_queue) {
+  // arrange
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 1}, {TaskType::rhiTransfer, 1}});
+
+  // act
+  std::future<int> result = executor.enqueue(TaskType::general, [&]() {
+    // Finishes after the waiting worker ran out of tasks and went to sleep.
+    std::future<int> transferResult =
+        executor.enqueue(TaskType::rhiTransfer, []() {
+          std::this_thread::sleep_for(std::chrono::milliseconds{10});
+          return 1;
+        });
+    executor.wait(transferResult);
+    return transferResult.get();
+  });
+
+  // assert
+  ASSERT_EQ(result.get(), 1);
+}
+
+TEST(task, task_executor_wait_from_other_thread) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  // act
+  TaskHandle<int> const handle = executor.spawn(taskType, []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    return 1;
+  });
+  executor.wait(handle);
+
+  // assert
+  ASSERT_TRUE(handle.getFuture().wait_for(std::chrono::seconds{0}) ==
+              std::future_status::ready);
+  ASSERT_EQ(handle.get(), 1);
+}
+
+TEST(task, task_executor_wait_on_queued_task_during_shutdown) {
+  // arrange
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 1}, {TaskType::rhiTransfer, 1}});
+
+  // Destroyed once the executor shuts down, which breaks the future.
+  std::future<void> const shutdownStarted = executor.enqueueAfter(
+      TaskType::general, std::chrono::hours{1}, []() {});
+
+  std::promise<void> waiterStarted;
+
+  std::future<bool> taskBroken = executor.enqueue(TaskType::general, [&]() {
+    waiterStarted.set_value();
+    shutdownStarted.wait();
+
+    // Queued after the transfer worker stopped taking tasks.
+    TaskHandle<void> const queued =
+        executor.spawn(TaskType::rhiTransfer, []() {});
+    executor.wait(queued);
+
+    try {
+      queued.get();
+      return false;
+    } catch (std::future_error const&) {
+      return true;
+    }
+  });
+
+  waiterStarted.get_future().wait();
+
+  // act
+  executor.shutdown();
+
+  // assert
+  ASSERT_TRUE(taskBroken.get());
+}
+
+namespace {
+
+// Occupies the only worker of a queue until release is set, so that the tasks
+// enqueued in the meantime can only be picked up afterwards.
+void blockWorker(TaskExecutor& executor, TaskType taskType,
+                 std::promise<void>& release) {
+  std::promise<void> started;
+  std::shared_future<void> const released = release.get_future().share();
+
+  executor.enqueue(taskType, [&started, released]() {
+    started.set_value();
+    released.wait();
+  });
+
+  started.get_future().wait();
+}
+
+} /*namespace*/
+
+TEST(task, task_executor_higher_priority_first) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  std::promise<void> release;
+  blockWorker(executor, taskType, release);
+
+  std::vector<std::string> order;
+
+  // act
+  executor.enqueue({taskType, TaskPriority::background},
+                   [&]() { order.push_back("background"); });
+  executor.enqueue(taskType, [&]() { order.push_back("normal 1"); });
+  executor.enqueue({taskType, TaskPriority::high},
+                   [&]() { order.push_back("high"); });
+  executor.enqueue(taskType, [&]() { order.push_back("normal 2"); });
+
+  release.set_value();
+  executor.waitIdle();
+
+  // assert
+  std::vector<std::string> const expectedOrder = {"high", "normal 1",
+                                                  "normal 2", "background"};
+  ASSERT_EQ(order, expectedOrder);
+}
+
+TEST(task, task_executor_fifo_within_priority) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 32;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  std::vector<std::size_t> order;
+
+  // act
+  executor
+      .spawn(taskType,
+             [&]() {
+               // enqueued by the worker itself, so the tasks go to its deque
+               for (std::size_t i = 0; i < taskCount; ++i) {
+                 executor.enqueueDetached(
+                     taskType, [&order, i]() { order.push_back(i); });
+               }
+             })
+      .wait();
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(order.size(), taskCount);
+  ASSERT_TRUE(std::is_sorted(order.cbegin(), order.cend()));
+}
+
+TEST(task, task_executor_deadline_order) {
+  // arrange
+  using namespace std::chrono;
+
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  std::promise<void> release;
+  blockWorker(executor, taskType, release);
+
+  TaskDeadline const now = steady_clock::now();
+  std::vector<std::string> order;
+
+  // act
+  executor.enqueue(taskType, [&]() { order.push_back("no deadline"); });
+  executor.enqueue({taskType, TaskPriority::normal, now + hours{2}},
+                   [&]() { order.push_back("late deadline"); });
+  executor.enqueue({taskType, TaskPriority::normal, now + hours{1}},
+                   [&]() { order.push_back("early deadline"); });
+  executor.enqueue({taskType, TaskPriority::high},
+                   [&]() { order.push_back("high"); });
+  executor.enqueue({taskType, TaskPriority::background, now - seconds{1}},
+                   [&]() { order.push_back("overdue"); });
+
+  release.set_value();
+  executor.waitIdle();
+
+  // assert
+  std::vector<std::string> const expectedOrder = {
+      "overdue", "high", "early deadline", "late deadline", "no deadline"};
+  ASSERT_EQ(order, expectedOrder);
+}
+
+TEST(task, task_executor_enqueue_batch) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 100;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  auto const makeFunc = [](std::size_t i) { return [i]() { return i * 2; }; };
+
+  std::vector<decltype(makeFunc(0))> funcs;
+
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    funcs.push_back(makeFunc(i));
+  }
+
+  // act
+  std::vector<std::future<std::size_t>> futures =
+      executor.enqueueBatch(taskType, funcs);
+
+  // assert
+  ASSERT_EQ(futures.size(), taskCount);
+
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    ASSERT_EQ(futures[i].get(), i * 2);
+  }
+}
+
+TEST(task, task_executor_spawn_batch_from_worker) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 100;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  std::atomic<std::size_t> finishedCount = 0;
+
+  // act
+  executor
+      .spawn(taskType,
+             [&]() {
+               std::vector<std::function<void()>> funcs(
+                   taskCount, [&finishedCount]() { ++finishedCount; });
+
+               executor.wait(
+                   whenAll(executor.spawnBatch(taskType, std::move(funcs))));
+             })
+      .wait();
+
+  // assert
+  ASSERT_EQ(finishedCount, taskCount);
+}
+
+TEST(task, task_executor_enqueue_after) {
+  // arrange
+  using namespace std::chrono_literals;
+  using Clock = std::chrono::steady_clock;
+
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  Clock::time_point const start = Clock::now();
+
+  // act
+  std::future<Clock::time_point> later =
+      executor.enqueueAfter(taskType, 50ms, []() { return Clock::now(); });
+  std::future<Clock::time_point> sooner =
+      executor.enqueueAfter(taskType, 10ms, []() { return Clock::now(); });
+
+  // assert
+  Clock::time_point const soonerTime = sooner.get();
+  Clock::time_point const laterTime = later.get();
+
+  ASSERT_GE(soonerTime - start, 10ms);
+  ASSERT_GE(laterTime - start, 50ms);
+  ASSERT_LT(soonerTime, laterTime);
+}
+
+TEST(task, task_executor_enqueue_every_until_cancelled) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  std::atomic<int> runCount = 0;
+  std::promise<void> ranThreeTimes;
+
+  // act
+  TimerHandle timer = executor.enqueueEvery(taskType, 5ms, [&]() {
+    if (++runCount == 3) {
+      ranThreeTimes.set_value();
+    }
+  });
+
+  ranThreeTimes.get_future().wait();
+  timer.cancel();
+
+  std::this_thread::sleep_for(20ms);
+  executor.waitIdle();
+  int const runCountAfterCancel = runCount;
+  std::this_thread::sleep_for(20ms);
+
+  // assert
+  ASSERT_TRUE(timer.valid());
+  ASSERT_EQ(runCount, runCountAfterCancel);
+}
+
+TEST(task, task_executor_interval_called_on_every_worker) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  constexpr TaskType taskType = TaskType::general;
+  constexpr unsigned int workerCount = 3;
+
+  std::mutex threadIdsMutex;
+  std::set<std::thread::id> threadIds;
+  std::promise<void> calledOnAllWorkers;
+
+  TaskExecutor executor;
+
+  // act
+  executor.initAndRun({{taskType, workerCount,
+                        [&]() {
+                          std::scoped_lock l{threadIdsMutex};
+
+                          if (threadIds.insert(std::this_thread::get_id())
+                                      .second &&
+                              threadIds.size() == workerCount) {
+                            calledOnAllWorkers.set_value();
+                          }
+                        },
+                        5}});
+
+  // assert
+  ASSERT_EQ(calledOnAllWorkers.get_future().wait_for(5s),
+            std::future_status::ready);
+}
+
+TEST(task, task_executor_helpers_run_tasks_of_busy_queue) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, 1},
+                       {TaskType::rhiTransfer, 1, {}, 0, {}, {},
+                        {TaskType::general}}});
+
+  std::promise<void> unblock;
+  std::shared_future<void> const unblocked = unblock.get_future().share();
+  std::promise<std::thread::id> blockedThreadId;
+
+  executor.enqueue(TaskType::general, [&]() {
+    blockedThreadId.set_value(std::this_thread::get_id());
+    unblocked.wait();
+  });
+
+  std::thread::id const generalThreadId = blockedThreadId.get_future().get();
+
+  // act
+  std::future<std::thread::id> helpedFuture = executor.enqueue(
+      TaskType::general, []() { return std::this_thread::get_id(); });
+
+  std::future_status const helpedStatus = helpedFuture.wait_for(5s);
+  unblock.set_value();
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(helpedStatus, std::future_status::ready);
+  ASSERT_NE(helpedFuture.get(), generalThreadId);
+}
+
+TEST(task, task_executor_queue_served_only_by_helpers) {
+  // arrange
+  constexpr std::size_t taskCount = 32;
+
+  TaskExecutor executor;
+  executor.initAndRun(
+      {{TaskType::resourceUpload, 0},
+       {TaskType::general, 2, {}, 0, {}, {}, {TaskType::resourceUpload}}});
+
+  std::atomic<std::size_t> executedCount = 0;
+
+  // act
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    executor.enqueueDetached(TaskType::resourceUpload,
+                             [&executedCount]() { ++executedCount; });
+  }
+
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(executedCount, taskCount);
+  ASSERT_EQ(executor.getStats(TaskType::resourceUpload).tasksInProgress, 0);
+}
+
+TEST(task, task_executor_run_on_each_worker) {
+  // arrange
+  constexpr unsigned int workerCount = 3;
+
+  TaskExecutor executor;
+  executor.initAndRun({{TaskType::general, workerCount}});
+
+  std::mutex threadIdsMutex;
+  std::set<std::thread::id> threadIds;
+
+  // act
+  executor.runOnEachWorker(TaskType::general, [&]() {
+    std::scoped_lock l{threadIdsMutex};
+    threadIds.insert(std::this_thread::get_id());
+  });
+
+  // assert
+  ASSERT_EQ(threadIds.size(), workerCount);
+  ASSERT_FALSE(threadIds.contains(std::this_thread::get_id()));
+}
@@ -0,0 +1,129 @@
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_group.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+TEST(task, task_group_wait_ignores_other_tasks) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 32;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  std::promise<void> releaseOther;
+  std::shared_future<void> const otherReleased =
+      releaseOther.get_future().share();
+  executor.enqueue(taskType, [otherReleased]() { otherReleased.wait(); });
+
+  TaskGroup group{executor};
+  std::atomic<std::size_t> finishedCount = 0;
+
+  // act
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    group.spawn(taskType, [&]() { ++finishedCount; });
+  }
+
+  group.wait();
+
+  // assert
+  ASSERT_EQ(finishedCount, taskCount);
+  releaseOther.set_value();
+}
+
+TEST(task, task_group_cancel_skips_tasks_not_started) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  TaskGroup group{executor};
+
+  std::promise<void> started;
+  std::promise<void> release;
+  std::shared_future<void> const released = release.get_future().share();
+
+  group.spawn(taskType, [&started, released]() {
+    started.set_value();
+    released.wait();
+  });
+  started.get_future().wait();
+
+  bool queuedTaskCalled = false;
+  TaskHandle<int> const queued = group.spawn(taskType, [&]() {
+    queuedTaskCalled = true;
+    return 1;
+  });
+
+  // act
+  group.cancel();
+  release.set_value();
+  group.wait();
+
+  // assert
+  ASSERT_FALSE(queuedTaskCalled);
+  ASSERT_THROW(queued.get(), TaskCancelledError);
+}
+
+TEST(task, task_group_token_observes_cancel) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  TaskGroup group{executor};
+
+  std::promise<void> started;
+
+  TaskHandle<bool> const running =
+      group.spawn(taskType, [&started](CancellationToken const& token) {
+        started.set_value();
+
+        while (!token.isCancelled()) {
+          std::this_thread::yield();
+        }
+
+        return true;
+      });
+  started.get_future().wait();
+
+  // act
+  group.cancel();
+  group.wait();
+
+  // assert
+  ASSERT_TRUE(running.get());
+  ASSERT_TRUE(group.isCancelled());
+  ASSERT_FALSE(CancellationToken{}.isCancelled());
+}
+
+TEST(task, task_group_add_handle) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  TaskGroup group{executor};
+  std::atomic<bool> continuationCalled = false;
+
+  // act
+  group.add(executor.then(executor.spawn(taskType, []() {}), taskType,
+                          [&]() { continuationCalled = true; }));
+  group.wait();
+
+  // assert
+  ASSERT_TRUE(continuationCalled);
+}
@@ -0,0 +1,156 @@
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_handle.hpp>
+#include <obsidian/task/task_type.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+TEST(task, task_handle_then_receives_result) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  // act
+  TaskHandle<int> const first = executor.spawn(taskType, []() { return 20; });
+  TaskHandle<std::string> const second = executor.then(
+      first, taskType, [](int value) { return std::to_string(value + 1); });
+
+  // assert
+  ASSERT_EQ(second.get(), "21");
+  ASSERT_TRUE(first.isDone());
+}
+
+TEST(task, task_handle_then_after_completion) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 1}});
+
+  TaskHandle<void> const first = executor.spawn(taskType, []() {});
+  executor.waitIdle();
+
+  // act
+  bool continuationCalled = false;
+  executor.then(first, taskType, [&]() { continuationCalled = true; }).wait();
+
+  // assert
+  ASSERT_TRUE(continuationCalled);
+}
+
+TEST(task, task_handle_then_forwards_exception) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  bool continuationCalled = false;
+
+  // act
+  TaskHandle<void> const first = executor.spawn(
+      taskType, []() { throw std::runtime_error("first task failed"); });
+  TaskHandle<void> const second =
+      executor.then(first, taskType, [&]() { continuationCalled = true; });
+
+  // assert
+  ASSERT_THROW(second.get(), std::runtime_error);
+  ASSERT_FALSE(continuationCalled);
+}
+
+TEST(task, task_handle_then_unwraps_returned_handle) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  std::promise<void> releaseInner;
+  std::shared_future<void> const innerReleased =
+      releaseInner.get_future().share();
+
+  // act
+  TaskHandle<int> const outer =
+      executor.then(executor.spawn(taskType, []() {}), taskType, [&]() {
+        return executor.spawn(taskType, [innerReleased]() {
+          innerReleased.wait();
+          return 7;
+        });
+      });
+
+  // assert
+  ASSERT_FALSE(outer.isDone());
+  releaseInner.set_value();
+  ASSERT_EQ(outer.get(), 7);
+}
+
+TEST(task, task_handle_when_all) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 64;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 4}});
+
+  std::atomic<std::size_t> finishedCount = 0;
+  std::vector<TaskHandle<void>> handles;
+
+  // act
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    handles.push_back(executor.spawn(taskType, [&]() { ++finishedCount; }));
+  }
+
+  std::size_t observedCount = 0;
+  executor
+      .then(whenAll(handles), taskType,
+            [&]() { observedCount = finishedCount; })
+      .wait();
+
+  // assert
+  ASSERT_EQ(observedCount, taskCount);
+}
+
+TEST(task, task_handle_when_all_empty) {
+  // arrange
+  std::vector<TaskHandle<void>> const handles;
+
+  // act
+  TaskHandle<void> const all = whenAll(handles);
+
+  // assert
+  ASSERT_TRUE(all.isDone());
+}
+
+TEST(task, task_handle_when_any) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+
+  std::promise<void> releaseBlocked;
+  std::shared_future<void> const blockedReleased =
+      releaseBlocked.get_future().share();
+
+  std::vector<TaskHandle<void>> const handles = {
+      executor.spawn(taskType, [blockedReleased]() { blockedReleased.wait(); }),
+      executor.spawn(taskType, []() {})};
+
+  // act
+  std::size_t const firstCompleted = whenAny(handles).get();
+  releaseBlocked.set_value();
+
+  // assert
+  ASSERT_EQ(firstCompleted, 1);
+}
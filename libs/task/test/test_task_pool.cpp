@@ -0,0 +1,72 @@
+#include <obsidian/task/task_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+TEST(task_pool, freed_block_is_reused) {
+  // arrange
+  void* const first = TaskPool::allocate(100);
+
+  // act
+  TaskPool::deallocate(first, 100);
+  void* const second = TaskPool::allocate(100);
+
+  // assert
+  EXPECT_EQ(first, second);
+
+  TaskPool::deallocate(second, 100);
+}
+
+TEST(task_pool, blocks_are_aligned) {
+  // arrange
+  std::vector<void*> blocks;
+
+  // act
+  for (std::size_t size = 1; size <= 2 * TaskPool::maxBlockSize; size += 7) {
+    blocks.push_back(TaskPool::allocate(size));
+  }
+
+  // assert
+  for (void* block : blocks) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) %
+                  alignof(std::max_align_t),
+              0);
+  }
+
+  std::size_t size = 1;
+  for (void* block : blocks) {
+    TaskPool::deallocate(block, size);
+    size += 7;
+  }
+}
+
+TEST(task_pool, free_on_other_thread) {
+  // arrange
+  constexpr std::size_t blockCount = 10000;
+  std::vector<void*> blocks;
+
+  for (std::size_t i = 0; i < blockCount; ++i) {
+    blocks.push_back(TaskPool::allocate(64));
+    *static_cast<std::size_t*>(blocks.back()) = i;
+  }
+
+  // act
+  std::thread t{[&blocks]() {
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+      ASSERT_EQ(*static_cast<std::size_t*>(blocks[i]), i);
+      TaskPool::deallocate(blocks[i], 64);
+    }
+  }};
+
+  t.join();
+
+  // assert
+  void* const block = TaskPool::allocate(64);
+  EXPECT_NE(block, nullptr);
+  TaskPool::deallocate(block, 64);
+}
@@ -0,0 +1,118 @@
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_stats.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+using namespace obsidian::task;
+
+TEST(task, task_stats_histogram_buckets) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  AtomicTaskDurationHistogram histogram;
+
+  // act
+  histogram.record(500ns);
+  histogram.record(1us);
+  histogram.record(3us);
+  histogram.record(3us);
+  histogram.record(1000s);
+
+  TaskDurationHistogram const snapshot = histogram.snapshot();
+
+  // assert
+  ASSERT_EQ(snapshot.sampleCount, 5);
+  ASSERT_EQ(snapshot.buckets[0], 1);
+  ASSERT_EQ(snapshot.buckets[1], 1);
+  ASSERT_EQ(snapshot.buckets[2], 2);
+  ASSERT_EQ(snapshot.buckets[TaskDurationHistogram::bucketCount - 1], 1);
+  ASSERT_EQ(snapshot.max, 1000s);
+  ASSERT_EQ(snapshot.percentile(0.5), 4us);
+  ASSERT_EQ(snapshot.percentile(0.2), 1us);
+}
+
+TEST(task, task_stats_full_mode_records_every_task) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t taskCount = 20;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+  executor.setStatsMode(TaskStatsMode::full);
+
+  // act
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    executor.enqueueDetached(taskType,
+                             []() { std::this_thread::sleep_for(1ms); });
+  }
+
+  executor.waitIdle();
+
+  TaskQueueStats const stats = executor.getStats(taskType);
+
+  // assert
+  ASSERT_EQ(stats.startLatency.sampleCount, taskCount);
+  ASSERT_EQ(stats.executionTime.sampleCount, taskCount);
+  ASSERT_GE(stats.executionTime.total, taskCount * 1ms);
+  ASSERT_GE(stats.executionTime.percentile(0.5), 1ms);
+  ASSERT_EQ(stats.queuedTaskCount, 0);
+  ASSERT_EQ(stats.tasksInProgress, 0);
+  ASSERT_EQ(stats.workerCount, 2);
+  ASSERT_GE(stats.busyRatio, 0.0);
+  ASSERT_LE(stats.busyRatio, 1.0);
+}
+
+TEST(task, task_stats_sampled_mode) {
+  // arrange
+  constexpr TaskType taskType = TaskType::general;
+  constexpr std::size_t samplingInterval = 4;
+  constexpr std::size_t taskCount = 40;
+
+  TaskExecutor executor;
+  executor.initAndRun({{taskType, 2}});
+  executor.setStatsMode(TaskStatsMode::sampled, samplingInterval);
+
+  // act
+  for (std::size_t i = 0; i < taskCount; ++i) {
+    executor.enqueueDetached(taskType, []() {});
+  }
+
+  executor.waitIdle();
+
+  // assert
+  ASSERT_EQ(executor.getStats(taskType).executionTime.sampleCount,
+            taskCount / samplingInterval);
+}
+
+TEST(task, task_stats_idle_workers_not_busy) {
+  // arrange
+  using namespace std::chrono_literals;
+
+  constexpr TaskType taskType = TaskType::general;
+
+  TaskExecutor executor;
+  executor.setStatsMode(TaskStatsMode::full);
+  executor.initAndRun({{taskType, 2}});
+
+  // act
+  std::this_thread::sleep_for(50ms);
+
+  TaskQueueStats const idleStats = executor.getStats(taskType);
+
+  executor.resetStats();
+  executor.enqueueDetached(taskType, []() {});
+  executor.waitIdle();
+  executor.setStatsMode(TaskStatsMode::disabled);
+
+  TaskQueueStats const resetStats = executor.getStats(taskType);
+
+  // assert
+  ASSERT_LT(idleStats.busyRatio, 0.5);
+  ASSERT_EQ(resetStats.executionTime.sampleCount, 1);
+}
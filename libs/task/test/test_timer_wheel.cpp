@@ -0,0 +1,88 @@
+#include <obsidian/task/timer_wheel.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace obsidian::task;
+
+TEST(timer_wheel, entries_due_in_order) {
+  // arrange
+  TimerWheel<int> wheel;
+  std::vector<int> due;
+
+  wheel.insert(5, 5);
+  wheel.insert(1, 1);
+  wheel.insert(64, 64);
+  wheel.insert(70, 70);
+
+  // act
+  wheel.advance(4, due);
+  std::vector<int> const dueAt4 = due;
+
+  due.clear();
+  wheel.advance(64, due);
+  std::vector<int> const dueAt64 = due;
+
+  due.clear();
+  wheel.advance(100, due);
+
+  // assert
+  ASSERT_EQ(dueAt4, std::vector<int>({1}));
+  ASSERT_EQ(dueAt64, std::vector<int>({5, 64}));
+  ASSERT_EQ(due, std::vector<int>({70}));
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, cascades_far_entries) {
+  // arrange
+  using Tick = TimerWheel<std::uint64_t>::Tick;
+
+  TimerWheel<std::uint64_t> wheel;
+  std::vector<Tick> const dueTicks = {
+      3, 63, 64, 4095, 4096, 4097, 262143, 262144, Tick{1} << 24,
+      (Tick{1} << 24) + 1, Tick{1} << 40};
+
+  for (Tick const t : dueTicks) {
+    wheel.insert(t, t);
+  }
+
+  // act
+  std::vector<std::uint64_t> due;
+
+  // Every step has to stop exactly at the next entry.
+  while (auto const nextTick = wheel.getNextEventTick()) {
+    std::size_t const dueCount = due.size();
+
+    wheel.advance(*nextTick, due);
+
+    for (std::size_t i = dueCount; i < due.size(); ++i) {
+      ASSERT_EQ(due[i], *nextTick);
+    }
+  }
+
+  // assert
+  ASSERT_EQ(due, dueTicks);
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, entry_in_the_past_is_due_right_away) {
+  // arrange
+  TimerWheel<int> wheel;
+  std::vector<int> due;
+
+  wheel.advance(1000, due);
+
+  // act
+  wheel.insert(10, 10);
+
+  // assert
+  ASSERT_EQ(wheel.getNextEventTick(), 1000);
+
+  wheel.advance(1000, due);
+
+  ASSERT_EQ(due, std::vector<int>({10}));
+}
@@ -0,0 +1,99 @@
+#include <obsidian/task/work_stealing_deque.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace obsidian::task;
+
+TEST(work_stealing_deque, owner_push_pop_lifo) {
+  // arrange
+  WorkStealingDeque<int*> deque{2};
+  std::vector<int> values(10);
+
+  // act
+  for (int& v : values) {
+    deque.push(&v);
+  }
+
+  // assert
+  for (auto it = values.rbegin(); it != values.rend(); ++it) {
+    EXPECT_EQ(deque.pop(), &*it);
+  }
+
+  EXPECT_EQ(deque.pop(), nullptr);
+  EXPECT_TRUE(deque.empty());
+}
+
+TEST(work_stealing_deque, steal_fifo) {
+  // arrange
+  WorkStealingDeque<int*> deque;
+  std::vector<int> values(10);
+
+  // act
+  for (int& v : values) {
+    deque.push(&v);
+  }
+
+  // assert
+  for (int& v : values) {
+    EXPECT_EQ(deque.steal(), &v);
+  }
+
+  EXPECT_EQ(deque.steal(), nullptr);
+}
+
+TEST(work_stealing_deque, concurrent_steal_takes_each_item_once) {
+  // arrange
+  constexpr int itemCount = 100000;
+  constexpr int thiefCount = 4;
+
+  WorkStealingDeque<int*> deque{4};
+  std::vector<int> values(itemCount, 0);
+  std::vector<std::atomic<int>> takenCounts(itemCount);
+  std::atomic<bool> ownerDone = false;
+
+  auto const markTaken = [&](int* item) {
+    ++takenCounts[item - values.data()];
+  };
+
+  // act
+  std::vector<std::thread> thieves;
+
+  for (int i = 0; i < thiefCount; ++i) {
+    thieves.emplace_back([&]() {
+      while (!ownerDone || !deque.empty()) {
+        if (int* const item = deque.steal()) {
+          markTaken(item);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < itemCount; ++i) {
+    deque.push(&values[i]);
+
+    if (i % 3 == 0) {
+      if (int* const item = deque.pop()) {
+        markTaken(item);
+      }
+    }
+  }
+
+  while (int* const item = deque.pop()) {
+    markTaken(item);
+  }
+
+  ownerDone = true;
+
+  for (std::thread& t : thieves) {
+    t.join();
+  }
+
+  // assert
+  for (std::atomic<int> const& cnt : takenCounts) {
+    ASSERT_EQ(cnt, 1);
+  }
+}
@@ -33,6 +33,7 @@ struct Mesh {
   VkDeviceSize indexCount;
   AllocatedBuffer indexBuffer;
   std::vector<std::size_t> indexBufferSizes;
+  std::vector<std::size_t> indexBufferOffsets;
   rhi::ResourceRHI resource;
   bool hasNormals;
   bool hasColors;
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <obsidian/core/material.hpp>
+#include <obsidian/platform/cpu_topology.hpp>
 #include <obsidian/rhi/resource_rhi.hpp>
 #include <obsidian/rhi/rhi.hpp>
 #include <obsidian/rhi/submit_types_rhi.hpp>
+#include <obsidian/task/task_executor.hpp>
 #include <obsidian/vk_rhi/vk_check.hpp>
 #include <obsidian/vk_rhi/vk_debug.hpp>
 #include <obsidian/vk_rhi/vk_deletion_queue.hpp>
@@ -40,6 +42,11 @@ class VulkanRHI : public rhi::RHI {
   static unsigned int const environmentMapResolution = 400;
 
 public:
+  // Transfer work runs on the rhiTransfer queue of the given executor, which
+  // has to outlive the RHI. Every transfer worker keeps Vulkan objects of its
+  // own until cleanup.
+  explicit VulkanRHI(task::TaskExecutor& taskExecutor);
+
   bool IsInitialized{false};
   int FrameNumber{0};
 
@@ -108,8 +115,13 @@ public:
 
   void applyPendingEnvironmentMapUpdates();
 
+  // The init info of the rhiTransfer queue, to be passed to the executor
+  // before init. The workers release finished transfers periodically.
+  task::ThreadInitInfo getTransferThreadInitInfo(unsigned int threadCount,
+                                                 platform::CpuSet cpus);
+
 private:
-  task::TaskExecutor _taskExecutor;
+  task::TaskExecutor& _taskExecutor;
 
   // Instance
   VkInstance _vkInstance;
@@ -129,6 +141,7 @@ private:
   std::vector<VKDrawCall> _drawCallQueue;
   std::vector<VKDrawCall> _ssaoDrawCallQueue;
   std::vector<VKDrawCall> _transparentDrawCallQueue;
+  std::vector<std::uint8_t> _drawCallVisibility;
   std::vector<rhi::DirectionalLight> _submittedDirectionalLights;
   std::vector<rhi::Spotlight> _submittedSpotlights;
   std::array<FrameData, frameOverlap> _frameDataArray = {};
@@ -348,6 +361,10 @@ private:
                          bufferQueueFamilyInd, bufferTransferOptions);
   }
 
+  // Fills _drawCallVisibility with the frustum test of each of the count draw
+  // calls against the camera.
+  void cullDrawCalls(VKDrawCall const* first, int count,
+                     GPUCameraData const& cameraData);
   void drawWithMaterials(VkCommandBuffer cmd, VKDrawCall* first, int count,
                          GPUCameraData const& cameraData,
                          std::vector<std::uint32_t> const& dynamicOffsets,
@@ -12,6 +12,7 @@
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 
 namespace obsidian::vk_rhi {
@@ -190,6 +191,8 @@ struct ImageTransferInfo {
   std::uint32_t mipCount;
   std::uint32_t layerCount;
   VkImageAspectFlags aspectMask;
+  // where every mip level starts in the staging buffer
+  std::span<std::size_t const> mipOffsets;
 };
 
 struct ImageTransferDstState {
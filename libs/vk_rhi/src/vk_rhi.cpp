@@ -25,10 +25,10 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <mutex>
-#include <numeric>
 #include <optional>
 #include <utility>
 #include <variant>
@@ -41,6 +41,9 @@ static thread_local std::unordered_map<std::uint32_t, ImmediateSubmitContext>
 static thread_local bool immediateContextsInitialized = false;
 static thread_local ResourceTransferContext resourceTransferCtx;
 
+VulkanRHI::VulkanRHI(task::TaskExecutor& taskExecutor)
+    : _taskExecutor{taskExecutor} {}
+
 void VulkanRHI::waitDeviceIdle() const {
   std::scoped_lock l{_gpuQueueMutexes.at(_graphicsQueueFamilyIndex),
                      _gpuQueueMutexes.at(_transferQueueFamilyIndex)};
@@ -64,6 +67,12 @@ VulkanRHI::uploadTexture(rhi::ResourceIdRHI id,
                          rhi::UploadTextureRHI uploadTextureInfoRHI) {
   Texture& newTexture = _textures.at(id);
 
+  if (uploadTextureInfoRHI.mipOffsets.size() !=
+      uploadTextureInfoRHI.mipLevels) {
+    OBS_LOG_ERR("Texture upload needs the offset of every mip level.");
+    return {};
+  }
+
   rhi::ResourceState expected = rhi::ResourceState::initial;
 
   if (!newTexture.resource.state.compare_exchange_strong(
@@ -104,14 +113,10 @@ VulkanRHI::uploadTexture(rhi::ResourceIdRHI id,
   setDbgResourceName(_vkDevice, (std::uint64_t)newTexture.imageView,
                      VK_OBJECT_TYPE_IMAGE_VIEW, uploadTextureInfoRHI.debugName);
 
-  return rhi::ResourceTransferRHI{_taskExecutor.enqueue(
+  return rhi::ResourceTransferRHI{_taskExecutor.spawn(
       task::TaskType::rhiTransfer,
       [this, &newTexture, extent, info = std::move(uploadTextureInfoRHI)]() {
-        bool const hasMips = info.mipLevels > 1;
-
-        std::size_t const size = info.width * info.height *
-                                 core::getFormatPixelSize(info.format) *
-                                 (hasMips ? 2 : 1);
+        std::size_t const size = info.textureDataSize;
 
         AllocatedBuffer stagingBuffer =
             createBuffer(size, VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
@@ -137,6 +142,7 @@ VulkanRHI::uploadTexture(rhi::ResourceIdRHI id,
             .mipCount = info.mipLevels,
             .layerCount = 1,
             .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipOffsets = info.mipOffsets,
         };
 
         ImageTransferDstState const transferDstState = {
@@ -181,6 +187,11 @@ rhi::ResourceTransferRHI VulkanRHI::uploadMesh(rhi::ResourceIdRHI id,
                                                rhi::UploadMeshRHI meshInfo) {
   Mesh& mesh = _meshes[id];
 
+  if (meshInfo.indexBufferOffsets.size() != meshInfo.indexBufferSizes.size()) {
+    OBS_LOG_ERR("Mesh upload needs the offset of every index buffer.");
+    return {};
+  }
+
   rhi::ResourceState expected = rhi::ResourceState::initial;
 
   if (!mesh.resource.state.compare_exchange_strong(
@@ -199,11 +210,15 @@ rhi::ResourceTransferRHI VulkanRHI::uploadMesh(rhi::ResourceIdRHI id,
                      VK_OBJECT_TYPE_BUFFER, meshInfo.debugName,
                      "Vertex Buffer");
 
-  std::size_t const totalIndexBufferSize =
-      std::accumulate(meshInfo.indexBufferSizes.cbegin(),
-                      meshInfo.indexBufferSizes.cend(), std::size_t{0});
+  // The index buffers are copied together with the padding between them, so
+  // that the copy is a single region.
+  std::size_t const indexSectionOffset =
+      meshInfo.indexBufferOffsets.empty() ? meshInfo.meshDataSize
+                                          : meshInfo.indexBufferOffsets.front();
+  std::size_t const indexSectionSize =
+      meshInfo.meshDataSize - indexSectionOffset;
 
-  mesh.indexBuffer = createBuffer(totalIndexBufferSize,
+  mesh.indexBuffer = createBuffer(indexSectionSize,
                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
                                   VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, 0);
@@ -212,6 +227,12 @@ rhi::ResourceTransferRHI VulkanRHI::uploadMesh(rhi::ResourceIdRHI id,
                      VK_OBJECT_TYPE_BUFFER, meshInfo.debugName, "Index Buffer");
 
   mesh.indexBufferSizes = meshInfo.indexBufferSizes;
+  mesh.indexBufferOffsets.clear();
+
+  for (std::size_t const offset : meshInfo.indexBufferOffsets) {
+    mesh.indexBufferOffsets.push_back(offset - indexSectionOffset);
+  }
+
   mesh.indexCount = meshInfo.indexCount;
   mesh.hasNormals = meshInfo.hasNormals;
   mesh.hasColors = meshInfo.hasColors;
@@ -219,11 +240,12 @@ rhi::ResourceTransferRHI VulkanRHI::uploadMesh(rhi::ResourceIdRHI id,
   mesh.hasTangents = meshInfo.hasTangents;
   mesh.aabb = meshInfo.aabb;
 
-  return rhi::ResourceTransferRHI{_taskExecutor.enqueue(
+  return rhi::ResourceTransferRHI{_taskExecutor.spawn(
       task::TaskType::rhiTransfer,
-      [this, totalIndexBufferSize, &mesh, info = std::move(meshInfo)]() {
+      [this, indexSectionOffset, indexSectionSize, &mesh,
+       info = std::move(meshInfo)]() {
         AllocatedBuffer stagingBuffer = createBuffer(
-            info.vertexBufferSize + totalIndexBufferSize,
+            info.meshDataSize,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
             VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT, 0,
             VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
@@ -246,9 +268,9 @@ rhi::ResourceTransferRHI VulkanRHI::uploadMesh(rhi::ResourceIdRHI id,
              .dstOffset = 0,
              .size = info.vertexBufferSize,
              .dstBuffer = mesh.vertexBuffer.buffer},
-            {.srcOffset = info.vertexBufferSize,
+            {.srcOffset = indexSectionOffset,
              .dstOffset = 0,
-             .size = totalIndexBufferSize,
+             .size = indexSectionSize,
              .dstBuffer = mesh.indexBuffer.buffer}};
 
         BufferTransferOptions bufferTransferOptions = {
@@ -303,7 +325,7 @@ VulkanRHI::uploadShader(rhi::ResourceIdRHI id,
     return {};
   }
 
-  return rhi::ResourceTransferRHI{_taskExecutor.enqueue(
+  return rhi::ResourceTransferRHI{_taskExecutor.spawn(
       task::TaskType::rhiTransfer,
       [this, id, uploadShader = std::move(uploadShader)]() {
         Shader& shader = _shaderModules.at(id);
@@ -406,330 +428,330 @@ VulkanRHI::uploadMaterial(rhi::ResourceIdRHI id,
 
   return rhi::ResourceTransferRHI{
       _taskExecutor
-          .enqueue(task::TaskType::rhiTransfer,
-                   [this, id, uploadMaterial = std::move(uploadMaterial)]() {
-                     VkMaterial& newMaterial = _materials[id];
-
-                     PipelineBuilder pipelineBuilder =
-                         _pipelineBuilders.at(uploadMaterial.materialType);
-
-                     Shader& vertexShaderModule =
-                         _shaderModules.at(uploadMaterial.vertexShaderId);
-                     ++vertexShaderModule.resource.refCount;
-                     newMaterial.vertexShaderResourceDependencyId =
-                         vertexShaderModule.resource.id;
-
-                     pipelineBuilder._vkShaderStageCreateInfos.clear();
-                     pipelineBuilder._vkShaderStageCreateInfos.push_back(
-                         vkinit::pipelineShaderStageCreateInfo(
-                             VK_SHADER_STAGE_VERTEX_BIT,
-                             vertexShaderModule.vkShaderModule));
-
-                     Shader& fragmentShaderModule =
-                         _shaderModules.at(uploadMaterial.fragmentShaderId);
-                     ++fragmentShaderModule.resource.refCount;
-                     newMaterial.fragmentShaderResourceDependencyId =
-                         fragmentShaderModule.resource.id;
-
-                     pipelineBuilder._vkShaderStageCreateInfos.push_back(
-                         vkinit::pipelineShaderStageCreateInfo(
-                             VK_SHADER_STAGE_FRAGMENT_BIT,
-                             fragmentShaderModule.vkShaderModule));
-
-                     newMaterial.vkPipelineLayout =
-                         pipelineBuilder._vkPipelineLayout;
-
-                     pipelineBuilder._vkDepthStencilStateCreateInfo =
-                         vkinit::
-                             depthStencilStateCreateInfo(
-                                 true, _sampleCount != VK_SAMPLE_COUNT_1_BIT /*we don't reuse depth in case of multisampling*/);
-                     newMaterial.vkPipelineMainRenderPass =
-                         pipelineBuilder.buildPipeline(_vkDevice,
-                                                       _mainRenderPass);
-
-                     setDbgResourceName(
-                         _vkDevice,
-                         (std::uint64_t)newMaterial.vkPipelineMainRenderPass,
-                         VK_OBJECT_TYPE_PIPELINE, uploadMaterial.debugName,
-                         "Reuse depth pipeline");
-
-                     pipelineBuilder._vkDepthStencilStateCreateInfo =
-                         vkinit::depthStencilStateCreateInfo(true, true);
-                     pipelineBuilder._vkRasterizationCreateInfo.frontFace =
-                         VK_FRONT_FACE_CLOCKWISE;
-                     newMaterial.vkPipelineEnvironmentRendering =
-                         pipelineBuilder.buildPipeline(_vkDevice,
-                                                       _envMapRenderPass);
-                     pipelineBuilder._vkRasterizationCreateInfo.frontFace =
-                         VK_FRONT_FACE_COUNTER_CLOCKWISE;
-
-                     setDbgResourceName(
-                         _vkDevice,
-                         (std::uint64_t)
-                             newMaterial.vkPipelineEnvironmentRendering,
-                         VK_OBJECT_TYPE_PIPELINE, uploadMaterial.debugName,
-                         "Environment rendering pipeline");
-
-                     newMaterial.transparent = uploadMaterial.transparent;
-
-                     DescriptorBuilder descriptorBuilder =
-                         DescriptorBuilder::begin(_vkDevice,
-                                                  _descriptorAllocator,
-                                                  _descriptorLayoutCache);
-
-                     VkDescriptorBufferInfo materialDataBufferInfo;
-
-                     if (uploadMaterial.materialType ==
-                         core::MaterialType::lit) {
-                       rhi::UploadLitMaterialRHI const& uploadLitMaterial =
-                           std::get<rhi::UploadLitMaterialRHI>(
-                               uploadMaterial.uploadMaterialSubtype);
-
-                       newMaterial.reflection = uploadLitMaterial.reflection;
-
-                       GPULitMaterialData materialData;
-                       materialData.hasDiffuseTex =
-                           uploadLitMaterial.diffuseTextureId !=
-                           rhi::rhiIdUninitialized;
-                       materialData.hasNormalMap =
-                           uploadLitMaterial.normalTextureId !=
-                           rhi::rhiIdUninitialized;
-                       materialData.reflection = uploadLitMaterial.reflection;
-                       materialData.ambientColor =
-                           uploadLitMaterial.ambientColor;
-                       materialData.diffuseColor =
-                           uploadLitMaterial.diffuseColor;
-                       materialData.specularColor =
-                           uploadLitMaterial.specularColor;
-                       materialData.shininess = uploadLitMaterial.shininess;
-
-                       createAndBindMaterialDataBuffer(materialData,
-                                                       descriptorBuilder,
-                                                       materialDataBufferInfo);
-
-                       bool const hasDiffuseTex =
-                           uploadLitMaterial.diffuseTextureId !=
-                           rhi::rhiIdUninitialized;
-
-                       if (hasDiffuseTex) {
-                         Texture& diffuseTexture =
-                             _textures[uploadLitMaterial.diffuseTextureId];
-
-                         ++diffuseTexture.resource.refCount;
-                         newMaterial.textureResourceDependencyIds.push_back(
-                             diffuseTexture.resource.id);
-
-                         VkDescriptorImageInfo diffuseTexImageInfo;
-                         diffuseTexImageInfo.imageLayout =
-                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                         diffuseTexImageInfo.imageView =
-                             diffuseTexture.imageView;
-                         diffuseTexImageInfo.sampler = _vkLinearRepeatSampler;
-
-                         descriptorBuilder.bindImage(
-                             1, diffuseTexImageInfo,
-                             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
-                       } else {
-                         descriptorBuilder.declareUnusedImage(
-                             1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT);
-                       }
-
-                       bool const hasNormalMap =
-                           uploadLitMaterial.normalTextureId !=
-                           rhi::rhiIdUninitialized;
-
-                       if (hasNormalMap) {
-                         VkDescriptorImageInfo normalMapTexImageInfo;
-                         normalMapTexImageInfo.imageLayout =
-                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                         normalMapTexImageInfo.sampler = _vkLinearRepeatSampler;
-                         Texture& normalMapTexture =
-                             _textures[uploadLitMaterial.normalTextureId];
-
-                         ++normalMapTexture.resource.refCount;
-                         newMaterial.textureResourceDependencyIds.push_back(
-                             normalMapTexture.resource.id);
-
-                         normalMapTexImageInfo.imageView =
-                             normalMapTexture.imageView;
-
-                         descriptorBuilder.bindImage(
-                             2, normalMapTexImageInfo,
-                             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
-                       } else {
-                         descriptorBuilder.declareUnusedImage(
-                             2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT);
-                       }
-                     } else if (uploadMaterial.materialType ==
-                                core::MaterialType::unlit) {
-                       rhi::UploadUnlitMaterialRHI const& uploadUnlitMaterial =
-                           std::get<rhi::UploadUnlitMaterialRHI>(
-                               uploadMaterial.uploadMaterialSubtype);
-                       GPUUnlitMaterialData materialData;
-                       materialData.hasColorTex =
-                           uploadUnlitMaterial.colorTextureId !=
-                           rhi::rhiIdUninitialized;
-                       materialData.color = uploadUnlitMaterial.color;
-
-                       createAndBindMaterialDataBuffer(materialData,
-                                                       descriptorBuilder,
-                                                       materialDataBufferInfo);
-
-                       bool const hasColorTex =
-                           uploadUnlitMaterial.colorTextureId !=
-                           rhi::rhiIdUninitialized;
-                       if (hasColorTex) {
-                         Texture& colorTexture =
-                             _textures[uploadUnlitMaterial.colorTextureId];
-
-                         ++colorTexture.resource.refCount;
-                         newMaterial.textureResourceDependencyIds.push_back(
-                             colorTexture.resource.id);
-
-                         VkDescriptorImageInfo colorTexImageInfo;
-                         colorTexImageInfo.imageLayout =
-                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                         colorTexImageInfo.imageView = colorTexture.imageView;
-                         colorTexImageInfo.sampler = _vkLinearRepeatSampler;
-
-                         descriptorBuilder.bindImage(
-                             1, colorTexImageInfo,
-                             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
-                       } else {
-                         descriptorBuilder.declareUnusedImage(
-                             1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT);
-                       }
-                     } else if (uploadMaterial.materialType ==
-                                core::MaterialType::pbr) {
-                       rhi::UploadPBRMaterialRHI const& uploadPbrMaterial =
-                           std::get<rhi::UploadPBRMaterialRHI>(
-                               uploadMaterial.uploadMaterialSubtype);
-
-                       GPUPbrMaterialData pbrMaterialData;
-                       pbrMaterialData.metalnessAndRoughnessSeparate =
-                           uploadPbrMaterial.roughnessTextureId !=
-                           rhi::rhiIdUninitialized;
-
-                       createAndBindMaterialDataBuffer(pbrMaterialData,
-                                                       descriptorBuilder,
-                                                       materialDataBufferInfo);
-
-                       Texture& albedoTexture =
-                           _textures[uploadPbrMaterial.albedoTextureId];
-
-                       ++albedoTexture.resource.refCount;
+          .spawn(task::TaskType::rhiTransfer,
+                 [this, id, uploadMaterial = std::move(uploadMaterial)]() {
+                   VkMaterial& newMaterial = _materials[id];
+
+                   PipelineBuilder pipelineBuilder =
+                       _pipelineBuilders.at(uploadMaterial.materialType);
+
+                   Shader& vertexShaderModule =
+                       _shaderModules.at(uploadMaterial.vertexShaderId);
+                   ++vertexShaderModule.resource.refCount;
+                   newMaterial.vertexShaderResourceDependencyId =
+                       vertexShaderModule.resource.id;
+
+                   pipelineBuilder._vkShaderStageCreateInfos.clear();
+                   pipelineBuilder._vkShaderStageCreateInfos.push_back(
+                       vkinit::pipelineShaderStageCreateInfo(
+                           VK_SHADER_STAGE_VERTEX_BIT,
+                           vertexShaderModule.vkShaderModule));
+
+                   Shader& fragmentShaderModule =
+                       _shaderModules.at(uploadMaterial.fragmentShaderId);
+                   ++fragmentShaderModule.resource.refCount;
+                   newMaterial.fragmentShaderResourceDependencyId =
+                       fragmentShaderModule.resource.id;
+
+                   pipelineBuilder._vkShaderStageCreateInfos.push_back(
+                       vkinit::pipelineShaderStageCreateInfo(
+                           VK_SHADER_STAGE_FRAGMENT_BIT,
+                           fragmentShaderModule.vkShaderModule));
+
+                   newMaterial.vkPipelineLayout =
+                       pipelineBuilder._vkPipelineLayout;
+
+                   pipelineBuilder._vkDepthStencilStateCreateInfo =
+                       vkinit::
+                           depthStencilStateCreateInfo(
+                               true, _sampleCount != VK_SAMPLE_COUNT_1_BIT /*we don't reuse depth in case of multisampling*/);
+                   newMaterial.vkPipelineMainRenderPass =
+                       pipelineBuilder.buildPipeline(_vkDevice,
+                                                     _mainRenderPass);
+
+                   setDbgResourceName(
+                       _vkDevice,
+                       (std::uint64_t)newMaterial.vkPipelineMainRenderPass,
+                       VK_OBJECT_TYPE_PIPELINE, uploadMaterial.debugName,
+                       "Reuse depth pipeline");
+
+                   pipelineBuilder._vkDepthStencilStateCreateInfo =
+                       vkinit::depthStencilStateCreateInfo(true, true);
+                   pipelineBuilder._vkRasterizationCreateInfo.frontFace =
+                       VK_FRONT_FACE_CLOCKWISE;
+                   newMaterial.vkPipelineEnvironmentRendering =
+                       pipelineBuilder.buildPipeline(_vkDevice,
+                                                     _envMapRenderPass);
+                   pipelineBuilder._vkRasterizationCreateInfo.frontFace =
+                       VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+                   setDbgResourceName(
+                       _vkDevice,
+                       (std::uint64_t)
+                           newMaterial.vkPipelineEnvironmentRendering,
+                       VK_OBJECT_TYPE_PIPELINE, uploadMaterial.debugName,
+                       "Environment rendering pipeline");
+
+                   newMaterial.transparent = uploadMaterial.transparent;
+
+                   DescriptorBuilder descriptorBuilder =
+                       DescriptorBuilder::begin(_vkDevice,
+                                                _descriptorAllocator,
+                                                _descriptorLayoutCache);
+
+                   VkDescriptorBufferInfo materialDataBufferInfo;
+
+                   if (uploadMaterial.materialType ==
+                       core::MaterialType::lit) {
+                     rhi::UploadLitMaterialRHI const& uploadLitMaterial =
+                         std::get<rhi::UploadLitMaterialRHI>(
+                             uploadMaterial.uploadMaterialSubtype);
+
+                     newMaterial.reflection = uploadLitMaterial.reflection;
+
+                     GPULitMaterialData materialData;
+                     materialData.hasDiffuseTex =
+                         uploadLitMaterial.diffuseTextureId !=
+                         rhi::rhiIdUninitialized;
+                     materialData.hasNormalMap =
+                         uploadLitMaterial.normalTextureId !=
+                         rhi::rhiIdUninitialized;
+                     materialData.reflection = uploadLitMaterial.reflection;
+                     materialData.ambientColor =
+                         uploadLitMaterial.ambientColor;
+                     materialData.diffuseColor =
+                         uploadLitMaterial.diffuseColor;
+                     materialData.specularColor =
+                         uploadLitMaterial.specularColor;
+                     materialData.shininess = uploadLitMaterial.shininess;
+
+                     createAndBindMaterialDataBuffer(materialData,
+                                                     descriptorBuilder,
+                                                     materialDataBufferInfo);
+
+                     bool const hasDiffuseTex =
+                         uploadLitMaterial.diffuseTextureId !=
+                         rhi::rhiIdUninitialized;
+
+                     if (hasDiffuseTex) {
+                       Texture& diffuseTexture =
+                           _textures[uploadLitMaterial.diffuseTextureId];
+
+                       ++diffuseTexture.resource.refCount;
                        newMaterial.textureResourceDependencyIds.push_back(
-                           albedoTexture.resource.id);
+                           diffuseTexture.resource.id);
 
-                       VkDescriptorImageInfo albedoTexImageInfo;
-                       albedoTexImageInfo.imageLayout =
+                       VkDescriptorImageInfo diffuseTexImageInfo;
+                       diffuseTexImageInfo.imageLayout =
                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                       albedoTexImageInfo.imageView = albedoTexture.imageView;
-                       albedoTexImageInfo.sampler = _vkLinearRepeatSampler;
+                       diffuseTexImageInfo.imageView =
+                           diffuseTexture.imageView;
+                       diffuseTexImageInfo.sampler = _vkLinearRepeatSampler;
 
                        descriptorBuilder.bindImage(
-                           1, albedoTexImageInfo,
+                           1, diffuseTexImageInfo,
                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
+                     } else {
+                       descriptorBuilder.declareUnusedImage(
+                           1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           VK_SHADER_STAGE_FRAGMENT_BIT);
+                     }
+
+                     bool const hasNormalMap =
+                         uploadLitMaterial.normalTextureId !=
+                         rhi::rhiIdUninitialized;
 
-                       Texture& normalTexture =
-                           _textures[uploadPbrMaterial.normalTextureId];
+                     if (hasNormalMap) {
+                       VkDescriptorImageInfo normalMapTexImageInfo;
+                       normalMapTexImageInfo.imageLayout =
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                       normalMapTexImageInfo.sampler = _vkLinearRepeatSampler;
+                       Texture& normalMapTexture =
+                           _textures[uploadLitMaterial.normalTextureId];
 
-                       ++normalTexture.resource.refCount;
+                       ++normalMapTexture.resource.refCount;
                        newMaterial.textureResourceDependencyIds.push_back(
-                           normalTexture.resource.id);
+                           normalMapTexture.resource.id);
 
-                       VkDescriptorImageInfo normalTexImageInfo;
-                       normalTexImageInfo.imageLayout =
-                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                       normalTexImageInfo.imageView = normalTexture.imageView;
-                       normalTexImageInfo.sampler = _vkLinearRepeatSampler;
+                       normalMapTexImageInfo.imageView =
+                           normalMapTexture.imageView;
 
                        descriptorBuilder.bindImage(
-                           2, normalTexImageInfo,
+                           2, normalMapTexImageInfo,
                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
+                     } else {
+                       descriptorBuilder.declareUnusedImage(
+                           2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           VK_SHADER_STAGE_FRAGMENT_BIT);
+                     }
+                   } else if (uploadMaterial.materialType ==
+                              core::MaterialType::unlit) {
+                     rhi::UploadUnlitMaterialRHI const& uploadUnlitMaterial =
+                         std::get<rhi::UploadUnlitMaterialRHI>(
+                             uploadMaterial.uploadMaterialSubtype);
+                     GPUUnlitMaterialData materialData;
+                     materialData.hasColorTex =
+                         uploadUnlitMaterial.colorTextureId !=
+                         rhi::rhiIdUninitialized;
+                     materialData.color = uploadUnlitMaterial.color;
+
+                     createAndBindMaterialDataBuffer(materialData,
+                                                     descriptorBuilder,
+                                                     materialDataBufferInfo);
+
+                     bool const hasColorTex =
+                         uploadUnlitMaterial.colorTextureId !=
+                         rhi::rhiIdUninitialized;
+                     if (hasColorTex) {
+                       Texture& colorTexture =
+                           _textures[uploadUnlitMaterial.colorTextureId];
+
+                       ++colorTexture.resource.refCount;
+                       newMaterial.textureResourceDependencyIds.push_back(
+                           colorTexture.resource.id);
 
-                       Texture& metalnessTexture =
-                           _textures[uploadPbrMaterial.metalnessTextureId];
+                       VkDescriptorImageInfo colorTexImageInfo;
+                       colorTexImageInfo.imageLayout =
+                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                       colorTexImageInfo.imageView = colorTexture.imageView;
+                       colorTexImageInfo.sampler = _vkLinearRepeatSampler;
 
-                       ++metalnessTexture.resource.refCount;
+                       descriptorBuilder.bindImage(
+                           1, colorTexImageInfo,
+                           VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
+                     } else {
+                       descriptorBuilder.declareUnusedImage(
+                           1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           VK_SHADER_STAGE_FRAGMENT_BIT);
+                     }
+                   } else if (uploadMaterial.materialType ==
+                              core::MaterialType::pbr) {
+                     rhi::UploadPBRMaterialRHI const& uploadPbrMaterial =
+                         std::get<rhi::UploadPBRMaterialRHI>(
+                             uploadMaterial.uploadMaterialSubtype);
+
+                     GPUPbrMaterialData pbrMaterialData;
+                     pbrMaterialData.metalnessAndRoughnessSeparate =
+                         uploadPbrMaterial.roughnessTextureId !=
+                         rhi::rhiIdUninitialized;
+
+                     createAndBindMaterialDataBuffer(pbrMaterialData,
+                                                     descriptorBuilder,
+                                                     materialDataBufferInfo);
+
+                     Texture& albedoTexture =
+                         _textures[uploadPbrMaterial.albedoTextureId];
+
+                     ++albedoTexture.resource.refCount;
+                     newMaterial.textureResourceDependencyIds.push_back(
+                         albedoTexture.resource.id);
+
+                     VkDescriptorImageInfo albedoTexImageInfo;
+                     albedoTexImageInfo.imageLayout =
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                     albedoTexImageInfo.imageView = albedoTexture.imageView;
+                     albedoTexImageInfo.sampler = _vkLinearRepeatSampler;
+
+                     descriptorBuilder.bindImage(
+                         1, albedoTexImageInfo,
+                         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                         VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+
+                     Texture& normalTexture =
+                         _textures[uploadPbrMaterial.normalTextureId];
+
+                     ++normalTexture.resource.refCount;
+                     newMaterial.textureResourceDependencyIds.push_back(
+                         normalTexture.resource.id);
+
+                     VkDescriptorImageInfo normalTexImageInfo;
+                     normalTexImageInfo.imageLayout =
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                     normalTexImageInfo.imageView = normalTexture.imageView;
+                     normalTexImageInfo.sampler = _vkLinearRepeatSampler;
+
+                     descriptorBuilder.bindImage(
+                         2, normalTexImageInfo,
+                         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                         VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+
+                     Texture& metalnessTexture =
+                         _textures[uploadPbrMaterial.metalnessTextureId];
+
+                     ++metalnessTexture.resource.refCount;
+                     newMaterial.textureResourceDependencyIds.push_back(
+                         metalnessTexture.resource.id);
+
+                     VkDescriptorImageInfo metalnessTexImageInfo;
+                     metalnessTexImageInfo.imageLayout =
+                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                     metalnessTexImageInfo.imageView =
+                         metalnessTexture.imageView;
+                     metalnessTexImageInfo.sampler = _vkLinearRepeatSampler;
+
+                     descriptorBuilder.bindImage(
+                         3, metalnessTexImageInfo,
+                         VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                         VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
+
+                     if (pbrMaterialData.metalnessAndRoughnessSeparate) {
+                       Texture& roughnessTexture =
+                           _textures[uploadPbrMaterial.roughnessTextureId];
+
+                       ++roughnessTexture.resource.refCount;
                        newMaterial.textureResourceDependencyIds.push_back(
-                           metalnessTexture.resource.id);
+                           roughnessTexture.resource.id);
 
-                       VkDescriptorImageInfo metalnessTexImageInfo;
-                       metalnessTexImageInfo.imageLayout =
+                       VkDescriptorImageInfo roughnessTexImageInfo;
+                       roughnessTexImageInfo.imageLayout =
                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                       metalnessTexImageInfo.imageView =
+                       roughnessTexImageInfo.imageView =
                            metalnessTexture.imageView;
-                       metalnessTexImageInfo.sampler = _vkLinearRepeatSampler;
+                       roughnessTexImageInfo.sampler = _vkLinearRepeatSampler;
 
                        descriptorBuilder.bindImage(
-                           3, metalnessTexImageInfo,
+                           4, roughnessTexImageInfo,
                            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                            VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
-
-                       if (pbrMaterialData.metalnessAndRoughnessSeparate) {
-                         Texture& roughnessTexture =
-                             _textures[uploadPbrMaterial.roughnessTextureId];
-
-                         ++roughnessTexture.resource.refCount;
-                         newMaterial.textureResourceDependencyIds.push_back(
-                             roughnessTexture.resource.id);
-
-                         VkDescriptorImageInfo roughnessTexImageInfo;
-                         roughnessTexImageInfo.imageLayout =
-                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                         roughnessTexImageInfo.imageView =
-                             metalnessTexture.imageView;
-                         roughnessTexImageInfo.sampler = _vkLinearRepeatSampler;
-
-                         descriptorBuilder.bindImage(
-                             4, roughnessTexImageInfo,
-                             VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT, nullptr);
-                       } else {
-                         descriptorBuilder.declareUnusedImage(
-                             4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                             VK_SHADER_STAGE_FRAGMENT_BIT);
-                       }
-                     }
-
-                     if (uploadMaterial.hasTimer) {
-                       VkDescriptorBufferInfo bufferInfo = {};
-                       bufferInfo.buffer = _timerBuffer.buffer;
-                       bufferInfo.offset = 0;
-                       bufferInfo.range = VK_WHOLE_SIZE;
-                       descriptorBuilder.bindBuffer(
-                           10, bufferInfo, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                           VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
                      } else {
-                       descriptorBuilder.declareUnusedBuffer(
-                           10, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                       descriptorBuilder.declareUnusedImage(
+                           4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                            VK_SHADER_STAGE_FRAGMENT_BIT);
                      }
-
-                     if (!descriptorBuilder.build(
-                             newMaterial.vkDescriptorSet)) {
-                       OBS_LOG_ERR("Failed to build descriptor set when "
-                                   "uploading material");
-                       newMaterial.resource.state = rhi::ResourceState::invalid;
-                     } else {
-                       rhi::ResourceState expected =
-                           rhi::ResourceState::uploading;
-
-                       if (!newMaterial.resource.state.compare_exchange_strong(
-                               expected, rhi::ResourceState::uploaded)) {
-                         assert(false && "Material resource in invalid state");
-                       }
+                   }
+
+                   if (uploadMaterial.hasTimer) {
+                     VkDescriptorBufferInfo bufferInfo = {};
+                     bufferInfo.buffer = _timerBuffer.buffer;
+                     bufferInfo.offset = 0;
+                     bufferInfo.range = VK_WHOLE_SIZE;
+                     descriptorBuilder.bindBuffer(
+                         10, bufferInfo, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                         VK_SHADER_STAGE_FRAGMENT_BIT, nullptr, true);
+                   } else {
+                     descriptorBuilder.declareUnusedBuffer(
+                         10, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                         VK_SHADER_STAGE_FRAGMENT_BIT);
+                   }
+
+                   if (!descriptorBuilder.build(
+                           newMaterial.vkDescriptorSet)) {
+                     OBS_LOG_ERR("Failed to build descriptor set when "
+                                 "uploading material");
+                     newMaterial.resource.state = rhi::ResourceState::invalid;
+                   } else {
+                     rhi::ResourceState expected =
+                         rhi::ResourceState::uploading;
+
+                     if (!newMaterial.resource.state.compare_exchange_strong(
+                             expected, rhi::ResourceState::uploaded)) {
+                       assert(false && "Material resource in invalid state");
                      }
-                   })};
+                   }
+                 })};
 }
 
 void VulkanRHI::releaseMaterial(rhi::ResourceIdRHI resourceIdRHI) {
@@ -947,6 +969,19 @@ VkInstance VulkanRHI::getInstance() const { return _vkInstance; }
 
 void VulkanRHI::setSurface(VkSurfaceKHR surface) { _vkSurface = surface; }
 
+task::ThreadInitInfo
+VulkanRHI::getTransferThreadInitInfo(unsigned int threadCount,
+                                     platform::CpuSet cpus) {
+  constexpr std::size_t transferCleanupIntervalMs = 250;
+
+  return {task::TaskType::rhiTransfer,
+          threadCount,
+          [this]() { cleanupFinishedTransfersForCurrentThread(false); },
+          transferCleanupIntervalMs,
+          "rhi transfer",
+          {std::move(cpus)}};
+}
+
 void VulkanRHI::updateExtent(rhi::WindowExtentRHI newExtent) {
   std::scoped_lock l{_pendingExtentUpdateMutex};
   _pendingExtentUpdate = newExtent;
@@ -1015,6 +1050,12 @@ void VulkanRHI::initResourceTransferContext(ResourceTransferContext& ctx) {
 void VulkanRHI::cleanupFinishedTransfersForCurrentThread(bool waitToFinish) {
   static thread_local std::vector<TransferResources> transferResources;
 
+  // Threads without a context have nothing to release, and the context
+  // mustn't be recreated once the RHI is cleaned up.
+  if (!resourceTransferCtx.initialized) {
+    return;
+  }
+
   ResourceTransferContext& ctx = getResourceTransferContextForCurrentThread();
   transferResources.swap(ctx.transferResources);
 
@@ -1176,16 +1217,9 @@ void VulkanRHI::transferDataToImage(AllocatedBuffer stagingBuffer,
                        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
                        nullptr, 1, &barrierTransitionToTransferQueue);
 
-  std::size_t const size = imgTransferInfo.width * imgTransferInfo.height *
-                           core::getFormatPixelSize(imgTransferInfo.format) *
-                           (imgTransferInfo.mipCount > 1 ? 2 : 1);
-  VkDeviceSize const mipLevelSize =
-      imgTransferInfo.mipCount > 1 ? (size / 2) : size;
-
-  VkDeviceSize offset = 0;
   for (std::size_t i = 0; i < imgTransferInfo.mipCount; ++i) {
     VkBufferImageCopy vkBufferImgCopy = {};
-    vkBufferImgCopy.bufferOffset = offset;
+    vkBufferImgCopy.bufferOffset = imgTransferInfo.mipOffsets[i];
     vkBufferImgCopy.imageExtent = {imgTransferInfo.width >> i,
                                    imgTransferInfo.height >> i, 1};
     vkBufferImgCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -1195,8 +1229,6 @@ void VulkanRHI::transferDataToImage(AllocatedBuffer stagingBuffer,
     vkCmdCopyBufferToImage(cmdTransfer, stagingBuffer.buffer, dstImg,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
                            &vkBufferImgCopy);
-
-    offset += mipLevelSize >> (i * 2);
   }
 
   VkSubmitInfo transferSubmitInfo = {};
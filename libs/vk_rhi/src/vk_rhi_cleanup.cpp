@@ -1,4 +1,5 @@
 #include <obsidian/renderdoc/renderdoc.hpp>
+#include <obsidian/task/task_type.hpp>
 #include <obsidian/vk_rhi/vk_rhi.hpp>
 
 #include <VkBootstrap.h>
@@ -12,9 +13,12 @@ void VulkanRHI::cleanup() {
 
     waitDeviceIdle();
 
-    _taskExecutor.shutdown();
-    while (!_taskExecutor.shutdownComplete())
-      ;
+    // The executor outlives the RHI, so the transfer workers have to release
+    // their contexts before the device is destroyed.
+    _taskExecutor.runOnEachWorker(task::TaskType::rhiTransfer, [this]() {
+      destroyImmediateCtxForCurrentThread();
+      cleanupResourceTransferCtxForCurrentThread();
+    });
 
     destroyImmediateCtxForCurrentThread();
     cleanupResourceTransferCtxForCurrentThread();
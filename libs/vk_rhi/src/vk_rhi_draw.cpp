@@ -2,6 +2,8 @@
 #include <obsidian/core/utils/aabb.hpp>
 #include <obsidian/core/vertex_type.hpp>
 #include <obsidian/rhi/rhi.hpp>
+#include <obsidian/task/task_executor.hpp>
+#include <obsidian/task/task_type.hpp>
 #include <obsidian/vk_rhi/vk_check.hpp>
 #include <obsidian/vk_rhi/vk_frame_data.hpp>
 #include <obsidian/vk_rhi/vk_initializers.hpp>
@@ -16,9 +18,9 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <cstddef>
 #include <cstring>
 #include <mutex>
-#include <numeric>
 
 using namespace obsidian;
 using namespace obsidian::vk_rhi;
@@ -712,6 +714,29 @@ void VulkanRHI::draw(rhi::SceneGlobalParams const& sceneParams) {
   FrameMark;
 }
 
+void VulkanRHI::cullDrawCalls(VKDrawCall const* first, int count,
+                              GPUCameraData const& cameraData) {
+  ZoneScopedN("Frustum Culling");
+
+  // Large passes are culled on the general workers before recording.
+  constexpr std::size_t cullingGrainSize = 256;
+
+  _drawCallVisibility.resize(count);
+
+  _taskExecutor.parallelFor(
+      task::TaskType::general, 0, count, cullingGrainSize,
+      [this, first, &cameraData](int b, int e) {
+        for (int i = b; i < e; ++i) {
+          VKDrawCall const& drawCall = first[i];
+
+          assert(drawCall.mesh && "Error: Missing mesh");
+
+          _drawCallVisibility[i] = core::utils::isVisible(
+              drawCall.mesh->aabb, cameraData.viewProj * drawCall.model);
+        }
+      });
+}
+
 void VulkanRHI::drawWithMaterials(
     VkCommandBuffer cmd, VKDrawCall* first, int count,
     GPUCameraData const& cameraData,
@@ -721,6 +746,8 @@ void VulkanRHI::drawWithMaterials(
     std::optional<VkRect2D> dynamicScissor, bool reusesDepth) {
   ZoneScoped;
 
+  cullDrawCalls(first, count, cameraData);
+
   VkMaterial const* lastMaterial = nullptr;
   for (int i = 0; i < count; ++i) {
     ZoneScopedN("Draw Object");
@@ -732,8 +759,7 @@ void VulkanRHI::drawWithMaterials(
     assert(drawCall.mesh && "Error: Missing mesh");
     Mesh const& mesh = *drawCall.mesh;
 
-    if (!core::utils::isVisible(mesh.aabb,
-                                cameraData.viewProj * drawCall.model)) {
+    if (!_drawCallVisibility[i]) {
       continue;
     }
 
@@ -782,10 +808,7 @@ void VulkanRHI::drawWithMaterials(
     vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.vertexBuffer.buffer, &bufferOffset);
 
     VkDeviceSize const indBufferOffset =
-        static_cast<VkDeviceSize>(std::accumulate(
-            mesh.indexBufferSizes.cbegin(),
-            mesh.indexBufferSizes.cbegin() + drawCall.indexBufferInd,
-            std::size_t{0}));
+        mesh.indexBufferOffsets[drawCall.indexBufferInd];
     vkCmdBindIndexBuffer(cmd, mesh.indexBuffer.buffer, indBufferOffset,
                          VK_INDEX_TYPE_UINT32);
 
@@ -830,14 +853,15 @@ void VulkanRHI::drawNoMaterials(
                           descriptorSets.size(), descriptorSets.data(),
                           dynamicOffsets.size(), dynamicOffsets.data());
 
+  cullDrawCalls(first, count, cameraData);
+
   for (std::size_t i = 0; i < count; ++i) {
     VKDrawCall& drawCall = first[i];
     assert(drawCall.mesh && "Error: Missing mesh");
 
     Mesh& mesh = *drawCall.mesh;
 
-    if (!core::utils::isVisible(mesh.aabb,
-                                cameraData.viewProj * drawCall.model)) {
+    if (!_drawCallVisibility[i]) {
       continue;
     }
 
@@ -853,10 +877,7 @@ void VulkanRHI::drawNoMaterials(
                            &vertBufferOffset);
 
     VkDeviceSize const indBufferOffset =
-        static_cast<VkDeviceSize>(std::accumulate(
-            mesh.indexBufferSizes.cbegin(),
-            mesh.indexBufferSizes.cbegin() + drawCall.indexBufferInd,
-            std::size_t{0}));
+        mesh.indexBufferOffsets[drawCall.indexBufferInd];
 
     vkCmdBindIndexBuffer(cmd, mesh.indexBuffer.buffer, indBufferOffset,
                          VK_INDEX_TYPE_UINT32);
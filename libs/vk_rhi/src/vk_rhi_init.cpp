@@ -37,13 +37,6 @@ void VulkanRHI::init(rhi::WindowExtentRHI extent,
   initVulkan(surfaceProvider);
   initFrameNumberSemaphore();
 
-  constexpr std::size_t transferCleanupIntervalMs = 250;
-  
-  _taskExecutor.initAndRun(
-      {{task::TaskType::rhiTransfer, 4,
-        [this]() { cleanupFinishedTransfersForCurrentThread(false); },
-        transferCleanupIntervalMs}});
-
   _deletionQueue.pushFunction([this]() { destroyUnusedResources(true); });
 
   initSwapchain(extent);
@@ -1517,6 +1510,9 @@ void VulkanRHI::initSsaoSamplesAndNoise() {
   uploadTextureRHI.width = 4;
   uploadTextureRHI.height = 4;
   uploadTextureRHI.mipLevels = 1;
+  uploadTextureRHI.textureDataSize =
+      noiseVectors.size() * sizeof(decltype(noiseVectors)::value_type);
+  uploadTextureRHI.mipOffsets = {0};
   uploadTextureRHI.unpackFunc = [noise = std::move(noiseVectors)](char* dst) {
     std::memcpy(dst, reinterpret_cast<char const*>(noise.data()),
                 noise.size() * sizeof(decltype(noiseVectors)::value_type));
@@ -139,6 +139,21 @@ set(LZ4_BUILD_LEGACY_LZ4C OFF CACHE BOOL "Build lz4c program with legacy argumen
 
 FetchContent_MakeAvailable(fetch_lz4)
 
+FetchContent_Declare(fetch_zstd
+    GIT_REPOSITORY https://github.com/facebook/zstd.git
+    GIT_TAG v1.5.6
+    SOURCE_SUBDIR ./build/cmake
+    GIT_PROGRESS TRUE
+    SYSTEM
+)
+
+set(ZSTD_BUILD_PROGRAMS OFF CACHE BOOL "Build zstd programs" FORCE)
+set(ZSTD_BUILD_SHARED OFF CACHE BOOL "Build zstd shared library" FORCE)
+set(ZSTD_BUILD_TESTS OFF CACHE BOOL "Build zstd tests" FORCE)
+set(ZSTD_LEGACY_SUPPORT OFF CACHE BOOL "Support legacy zstd formats" FORCE)
+
+FetchContent_MakeAvailable(fetch_zstd)
+
 FetchContent_Declare(fetch_json
     GIT_REPOSITORY https://github.com/nlohmann/json.git
     GIT_TAG v3.11.2
@@ -178,6 +193,19 @@ FetchContent_Declare(fetch_gtest
 
 FetchContent_MakeAvailable(fetch_gtest)
 
+FetchContent_Declare(fetch_benchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG v1.8.3
+    GIT_PROGRESS TRUE
+    SYSTEM
+)
+
+set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+
+FetchContent_MakeAvailable(fetch_benchmark)
+
 FetchContent_Declare(fetch_imguifiledialog
     GIT_REPOSITORY https://github.com/aiekick/ImGuiFileDialog
     GIT_TAG v0.6.7
@@ -205,6 +233,8 @@ if (WIN32)
         gtest_main
         gmock
         gmock_main
+        benchmark
+        benchmark_main
         SDL2
         SDL2_test
         SDL2main
@@ -214,6 +244,7 @@ if (WIN32)
         tinyobjloader
         vk-bootstrap
         lz4_static
+        libzstd_static
         loader_example
         DearImgui
         ImGuiFileDialog